@@ -0,0 +1,69 @@
+#include "bench.h"
+#include <rmgr/fib/algorithm.h>
+
+
+namespace {
+
+
+//=================================================================================================
+// Population count
+
+/// The usual scalar loop, one 64-bit word at a time
+static uint64_t popcount_scalar(const void* data, size_t size) RMGR_NOEXCEPT
+{
+    const uint8_t* src   = static_cast<const uint8_t*>(data);
+    uint64_t       total = 0;
+    for (; size >= 8; src += 8, size -= 8)
+    {
+        uint64_t word;
+        memcpy(&word, src, sizeof(word));
+        total += popcnt(word);
+    }
+    for (; size != 0; ++src, --size)
+        total += popcnt(*src);
+    return total;
+}
+
+RMGR_FIB_BENCH_BULK(popcount, INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ && INTERNAL_RMGR_FIB_USE_AVX512VL,
+                    rmgr::fib::popcount(data, size), popcount_scalar(data, size));
+
+
+
+//=================================================================================================
+// Stream compaction
+
+/// Selects the positive lanes
+struct positive
+{
+    typedef rmgr::fib::vec<int32_t, 4> vec_type;
+    vec_type::mask_type operator()(const vec_type& v) const RMGR_NOEXCEPT { return v > vec_type::zero(); }
+};
+
+static int32_t g_compressed[rmgr::fib::bench::BULK_LARGE / sizeof(int32_t)];
+
+/// Keeps the positive 32-bit integers of a buffer, trailing bytes are ignored
+static size_t compress_vector(const void* data, size_t size) RMGR_NOEXCEPT
+{
+    return rmgr::fib::compress(g_compressed, static_cast<const int32_t*>(data), size / sizeof(int32_t), positive());
+}
+
+/// The usual branchless scalar loop, which always writes and only advances past the kept elements
+static size_t compress_scalar(const void* data, size_t size) RMGR_NOEXCEPT
+{
+    const uint8_t* src   = static_cast<const uint8_t*>(data);
+    size_t         count = 0;
+    for (; size >= sizeof(int32_t); src += sizeof(int32_t), size -= sizeof(int32_t))
+    {
+        int32_t x;
+        memcpy(&x, src, sizeof(x));
+        g_compressed[count] = x;
+        count += (x > 0);
+    }
+    return count;
+}
+
+RMGR_FIB_BENCH_BULK(compress, INTERNAL_RMGR_FIB_USE_AVX512VL,
+                    compress_vector(data, size), compress_scalar(data, size));
+
+
+} // namespace
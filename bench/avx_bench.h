@@ -0,0 +1,178 @@
+#include "bench.h"
+#include <rmgr/fib/avx.h>
+#include <cmath>
+
+
+// The scalar helpers (mask, min, max, mulhi) come from sse_bench.h, which is included first
+namespace {
+
+
+#if INTERNAL_RMGR_FIB_USE_AVX
+
+//=================================================================================================
+// Negation & absolute value
+
+RMGR_FIB_BENCH(__m256,  float,  _mm256_neg_ps, 0, _mm256_neg_ps(a), -a);
+RMGR_FIB_BENCH(__m256d, double, _mm256_neg_pd, 0, _mm256_neg_pd(a), -a);
+RMGR_FIB_BENCH(__m256,  float,  _mm256_abs_ps, 0, _mm256_abs_ps(a), std::fabs(a));
+RMGR_FIB_BENCH(__m256d, double, _mm256_abs_pd, 0, _mm256_abs_pd(a), std::fabs(a));
+
+#endif // INTERNAL_RMGR_FIB_USE_AVX
+
+
+#if INTERNAL_RMGR_FIB_USE_AVX2
+
+//=================================================================================================
+// Bitwise NOT and negation
+
+RMGR_FIB_BENCH(__m256i, uint32_t, _mm256_not_si256, 0, _mm256_not_si256(a), ~a);
+RMGR_FIB_BENCH(__m256i, int8_t,   _mm256_neg_epi8,  0, _mm256_neg_epi8(a),  -a);
+RMGR_FIB_BENCH(__m256i, int16_t,  _mm256_neg_epi16, 0, _mm256_neg_epi16(a), -a);
+RMGR_FIB_BENCH(__m256i, int32_t,  _mm256_neg_epi32, 0, _mm256_neg_epi32(a), -a);
+RMGR_FIB_BENCH(__m256i, int64_t,  _mm256_neg_epi64, 0, _mm256_neg_epi64(a), -a);
+
+
+//=================================================================================================
+// Ternary logic
+
+RMGR_FIB_BENCH(__m256i, uint32_t, _mm256_ternarylogic_epi32, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_ternarylogic_epi32(a, b, _mm256_add_epi32(a,b), 0xE8), (a & b) | ((a + b) & (a | b)));
+RMGR_FIB_BENCH(__m256i, uint64_t, _mm256_ternarylogic_epi64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_ternarylogic_epi64(a, b, _mm256_add_epi64(a,b), 0xCA), (a & b) | (~a & (a + b)));
+
+
+//=================================================================================================
+// Comparisons
+
+RMGR_FIB_BENCH(__m256i, int8_t,   _mm256_cmpneq_epi8,  0, _mm256_cmpneq_epi8(a,b),  mask<int8_t>(a != b));
+RMGR_FIB_BENCH(__m256i, int8_t,   _mm256_cmpge_epi8,   0, _mm256_cmpge_epi8(a,b),   mask<int8_t>(a >= b));
+RMGR_FIB_BENCH(__m256i, int8_t,   _mm256_cmple_epi8,   0, _mm256_cmple_epi8(a,b),   mask<int8_t>(a <= b));
+RMGR_FIB_BENCH(__m256i, uint8_t,  _mm256_cmpgt_epu8,   0, _mm256_cmpgt_epu8(a,b),   mask<uint8_t>(a > b));
+RMGR_FIB_BENCH(__m256i, uint8_t,  _mm256_cmpge_epu8,   0, _mm256_cmpge_epu8(a,b),   mask<uint8_t>(a >= b));
+RMGR_FIB_BENCH(__m256i, uint8_t,  _mm256_cmplt_epu8,   0, _mm256_cmplt_epu8(a,b),   mask<uint8_t>(a < b));
+RMGR_FIB_BENCH(__m256i, uint8_t,  _mm256_cmple_epu8,   0, _mm256_cmple_epu8(a,b),   mask<uint8_t>(a <= b));
+RMGR_FIB_BENCH(__m256i, int16_t,  _mm256_cmpneq_epi16, 0, _mm256_cmpneq_epi16(a,b), mask<int16_t>(a != b));
+RMGR_FIB_BENCH(__m256i, int16_t,  _mm256_cmpge_epi16,  0, _mm256_cmpge_epi16(a,b),  mask<int16_t>(a >= b));
+RMGR_FIB_BENCH(__m256i, int16_t,  _mm256_cmple_epi16,  0, _mm256_cmple_epi16(a,b),  mask<int16_t>(a <= b));
+RMGR_FIB_BENCH(__m256i, uint16_t, _mm256_cmpgt_epu16,  0, _mm256_cmpgt_epu16(a,b),  mask<uint16_t>(a > b));
+RMGR_FIB_BENCH(__m256i, uint16_t, _mm256_cmpge_epu16,  0, _mm256_cmpge_epu16(a,b),  mask<uint16_t>(a >= b));
+RMGR_FIB_BENCH(__m256i, uint16_t, _mm256_cmplt_epu16,  0, _mm256_cmplt_epu16(a,b),  mask<uint16_t>(a < b));
+RMGR_FIB_BENCH(__m256i, uint16_t, _mm256_cmple_epu16,  0, _mm256_cmple_epu16(a,b),  mask<uint16_t>(a <= b));
+RMGR_FIB_BENCH(__m256i, int32_t,  _mm256_cmpneq_epi32, 0, _mm256_cmpneq_epi32(a,b), mask<int32_t>(a != b));
+RMGR_FIB_BENCH(__m256i, int32_t,  _mm256_cmpge_epi32,  0, _mm256_cmpge_epi32(a,b),  mask<int32_t>(a >= b));
+RMGR_FIB_BENCH(__m256i, int32_t,  _mm256_cmple_epi32,  0, _mm256_cmple_epi32(a,b),  mask<int32_t>(a <= b));
+RMGR_FIB_BENCH(__m256i, uint32_t, _mm256_cmpgt_epu32,  0, _mm256_cmpgt_epu32(a,b),  mask<uint32_t>(a > b));
+RMGR_FIB_BENCH(__m256i, uint32_t, _mm256_cmpge_epu32,  0, _mm256_cmpge_epu32(a,b),  mask<uint32_t>(a >= b));
+RMGR_FIB_BENCH(__m256i, uint32_t, _mm256_cmplt_epu32,  0, _mm256_cmplt_epu32(a,b),  mask<uint32_t>(a < b));
+RMGR_FIB_BENCH(__m256i, uint32_t, _mm256_cmple_epu32,  0, _mm256_cmple_epu32(a,b),  mask<uint32_t>(a <= b));
+RMGR_FIB_BENCH(__m256i, int64_t,  _mm256_cmpneq_epi64, 0, _mm256_cmpneq_epi64(a,b), mask<int64_t>(a != b));
+RMGR_FIB_BENCH(__m256i, int64_t,  _mm256_cmpge_epi64,  0, _mm256_cmpge_epi64(a,b),  mask<int64_t>(a >= b));
+RMGR_FIB_BENCH(__m256i, int64_t,  _mm256_cmplt_epi64,  0, _mm256_cmplt_epi64(a,b),  mask<int64_t>(a < b));
+RMGR_FIB_BENCH(__m256i, int64_t,  _mm256_cmple_epi64,  0, _mm256_cmple_epi64(a,b),  mask<int64_t>(a <= b));
+RMGR_FIB_BENCH(__m256i, uint64_t, _mm256_cmpgt_epu64,  0, _mm256_cmpgt_epu64(a,b),  mask<uint64_t>(a > b));
+RMGR_FIB_BENCH(__m256i, uint64_t, _mm256_cmpge_epu64,  0, _mm256_cmpge_epu64(a,b),  mask<uint64_t>(a >= b));
+RMGR_FIB_BENCH(__m256i, uint64_t, _mm256_cmplt_epu64,  0, _mm256_cmplt_epu64(a,b),  mask<uint64_t>(a < b));
+RMGR_FIB_BENCH(__m256i, uint64_t, _mm256_cmple_epu64,  0, _mm256_cmple_epu64(a,b),  mask<uint64_t>(a <= b));
+
+
+//=================================================================================================
+// Shifts
+
+RMGR_FIB_BENCH(__m256i, uint8_t,  _mm256_slli_epi8,  0,                             _mm256_slli_epi8(a,3),                     a << 3);
+RMGR_FIB_BENCH(__m256i, uint8_t,  _mm256_srli_epi8,  0,                             _mm256_srli_epi8(a,3),                     a >> 3);
+RMGR_FIB_BENCH(__m256i, int8_t,   _mm256_srai_epi8,  0,                             _mm256_srai_epi8(a,3),                     a >> 3);
+RMGR_FIB_BENCH(__m256i, uint8_t,  _mm256_sll_epi8,   0,                             _mm256_sll_epi8(a,_mm_cvtsi32_si128(3)),   a << 3);
+RMGR_FIB_BENCH(__m256i, uint8_t,  _mm256_srl_epi8,   0,                             _mm256_srl_epi8(a,_mm_cvtsi32_si128(3)),   a >> 3);
+RMGR_FIB_BENCH(__m256i, int8_t,   _mm256_sra_epi8,   0,                             _mm256_sra_epi8(a,_mm_cvtsi32_si128(3)),   a >> 3);
+RMGR_FIB_BENCH(__m256i, int64_t,  _mm256_srai_epi64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_srai_epi64(a,13),                   a >> 13);
+RMGR_FIB_BENCH(__m256i, int64_t,  _mm256_sra_epi64,  INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_sra_epi64(a,_mm_cvtsi32_si128(13)), a >> 13);
+
+
+//=================================================================================================
+// Variable shifts
+
+#define RMGR_FIB_BENCH_BW_VL  (INTERNAL_RMGR_FIB_USE_AVX512BW && INTERNAL_RMGR_FIB_USE_AVX512VL)
+RMGR_FIB_BENCH(__m256i, uint8_t,  _mm256_sllv_epi8,  0,                              _mm256_sllv_epi8(a,b),  b < 8  ? a << b : 0);
+RMGR_FIB_BENCH(__m256i, uint8_t,  _mm256_srlv_epi8,  0,                              _mm256_srlv_epi8(a,b),  b < 8  ? a >> b : 0);
+RMGR_FIB_BENCH(__m256i, int8_t,   _mm256_srav_epi8,  0,                              _mm256_srav_epi8(a,b),  a >> min<uint8_t>(uint8_t(b), 7));
+RMGR_FIB_BENCH(__m256i, uint16_t, _mm256_sllv_epi16, RMGR_FIB_BENCH_BW_VL,           _mm256_sllv_epi16(a,b), b < 16 ? a << b : 0);
+RMGR_FIB_BENCH(__m256i, uint16_t, _mm256_srlv_epi16, RMGR_FIB_BENCH_BW_VL,           _mm256_srlv_epi16(a,b), b < 16 ? a >> b : 0);
+RMGR_FIB_BENCH(__m256i, int16_t,  _mm256_srav_epi16, RMGR_FIB_BENCH_BW_VL,           _mm256_srav_epi16(a,b), a >> min<uint16_t>(uint16_t(b), 15));
+RMGR_FIB_BENCH(__m256i, int64_t,  _mm256_srav_epi64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_srav_epi64(a,b), a >> min<uint64_t>(uint64_t(b), 63));
+#undef RMGR_FIB_BENCH_BW_VL
+
+
+//=================================================================================================
+// Rotates
+
+RMGR_FIB_BENCH(__m256i, uint8_t,  _mm256_rol_epi8,   0,                              _mm256_rol_epi8(a,3),   rotl(a, 3));
+RMGR_FIB_BENCH(__m256i, uint16_t, _mm256_rol_epi16,  0,                              _mm256_rol_epi16(a,8),  rotl(a, 8));
+RMGR_FIB_BENCH(__m256i, uint32_t, _mm256_rol_epi32,  INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_rol_epi32(a,13), rotl(a, 13));
+RMGR_FIB_BENCH(__m256i, uint64_t, _mm256_rol_epi64,  INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_rol_epi64(a,13), rotl(a, 13));
+RMGR_FIB_BENCH(__m256i, uint8_t,  _mm256_rolv_epi8,  0,                              _mm256_rolv_epi8(a,b),  rotl(a, b));
+RMGR_FIB_BENCH(__m256i, uint16_t, _mm256_rolv_epi16, 0,                              _mm256_rolv_epi16(a,b), rotl(a, b));
+RMGR_FIB_BENCH(__m256i, uint32_t, _mm256_rolv_epi32, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_rolv_epi32(a,b), rotl(a, b));
+RMGR_FIB_BENCH(__m256i, uint64_t, _mm256_rolv_epi64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_rolv_epi64(a,b), rotl(a, unsigned(b)));
+
+
+//=================================================================================================
+// Min & max
+
+RMGR_FIB_BENCH(__m256i, int64_t,  _mm256_min_epi64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_min_epi64(a,b), min(a,b));
+RMGR_FIB_BENCH(__m256i, int64_t,  _mm256_max_epi64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_max_epi64(a,b), max(a,b));
+RMGR_FIB_BENCH(__m256i, uint64_t, _mm256_min_epu64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_min_epu64(a,b), min(a,b));
+RMGR_FIB_BENCH(__m256i, uint64_t, _mm256_max_epu64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_max_epu64(a,b), max(a,b));
+
+
+//=================================================================================================
+// Absolute value
+
+RMGR_FIB_BENCH(__m256i, int64_t,  _mm256_abs_epi64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_abs_epi64(a), (a < 0) ? -a : a);
+
+
+//=================================================================================================
+// Absolute difference
+
+RMGR_FIB_BENCH(__m256i, int8_t,   _mm256_absdiff_epi8,  0, _mm256_absdiff_epi8(a,b),  (a > b) ? a - b : b - a);
+RMGR_FIB_BENCH(__m256i, uint16_t, _mm256_absdiff_epu16, 0, _mm256_absdiff_epu16(a,b), (a > b) ? a - b : b - a);
+RMGR_FIB_BENCH(__m256i, uint32_t, _mm256_absdiff_epu32, 0, _mm256_absdiff_epu32(a,b), (a > b) ? a - b : b - a);
+RMGR_FIB_BENCH(__m256i, int64_t,  _mm256_absdiff_epi64, 0, _mm256_absdiff_epi64(a,b), (a > b) ? uint64_t(a) - uint64_t(b) : uint64_t(b) - uint64_t(a));
+RMGR_FIB_BENCH(__m256i, uint64_t, _mm256_absdiff_epu64, 0, _mm256_absdiff_epu64(a,b), (a > b) ? a - b : b - a);
+
+
+//=================================================================================================
+// Averages
+
+RMGR_FIB_BENCH(__m256i, int8_t,   _mm256_avg_epi8,        0, _mm256_avg_epi8(a,b),        (int16_t(a) + b + 1) >> 1);
+RMGR_FIB_BENCH(__m256i, uint8_t,  _mm256_avg_floor_epu8,  0, _mm256_avg_floor_epu8(a,b),  (uint16_t(a) + b) >> 1);
+RMGR_FIB_BENCH(__m256i, int16_t,  _mm256_avg_epi16,       0, _mm256_avg_epi16(a,b),       (int32_t(a) + b + 1) >> 1);
+RMGR_FIB_BENCH(__m256i, int16_t,  _mm256_avg_floor_epi16, 0, _mm256_avg_floor_epi16(a,b), (int32_t(a) + b) >> 1);
+RMGR_FIB_BENCH(__m256i, uint32_t, _mm256_avg_epu32,       0, _mm256_avg_epu32(a,b),       (uint64_t(a) + b + 1) >> 1);
+RMGR_FIB_BENCH(__m256i, int64_t,  _mm256_avg_epi64,       0, _mm256_avg_epi64(a,b),       (a >> 1) + (b >> 1) + ((a | b) & 1));
+RMGR_FIB_BENCH(__m256i, uint64_t, _mm256_avg_floor_epu64, 0, _mm256_avg_floor_epu64(a,b), (a >> 1) + (b >> 1) + (a & b & 1));
+
+
+//=================================================================================================
+// Multiplication
+
+RMGR_FIB_BENCH(__m256i, uint64_t, _mm256_mullo_epi64, INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_mullo_epi64(a,b), a * b);
+RMGR_FIB_BENCH(__m256i, uint64_t, _mm256_mulhi_epu64, 0,                                                              _mm256_mulhi_epu64(a,b), mulhi(a,b));
+RMGR_FIB_BENCH(__m256i, int64_t,  _mm256_mulhi_epi64, 0,                                                              _mm256_mulhi_epi64(a,b), mulhi(a,b));
+
+
+//=================================================================================================
+// Population count
+
+RMGR_FIB_BENCH(__m256i, uint8_t,  _mm256_popcnt_epi8,  INTERNAL_RMGR_FIB_USE_AVX512BITALG && INTERNAL_RMGR_FIB_USE_AVX512VL,    _mm256_popcnt_epi8(a),  popcnt(a));
+RMGR_FIB_BENCH(__m256i, uint64_t, _mm256_popcnt_epi64, INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_popcnt_epi64(a), popcnt(a));
+
+
+//=================================================================================================
+// Leading & trailing zero counts
+
+RMGR_FIB_BENCH(__m256i, uint8_t,  _mm256_lzcnt_epi8,  0,                                                              _mm256_lzcnt_epi8(a),  lzcnt(a));
+RMGR_FIB_BENCH(__m256i, uint32_t, _mm256_lzcnt_epi32, INTERNAL_RMGR_FIB_USE_AVX512CD && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm256_lzcnt_epi32(a), lzcnt(a));
+RMGR_FIB_BENCH(__m256i, uint64_t, _mm256_tzcnt_epi64, 0,                                                              _mm256_tzcnt_epi64(a), tzcnt(a));
+
+#endif // INTERNAL_RMGR_FIB_USE_AVX2
+
+
+} // namespace
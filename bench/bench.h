@@ -0,0 +1,580 @@
+/*
+ * Copyright (c) 2022, Romain Bailly
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef RMGR_FIB_BENCH_H
+#define RMGR_FIB_BENCH_H
+
+#include <rmgr/fib/sse.h>
+#include <rmgr/fib/dispatch.h>
+#include <cfloat>
+#include <cstddef>
+#include <cstring>
+#if RMGR_COMPILER_IS_MSVC
+    #include <intrin.h>
+#endif
+
+
+#define RMGR_FIB_BENCH_STRINGIFY(x)     RMGR_FIB_BENCH_DO_STRINGIFY(x)
+#define RMGR_FIB_BENCH_DO_STRINGIFY(x)  #x
+
+
+namespace rmgr { namespace fib { namespace bench {
+
+
+//=================================================================================================
+// Registry
+
+/**
+ * @brief Measures an operation
+ * @return The best observed number of cycles per operation
+ */
+typedef double (*Measurement)();
+
+struct Benchmark
+{
+    const char* intrinsic;          ///< Name of the benchmarked intrinsic
+    const char* instructionSet;     ///< Instruction set the benchmark was compiled for
+    unsigned    instructionSetRank; ///< Position of the instruction set in `RMGR_FIB_IS_LIST`
+    const char* implementation;     ///< Either "native", "emulated", "vec" or "scalar"
+    Measurement latency;            ///< Measures a chain of dependent operations
+    Measurement throughput;         ///< Measures independent streams of operations
+    uint32_t    requiredFeatures;   ///< CPU features the benchmark was compiled for, see `cpu_supports()`
+};
+
+void register_benchmark(const Benchmark& benchmark);
+
+
+//=================================================================================================
+// Measurement primitives
+
+const unsigned ITERATIONS  = 4096; ///< Number of operations per stream and per repetition
+const unsigned REPETITIONS = 7;    ///< The best repetition is the one retained
+const unsigned STREAMS     = 8;    ///< Number of independent streams when measuring throughput
+
+/**
+ * @brief Reads the time-stamp counter
+ *
+ * Note that the TSC ticks at a constant reference frequency which may differ from the actual core
+ * frequency (turbo, power saving), so results are best compared with frequency scaling disabled.
+ */
+static RMGR_FORCEINLINE uint64_t timestamp() RMGR_NOEXCEPT
+{
+    _mm_lfence();
+#if RMGR_COMPILER_IS_MSVC
+    const uint64_t t = __rdtsc();
+#else
+    const uint64_t t = __builtin_ia32_rdtsc();
+#endif
+    _mm_lfence();
+    return t;
+}
+
+
+/**
+ * @brief Prevents the compiler from reasoning about a value
+ *
+ * This keeps it from folding successive operations together, hoisting them out of loops or
+ * auto-vectorizing the scalar baselines.
+ */
+#if RMGR_COMPILER_IS_GCC_OR_CLANG
+    template<typename T>
+    static RMGR_FORCEINLINE void opaque(T& value) RMGR_NOEXCEPT
+    {
+        __asm__ volatile("" : "+m"(value));
+    }
+
+    static RMGR_FORCEINLINE void opaque(__m128i&  value) RMGR_NOEXCEPT { __asm__ volatile("" : "+x"(value)); }
+    static RMGR_FORCEINLINE void opaque(__m128&   value) RMGR_NOEXCEPT { __asm__ volatile("" : "+x"(value)); }
+    static RMGR_FORCEINLINE void opaque(__m128d&  value) RMGR_NOEXCEPT { __asm__ volatile("" : "+x"(value)); }
+    #if INTERNAL_RMGR_FIB_USE_AVX
+        static RMGR_FORCEINLINE void opaque(__m256i& value) RMGR_NOEXCEPT { __asm__ volatile("" : "+x"(value)); }
+        static RMGR_FORCEINLINE void opaque(__m256&  value) RMGR_NOEXCEPT { __asm__ volatile("" : "+x"(value)); }
+        static RMGR_FORCEINLINE void opaque(__m256d& value) RMGR_NOEXCEPT { __asm__ volatile("" : "+x"(value)); }
+    #endif
+    static RMGR_FORCEINLINE void opaque(float&    value) RMGR_NOEXCEPT { __asm__ volatile("" : "+x"(value)); }
+    static RMGR_FORCEINLINE void opaque(double&   value) RMGR_NOEXCEPT { __asm__ volatile("" : "+x"(value)); }
+    static RMGR_FORCEINLINE void opaque(int8_t&   value) RMGR_NOEXCEPT { __asm__ volatile("" : "+q"(value)); }
+    static RMGR_FORCEINLINE void opaque(uint8_t&  value) RMGR_NOEXCEPT { __asm__ volatile("" : "+q"(value)); }
+    static RMGR_FORCEINLINE void opaque(int16_t&  value) RMGR_NOEXCEPT { __asm__ volatile("" : "+r"(value)); }
+    static RMGR_FORCEINLINE void opaque(uint16_t& value) RMGR_NOEXCEPT { __asm__ volatile("" : "+r"(value)); }
+    static RMGR_FORCEINLINE void opaque(int32_t&  value) RMGR_NOEXCEPT { __asm__ volatile("" : "+r"(value)); }
+    static RMGR_FORCEINLINE void opaque(uint32_t& value) RMGR_NOEXCEPT { __asm__ volatile("" : "+r"(value)); }
+    #if RMGR_ARCH_IS_X86_64
+        static RMGR_FORCEINLINE void opaque(int64_t&  value) RMGR_NOEXCEPT { __asm__ volatile("" : "+r"(value)); }
+        static RMGR_FORCEINLINE void opaque(uint64_t& value) RMGR_NOEXCEPT { __asm__ volatile("" : "+r"(value)); }
+    #endif
+#else
+    // Visual C++ has neither inline assembly on x64 nor a register-level optimization barrier, so
+    // the value makes a round-trip through memory the compiler cannot see the origin of instead
+    template<typename T>
+    static RMGR_FORCEINLINE void opaque(T& value) RMGR_NOEXCEPT
+    {
+        T* volatile address = &value;
+        _ReadWriteBarrier();
+        value = *address;
+        _ReadWriteBarrier();
+    }
+#endif
+
+
+/// Loads a vector from memory, whatever its type
+static RMGR_FORCEINLINE void load(__m128i& v, const void* p) RMGR_NOEXCEPT { v = _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+static RMGR_FORCEINLINE void load(__m128&  v, const void* p) RMGR_NOEXCEPT { v = _mm_loadu_ps(static_cast<const float*>(p)); }
+static RMGR_FORCEINLINE void load(__m128d& v, const void* p) RMGR_NOEXCEPT { v = _mm_loadu_pd(static_cast<const double*>(p)); }
+#if INTERNAL_RMGR_FIB_USE_AVX
+static RMGR_FORCEINLINE void load(__m256i& v, const void* p) RMGR_NOEXCEPT { v = _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+static RMGR_FORCEINLINE void load(__m256&  v, const void* p) RMGR_NOEXCEPT { v = _mm256_loadu_ps(static_cast<const float*>(p)); }
+static RMGR_FORCEINLINE void load(__m256d& v, const void* p) RMGR_NOEXCEPT { v = _mm256_loadu_pd(static_cast<const double*>(p)); }
+#endif
+
+
+/**
+ * @brief Arbitrary but reproducible input data, large enough for any vector type
+ *
+ * All bytes lie within [0x3C,0x43] so that, whatever the offset, floating-point lanes are normal
+ * numbers of moderate magnitude (denormals would skew the timings).
+ */
+extern const uint8_t g_seedA[64];
+extern const uint8_t g_seedB[64];
+
+/// Prevents the results of the measured operations from being optimized out
+void consume(const void* data, size_t size);
+
+
+/// The lanes of a vector, for the scalar baselines
+template<typename Scalar, size_t Length>
+struct Lanes
+{
+    static const size_t LENGTH = Length;
+    Scalar values[Length];
+};
+
+
+/**
+ * @brief Generic latency and throughput measurements
+ *
+ * `Op` must provide:
+ *  - `vector_type` and `scalar_type`
+ *  - `static vector_type vector(const vector_type& a, const vector_type& b)`
+ *  - `static scalar_type scalar(scalar_type a, scalar_type b)`
+ */
+template<typename Op>
+struct Measure
+{
+    typedef typename Op::vector_type        Vector;
+    typedef typename Op::scalar_type        Scalar;
+    typedef Lanes<Scalar, sizeof(Vector) / sizeof(Scalar)> ScalarLanes;
+
+    static double vector_latency()
+    {
+        // The results are copied before being consumed so that the working variables are not
+        // forced to live in memory
+        Vector a, b;
+        load(a, g_seedA);
+        load(b, g_seedB);
+        double best = DBL_MAX;
+        for (unsigned r=0; r<REPETITIONS; ++r)
+        {
+            const uint64_t start = timestamp();
+            for (unsigned i=0; i<ITERATIONS; ++i)
+            {
+                a = Op::vector(a, b);
+                opaque(a);
+            }
+            const uint64_t end = timestamp();
+            best = min(best, double(end - start) / ITERATIONS);
+        }
+        const Vector result = a;
+        consume(&result, sizeof(result));
+        return best;
+    }
+
+    static double vector_throughput()
+    {
+        // Spelled out rather than stored in an array so that all streams stay in registers
+        RMGR_STATIC_ASSERT(STREAMS == 8);
+        Vector a0, a1, a2, a3, a4, a5, a6, a7, b;
+        load(a0, g_seedA + 0);
+        load(a1, g_seedA + 1);
+        load(a2, g_seedA + 2);
+        load(a3, g_seedA + 3);
+        load(a4, g_seedA + 4);
+        load(a5, g_seedA + 5);
+        load(a6, g_seedA + 6);
+        load(a7, g_seedA + 7);
+        load(b,  g_seedB);
+        double best = DBL_MAX;
+        for (unsigned r=0; r<REPETITIONS; ++r)
+        {
+            const uint64_t start = timestamp();
+            for (unsigned i=0; i<ITERATIONS; ++i)
+            {
+                a0 = Op::vector(a0, b);
+                a1 = Op::vector(a1, b);
+                a2 = Op::vector(a2, b);
+                a3 = Op::vector(a3, b);
+                a4 = Op::vector(a4, b);
+                a5 = Op::vector(a5, b);
+                a6 = Op::vector(a6, b);
+                a7 = Op::vector(a7, b);
+                opaque(a0); opaque(a1); opaque(a2); opaque(a3);
+                opaque(a4); opaque(a5); opaque(a6); opaque(a7);
+            }
+            const uint64_t end = timestamp();
+            best = min(best, double(end - start) / (ITERATIONS * STREAMS));
+        }
+        const Vector results[STREAMS] = {a0, a1, a2, a3, a4, a5, a6, a7};
+        consume(results, sizeof(results));
+        return best;
+    }
+
+    static double scalar_latency()
+    {
+        ScalarLanes a, b;
+        init(a, g_seedA);
+        init(b, g_seedB);
+        double best = DBL_MAX;
+        for (unsigned r=0; r<REPETITIONS; ++r)
+        {
+            const uint64_t start = timestamp();
+            for (unsigned i=0; i<ITERATIONS; ++i)
+                apply(a, b);
+            const uint64_t end = timestamp();
+            best = min(best, double(end - start) / ITERATIONS);
+        }
+        consume(&a, sizeof(a));
+        return best;
+    }
+
+    static double scalar_throughput()
+    {
+        ScalarLanes a[STREAMS], b;
+        for (unsigned s=0; s<STREAMS; ++s)
+            init(a[s], g_seedA + s);
+        init(b, g_seedB);
+        double best = DBL_MAX;
+        for (unsigned r=0; r<REPETITIONS; ++r)
+        {
+            const uint64_t start = timestamp();
+            for (unsigned i=0; i<ITERATIONS; ++i)
+                for (unsigned s=0; s<STREAMS; ++s)
+                    apply(a[s], b);
+            const uint64_t end = timestamp();
+            best = min(best, double(end - start) / (ITERATIONS * STREAMS));
+        }
+        consume(a, sizeof(a));
+        return best;
+    }
+
+private:
+
+    static double min(double a, double b)
+    {
+        return (a < b) ? a : b;
+    }
+
+    static void init(ScalarLanes& lanes, const uint8_t* seed)
+    {
+        memcpy(lanes.values, seed, sizeof(lanes.values));
+    }
+
+    static RMGR_FORCEINLINE void apply(ScalarLanes& a, const ScalarLanes& b)
+    {
+        for (size_t l=0; l<ScalarLanes::LENGTH; ++l)
+        {
+            Scalar r = Op::scalar(a.values[l], b.values[l]);
+            opaque(r);
+            a.values[l] = r;
+        }
+    }
+};
+
+
+/// Registers the vector and scalar measurements of an operation
+template<typename Op>
+struct Registrar
+{
+    Registrar(const char* intrinsic, const char* instructionSet, unsigned instructionSetRank, bool native, uint32_t requiredFeatures)
+    {
+        const Benchmark vector = {intrinsic, instructionSet, instructionSetRank, native ? "native" : "emulated",
+                                  &Measure<Op>::vector_latency, &Measure<Op>::vector_throughput, requiredFeatures};
+        const Benchmark scalar = {intrinsic, instructionSet, instructionSetRank, "scalar",
+                                  &Measure<Op>::scalar_latency, &Measure<Op>::scalar_throughput, requiredFeatures};
+        register_benchmark(vector);
+        register_benchmark(scalar);
+    }
+};
+
+
+/// Registers the measurements of an operation written with `vec<T, N>`, to be compared with the raw intrinsic
+template<typename Op>
+struct VecRegistrar
+{
+    VecRegistrar(const char* intrinsic, const char* instructionSet, unsigned instructionSetRank, uint32_t requiredFeatures)
+    {
+        const Benchmark vector = {intrinsic, instructionSet, instructionSetRank, "vec",
+                                  &Measure<Op>::vector_latency, &Measure<Op>::vector_throughput, requiredFeatures};
+        register_benchmark(vector);
+    }
+};
+
+
+/**
+ * @brief Adapts a horizontal reduction to `Measure`
+ *
+ * The result is folded back into the vector so that successive reductions form a dependency chain.
+ * With `Loop`, the reduction is the naive store and extract loop instead of the intrinsic.
+ */
+template<typename Reduce, bool Loop>
+struct ReduceOp
+{
+    typedef __m128i                       vector_type;
+    typedef typename Reduce::scalar_type  scalar_type;
+
+    static RMGR_FORCEINLINE __m128i vector(const __m128i& a, const __m128i&) RMGR_NOEXCEPT
+    {
+        const scalar_type r = Loop ? loop(a) : Reduce::vector(a);
+        return _mm_xor_si128(a, _mm_cvtsi32_si128(int32_t(r)));
+    }
+
+private:
+
+    static RMGR_FORCEINLINE scalar_type loop(const __m128i& a) RMGR_NOEXCEPT
+    {
+        scalar_type lanes[sizeof(__m128i) / sizeof(scalar_type)];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), a);
+        scalar_type r = lanes[0];
+        for (size_t l=1; l<sizeof(lanes)/sizeof(lanes[0]); ++l)
+        {
+            scalar_type lane = lanes[l];
+            opaque(lane);
+            r = Reduce::scalar(r, lane);
+        }
+        return r;
+    }
+};
+
+
+/// Registers the measurements of a horizontal reduction and of the equivalent extract loop
+template<typename Reduce>
+struct ReduceRegistrar
+{
+    ReduceRegistrar(const char* intrinsic, const char* instructionSet, unsigned instructionSetRank, bool native, uint32_t requiredFeatures)
+    {
+        const Benchmark vector = {intrinsic, instructionSet, instructionSetRank, native ? "native" : "emulated",
+                                  &Measure<ReduceOp<Reduce, false> >::vector_latency,
+                                  &Measure<ReduceOp<Reduce, false> >::vector_throughput, requiredFeatures};
+        const Benchmark scalar = {intrinsic, instructionSet, instructionSetRank, "scalar",
+                                  &Measure<ReduceOp<Reduce, true> >::vector_latency,
+                                  &Measure<ReduceOp<Reduce, true> >::vector_throughput, requiredFeatures};
+        register_benchmark(vector);
+        register_benchmark(scalar);
+    }
+};
+
+
+//=================================================================================================
+// Bulk routines
+
+const size_t BULK_SMALL = 256;       ///< Size of the small buffer, in bytes
+const size_t BULK_LARGE = 64 * 1024; ///< Size of the large buffer, in bytes, small enough to stay in L2
+
+/**
+ * @brief Measures a routine processing a whole buffer
+ *
+ * Figures are in cycles per 16 bytes, to be comparable with those of a single 128-bit operation.
+ * The "latency" is measured over a small buffer, where the call overhead and the handling of the
+ * tail weigh, and the "throughput" over a large one.
+ *
+ * `Bulk` must provide `static uint64_t vector(const void* data, size_t size)` and `scalar()` alike.
+ */
+template<typename Bulk, bool Scalar>
+struct MeasureBulk
+{
+    static double small()
+    {
+        return run(BULK_SMALL);
+    }
+
+    static double large()
+    {
+        return run(BULK_LARGE);
+    }
+
+private:
+
+    static double run(size_t size)
+    {
+        static uint8_t buffer[BULK_LARGE];
+        for (size_t i=0; i<BULK_LARGE; ++i)
+            buffer[i] = uint8_t(g_seedA[i % sizeof(g_seedA)] ^ g_seedB[(i / sizeof(g_seedA)) % sizeof(g_seedB)]);
+
+        // The same amount of data is processed whatever the size of the buffer
+        const size_t calls = 4 * BULK_LARGE / size;
+        uint64_t     sink  = 0;
+        double       best  = DBL_MAX;
+        for (unsigned r=0; r<REPETITIONS; ++r)
+        {
+            const uint64_t start = timestamp();
+            for (size_t c=0; c<calls; ++c)
+            {
+                const uint8_t* data = buffer;
+                opaque(data); // Keeps the compiler from hoisting the call out of the loop
+                sink += Scalar ? Bulk::scalar(data, size) : Bulk::vector(data, size);
+                opaque(sink);
+            }
+            const uint64_t end = timestamp();
+            const double   cycles = double(end - start) * 16 / (double(calls) * double(size));
+            best = (cycles < best) ? cycles : best;
+        }
+        consume(&sink, sizeof(sink));
+        return best;
+    }
+};
+
+
+/// Registers the measurements of a bulk routine and of its scalar equivalent
+template<typename Bulk>
+struct BulkRegistrar
+{
+    BulkRegistrar(const char* name, const char* instructionSet, unsigned instructionSetRank, bool native, uint32_t requiredFeatures)
+    {
+        const Benchmark vector = {name, instructionSet, instructionSetRank, native ? "native" : "emulated",
+                                  &MeasureBulk<Bulk, false>::small, &MeasureBulk<Bulk, false>::large, requiredFeatures};
+        const Benchmark scalar = {name, instructionSet, instructionSetRank, "scalar",
+                                  &MeasureBulk<Bulk, true>::small,  &MeasureBulk<Bulk, true>::large,  requiredFeatures};
+        register_benchmark(vector);
+        register_benchmark(scalar);
+    }
+};
+
+
+}}} // namespace rmgr::fib::bench
+
+
+/**
+ * @brief Declares the benchmark of an intrinsic
+ *
+ * @param Vector      The vector type
+ * @param Scalar      The lane type
+ * @param intrinsic   The name of the intrinsic
+ * @param native      Whether the intrinsic is natively supported by the current instruction set
+ * @param vectorExpr  The vector operation, as an expression of `a` and `b`
+ * @param scalarExpr  The equivalent scalar operation on one lane, as an expression of `a` and `b`
+ */
+#define RMGR_FIB_BENCH(Vector, Scalar, intrinsic, native, vectorExpr, scalarExpr)                   \
+    struct intrinsic##_bench                                                                      \
+    {                                                                                             \
+        typedef Vector vector_type;                                                               \
+        typedef Scalar scalar_type;                                                               \
+        static RMGR_FORCEINLINE Vector vector(const Vector& a, const Vector& b) RMGR_NOEXCEPT     \
+        {                                                                                         \
+            (void)b;                                                                              \
+            return (vectorExpr);                                                                  \
+        }                                                                                         \
+        static RMGR_FORCEINLINE Scalar scalar(Scalar a, Scalar b) RMGR_NOEXCEPT                   \
+        {                                                                                         \
+            (void)b;                                                                              \
+            return Scalar(scalarExpr);                                                            \
+        }                                                                                         \
+    };                                                                                            \
+    static const rmgr::fib::bench::Registrar<intrinsic##_bench> intrinsic##_registrar(            \
+        #intrinsic, RMGR_FIB_BENCH_STRINGIFY(IS), IS_RANK, (native), RMGR_FIB_REQUIRED_CPU_FEATURES)
+
+
+/**
+ * @brief Declares the benchmark of the `vec<T, N>` equivalent of an intrinsic
+ *
+ * Reported next to the intrinsic with the "vec" implementation: both should perform the same.
+ *
+ * @param Vector     The vector type
+ * @param Scalar     The lane type
+ * @param intrinsic  The name of the intrinsic
+ * @param vecExpr    The equivalent operation, as an expression of the `vec<Scalar, N>` `a` and `b`
+ */
+#define RMGR_FIB_BENCH_VEC(Vector, Scalar, intrinsic, vecExpr)                                    \
+    struct intrinsic##_vec_bench                                                                  \
+    {                                                                                             \
+        typedef Vector vector_type;                                                               \
+        typedef Scalar scalar_type;                                                               \
+        typedef rmgr::fib::vec<Scalar, sizeof(Vector) / sizeof(Scalar)> vec_type;                 \
+        static RMGR_FORCEINLINE Vector vector(const Vector& va, const Vector& vb) RMGR_NOEXCEPT   \
+        {                                                                                         \
+            const vec_type a(va), b(vb);                                                          \
+            (void)b;                                                                              \
+            return Vector(vecExpr);                                                               \
+        }                                                                                         \
+    };                                                                                            \
+    static const rmgr::fib::bench::VecRegistrar<intrinsic##_vec_bench> intrinsic##_vec_registrar( \
+        #intrinsic, RMGR_FIB_BENCH_STRINGIFY(IS), IS_RANK, RMGR_FIB_REQUIRED_CPU_FEATURES)
+
+
+/**
+ * @brief Declares the benchmark of a horizontal reduction of a `__m128i`
+ *
+ * Its "scalar" implementation is the loop extracting the lanes one by one.
+ *
+ * @param Scalar      The lane type, also the type of the result
+ * @param intrinsic   The name of the intrinsic
+ * @param native      Whether the intrinsic is natively supported by the current instruction set
+ * @param scalarExpr  The operation combining two lanes, as an expression of `a` and `b`
+ */
+#define RMGR_FIB_BENCH_REDUCE(Scalar, intrinsic, native, scalarExpr)                              \
+    struct intrinsic##_bench                                                                      \
+    {                                                                                             \
+        typedef Scalar scalar_type;                                                               \
+        static RMGR_FORCEINLINE Scalar vector(const __m128i& a) RMGR_NOEXCEPT                     \
+        {                                                                                         \
+            return intrinsic(a);                                                                  \
+        }                                                                                         \
+        static RMGR_FORCEINLINE Scalar scalar(Scalar a, Scalar b) RMGR_NOEXCEPT                   \
+        {                                                                                         \
+            return Scalar(scalarExpr);                                                            \
+        }                                                                                         \
+    };                                                                                            \
+    static const rmgr::fib::bench::ReduceRegistrar<intrinsic##_bench> intrinsic##_registrar(      \
+        #intrinsic, RMGR_FIB_BENCH_STRINGIFY(IS), IS_RANK, (native), RMGR_FIB_REQUIRED_CPU_FEATURES)
+
+
+/**
+ * @brief Declares the benchmark of a bulk routine of `algorithm.h`
+ *
+ * @param name        The name of the routine
+ * @param native      Whether the routine relies on instructions doing all the work natively
+ * @param vectorExpr  The call to the routine, as an expression of `data` and `size`
+ * @param scalarExpr  The equivalent scalar loop, as an expression of `data` and `size`
+ */
+#define RMGR_FIB_BENCH_BULK(name, native, vectorExpr, scalarExpr)                                 \
+    struct name##_bulk_bench                                                                      \
+    {                                                                                             \
+        static RMGR_FORCEINLINE uint64_t vector(const void* data, size_t size) RMGR_NOEXCEPT       \
+        {                                                                                         \
+            return uint64_t(vectorExpr);                                                          \
+        }                                                                                         \
+        static RMGR_FORCEINLINE uint64_t scalar(const void* data, size_t size) RMGR_NOEXCEPT       \
+        {                                                                                         \
+            return uint64_t(scalarExpr);                                                          \
+        }                                                                                         \
+    };                                                                                            \
+    static const rmgr::fib::bench::BulkRegistrar<name##_bulk_bench> name##_bulk_registrar(        \
+        #name, RMGR_FIB_BENCH_STRINGIFY(IS), IS_RANK, (native), RMGR_FIB_REQUIRED_CPU_FEATURES)
+
+
+#endif // RMGR_FIB_BENCH_H
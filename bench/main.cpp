@@ -0,0 +1,128 @@
+#include "bench.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+
+namespace rmgr { namespace fib { namespace bench {
+
+
+const uint8_t g_seedA[64] =
+{
+    0x3F,0x41,0x3C,0x42,0x40,0x3D,0x43,0x3E, 0x41,0x3F,0x42,0x3C,0x3D,0x40,0x3E,0x43,
+    0x40,0x42,0x3E,0x3C,0x43,0x41,0x3F,0x3D, 0x3C,0x43,0x41,0x40,0x3E,0x3F,0x3D,0x42,
+    0x42,0x3E,0x40,0x41,0x3F,0x43,0x3C,0x3D, 0x3E,0x3C,0x43,0x3F,0x42,0x3D,0x41,0x40,
+    0x3D,0x40,0x3F,0x43,0x3C,0x3E,0x42,0x41, 0x43,0x3D,0x3C,0x3E,0x41,0x42,0x40,0x3F,
+};
+
+const uint8_t g_seedB[64] =
+{
+    0x41,0x3D,0x43,0x3F,0x3C,0x42,0x3E,0x40, 0x3E,0x42,0x3D,0x41,0x43,0x3C,0x40,0x3F,
+    0x3C,0x3F,0x41,0x43,0x3E,0x40,0x42,0x3D, 0x43,0x40,0x3E,0x3D,0x3F,0x41,0x3C,0x42,
+    0x3F,0x43,0x42,0x3C,0x40,0x3E,0x3D,0x41, 0x40,0x41,0x3C,0x42,0x3D,0x3F,0x43,0x3E,
+    0x42,0x3C,0x40,0x3E,0x41,0x43,0x3F,0x3D, 0x3D,0x3E,0x3F,0x40,0x43,0x3C,0x41,0x42,
+};
+
+
+static volatile uint8_t g_sink;
+
+void consume(const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint8_t acc = 0;
+    for (size_t i=0; i<size; ++i)
+        acc ^= bytes[i];
+    g_sink = acc;
+}
+
+
+static std::vector<Benchmark>& registry()
+{
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+void register_benchmark(const Benchmark& benchmark)
+{
+    registry().push_back(benchmark);
+}
+
+
+/// Sorts benchmarks so that the output can be diffed across runs and compilers
+static bool operator<(const Benchmark& a, const Benchmark& b)
+{
+    if (const int c = strcmp(a.intrinsic, b.intrinsic))
+        return (c < 0);
+    if (a.instructionSetRank != b.instructionSetRank)
+        return (a.instructionSetRank < b.instructionSetRank);
+    return (strcmp(a.implementation, b.implementation) < 0);
+}
+
+
+}}} // namespace rmgr::fib::bench
+
+
+static void print_usage(const char* program)
+{
+    fprintf(stderr, "Usage: %s [--csv|--json] [--filter <substring>]\n", program);
+}
+
+
+extern "C" int main(int argc, char** argv)
+{
+    using namespace rmgr::fib::bench;
+
+    bool        json   = false;
+    const char* filter = NULL;
+    for (int i=1; i<argc; ++i)
+    {
+        if (strcmp(argv[i], "--csv") == 0)
+            json = false;
+        else if (strcmp(argv[i], "--json") == 0)
+            json = true;
+        else if (strcmp(argv[i], "--filter") == 0 && i+1 < argc)
+            filter = argv[++i];
+        else
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<Benchmark>& benchmarks = registry();
+    std::stable_sort(benchmarks.begin(), benchmarks.end());
+
+    if (json)
+        printf("[\n");
+    else
+        printf("intrinsic,instruction_set,implementation,latency,throughput\n");
+
+    bool first = true;
+    for (size_t i=0; i<benchmarks.size(); ++i)
+    {
+        const Benchmark& b = benchmarks[i];
+        if (filter && !strstr(b.intrinsic, filter))
+            continue;
+        if (!rmgr::fib::cpu_supports(b.requiredFeatures))
+            continue; // Would die of an illegal instruction
+
+        const double latency    = b.latency();
+        const double throughput = b.throughput();
+        if (json)
+        {
+            printf("%s  {\"intrinsic\": \"%s\", \"instruction_set\": \"%s\", \"implementation\": \"%s\", \"latency\": %.2f, \"throughput\": %.2f}",
+                   first ? "" : ",\n", b.intrinsic, b.instructionSet, b.implementation, latency, throughput);
+        }
+        else
+        {
+            printf("%s,%s,%s,%.2f,%.2f\n", b.intrinsic, b.instructionSet, b.implementation, latency, throughput);
+        }
+        fflush(stdout);
+        first = false;
+    }
+
+    if (json)
+        printf("\n]\n");
+    return 0;
+}
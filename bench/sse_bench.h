@@ -0,0 +1,515 @@
+#include "bench.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+
+namespace {
+
+
+/// Scalar equivalent of a comparison lane
+template<typename T>
+static RMGR_FORCEINLINE T mask(bool b) RMGR_NOEXCEPT
+{
+    return b ? T(~T(0)) : T(0);
+}
+
+template<typename T>
+static RMGR_FORCEINLINE T min(T a, T b) RMGR_NOEXCEPT
+{
+    return (b < a) ? b : a;
+}
+
+template<typename T>
+static RMGR_FORCEINLINE T max(T a, T b) RMGR_NOEXCEPT
+{
+    return (a < b) ? b : a;
+}
+
+/// Scalar left rotate, by n modulo the width of T
+template<typename T>
+static RMGR_FORCEINLINE T rotl(T a, unsigned n) RMGR_NOEXCEPT
+{
+    const unsigned bits = 8 * sizeof(T);
+    n &= bits - 1;
+    return T((a << n) | (a >> ((bits - n) & (bits - 1))));
+}
+
+static RMGR_FORCEINLINE uint64_t mulhi(uint64_t a, uint64_t b) RMGR_NOEXCEPT
+{
+#if RMGR_COMPILER_IS_MSVC && RMGR_ARCH_IS_X86_64
+    return __umulh(a, b);
+#elif RMGR_COMPILER_IS_GCC_OR_CLANG && RMGR_ARCH_IS_X86_64
+    return uint64_t((unsigned __int128)(a) * b >> 64);
+#else
+    const uint64_t t = (a >> 32) * (b & 0xFFFFFFFFu) + (((a & 0xFFFFFFFFu) * (b & 0xFFFFFFFFu)) >> 32);
+    const uint64_t u = (a & 0xFFFFFFFFu) * (b >> 32) + (t & 0xFFFFFFFFu);
+    return (a >> 32) * (b >> 32) + (t >> 32) + (u >> 32);
+#endif
+}
+
+static RMGR_FORCEINLINE int64_t mulhi(int64_t a, int64_t b) RMGR_NOEXCEPT
+{
+#if RMGR_COMPILER_IS_MSVC && RMGR_ARCH_IS_X86_64
+    return __mulh(a, b);
+#elif RMGR_COMPILER_IS_GCC_OR_CLANG && RMGR_ARCH_IS_X86_64
+    return int64_t((__int128)(a) * b >> 64);
+#else
+    return int64_t(mulhi(uint64_t(a), uint64_t(b)) - (a < 0 ? uint64_t(b) : 0) - (b < 0 ? uint64_t(a) : 0));
+#endif
+}
+
+/// Scalar population count
+static RMGR_FORCEINLINE unsigned popcnt(uint64_t a) RMGR_NOEXCEPT
+{
+#if RMGR_COMPILER_IS_GCC_OR_CLANG
+    return unsigned(__builtin_popcountll(a));
+#else
+    a = a - ((a >> 1) & 0x5555555555555555ull);
+    a = (a & 0x3333333333333333ull) + ((a >> 2) & 0x3333333333333333ull);
+    return unsigned((((a + (a >> 4)) & 0x0F0F0F0F0F0F0F0Full) * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+/// Scalar leading and trailing zero counts
+template<typename T>
+static RMGR_FORCEINLINE T lzcnt(T a) RMGR_NOEXCEPT
+{
+    const unsigned bits = sizeof(T) * 8;
+#if RMGR_COMPILER_IS_GCC_OR_CLANG
+    return T(a ? __builtin_clzll(uint64_t(a) & (~uint64_t(0) >> (64 - bits))) - (64 - bits) : bits);
+#else
+    unsigned n = 0;
+    while (n < bits && !((a >> (bits - 1 - n)) & 1))
+        ++n;
+    return T(n);
+#endif
+}
+
+template<typename T>
+static RMGR_FORCEINLINE T tzcnt(T a) RMGR_NOEXCEPT
+{
+    const unsigned bits = sizeof(T) * 8;
+#if RMGR_COMPILER_IS_GCC_OR_CLANG
+    return T(a ? __builtin_ctzll(uint64_t(a)) : bits);
+#else
+    unsigned n = 0;
+    while (n < bits && !((a >> n) & 1))
+        ++n;
+    return T(n);
+#endif
+}
+
+/// Scalar saturated addition and subtraction
+template<typename T>
+static RMGR_FORCEINLINE T adds(T a, T b) RMGR_NOEXCEPT
+{
+    typedef std::numeric_limits<T> limits;
+    if (b > 0)
+        return (a > T(limits::max() - b)) ? limits::max() : T(a + b);
+    return (a < T(limits::min() - b)) ? limits::min() : T(a + b);
+}
+
+template<typename T>
+static RMGR_FORCEINLINE T subs(T a, T b) RMGR_NOEXCEPT
+{
+    typedef std::numeric_limits<T> limits;
+    if (b > 0)
+        return (a < T(limits::min() + b)) ? limits::min() : T(a - b);
+    return (a > T(limits::max() + b)) ? limits::max() : T(a - b);
+}
+
+/// Reinterprets the bits of a scalar as another type of the same size, for conversion lanes
+template<typename To, typename From>
+static RMGR_FORCEINLINE To reinterpret(From a) RMGR_NOEXCEPT
+{
+    To r;
+    memcpy(&r, &a, sizeof(r));
+    return r;
+}
+
+
+//=================================================================================================
+// Bitwise NOT and negation
+
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_not_si128, 0, _mm_not_si128(a), ~a);
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_neg_epi8,  0, _mm_neg_epi8(a),  -a);
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_neg_epi16, 0, _mm_neg_epi16(a), -a);
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_neg_epi32, 0, _mm_neg_epi32(a), -a);
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_neg_epi64, 0, _mm_neg_epi64(a), -a);
+RMGR_FIB_BENCH(__m128,  float,    _mm_neg_ps,    0, _mm_neg_ps(a),    -a);
+RMGR_FIB_BENCH(__m128d, double,   _mm_neg_pd,    0, _mm_neg_pd(a),    -a);
+
+
+//=================================================================================================
+// Ternary logic
+
+// Majority (0xE8) and bitwise select (0xCA), the third input being a + b
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_ternarylogic_epi32, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_ternarylogic_epi32(a, b, _mm_add_epi32(a,b), 0xE8), (a & b) | ((a + b) & (a | b)));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_ternarylogic_epi64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_ternarylogic_epi64(a, b, _mm_add_epi64(a,b), 0xCA), (a & b) | (~a & (a + b)));
+
+
+
+//=================================================================================================
+// Blends
+
+// Immediate blends are just a copy for a scalar lane, which comes from either a or b
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_blendv_epi8, INTERNAL_RMGR_FIB_USE_SSE41, _mm_blendv_epi8(a,b,a),  (a < 0) ? b : a);
+RMGR_FIB_BENCH(__m128,  float,    _mm_blendv_ps,   INTERNAL_RMGR_FIB_USE_SSE41, _mm_blendv_ps(a,b,a),    (a < 0) ? b : a);
+RMGR_FIB_BENCH(__m128d, double,   _mm_blendv_pd,   INTERNAL_RMGR_FIB_USE_SSE41, _mm_blendv_pd(a,b,a),    (a < 0) ? b : a);
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_blend_epi16, INTERNAL_RMGR_FIB_USE_SSE41, _mm_blend_epi16(a,b,0xAA), b);
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_blend_epi32, INTERNAL_RMGR_FIB_USE_AVX2,  _mm_blend_epi32(a,b,0xC),  b);
+RMGR_FIB_BENCH(__m128,  float,    _mm_blend_ps,    INTERNAL_RMGR_FIB_USE_SSE41, _mm_blend_ps(a,b,0x5),    b);
+RMGR_FIB_BENCH(__m128d, double,   _mm_blend_pd,    INTERNAL_RMGR_FIB_USE_SSE41, _mm_blend_pd(a,b,0x2),    b);
+
+
+//=================================================================================================
+// Comparisons
+
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_cmpneq_epi8,  0,                          _mm_cmpneq_epi8(a,b),  mask<int8_t>(a != b));
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_cmpge_epi8,   0,                          _mm_cmpge_epi8(a,b),   mask<int8_t>(a >= b));
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_cmple_epi8,   0,                          _mm_cmple_epi8(a,b),   mask<int8_t>(a <= b));
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_cmpgt_epu8,   0,                          _mm_cmpgt_epu8(a,b),   mask<uint8_t>(a > b));
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_cmpge_epu8,   0,                          _mm_cmpge_epu8(a,b),   mask<uint8_t>(a >= b));
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_cmplt_epu8,   0,                          _mm_cmplt_epu8(a,b),   mask<uint8_t>(a < b));
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_cmple_epu8,   0,                          _mm_cmple_epu8(a,b),   mask<uint8_t>(a <= b));
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_cmpneq_epi16, 0,                          _mm_cmpneq_epi16(a,b), mask<int16_t>(a != b));
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_cmpge_epi16,  0,                          _mm_cmpge_epi16(a,b),  mask<int16_t>(a >= b));
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_cmple_epi16,  0,                          _mm_cmple_epi16(a,b),  mask<int16_t>(a <= b));
+RMGR_FIB_BENCH(__m128i, uint16_t, _mm_cmpgt_epu16,  0,                          _mm_cmpgt_epu16(a,b),  mask<uint16_t>(a > b));
+RMGR_FIB_BENCH(__m128i, uint16_t, _mm_cmpge_epu16,  0,                          _mm_cmpge_epu16(a,b),  mask<uint16_t>(a >= b));
+RMGR_FIB_BENCH(__m128i, uint16_t, _mm_cmplt_epu16,  0,                          _mm_cmplt_epu16(a,b),  mask<uint16_t>(a < b));
+RMGR_FIB_BENCH(__m128i, uint16_t, _mm_cmple_epu16,  0,                          _mm_cmple_epu16(a,b),  mask<uint16_t>(a <= b));
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_cmpneq_epi32, 0,                          _mm_cmpneq_epi32(a,b), mask<int32_t>(a != b));
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_cmpge_epi32,  0,                          _mm_cmpge_epi32(a,b),  mask<int32_t>(a >= b));
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_cmple_epi32,  0,                          _mm_cmple_epi32(a,b),  mask<int32_t>(a <= b));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_cmpgt_epu32,  0,                          _mm_cmpgt_epu32(a,b),  mask<uint32_t>(a > b));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_cmpge_epu32,  0,                          _mm_cmpge_epu32(a,b),  mask<uint32_t>(a >= b));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_cmplt_epu32,  0,                          _mm_cmplt_epu32(a,b),  mask<uint32_t>(a < b));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_cmple_epu32,  0,                          _mm_cmple_epu32(a,b),  mask<uint32_t>(a <= b));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_cmpeq_epi64,  INTERNAL_RMGR_FIB_USE_SSE41, _mm_cmpeq_epi64(a,b),  mask<int64_t>(a == b));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_cmpneq_epi64, 0,                          _mm_cmpneq_epi64(a,b), mask<int64_t>(a != b));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_cmpgt_epi64,  INTERNAL_RMGR_FIB_USE_SSE42, _mm_cmpgt_epi64(a,b),  mask<int64_t>(a > b));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_cmpge_epi64,  0,                          _mm_cmpge_epi64(a,b),  mask<int64_t>(a >= b));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_cmplt_epi64,  0,                          _mm_cmplt_epi64(a,b),  mask<int64_t>(a < b));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_cmple_epi64,  0,                          _mm_cmple_epi64(a,b),  mask<int64_t>(a <= b));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_cmpgt_epu64,  0,                          _mm_cmpgt_epu64(a,b),  mask<uint64_t>(a > b));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_cmpge_epu64,  0,                          _mm_cmpge_epu64(a,b),  mask<uint64_t>(a >= b));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_cmplt_epu64,  0,                          _mm_cmplt_epu64(a,b),  mask<uint64_t>(a < b));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_cmple_epu64,  0,                          _mm_cmple_epu64(a,b),  mask<uint64_t>(a <= b));
+
+
+//=================================================================================================
+// Shifts
+
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_slli_epi8,  0,                             _mm_slli_epi8(a,3),                       a << 3);
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_srli_epi8,  0,                             _mm_srli_epi8(a,3),                       a >> 3);
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_srai_epi8,  0,                             _mm_srai_epi8(a,3),                       a >> 3);
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_sll_epi8,   0,                             _mm_sll_epi8(a,_mm_cvtsi32_si128(3)),     a << 3);
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_srl_epi8,   0,                             _mm_srl_epi8(a,_mm_cvtsi32_si128(3)),     a >> 3);
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_sra_epi8,   0,                             _mm_sra_epi8(a,_mm_cvtsi32_si128(3)),     a >> 3);
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_srai_epi64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_srai_epi64(a,13),                     a >> 13);
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_sra_epi64,  INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_sra_epi64(a,_mm_cvtsi32_si128(13)),   a >> 13);
+
+
+//=================================================================================================
+// Variable shifts
+
+#define RMGR_FIB_BENCH_BW_VL  (INTERNAL_RMGR_FIB_USE_AVX512BW && INTERNAL_RMGR_FIB_USE_AVX512VL)
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_sllv_epi8,  0,                              _mm_sllv_epi8(a,b),  b < 8  ? a << b : 0);
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_srlv_epi8,  0,                              _mm_srlv_epi8(a,b),  b < 8  ? a >> b : 0);
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_srav_epi8,  0,                              _mm_srav_epi8(a,b),  a >> min<uint8_t>(uint8_t(b), 7));
+RMGR_FIB_BENCH(__m128i, uint16_t, _mm_sllv_epi16, RMGR_FIB_BENCH_BW_VL,           _mm_sllv_epi16(a,b), b < 16 ? a << b : 0);
+RMGR_FIB_BENCH(__m128i, uint16_t, _mm_srlv_epi16, RMGR_FIB_BENCH_BW_VL,           _mm_srlv_epi16(a,b), b < 16 ? a >> b : 0);
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_srav_epi16, RMGR_FIB_BENCH_BW_VL,           _mm_srav_epi16(a,b), a >> min<uint16_t>(uint16_t(b), 15));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_sllv_epi32, INTERNAL_RMGR_FIB_USE_AVX2,     _mm_sllv_epi32(a,b), b < 32 ? a << b : 0);
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_srlv_epi32, INTERNAL_RMGR_FIB_USE_AVX2,     _mm_srlv_epi32(a,b), b < 32 ? a >> b : 0);
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_srav_epi32, INTERNAL_RMGR_FIB_USE_AVX2,     _mm_srav_epi32(a,b), a >> min<uint32_t>(uint32_t(b), 31));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_sllv_epi64, INTERNAL_RMGR_FIB_USE_AVX2,     _mm_sllv_epi64(a,b), b < 64 ? a << b : 0);
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_srlv_epi64, INTERNAL_RMGR_FIB_USE_AVX2,     _mm_srlv_epi64(a,b), b < 64 ? a >> b : 0);
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_srav_epi64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_srav_epi64(a,b), a >> min<uint64_t>(uint64_t(b), 63));
+#undef RMGR_FIB_BENCH_BW_VL
+
+
+//=================================================================================================
+// Rotates
+
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_rol_epi8,   0,                              _mm_rol_epi8(a,3),   rotl(a, 3));
+RMGR_FIB_BENCH(__m128i, uint16_t, _mm_rol_epi16,  0,                              _mm_rol_epi16(a,8),  rotl(a, 8));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_rol_epi32,  INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_rol_epi32(a,13), rotl(a, 13));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_ror_epi32,  INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_ror_epi32(a,8),  rotl(a, 24));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_rol_epi64,  INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_rol_epi64(a,13), rotl(a, 13));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_ror_epi64,  INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_ror_epi64(a,16), rotl(a, 48));
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_rolv_epi8,  0,                              _mm_rolv_epi8(a,b),  rotl(a, b));
+RMGR_FIB_BENCH(__m128i, uint16_t, _mm_rolv_epi16, 0,                              _mm_rolv_epi16(a,b), rotl(a, b));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_rolv_epi32, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_rolv_epi32(a,b), rotl(a, b));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_rolv_epi64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_rolv_epi64(a,b), rotl(a, unsigned(b)));
+
+
+//=================================================================================================
+// Min & max
+
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_min_epi8,  INTERNAL_RMGR_FIB_USE_SSE41,    _mm_min_epi8(a,b),  min(a,b));
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_max_epi8,  INTERNAL_RMGR_FIB_USE_SSE41,    _mm_max_epi8(a,b),  max(a,b));
+RMGR_FIB_BENCH(__m128i, uint16_t, _mm_min_epu16, INTERNAL_RMGR_FIB_USE_SSE41,    _mm_min_epu16(a,b), min(a,b));
+RMGR_FIB_BENCH(__m128i, uint16_t, _mm_max_epu16, INTERNAL_RMGR_FIB_USE_SSE41,    _mm_max_epu16(a,b), max(a,b));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_min_epu32, INTERNAL_RMGR_FIB_USE_SSE41,    _mm_min_epu32(a,b), min(a,b));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_max_epu32, INTERNAL_RMGR_FIB_USE_SSE41,    _mm_max_epu32(a,b), max(a,b));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_min_epi64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_min_epi64(a,b), min(a,b));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_max_epi64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_max_epi64(a,b), max(a,b));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_min_epu64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_min_epu64(a,b), min(a,b));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_max_epu64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_max_epu64(a,b), max(a,b));
+
+
+//=================================================================================================
+// Absolute value
+
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_abs_epi8,  INTERNAL_RMGR_FIB_USE_SSSE3,    _mm_abs_epi8(a),  (a < 0) ? -a : a);
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_abs_epi16, INTERNAL_RMGR_FIB_USE_SSSE3,    _mm_abs_epi16(a), (a < 0) ? -a : a);
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_abs_epi32, INTERNAL_RMGR_FIB_USE_SSSE3,    _mm_abs_epi32(a), (a < 0) ? -a : a);
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_abs_epi64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_abs_epi64(a), (a < 0) ? -a : a);
+RMGR_FIB_BENCH(__m128,  float,    _mm_abs_ps,    0,                             _mm_abs_ps(a),    std::fabs(a));
+RMGR_FIB_BENCH(__m128d, double,   _mm_abs_pd,    0,                             _mm_abs_pd(a),    std::fabs(a));
+
+
+//=================================================================================================
+// Absolute difference
+
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_absdiff_epi8,  0, _mm_absdiff_epi8(a,b),  (a > b) ? a - b : b - a);
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_absdiff_epu8,  0, _mm_absdiff_epu8(a,b),  (a > b) ? a - b : b - a);
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_absdiff_epi16, 0, _mm_absdiff_epi16(a,b), (a > b) ? a - b : b - a);
+RMGR_FIB_BENCH(__m128i, uint16_t, _mm_absdiff_epu16, 0, _mm_absdiff_epu16(a,b), (a > b) ? a - b : b - a);
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_absdiff_epi32, 0, _mm_absdiff_epi32(a,b), (a > b) ? uint32_t(a) - uint32_t(b) : uint32_t(b) - uint32_t(a));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_absdiff_epu32, 0, _mm_absdiff_epu32(a,b), (a > b) ? a - b : b - a);
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_absdiff_epi64, 0, _mm_absdiff_epi64(a,b), (a > b) ? uint64_t(a) - uint64_t(b) : uint64_t(b) - uint64_t(a));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_absdiff_epu64, 0, _mm_absdiff_epu64(a,b), (a > b) ? a - b : b - a);
+
+
+//=================================================================================================
+// Averages
+//
+// The scalar expressions widen, add, shift and narrow. So do the _widened rows, with vectors, for
+// comparison with the overflow-free identities.
+
+static RMGR_FORCEINLINE __m128i avg_widened_epi8(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i lo  = _mm_add_epi16(_mm_add_epi16(_mm_srai_epi16(_mm_unpacklo_epi8(a,a), 8), _mm_srai_epi16(_mm_unpacklo_epi8(b,b), 8)), one);
+    const __m128i hi  = _mm_add_epi16(_mm_add_epi16(_mm_srai_epi16(_mm_unpackhi_epi8(a,a), 8), _mm_srai_epi16(_mm_unpackhi_epi8(b,b), 8)), one);
+    return _mm_packs_epi16(_mm_srai_epi16(lo, 1), _mm_srai_epi16(hi, 1));
+}
+
+static RMGR_FORCEINLINE __m128i avg_widened_epi16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i lo  = _mm_add_epi32(_mm_add_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(a,a), 16), _mm_srai_epi32(_mm_unpacklo_epi16(b,b), 16)), one);
+    const __m128i hi  = _mm_add_epi32(_mm_add_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(a,a), 16), _mm_srai_epi32(_mm_unpackhi_epi16(b,b), 16)), one);
+    return _mm_packs_epi32(_mm_srai_epi32(lo, 1), _mm_srai_epi32(hi, 1));
+}
+
+static RMGR_FORCEINLINE __m128i avg_widened_epu32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one  = _mm_set1_epi64x(1);
+    const __m128i lo   = _mm_srli_epi64(_mm_add_epi64(_mm_add_epi64(_mm_unpacklo_epi32(a,zero), _mm_unpacklo_epi32(b,zero)), one), 1);
+    const __m128i hi   = _mm_srli_epi64(_mm_add_epi64(_mm_add_epi64(_mm_unpackhi_epi32(a,zero), _mm_unpackhi_epi32(b,zero)), one), 1);
+    return _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(2,0,2,0)));
+}
+
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_avg_epi8,          0, _mm_avg_epi8(a,b),          (int16_t(a) + b + 1) >> 1);
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_avg_epi8_widened,  0, avg_widened_epi8(a,b),      (int16_t(a) + b + 1) >> 1);
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_avg_floor_epi8,    0, _mm_avg_floor_epi8(a,b),    (int16_t(a) + b) >> 1);
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_avg_floor_epu8,    0, _mm_avg_floor_epu8(a,b),    (uint16_t(a) + b) >> 1);
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_avg_epi16,         0, _mm_avg_epi16(a,b),         (int32_t(a) + b + 1) >> 1);
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_avg_epi16_widened, 0, avg_widened_epi16(a,b),     (int32_t(a) + b + 1) >> 1);
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_avg_floor_epi16,   0, _mm_avg_floor_epi16(a,b),   (int32_t(a) + b) >> 1);
+RMGR_FIB_BENCH(__m128i, uint16_t, _mm_avg_floor_epu16,   0, _mm_avg_floor_epu16(a,b),   (uint32_t(a) + b) >> 1);
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_avg_epi32,         0, _mm_avg_epi32(a,b),         (int64_t(a) + b + 1) >> 1);
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_avg_floor_epi32,   0, _mm_avg_floor_epi32(a,b),   (int64_t(a) + b) >> 1);
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_avg_epu32,         0, _mm_avg_epu32(a,b),         (uint64_t(a) + b + 1) >> 1);
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_avg_epu32_widened, 0, avg_widened_epu32(a,b),     (uint64_t(a) + b + 1) >> 1);
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_avg_floor_epu32,   0, _mm_avg_floor_epu32(a,b),   (uint64_t(a) + b) >> 1);
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_avg_epi64,         0, _mm_avg_epi64(a,b),         (a >> 1) + (b >> 1) + ((a | b) & 1));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_avg_floor_epi64,   0, _mm_avg_floor_epi64(a,b),   (a >> 1) + (b >> 1) + (a & b & 1));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_avg_epu64,         0, _mm_avg_epu64(a,b),         (a >> 1) + (b >> 1) + ((a | b) & 1));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_avg_floor_epu64,   0, _mm_avg_floor_epu64(a,b),   (a >> 1) + (b >> 1) + (a & b & 1));
+
+
+
+
+//=================================================================================================
+// Multiplication
+
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_mullo_epi32, INTERNAL_RMGR_FIB_USE_SSE41,                                   _mm_mullo_epi32(a,b), a * b);
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_mulhi_epu32, 0,                                                              _mm_mulhi_epu32(a,b), (uint64_t(a) * b) >> 32);
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_mulhi_epi32, 0,                                                              _mm_mulhi_epi32(a,b), (int64_t(a) * b) >> 32);
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_mullo_epi64, INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_mullo_epi64(a,b), a * b);
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_mulhi_epu64, 0,                                                              _mm_mulhi_epu64(a,b), mulhi(a,b));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_mulhi_epi64, 0,                                                              _mm_mulhi_epi64(a,b), mulhi(a,b));
+
+
+
+//=================================================================================================
+// Saturated arithmetic
+
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_adds_epi32, 0, _mm_adds_epi32(a,b), adds(a,b));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_adds_epu32, 0, _mm_adds_epu32(a,b), adds(a,b));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_adds_epi64, 0, _mm_adds_epi64(a,b), adds(a,b));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_adds_epu64, 0, _mm_adds_epu64(a,b), adds(a,b));
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_subs_epi32, 0, _mm_subs_epi32(a,b), subs(a,b));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_subs_epu32, 0, _mm_subs_epu32(a,b), subs(a,b));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_subs_epi64, 0, _mm_subs_epi64(a,b), subs(a,b));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_subs_epu64, 0, _mm_subs_epu64(a,b), subs(a,b));
+
+
+
+//=================================================================================================
+// Horizontal reductions
+
+RMGR_FIB_BENCH_REDUCE(int8_t,   _mm_reduce_add_epi8,  0, a + b);
+RMGR_FIB_BENCH_REDUCE(int16_t,  _mm_reduce_add_epi16, 0, a + b);
+RMGR_FIB_BENCH_REDUCE(int32_t,  _mm_reduce_add_epi32, 0, a + b);
+RMGR_FIB_BENCH_REDUCE(int64_t,  _mm_reduce_add_epi64, 0, a + b);
+RMGR_FIB_BENCH_REDUCE(int8_t,   _mm_reduce_and_epi8,  0, a & b);
+RMGR_FIB_BENCH_REDUCE(int32_t,  _mm_reduce_or_epi32,  0, a | b);
+RMGR_FIB_BENCH_REDUCE(int8_t,   _mm_reduce_min_epi8,  0, min(a,b));
+RMGR_FIB_BENCH_REDUCE(uint8_t,  _mm_reduce_max_epu8,  0, max(a,b));
+RMGR_FIB_BENCH_REDUCE(int16_t,  _mm_reduce_max_epi16, 0, max(a,b));
+RMGR_FIB_BENCH_REDUCE(uint16_t, _mm_reduce_min_epu16, 0, min(a,b));
+RMGR_FIB_BENCH_REDUCE(int32_t,  _mm_reduce_min_epi32, 0, min(a,b));
+RMGR_FIB_BENCH_REDUCE(uint32_t, _mm_reduce_max_epu32, 0, max(a,b));
+RMGR_FIB_BENCH_REDUCE(int64_t,  _mm_reduce_max_epi64, 0, max(a,b));
+RMGR_FIB_BENCH_REDUCE(uint64_t, _mm_reduce_min_epu64, 0, min(a,b));
+
+
+
+//=================================================================================================
+// Population count
+
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_popcnt_epi8,  INTERNAL_RMGR_FIB_USE_AVX512BITALG && INTERNAL_RMGR_FIB_USE_AVX512VL,    _mm_popcnt_epi8(a),  popcnt(a));
+RMGR_FIB_BENCH(__m128i, uint16_t, _mm_popcnt_epi16, INTERNAL_RMGR_FIB_USE_AVX512BITALG && INTERNAL_RMGR_FIB_USE_AVX512VL,    _mm_popcnt_epi16(a), popcnt(a));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_popcnt_epi32, INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_popcnt_epi32(a), popcnt(a));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_popcnt_epi64, INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_popcnt_epi64(a), popcnt(a));
+
+
+
+//=================================================================================================
+// Leading & trailing zero counts
+
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_lzcnt_epi8,  0,                                                              _mm_lzcnt_epi8(a),  lzcnt(a));
+RMGR_FIB_BENCH(__m128i, uint16_t, _mm_lzcnt_epi16, 0,                                                              _mm_lzcnt_epi16(a), lzcnt(a));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_lzcnt_epi32, INTERNAL_RMGR_FIB_USE_AVX512CD && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_lzcnt_epi32(a), lzcnt(a));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_lzcnt_epi64, INTERNAL_RMGR_FIB_USE_AVX512CD && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_lzcnt_epi64(a), lzcnt(a));
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_tzcnt_epi8,  0,                                                              _mm_tzcnt_epi8(a),  tzcnt(a));
+RMGR_FIB_BENCH(__m128i, uint16_t, _mm_tzcnt_epi16, 0,                                                              _mm_tzcnt_epi16(a), tzcnt(a));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_tzcnt_epi32, 0,                                                              _mm_tzcnt_epi32(a), tzcnt(a));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_tzcnt_epi64, 0,                                                              _mm_tzcnt_epi64(a), tzcnt(a));
+
+
+
+//=================================================================================================
+// Rounding
+
+RMGR_FIB_BENCH(__m128,  float,  _mm_floor_ps, INTERNAL_RMGR_FIB_USE_SSE41, _mm_floor_ps(a), std::floor(a));
+RMGR_FIB_BENCH(__m128,  float,  _mm_ceil_ps,  INTERNAL_RMGR_FIB_USE_SSE41, _mm_ceil_ps(a),  std::ceil(a));
+RMGR_FIB_BENCH(__m128,  float,  _mm_round_ps, INTERNAL_RMGR_FIB_USE_SSE41, _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC), std::nearbyint(a));
+RMGR_FIB_BENCH(__m128d, double, _mm_floor_pd, INTERNAL_RMGR_FIB_USE_SSE41, _mm_floor_pd(a), std::floor(a));
+RMGR_FIB_BENCH(__m128d, double, _mm_ceil_pd,  INTERNAL_RMGR_FIB_USE_SSE41, _mm_ceil_pd(a),  std::ceil(a));
+RMGR_FIB_BENCH(__m128d, double, _mm_round_pd, INTERNAL_RMGR_FIB_USE_SSE41, _mm_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC), std::nearbyint(a));
+
+
+
+//=================================================================================================
+// Integer <-> floating point conversions
+
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_cvtepu32_ps,       INTERNAL_RMGR_FIB_USE_AVX512VL,                                   _mm_castps_si128(_mm_cvtepu32_ps(a)),       reinterpret<uint32_t>(float(a)));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_cvtepi64_pd,       INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_castpd_si128(_mm_cvtepi64_pd(a)),       reinterpret<int64_t>(double(a)));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_cvtepu64_pd,       INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_castpd_si128(_mm_cvtepu64_pd(a)),       reinterpret<uint64_t>(double(a)));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_cvtepi64_ps,       INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_castps_si128(_mm_cvtepi64_ps(a)),       reinterpret<uint32_t>(float(a)));
+RMGR_FIB_BENCH(__m128d, double,   _mm_cvttpd_epi64,      INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_castsi128_pd(_mm_cvttpd_epi64(a)),      reinterpret<double>(int64_t(a)));
+RMGR_FIB_BENCH(__m128d, double,   _mm_cvttpd_epu64,      INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_castsi128_pd(_mm_cvttpd_epu64(a)),      reinterpret<double>(uint64_t(a)));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_cvtepi64_pd_fast,  INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_castpd_si128(_mm_cvtepi64_pd_fast(a)),  reinterpret<int64_t>(double(a)));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_cvtepu64_pd_fast,  INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_castpd_si128(_mm_cvtepu64_pd_fast(a)),  reinterpret<uint64_t>(double(a)));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_cvtepi64_ps_fast,  INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_castps_si128(_mm_cvtepi64_ps_fast(a)),  reinterpret<uint32_t>(float(a)));
+RMGR_FIB_BENCH(__m128d, double,   _mm_cvttpd_epi64_fast, INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_castsi128_pd(_mm_cvttpd_epi64_fast(a)), reinterpret<double>(int64_t(a)));
+RMGR_FIB_BENCH(__m128d, double,   _mm_cvttpd_epu64_fast, INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_castsi128_pd(_mm_cvttpd_epu64_fast(a)), reinterpret<double>(uint64_t(a)));
+
+
+
+//=================================================================================================
+// Widening & narrowing
+
+RMGR_FIB_BENCH(__m128i, uint16_t, _mm_cvtepu8_epi16,    INTERNAL_RMGR_FIB_USE_SSE41,    _mm_cvtepu8_epi16(a),    uint8_t(a));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_cvtepu8_epi32,    INTERNAL_RMGR_FIB_USE_SSE41,    _mm_cvtepu8_epi32(a),    uint8_t(a));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_cvtepu8_epi64,    INTERNAL_RMGR_FIB_USE_SSE41,    _mm_cvtepu8_epi64(a),    uint8_t(a));
+RMGR_FIB_BENCH(__m128i, uint32_t, _mm_cvtepu16_epi32,   INTERNAL_RMGR_FIB_USE_SSE41,    _mm_cvtepu16_epi32(a),   uint16_t(a));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_cvtepu16_epi64,   INTERNAL_RMGR_FIB_USE_SSE41,    _mm_cvtepu16_epi64(a),   uint16_t(a));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_cvtepu32_epi64,   INTERNAL_RMGR_FIB_USE_SSE41,    _mm_cvtepu32_epi64(a),   uint32_t(a));
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_cvtepi8_epi16,    INTERNAL_RMGR_FIB_USE_SSE41,    _mm_cvtepi8_epi16(a),    int8_t(a));
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_cvtepi8_epi32,    INTERNAL_RMGR_FIB_USE_SSE41,    _mm_cvtepi8_epi32(a),    int8_t(a));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_cvtepi8_epi64,    INTERNAL_RMGR_FIB_USE_SSE41,    _mm_cvtepi8_epi64(a),    int8_t(a));
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_cvtepi16_epi32,   INTERNAL_RMGR_FIB_USE_SSE41,    _mm_cvtepi16_epi32(a),   int16_t(a));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_cvtepi16_epi64,   INTERNAL_RMGR_FIB_USE_SSE41,    _mm_cvtepi16_epi64(a),   int16_t(a));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_cvtepi32_epi64,   INTERNAL_RMGR_FIB_USE_SSE41,    _mm_cvtepi32_epi64(a),   int32_t(a));
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_packus_epi32,     INTERNAL_RMGR_FIB_USE_SSE41,    _mm_packus_epi32(a,b),   min(max(a, 0), 65535));
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_cvtepi32_epi8,    INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_cvtepi32_epi8(a),    uint8_t(a));
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_cvtsepi64_epi32,  INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_cvtsepi64_epi32(a),  min(max(a, int64_t(INT32_MIN)), int64_t(INT32_MAX)));
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_cvtusepi64_epi32, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_cvtusepi64_epi32(a), min(a, uint64_t(UINT32_MAX)));
+
+
+
+//=================================================================================================
+// SSSE3
+
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_shuffle_epi8,       INTERNAL_RMGR_FIB_USE_SSSE3, _mm_shuffle_epi8(a,b),     (b & 0x80) ? 0 : a >> (b & 7));
+RMGR_FIB_BENCH(__m128i, uint8_t,  _mm_shuffle_epi8_const, INTERNAL_RMGR_FIB_USE_SSSE3, _mm_shuffle_epi8_const(a, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0), a);
+RMGR_FIB_BENCH(__m128i, uint64_t, _mm_alignr_epi8,        INTERNAL_RMGR_FIB_USE_SSSE3, _mm_alignr_epi8(a,b,5),    (a << 24) | (b >> 40));
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_hadd_epi16,         INTERNAL_RMGR_FIB_USE_SSSE3, _mm_hadd_epi16(a,b),       a + b);
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_hadds_epi16,        INTERNAL_RMGR_FIB_USE_SSSE3, _mm_hadds_epi16(a,b),      min(max(int32_t(a) + b, -32768), 32767));
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_hadd_epi32,         INTERNAL_RMGR_FIB_USE_SSSE3, _mm_hadd_epi32(a,b),       a + b);
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_hsub_epi16,         INTERNAL_RMGR_FIB_USE_SSSE3, _mm_hsub_epi16(a,b),       a - b);
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_hsubs_epi16,        INTERNAL_RMGR_FIB_USE_SSSE3, _mm_hsubs_epi16(a,b),      min(max(int32_t(a) - b, -32768), 32767));
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_hsub_epi32,         INTERNAL_RMGR_FIB_USE_SSSE3, _mm_hsub_epi32(a,b),       a - b);
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_sign_epi8,          INTERNAL_RMGR_FIB_USE_SSSE3, _mm_sign_epi8(a,b),        (b < 0) ? -a : (b == 0) ? 0 : a);
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_sign_epi16,         INTERNAL_RMGR_FIB_USE_SSSE3, _mm_sign_epi16(a,b),       (b < 0) ? -a : (b == 0) ? 0 : a);
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_sign_epi32,         INTERNAL_RMGR_FIB_USE_SSSE3, _mm_sign_epi32(a,b),       (b < 0) ? -a : (b == 0) ? 0 : a);
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_mulhrs_epi16,       INTERNAL_RMGR_FIB_USE_SSSE3, _mm_mulhrs_epi16(a,b),     ((int32_t(a) * b >> 14) + 1) >> 1);
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_maddubs_epi16,      INTERNAL_RMGR_FIB_USE_SSSE3, _mm_maddubs_epi16(a,b),    min(max(int32_t(uint8_t(a)) * int8_t(b) + int32_t(uint8_t(a >> 8)) * int8_t(b >> 8), -32768), 32767));
+
+
+
+//=================================================================================================
+// Masks
+//
+// Round trips from vector to mask and back, which amount to broadcasting the sign of each lane
+
+#define RMGR_FIB_BENCH_BW_VL  (INTERNAL_RMGR_FIB_USE_AVX512BW && INTERNAL_RMGR_FIB_USE_AVX512VL)
+#define RMGR_FIB_BENCH_DQ_VL  (INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL)
+RMGR_FIB_BENCH(__m128i, int16_t, _mm_movemask_epi16, 0,                    _mm_movm_epi16(__mmask8(_mm_movemask_epi16(a))), (a < 0) ? -1 : 0);
+RMGR_FIB_BENCH(__m128i, int32_t, _mm_movemask_epi32, 0,                    _mm_movm_epi32(__mmask8(_mm_movemask_epi32(a))), (a < 0) ? -1 : 0);
+RMGR_FIB_BENCH(__m128i, int64_t, _mm_movemask_epi64, 0,                    _mm_movm_epi64(__mmask8(_mm_movemask_epi64(a))), (a < 0) ? -1 : 0);
+RMGR_FIB_BENCH(__m128i, int8_t,  _mm_movm_epi8,      RMGR_FIB_BENCH_BW_VL, _mm_movm_epi8(__mmask16(_mm_movemask_epi8(a))),  (a < 0) ? -1 : 0);
+RMGR_FIB_BENCH(__m128i, int16_t, _mm_movm_epi16,     RMGR_FIB_BENCH_BW_VL, _mm_movm_epi16(_mm_movepi16_mask(a)),            (a < 0) ? -1 : 0);
+RMGR_FIB_BENCH(__m128i, int32_t, _mm_movm_epi32,     RMGR_FIB_BENCH_DQ_VL, _mm_movm_epi32(_mm_movepi32_mask(a)),            (a < 0) ? -1 : 0);
+RMGR_FIB_BENCH(__m128i, int64_t, _mm_movm_epi64,     RMGR_FIB_BENCH_DQ_VL, _mm_movm_epi64(_mm_movepi64_mask(a)),            (a < 0) ? -1 : 0);
+#undef RMGR_FIB_BENCH_BW_VL
+#undef RMGR_FIB_BENCH_DQ_VL
+
+
+
+//=================================================================================================
+// Compress & expand
+//
+// The mask comes from the signs of b, the scalar loop is the per-lane branch they replace
+
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_maskz_compress_epi8,  0,                              _mm_maskz_compress_epi8(_mm_movepi8_mask(b), a),   (b < 0) ? a : 0);
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_maskz_compress_epi16, 0,                              _mm_maskz_compress_epi16(_mm_movepi16_mask(b), a), (b < 0) ? a : 0);
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_maskz_compress_epi32, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_maskz_compress_epi32(_mm_movepi32_mask(b), a), (b < 0) ? a : 0);
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_maskz_compress_epi64, INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_maskz_compress_epi64(_mm_movepi64_mask(b), a), (b < 0) ? a : 0);
+RMGR_FIB_BENCH(__m128i, int8_t,   _mm_maskz_expand_epi8,    0,                              _mm_maskz_expand_epi8(_mm_movepi8_mask(b), a),     (b < 0) ? a : 0);
+RMGR_FIB_BENCH(__m128i, int16_t,  _mm_maskz_expand_epi16,   0,                              _mm_maskz_expand_epi16(_mm_movepi16_mask(b), a),   (b < 0) ? a : 0);
+RMGR_FIB_BENCH(__m128i, int32_t,  _mm_maskz_expand_epi32,   INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_maskz_expand_epi32(_mm_movepi32_mask(b), a),   (b < 0) ? a : 0);
+RMGR_FIB_BENCH(__m128i, int64_t,  _mm_maskz_expand_epi64,   INTERNAL_RMGR_FIB_USE_AVX512VL, _mm_maskz_expand_epi64(_mm_movepi64_mask(b), a),   (b < 0) ? a : 0);
+
+
+} // namespace
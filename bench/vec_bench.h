@@ -0,0 +1,86 @@
+#include "bench.h"
+#include <rmgr/fib/vec.h>
+
+
+// Each operation of vec<T, N> should compile to the same code as the intrinsic it forwards to, so
+// both are expected to report the same figures
+namespace {
+
+
+//=================================================================================================
+// 128-bit
+
+RMGR_FIB_BENCH_VEC(__m128i, int8_t,   _mm_neg_epi8,     -a);
+RMGR_FIB_BENCH_VEC(__m128i, uint32_t, _mm_not_si128,    ~a);
+RMGR_FIB_BENCH_VEC(__m128i, int8_t,   _mm_cmpge_epi8,   (a >= b).native());
+RMGR_FIB_BENCH_VEC(__m128i, uint8_t,  _mm_cmpgt_epu8,   (a >  b).native());
+RMGR_FIB_BENCH_VEC(__m128i, uint16_t, _mm_cmple_epu16,  (a <= b).native());
+RMGR_FIB_BENCH_VEC(__m128i, uint32_t, _mm_cmplt_epu32,  (a <  b).native());
+RMGR_FIB_BENCH_VEC(__m128i, int64_t,  _mm_cmpgt_epi64,  (a >  b).native());
+RMGR_FIB_BENCH_VEC(__m128i, uint64_t, _mm_cmpge_epu64,  (a >= b).native());
+RMGR_FIB_BENCH_VEC(__m128i, uint8_t,  _mm_srl_epi8,     a >> 3);
+RMGR_FIB_BENCH_VEC(__m128i, int8_t,   _mm_sra_epi8,     a >> 3);
+RMGR_FIB_BENCH_VEC(__m128i, int64_t,  _mm_sra_epi64,    a >> 13);
+RMGR_FIB_BENCH_VEC(__m128i, uint8_t,  _mm_sllv_epi8,    a << b);
+RMGR_FIB_BENCH_VEC(__m128i, int16_t,  _mm_srav_epi16,   a >> b);
+RMGR_FIB_BENCH_VEC(__m128i, uint16_t, _mm_min_epu16,    min(a, b));
+RMGR_FIB_BENCH_VEC(__m128i, uint32_t, _mm_max_epu32,    max(a, b));
+RMGR_FIB_BENCH_VEC(__m128i, int64_t,  _mm_min_epi64,    min(a, b));
+RMGR_FIB_BENCH_VEC(__m128i, uint64_t, _mm_max_epu64,    max(a, b));
+RMGR_FIB_BENCH_VEC(__m128i, int8_t,   _mm_abs_epi8,     abs(a));
+RMGR_FIB_BENCH_VEC(__m128i, int64_t,  _mm_abs_epi64,    abs(a));
+RMGR_FIB_BENCH_VEC(__m128,  float,    _mm_abs_ps,       abs(a));
+RMGR_FIB_BENCH_VEC(__m128d, double,   _mm_abs_pd,       abs(a));
+
+
+//=================================================================================================
+// 256-bit
+
+#if INTERNAL_RMGR_FIB_USE_AVX
+RMGR_FIB_BENCH_VEC(__m256,  float,    _mm256_abs_ps,    abs(a));
+RMGR_FIB_BENCH_VEC(__m256d, double,   _mm256_abs_pd,    abs(a));
+#endif
+
+#if INTERNAL_RMGR_FIB_USE_AVX2
+RMGR_FIB_BENCH_VEC(__m256i, uint8_t,  _mm256_cmpgt_epu8,  (a >  b).native());
+RMGR_FIB_BENCH_VEC(__m256i, uint64_t, _mm256_cmpge_epu64, (a >= b).native());
+RMGR_FIB_BENCH_VEC(__m256i, int8_t,   _mm256_sra_epi8,    a >> 3);
+RMGR_FIB_BENCH_VEC(__m256i, uint8_t,  _mm256_sllv_epi8,   a << b);
+RMGR_FIB_BENCH_VEC(__m256i, int64_t,  _mm256_min_epi64,   min(a, b));
+RMGR_FIB_BENCH_VEC(__m256i, int64_t,  _mm256_abs_epi64,   abs(a));
+#endif
+
+
+//=================================================================================================
+// Division by an invariant divisor
+//
+// The divisor is read from the seed at run time, so that the compiler can't turn the scalar
+// divisions into multiplications by itself. The seed is constant-initialized, the divisor is built
+// on first use so that it never depends on the order of dynamic initialization.
+
+template<typename T>
+struct Divisor
+{
+    static RMGR_FORCEINLINE T value() RMGR_NOEXCEPT
+    {
+        return T(rmgr::fib::bench::g_seedB[0] | 1);
+    }
+
+    static RMGR_FORCEINLINE const rmgr::fib::divisor<T>& vector()
+    {
+        static const rmgr::fib::divisor<T> d(value());
+        return d;
+    }
+};
+
+RMGR_FIB_BENCH(__m128i, uint16_t, divisor_div_epu16, 0, Divisor<uint16_t>::vector().div(a), a / Divisor<uint16_t>::value());
+RMGR_FIB_BENCH(__m128i, int16_t,  divisor_div_epi16, 0, Divisor<int16_t>::vector().div(a),  a / Divisor<int16_t>::value());
+RMGR_FIB_BENCH(__m128i, uint32_t, divisor_div_epu32, 0, Divisor<uint32_t>::vector().div(a), a / Divisor<uint32_t>::value());
+RMGR_FIB_BENCH(__m128i, int32_t,  divisor_div_epi32, 0, Divisor<int32_t>::vector().div(a),  a / Divisor<int32_t>::value());
+RMGR_FIB_BENCH(__m128i, uint64_t, divisor_div_epu64, 0, Divisor<uint64_t>::vector().div(a), a / Divisor<uint64_t>::value());
+RMGR_FIB_BENCH(__m128i, int64_t,  divisor_div_epi64, 0, Divisor<int64_t>::vector().div(a),  a / Divisor<int64_t>::value());
+RMGR_FIB_BENCH(__m128i, uint32_t, divisor_mod_epu32, 0, Divisor<uint32_t>::vector().mod(a), a % Divisor<uint32_t>::value());
+RMGR_FIB_BENCH(__m128i, int64_t,  divisor_mod_epi64, 0, Divisor<int64_t>::vector().mod(a),  a % Divisor<int64_t>::value());
+
+
+} // namespace
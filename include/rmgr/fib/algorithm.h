@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2022, Romain Bailly
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef RMGR_FIB_ALGORITHM_H
+#define RMGR_FIB_ALGORITHM_H
+
+
+/*
+ * Bulk routines working on whole buffers rather than on a single register, built on top of the
+ * `sse.h` and `avx.h` intrinsics. They use 256-bit vectors when AVX2 is enabled.
+ *
+ * Like the classes of `vec.h`, they live in `RMGR_FIB_IS_NAMESPACE` (made visible in `rmgr::fib`),
+ * so they can be compiled once per instruction set and picked at run time (see `dispatch.h`).
+ */
+
+
+#include "avx.h"
+#include "dispatch.h"
+#include "vec.h"
+#include <cstring>
+
+
+namespace rmgr { namespace fib {
+
+namespace RMGR_FIB_IS_NAMESPACE {
+
+
+//=================================================================================================
+// Population count
+
+/**
+ * @brief Returns the number of bits set in a buffer
+ *
+ * @param [in] data  The buffer, no alignment is required
+ * @param [in] size  The size of the buffer, in bytes
+ */
+inline uint64_t popcount(const void* data, size_t size) RMGR_NOEXCEPT
+{
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+
+#if INTERNAL_RMGR_FIB_USE_SSE42 && !INTERNAL_RMGR_FIB_USE_AVX2
+    // 128-bit vectors don't beat the scalar popcnt instruction, which comes with SSE 4.2
+    uint64_t total = 0;
+    for (; size >= 8; src += 8, size -= 8)
+    {
+        uint64_t word;
+        memcpy(&word, src, sizeof(word));
+    #if RMGR_ARCH_IS_X86_64
+        total += uint64_t(_mm_popcnt_u64(word));
+    #else
+        total += unsigned(_mm_popcnt_u32(uint32_t(word)) + _mm_popcnt_u32(uint32_t(word >> 32)));
+    #endif
+    }
+    for (; size != 0; ++src, --size)
+        total += unsigned(_mm_popcnt_u32(*src));
+    return total;
+#else
+    // Without a native 64-bit count, bytes are counted and only summed up with psadbw every 31
+    // vectors at most, before their 8-bit counters can overflow
+    #if INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ && INTERNAL_RMGR_FIB_USE_AVX512VL
+        __m256i sums256 = _mm256_setzero_si256();
+        for (; size >= 32; src += 32, size -= 32)
+            sums256 = _mm256_add_epi64(sums256, _mm256_popcnt_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src))));
+        __m128i sums = _mm_add_epi64(_mm256_castsi256_si128(sums256), _mm256_extracti128_si256(sums256, 1));
+    #elif INTERNAL_RMGR_FIB_USE_AVX2
+        __m256i sums256 = _mm256_setzero_si256();
+        while (size >= 32)
+        {
+            const size_t count  = (size / 32 < 31) ? size / 32 : 31;
+            __m256i      counts = _mm256_setzero_si256();
+            for (size_t i=0; i<count; ++i, src+=32)
+                counts = _mm256_add_epi8(counts, _mm256_popcnt_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src))));
+            sums256 = _mm256_add_epi64(sums256, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+            size -= count * 32;
+        }
+        __m128i sums = _mm_add_epi64(_mm256_castsi256_si128(sums256), _mm256_extracti128_si256(sums256, 1));
+    #else
+        __m128i sums = _mm_setzero_si128();
+        while (size >= 16)
+        {
+            const size_t count  = (size / 16 < 31) ? size / 16 : 31;
+            __m128i      counts = _mm_setzero_si128();
+            for (size_t i=0; i<count; ++i, src+=16)
+                counts = _mm_add_epi8(counts, _mm_popcnt_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src))));
+            sums = _mm_add_epi64(sums, _mm_sad_epu8(counts, _mm_setzero_si128()));
+            size -= count * 16;
+        }
+    #endif
+
+    // The remaining bytes are padded with zeros, which don't count
+    while (size != 0)
+    {
+        const size_t count    = (size < 16) ? size : 16;
+        uint8_t      tail[16] = {};
+        memcpy(tail, src, count);
+        sums  = _mm_add_epi64(sums, _mm_popcnt_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(tail))));
+        src  += count;
+        size -= count;
+    }
+    return uint64_t(_mm_cvtsi128_si64(_mm_add_epi64(sums, _mm_unpackhi_epi64(sums, sums))));
+#endif
+}
+
+//=================================================================================================
+// Stream compaction
+
+namespace internal {
+
+/// Compress & mask intrinsics for each lane size
+template<size_t bytes>
+struct compress_traits;
+
+template<>
+struct compress_traits<1>
+{
+    static RMGR_FORCEINLINE unsigned mask(const __m128i& m)                                RMGR_NOEXCEPT { return _mm_movepi8_mask(m); }
+    static RMGR_FORCEINLINE unsigned count(unsigned k)                                     RMGR_NOEXCEPT { return rmgr_fib_mask_popcnt(k); }
+    static RMGR_FORCEINLINE __m128i  compress(unsigned k, const __m128i& a)                RMGR_NOEXCEPT { return _mm_maskz_compress_epi8(__mmask16(k), a); }
+    static RMGR_FORCEINLINE void     compressstoreu(void* p, unsigned k, const __m128i& a) RMGR_NOEXCEPT { _mm_mask_compressstoreu_epi8(p, __mmask16(k), a); }
+};
+
+template<>
+struct compress_traits<2>
+{
+    static RMGR_FORCEINLINE unsigned mask(const __m128i& m)                                RMGR_NOEXCEPT { return _mm_movepi16_mask(m); }
+    static RMGR_FORCEINLINE unsigned count(unsigned k)                                     RMGR_NOEXCEPT { return rmgr_fib_mask_popcnt(k); }
+    static RMGR_FORCEINLINE __m128i  compress(unsigned k, const __m128i& a)                RMGR_NOEXCEPT { return _mm_maskz_compress_epi16(__mmask8(k), a); }
+    static RMGR_FORCEINLINE void     compressstoreu(void* p, unsigned k, const __m128i& a) RMGR_NOEXCEPT { _mm_mask_compressstoreu_epi16(p, __mmask8(k), a); }
+};
+
+template<>
+struct compress_traits<4>
+{
+    static RMGR_FORCEINLINE unsigned mask(const __m128i& m)                                RMGR_NOEXCEPT { return _mm_movepi32_mask(m); }
+    static RMGR_FORCEINLINE unsigned count(unsigned k)                                     RMGR_NOEXCEPT { return unsigned(0x4332322132212110ull >> (4 * k)) & 7; }
+    static RMGR_FORCEINLINE __m128i  compress(unsigned k, const __m128i& a)                RMGR_NOEXCEPT { return _mm_maskz_compress_epi32(__mmask8(k), a); }
+    static RMGR_FORCEINLINE void     compressstoreu(void* p, unsigned k, const __m128i& a) RMGR_NOEXCEPT { _mm_mask_compressstoreu_epi32(p, __mmask8(k), a); }
+};
+
+template<>
+struct compress_traits<8>
+{
+    static RMGR_FORCEINLINE unsigned mask(const __m128i& m)                                RMGR_NOEXCEPT { return _mm_movepi64_mask(m); }
+    static RMGR_FORCEINLINE unsigned count(unsigned k)                                     RMGR_NOEXCEPT { return (k & 1) + (k >> 1); }
+    static RMGR_FORCEINLINE __m128i  compress(unsigned k, const __m128i& a)                RMGR_NOEXCEPT { return _mm_maskz_compress_epi64(__mmask8(k), a); }
+    static RMGR_FORCEINLINE void     compressstoreu(void* p, unsigned k, const __m128i& a) RMGR_NOEXCEPT { _mm_mask_compressstoreu_epi64(p, __mmask8(k), a); }
+};
+
+} // namespace internal
+
+
+/**
+ * @brief Copies the elements of a buffer which satisfy a predicate, preserving their order
+ *
+ * The predicate is evaluated 128 bits at a time: it takes a `vec<T, 16 / sizeof(T)>` and returns
+ * its `vec_mask`, typically from one of the comparison operators:
+ *
+ *     typedef rmgr::fib::vec<int32_t, 4> i32x4;
+ *     struct positive { i32x4::mask_type operator()(const i32x4& v) const { return v > i32x4::zero(); } };
+ *     const size_t count = rmgr::fib::compress(dst, src, n, positive());
+ *
+ * The last vector is padded with zeros, the predicate's result for them is ignored. The selected
+ * elements of whole vectors are written with a full store, so the elements of `dst` past the
+ * returned count may be overwritten.
+ *
+ * @param [out] dst        The destination, with room for `n` elements. It may be `src` itself but
+ *                         must not overlap it otherwise
+ * @param [in]  src        The elements to filter, no alignment is required
+ * @param [in]  n          The number of elements of `src`
+ * @param [in]  predicate  The vector predicate selecting the elements to keep
+ *
+ * @return The number of elements written to `dst`
+ */
+template<typename T, typename Predicate>
+inline size_t compress(T* dst, const T* src, size_t n, Predicate predicate)
+{
+    RMGR_STATIC_ASSERT(std::is_integral<T>::value);
+    typedef vec<T, 16 / sizeof(T)>                 vec_type;
+    typedef internal::compress_traits<sizeof(T)> traits;
+    const size_t lanes = vec_type::SIZE;
+
+    size_t count = 0;
+    size_t i     = 0;
+    for (; i + lanes <= n; i += lanes)
+    {
+        // Never goes past dst + i + lanes, which has already been read when compressing in place
+        const vec_type v = vec_type::loadu(src + i);
+        const unsigned k = traits::mask(predicate(v).native());
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + count), traits::compress(k, v));
+        count += traits::count(k);
+    }
+
+    if (i != n)
+    {
+        T tail[lanes] = {};
+        memcpy(tail, src + i, (n - i) * sizeof(T));
+        const vec_type v = vec_type::loadu(tail);
+        const unsigned k = traits::mask(predicate(v).native()) & ((1u << (n - i)) - 1);
+        traits::compressstoreu(dst + count, k, v);
+        count += traits::count(k);
+    }
+    return count;
+}
+
+
+} // namespace RMGR_FIB_IS_NAMESPACE
+
+using namespace RMGR_FIB_IS_NAMESPACE;
+
+}} // namespace rmgr::fib
+
+
+#endif // RMGR_FIB_ALGORITHM_H
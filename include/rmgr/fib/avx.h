@@ -0,0 +1,1072 @@
+/*
+ * Copyright (c) 2022, Romain Bailly
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef RMGR_FIB_AVX_H
+#define RMGR_FIB_AVX_H
+
+
+/*
+ * The 256-bit counterpart of sse.h, which it includes and whose configuration macros it shares.
+ *
+ * The floating-point intrinsics require AVX, the integer ones require AVX2 (AVX has next to no
+ * 256-bit integer instructions). Nothing is defined when the required instruction set is disabled.
+ */
+
+
+#include "sse.h"
+
+
+//=================================================================================================
+// Disable warnings
+
+RMGR_WARNING_PUSH()
+RMGR_WARNING_MSVC_DISABLE(4505) // unreferenced function with internal linkage has been removed
+
+
+#if INTERNAL_RMGR_FIB_USE_AVX
+
+//=================================================================================================
+// Negation
+
+static RMGR_FORCEINLINE __m256 _mm256_neg_ps(const __m256& a) RMGR_NOEXCEPT
+{
+    return _mm256_sub_ps(_mm256_setzero_ps(), a);
+}
+
+static RMGR_FORCEINLINE __m256d _mm256_neg_pd(const __m256d& a) RMGR_NOEXCEPT
+{
+    return _mm256_sub_pd(_mm256_setzero_pd(), a);
+}
+
+
+//=================================================================================================
+// 32-bit x86 compat layer
+
+#if RMGR_ARCH_IS_X86_32
+    #define _mm256_set_epi64x                rmgr_fib_mm256_set_epi64x
+    #define _mm256_set1_epi64x               rmgr_fib_mm256_set1_epi64x
+    #define _mm256_extract_epi64(a, imm8)    rmgr_fib_mm256_extract_epi64<(imm8)>(a)
+    #define _mm256_insert_epi64(a, i, imm8)  rmgr_fib_mm256_insert_epi64<(imm8) & 3>((a), (i))
+
+    static RMGR_FORCEINLINE __m256i rmgr_fib_mm256_set_epi64x(int64_t e3, int64_t e2, int64_t e1, int64_t e0) RMGR_NOEXCEPT
+    {
+        return _mm256_set_epi32(int32_t(e3>>32), int32_t(e3&UINT64_C(0xFFFFFFFF)), int32_t(e2>>32), int32_t(e2&UINT64_C(0xFFFFFFFF)),
+                                int32_t(e1>>32), int32_t(e1&UINT64_C(0xFFFFFFFF)), int32_t(e0>>32), int32_t(e0&UINT64_C(0xFFFFFFFF)));
+    }
+
+    static RMGR_FORCEINLINE __m256i rmgr_fib_mm256_set1_epi64x(int64_t a) RMGR_NOEXCEPT
+    {
+        return rmgr_fib_mm256_set_epi64x(a, a, a, a);
+    }
+
+    template<int N>
+    static RMGR_FORCEINLINE int64_t rmgr_fib_mm256_extract_epi64(const __m256i& a) RMGR_NOEXCEPT
+    {
+        return int64_t((uint64_t(uint32_t(_mm256_extract_epi32(a, 2*N+1))) << 32) | uint32_t(_mm256_extract_epi32(a, 2*N)));
+    }
+
+    template<int N>
+    static RMGR_FORCEINLINE __m256i rmgr_fib_mm256_insert_epi64(const __m256i& a, int64_t i) RMGR_NOEXCEPT
+    {
+        // Like the native one, insert into the 128-bit half holding the lane
+        return _mm256_insertf128_si256(a, _mm_insert_epi64(_mm256_extractf128_si256(a, N/2), i, N%2), N/2);
+    }
+#endif
+
+
+//=================================================================================================
+// Absolute value
+
+static RMGR_FORCEINLINE __m256 _mm256_abs_ps(const __m256& a) RMGR_NOEXCEPT
+{
+    return _mm256_and_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF)));
+}
+
+static RMGR_FORCEINLINE __m256d _mm256_abs_pd(const __m256d& a) RMGR_NOEXCEPT
+{
+    return _mm256_and_pd(a, _mm256_castsi256_pd(_mm256_set1_epi64x(INT64_C(0x7FFFFFFFFFFFFFFF))));
+}
+
+#endif // INTERNAL_RMGR_FIB_USE_AVX
+
+
+#if INTERNAL_RMGR_FIB_USE_AVX2
+
+//=================================================================================================
+// Utility stuff
+
+#if !INTERNAL_RMGR_FIB_GCC_BLENDV_BUG
+    #define INTERNAL_RMGR_FIB_SELECT256(mask, a, b)  _mm256_blendv_epi8((b), (a), (mask))
+#else
+    #define INTERNAL_RMGR_FIB_SELECT256(mask, a, b)  _mm256_or_si256(_mm256_and_si256((mask),(a)), _mm256_andnot_si256((mask),(b)))
+#endif
+
+
+//=================================================================================================
+// Bitwise NOT and negation
+
+static RMGR_FORCEINLINE __m256i _mm256_not_si256(const __m256i& a) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm256_ternarylogic_epi32(a, a, a, 0x55); // Doesn't need a register of all ones
+#else
+    return _mm256_xor_si256(a, _mm256_cmpeq_epi32(a,a));
+#endif
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_neg_epi8(const __m256i& a) RMGR_NOEXCEPT
+{
+    return _mm256_sub_epi8(_mm256_setzero_si256(), a);
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_neg_epi16(const __m256i& a) RMGR_NOEXCEPT
+{
+    return _mm256_sub_epi16(_mm256_setzero_si256(), a);
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_neg_epi32(const __m256i& a) RMGR_NOEXCEPT
+{
+    return _mm256_sub_epi32(_mm256_setzero_si256(), a);
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_neg_epi64(const __m256i& a) RMGR_NOEXCEPT
+{
+    return _mm256_sub_epi64(_mm256_setzero_si256(), a);
+}
+
+
+//=================================================================================================
+// Ternary logic
+//
+// See sse.h for the details, the same expressions are used with 256-bit operations.
+
+template<>
+struct rmgr_fib_bitwise<sizeof(__m256i)>
+{
+    static RMGR_FORCEINLINE __m256i zero()                                     RMGR_NOEXCEPT { return _mm256_setzero_si256(); }
+    static RMGR_FORCEINLINE __m256i ones()                                     RMGR_NOEXCEPT { return _mm256_set1_epi32(-1); }
+    static RMGR_FORCEINLINE __m256i not_(const __m256i& a)                     RMGR_NOEXCEPT { return _mm256_xor_si256(a, ones()); }
+    static RMGR_FORCEINLINE __m256i and_(const __m256i& a, const __m256i& b)   RMGR_NOEXCEPT { return _mm256_and_si256(a, b); }
+    static RMGR_FORCEINLINE __m256i or_(const __m256i& a, const __m256i& b)    RMGR_NOEXCEPT { return _mm256_or_si256(a, b); }
+    static RMGR_FORCEINLINE __m256i xor_(const __m256i& a, const __m256i& b)   RMGR_NOEXCEPT { return _mm256_xor_si256(a, b); }
+    static RMGR_FORCEINLINE __m256i andnot(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT { return _mm256_andnot_si256(a, b); } // ~a & b
+};
+
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    // GCC declares them as macros in unoptimized builds, even without AVX512VL
+    #undef  _mm256_ternarylogic_epi32
+    #undef  _mm256_ternarylogic_epi64
+    #define _mm256_ternarylogic_epi32(a, b, c, imm8)  rmgr_fib_mm256_ternarylogic_epi32<(imm8) & 0xFF>(a, b, c)
+    #define _mm256_ternarylogic_epi64(a, b, c, imm8)  rmgr_fib_mm256_ternarylogic_epi32<(imm8) & 0xFF>(a, b, c)
+
+    // Without a mask, the lane size makes no difference
+    template<int imm>
+    static RMGR_FORCEINLINE __m256i rmgr_fib_mm256_ternarylogic_epi32(const __m256i& a, const __m256i& b, const __m256i& c) RMGR_NOEXCEPT
+    {
+        return rmgr_fib_ternarylogic<imm>::template apply<rmgr_fib_bitwise<sizeof(__m256i)> >(a, b, c);
+    }
+#endif
+
+
+//=================================================================================================
+// Comparisons
+
+// 8-bit signed
+static RMGR_FORCEINLINE __m256i _mm256_cmpneq_epi8(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_not_si256(_mm256_cmpeq_epi8(a,b));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmpge_epi8(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_not_si256(_mm256_cmpgt_epi8(b,a));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmplt_epi8(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpgt_epi8(b, a);
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmple_epi8(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpge_epi8(b, a);
+}
+
+// 8-bit unsigned
+#define _mm256_cmpeq_epu8         _mm256_cmpeq_epi8
+#define _mm256_cmpneq_epu8        _mm256_cmpneq_epi8
+
+static RMGR_FORCEINLINE __m256i _mm256_cmpge_epu8(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpeq_epi8(a, _mm256_max_epu8(a,b));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmple_epu8(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpge_epu8(b, a);
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmpgt_epu8(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_not_si256(_mm256_cmpge_epu8(b,a));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmplt_epu8(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpgt_epu8(b, a);
+}
+
+// 16-bit signed
+static RMGR_FORCEINLINE __m256i _mm256_cmpneq_epi16(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_not_si256(_mm256_cmpeq_epi16(a,b));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmpge_epi16(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_not_si256(_mm256_cmpgt_epi16(b,a));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmplt_epi16(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpgt_epi16(b, a);
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmple_epi16(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpge_epi16(b, a);
+}
+
+// 16-bit unsigned
+#define _mm256_cmpeq_epu16        _mm256_cmpeq_epi16
+#define _mm256_cmpneq_epu16       _mm256_cmpneq_epi16
+
+static RMGR_FORCEINLINE __m256i _mm256_cmpge_epu16(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpeq_epi16(a, _mm256_max_epu16(a,b));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmple_epu16(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpge_epu16(b, a);
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmpgt_epu16(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_not_si256(_mm256_cmpge_epu16(b,a));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmplt_epu16(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpgt_epu16(b, a);
+}
+
+// 32-bit signed
+static RMGR_FORCEINLINE __m256i _mm256_cmpneq_epi32(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_not_si256(_mm256_cmpeq_epi32(a,b));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmpge_epi32(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_not_si256(_mm256_cmpgt_epi32(b,a));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmplt_epi32(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpgt_epi32(b, a);
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmple_epi32(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpge_epi32(b, a);
+}
+
+// 32-bit unsigned
+#define _mm256_cmpeq_epu32        _mm256_cmpeq_epi32
+#define _mm256_cmpneq_epu32       _mm256_cmpneq_epi32
+
+static RMGR_FORCEINLINE __m256i _mm256_cmpge_epu32(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpeq_epi32(a, _mm256_max_epu32(a,b));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmple_epu32(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpge_epu32(b, a);
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmpgt_epu32(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_not_si256(_mm256_cmpge_epu32(b,a));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmplt_epu32(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpgt_epu32(b, a);
+}
+
+// 64-bit signed
+static RMGR_FORCEINLINE __m256i _mm256_cmpneq_epi64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_not_si256(_mm256_cmpeq_epi64(a,b));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmpge_epi64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_not_si256(_mm256_cmpgt_epi64(b,a));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmplt_epi64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpgt_epi64(b, a);
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmple_epi64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpge_epi64(b, a);
+}
+
+// 64-bit unsigned
+#define _mm256_cmpeq_epu64        _mm256_cmpeq_epi64
+#define _mm256_cmpneq_epu64       _mm256_cmpneq_epi64
+
+static RMGR_FORCEINLINE __m256i _mm256_cmpgt_epu64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    const __m256i flip = _mm256_set1_epi64x(INT64_MIN);
+    return _mm256_cmpgt_epi64(_mm256_xor_si256(a,flip), _mm256_xor_si256(b,flip));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmpge_epu64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_not_si256(_mm256_cmpgt_epu64(b,a));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmplt_epu64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpgt_epu64(b, a);
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_cmple_epu64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_cmpge_epu64(b, a);
+}
+
+
+//=================================================================================================
+// Shifts
+
+// 8-bit shifts
+#define _mm256_slli_epi8(a, imm8)  rmgr_fib_mm256_slli_epi8<(imm8)>(a)
+#define _mm256_srli_epi8(a, imm8)  rmgr_fib_mm256_srli_epi8<(imm8)>(a)
+#define _mm256_srai_epi8(a, imm8)  rmgr_fib_mm256_srai_epi8<(imm8)>(a)
+
+template<int N>
+static RMGR_FORCEINLINE __m256i rmgr_fib_mm256_slli_epi8(const __m256i& a) RMGR_NOEXCEPT
+{
+    return _mm256_and_si256(_mm256_slli_epi16(a,N), _mm256_set1_epi8(int8_t(255 & (255<<(N&7)))));
+}
+
+template<int N>
+static RMGR_FORCEINLINE __m256i rmgr_fib_mm256_srli_epi8(const __m256i& a) RMGR_NOEXCEPT
+{
+    return _mm256_and_si256(_mm256_srli_epi16(a,N), _mm256_set1_epi8(int8_t(255u>>(N&7))));
+}
+
+template<int N>
+static RMGR_FORCEINLINE __m256i rmgr_fib_mm256_srai_epi8(const __m256i& a) RMGR_NOEXCEPT
+{
+    return _mm256_packs_epi16(_mm256_srai_epi16(_mm256_unpacklo_epi8(a,a), N+8), _mm256_srai_epi16(_mm256_unpackhi_epi8(a,a), N+8));
+}
+
+static inline __m256i _mm256_sll_epi8(const __m256i& a, const __m128i& count) RMGR_NOEXCEPT
+{
+    const __m256i twoFiftySix = _mm256_set1_epi16(256);
+    const __m256i mask        = _mm256_sub_epi16(_mm256_sll_epi16(twoFiftySix, count), twoFiftySix);
+    return _mm256_andnot_si256(mask, _mm256_sll_epi16(a, count));
+}
+
+static inline __m256i _mm256_srl_epi8(const __m256i& a, const __m128i& count) RMGR_NOEXCEPT
+{
+    const __m256i twoFiftySix = _mm256_set1_epi16(256);
+    const __m256i mask        = _mm256_sub_epi16(twoFiftySix, _mm256_srl_epi16(twoFiftySix, count));
+    return _mm256_andnot_si256(mask, _mm256_srl_epi16(a, count));
+}
+
+static inline __m256i _mm256_sra_epi8(const __m256i& a, const __m128i& count) RMGR_NOEXCEPT
+{
+    // Unpacking and packing both work within 128-bit lanes, so the order of the bytes is preserved
+    const __m128i count16 = _mm_add_epi64(count, _mm_set1_epi64x(8));
+    return _mm256_packs_epi16(_mm256_sra_epi16(_mm256_unpacklo_epi8(a,a), count16), _mm256_sra_epi16(_mm256_unpackhi_epi8(a,a), count16));
+}
+
+// 64-bit arithmetic right shift
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    #undef  _mm256_srai_epi64  // GCC declares it as a macro in unoptimized builds, even without AVX512VL
+    #define _mm256_srai_epi64(a, imm8)  rmgr_fib_mm256_srai_epi64<(imm8)>(a)
+    #define _mm256_sra_epi64            rmgr_fib_mm256_sra_epi64
+
+    static inline __m256i rmgr_fib_mm256_sra_epi64(const __m256i& a, const __m128i& count) RMGR_NOEXCEPT
+    {
+        const __m256i sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), a);
+        return _mm256_or_si256(_mm256_srl_epi64(a,count), _mm256_sll_epi64(sign,_mm_sub_epi64(_mm_set1_epi64x(63),count)));
+    }
+
+    template<unsigned N>
+    static RMGR_FORCEINLINE __m256i rmgr_fib_mm256_srai_epi64(const __m256i& a) RMGR_NOEXCEPT
+    {
+        const __m256i sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), a);
+        return _mm256_or_si256(_mm256_srli_epi64(a,N), _mm256_slli_epi64(sign,63-N));
+    }
+
+    template<>
+    RMGR_FORCEINLINE __m256i rmgr_fib_mm256_srai_epi64<0u>(const __m256i& a) RMGR_NOEXCEPT
+    {
+        return a;
+    }
+
+    template<>
+    RMGR_FORCEINLINE __m256i rmgr_fib_mm256_srai_epi64<1u>(const __m256i& a) RMGR_NOEXCEPT
+    {
+        // The sign bit just stays in place
+        return _mm256_or_si256(_mm256_srli_epi64(a,1), _mm256_and_si256(a, _mm256_set1_epi64x(INT64_MIN)));
+    }
+
+    template<>
+    RMGR_FORCEINLINE __m256i rmgr_fib_mm256_srai_epi64<63u>(const __m256i& a) RMGR_NOEXCEPT
+    {
+        return _mm256_cmpgt_epi64(_mm256_setzero_si256(), a);
+    }
+#endif
+
+
+//=================================================================================================
+// Variable shifts
+//
+// Same semantics as their 128-bit counterparts, see sse.h.
+
+// 8-bit
+static inline __m256i _mm256_sllv_epi8(const __m256i& a, const __m256i& count) RMGR_NOEXCEPT
+{
+    // Multiply by 2^count (looked up in a table), even and odd bytes being multiplied separately
+    const __m256i table    = _mm256_setr_epi8(1,2,4,8,16,32,64,-128, 0,0,0,0,0,0,0,0, 1,2,4,8,16,32,64,-128, 0,0,0,0,0,0,0,0);
+    const __m256i pow2     = _mm256_shuffle_epi8(table, _mm256_min_epu8(count, _mm256_set1_epi8(8)));
+    const __m256i lowBytes = _mm256_set1_epi16(0x00FF);
+    const __m256i lo       = _mm256_mullo_epi16(a, pow2);
+    const __m256i hi       = _mm256_mullo_epi16(_mm256_andnot_si256(lowBytes, a), _mm256_srli_epi16(pow2, 8));
+    return _mm256_or_si256(_mm256_and_si256(lo, lowBytes), hi);
+}
+
+static inline __m256i _mm256_srlv_epi8(const __m256i& a, const __m256i& count) RMGR_NOEXCEPT
+{
+    // Shift by 4, 2 and 1, selecting each step with a bit of count brought to the MSB
+    __m256i c = _mm256_slli_epi16(count, 5);
+    __m256i r = _mm256_blendv_epi8(a, _mm256_srli_epi8(a, 4), c);
+    c = _mm256_add_epi8(c, c);
+    r = _mm256_blendv_epi8(r, _mm256_srli_epi8(r, 2), c);
+    c = _mm256_add_epi8(c, c);
+    r = _mm256_blendv_epi8(r, _mm256_srli_epi8(r, 1), c);
+    const __m256i seven = _mm256_set1_epi8(7);
+    return _mm256_and_si256(r, _mm256_cmpeq_epi8(_mm256_min_epu8(count, seven), count));
+}
+
+static inline __m256i _mm256_srav_epi8(const __m256i& a, const __m256i& count) RMGR_NOEXCEPT
+{
+    // Flipping negative values turns the arithmetic shift into a logical one
+    const __m256i s = _mm256_cmpgt_epi8(_mm256_setzero_si256(), a);
+    return _mm256_xor_si256(_mm256_srlv_epi8(_mm256_xor_si256(a, s), count), s);
+}
+
+// 16-bit
+#if !(INTERNAL_RMGR_FIB_USE_AVX512BW && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define _mm256_sllv_epi16  rmgr_fib_mm256_sllv_epi16
+    #define _mm256_srlv_epi16  rmgr_fib_mm256_srlv_epi16
+    #define _mm256_srav_epi16  rmgr_fib_mm256_srav_epi16
+
+    static inline __m256i rmgr_fib_mm256_sllv_epi16(const __m256i& a, const __m256i& count) RMGR_NOEXCEPT
+    {
+        // Even and odd lanes are shifted separately as 32-bit lanes
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i even = _mm256_sllv_epi32(a, _mm256_blend_epi16(count, zero, 0xAA));
+        const __m256i odd  = _mm256_sllv_epi32(_mm256_blend_epi16(zero, a, 0xAA), _mm256_srli_epi32(count, 16));
+        return _mm256_blend_epi16(even, odd, 0xAA);
+    }
+
+    static inline __m256i rmgr_fib_mm256_srlv_epi16(const __m256i& a, const __m256i& count) RMGR_NOEXCEPT
+    {
+        // Even and odd lanes are shifted separately as 32-bit lanes
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i even = _mm256_srlv_epi32(_mm256_blend_epi16(a, zero, 0xAA), _mm256_blend_epi16(count, zero, 0xAA));
+        const __m256i odd  = _mm256_srlv_epi32(a, _mm256_srli_epi32(count, 16));
+        return _mm256_blend_epi16(even, odd, 0xAA);
+    }
+
+    static inline __m256i rmgr_fib_mm256_srav_epi16(const __m256i& a, const __m256i& count) RMGR_NOEXCEPT
+    {
+        // Flipping negative values turns the arithmetic shift into a logical one
+        const __m256i s = _mm256_srai_epi16(a, 15);
+        return _mm256_xor_si256(rmgr_fib_mm256_srlv_epi16(_mm256_xor_si256(a, s), count), s);
+    }
+#endif
+
+// 64-bit arithmetic
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    #define _mm256_srav_epi64  rmgr_fib_mm256_srav_epi64
+
+    static inline __m256i rmgr_fib_mm256_srav_epi64(const __m256i& a, const __m256i& count) RMGR_NOEXCEPT
+    {
+        // Flipping negative values turns the arithmetic shift into a logical one
+        const __m256i s = _mm256_cmpgt_epi64(_mm256_setzero_si256(), a);
+        return _mm256_xor_si256(_mm256_srlv_epi64(_mm256_xor_si256(a, s), count), s);
+    }
+#endif
+
+
+//=================================================================================================
+// Rotates
+//
+// Same semantics as their 128-bit counterparts, see sse.h.
+
+// Rotates each lane of bits bits left by N bytes
+template<int bits, int N>
+static RMGR_FORCEINLINE __m256i rmgr_fib_mm256_rol_bytes(const __m256i& a) RMGR_NOEXCEPT
+{
+    // Destination byte d is read from byte d - N of the same lane, pshufb working within 128-bit halves
+    #define INTERNAL_RMGR_FIB_ROL_BYTE(d)  char((d) - (d) % (bits/8) + ((d) % (bits/8) + bits/8 - N) % (bits/8))
+    #define INTERNAL_RMGR_FIB_ROL_BYTES    INTERNAL_RMGR_FIB_ROL_BYTE(0),  INTERNAL_RMGR_FIB_ROL_BYTE(1),  INTERNAL_RMGR_FIB_ROL_BYTE(2),  INTERNAL_RMGR_FIB_ROL_BYTE(3),  \
+                                           INTERNAL_RMGR_FIB_ROL_BYTE(4),  INTERNAL_RMGR_FIB_ROL_BYTE(5),  INTERNAL_RMGR_FIB_ROL_BYTE(6),  INTERNAL_RMGR_FIB_ROL_BYTE(7),  \
+                                           INTERNAL_RMGR_FIB_ROL_BYTE(8),  INTERNAL_RMGR_FIB_ROL_BYTE(9),  INTERNAL_RMGR_FIB_ROL_BYTE(10), INTERNAL_RMGR_FIB_ROL_BYTE(11), \
+                                           INTERNAL_RMGR_FIB_ROL_BYTE(12), INTERNAL_RMGR_FIB_ROL_BYTE(13), INTERNAL_RMGR_FIB_ROL_BYTE(14), INTERNAL_RMGR_FIB_ROL_BYTE(15)
+    return _mm256_shuffle_epi8(a, _mm256_setr_epi8(INTERNAL_RMGR_FIB_ROL_BYTES, INTERNAL_RMGR_FIB_ROL_BYTES));
+    #undef INTERNAL_RMGR_FIB_ROL_BYTES
+    #undef INTERNAL_RMGR_FIB_ROL_BYTE
+}
+
+// 8-bit
+#define _mm256_rol_epi8(a, imm8)  rmgr_fib_mm256_rol_epi8<(imm8)>(a)
+#define _mm256_ror_epi8(a, imm8)  rmgr_fib_mm256_rol_epi8<-(imm8)>(a)
+
+template<int N>
+static RMGR_FORCEINLINE __m256i rmgr_fib_mm256_rol_epi8(const __m256i& a) RMGR_NOEXCEPT
+{
+    const int n = N & 7;
+    if (n == 0)
+        return a;
+    const __m256i mask = _mm256_set1_epi8(char(255 & (255 << n)));
+    return _mm256_ternarylogic_epi32(mask, _mm256_slli_epi16(a, n), _mm256_srli_epi16(a, (8 - n) & 7), 0xCA);
+}
+
+static inline __m256i _mm256_rolv_epi8(const __m256i& a, const __m256i& count) RMGR_NOEXCEPT
+{
+    const __m256i n = _mm256_and_si256(count, _mm256_set1_epi8(7));
+    return _mm256_or_si256(_mm256_sllv_epi8(a, n), _mm256_srlv_epi8(a, _mm256_sub_epi8(_mm256_set1_epi8(8), n)));
+}
+
+static inline __m256i _mm256_rorv_epi8(const __m256i& a, const __m256i& count) RMGR_NOEXCEPT
+{
+    return _mm256_rolv_epi8(a, _mm256_sub_epi8(_mm256_setzero_si256(), count));
+}
+
+// 16-bit
+#define _mm256_rol_epi16(a, imm8)  rmgr_fib_mm256_rol_epi16<(imm8)>(a)
+#define _mm256_ror_epi16(a, imm8)  rmgr_fib_mm256_rol_epi16<-(imm8)>(a)
+
+template<int N>
+static RMGR_FORCEINLINE __m256i rmgr_fib_mm256_rol_epi16(const __m256i& a) RMGR_NOEXCEPT
+{
+    const int n = N & 15;
+    if (n == 0)
+        return a;
+    if (n == 8)
+        return rmgr_fib_mm256_rol_bytes<16, 1>(a);
+    return _mm256_or_si256(_mm256_slli_epi16(a, n), _mm256_srli_epi16(a, (16 - n) & 15));
+}
+
+static inline __m256i _mm256_rolv_epi16(const __m256i& a, const __m256i& count) RMGR_NOEXCEPT
+{
+    const __m256i n = _mm256_and_si256(count, _mm256_set1_epi16(15));
+    return _mm256_or_si256(_mm256_sllv_epi16(a, n), _mm256_srlv_epi16(a, _mm256_sub_epi16(_mm256_set1_epi16(16), n)));
+}
+
+static inline __m256i _mm256_rorv_epi16(const __m256i& a, const __m256i& count) RMGR_NOEXCEPT
+{
+    return _mm256_rolv_epi16(a, _mm256_sub_epi16(_mm256_setzero_si256(), count));
+}
+
+// 32 & 64-bit
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    // GCC declares them as macros in unoptimized builds, even without AVX512VL
+    #undef  _mm256_rol_epi32
+    #undef  _mm256_ror_epi32
+    #undef  _mm256_rol_epi64
+    #undef  _mm256_ror_epi64
+    #define _mm256_rol_epi32(a, imm8)  rmgr_fib_mm256_rol_epi32<(imm8)>(a)
+    #define _mm256_ror_epi32(a, imm8)  rmgr_fib_mm256_rol_epi32<-(imm8)>(a)
+    #define _mm256_rol_epi64(a, imm8)  rmgr_fib_mm256_rol_epi64<(imm8)>(a)
+    #define _mm256_ror_epi64(a, imm8)  rmgr_fib_mm256_rol_epi64<-(imm8)>(a)
+    #define _mm256_rolv_epi32          rmgr_fib_mm256_rolv_epi32
+    #define _mm256_rorv_epi32          rmgr_fib_mm256_rorv_epi32
+    #define _mm256_rolv_epi64          rmgr_fib_mm256_rolv_epi64
+    #define _mm256_rorv_epi64          rmgr_fib_mm256_rorv_epi64
+
+    template<int N>
+    static RMGR_FORCEINLINE __m256i rmgr_fib_mm256_rol_epi32(const __m256i& a) RMGR_NOEXCEPT
+    {
+        const int n = N & 31;
+        if (n == 0)
+            return a;
+        if (n % 8 == 0)
+            return rmgr_fib_mm256_rol_bytes<32, n / 8>(a);
+        return _mm256_or_si256(_mm256_slli_epi32(a, n), _mm256_srli_epi32(a, (32 - n) & 31));
+    }
+
+    template<int N>
+    static RMGR_FORCEINLINE __m256i rmgr_fib_mm256_rol_epi64(const __m256i& a) RMGR_NOEXCEPT
+    {
+        const int n = N & 63;
+        if (n == 0)
+            return a;
+        if (n == 32)
+            return _mm256_shuffle_epi32(a, _MM_SHUFFLE(2,3,0,1));
+        if (n % 8 == 0)
+            return rmgr_fib_mm256_rol_bytes<64, n / 8>(a);
+        return _mm256_or_si256(_mm256_slli_epi64(a, n), _mm256_srli_epi64(a, (64 - n) & 63));
+    }
+
+    static inline __m256i rmgr_fib_mm256_rolv_epi32(const __m256i& a, const __m256i& count) RMGR_NOEXCEPT
+    {
+        const __m256i n = _mm256_and_si256(count, _mm256_set1_epi32(31));
+        return _mm256_or_si256(_mm256_sllv_epi32(a, n), _mm256_srlv_epi32(a, _mm256_sub_epi32(_mm256_set1_epi32(32), n)));
+    }
+
+    static inline __m256i rmgr_fib_mm256_rorv_epi32(const __m256i& a, const __m256i& count) RMGR_NOEXCEPT
+    {
+        return rmgr_fib_mm256_rolv_epi32(a, _mm256_sub_epi32(_mm256_setzero_si256(), count));
+    }
+
+    static inline __m256i rmgr_fib_mm256_rolv_epi64(const __m256i& a, const __m256i& count) RMGR_NOEXCEPT
+    {
+        const __m256i n = _mm256_and_si256(count, _mm256_set1_epi64x(63));
+        return _mm256_or_si256(_mm256_sllv_epi64(a, n), _mm256_srlv_epi64(a, _mm256_sub_epi64(_mm256_set1_epi64x(64), n)));
+    }
+
+    static inline __m256i rmgr_fib_mm256_rorv_epi64(const __m256i& a, const __m256i& count) RMGR_NOEXCEPT
+    {
+        return rmgr_fib_mm256_rolv_epi64(a, _mm256_sub_epi64(_mm256_setzero_si256(), count));
+    }
+#endif
+
+
+//=================================================================================================
+// Min & max
+
+// 64-bit signed
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    #define _mm256_min_epi64  rmgr_fib_mm256_min_epi64
+    #define _mm256_max_epi64  rmgr_fib_mm256_max_epi64
+
+    static inline __m256i rmgr_fib_mm256_min_epi64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+    {
+        const __m256i m = _mm256_cmpgt_epi64(a, b);
+        return INTERNAL_RMGR_FIB_SELECT256(m, b, a);
+    }
+
+    static inline __m256i rmgr_fib_mm256_max_epi64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+    {
+        const __m256i m = _mm256_cmpgt_epi64(a, b);
+        return INTERNAL_RMGR_FIB_SELECT256(m, a, b);
+    }
+#endif
+
+// 64-bit unsigned
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    #define _mm256_min_epu64  rmgr_fib_mm256_min_epu64
+    #define _mm256_max_epu64  rmgr_fib_mm256_max_epu64
+
+    static inline __m256i rmgr_fib_mm256_min_epu64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+    {
+        const __m256i m = _mm256_cmpgt_epu64(a, b);
+        return INTERNAL_RMGR_FIB_SELECT256(m, b, a);
+    }
+
+    static inline __m256i rmgr_fib_mm256_max_epu64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+    {
+        const __m256i m = _mm256_cmpgt_epu64(a, b);
+        return INTERNAL_RMGR_FIB_SELECT256(m, a, b);
+    }
+#endif
+
+
+//=================================================================================================
+// Absolute value
+
+// 64-bit
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    #define _mm256_abs_epi64  rmgr_fib_mm256_abs_epi64
+
+    static inline __m256i rmgr_fib_mm256_abs_epi64(const __m256i& a) RMGR_NOEXCEPT
+    {
+        // _mm256_blendv_pd() only looks at the sign bits, which saves computing a mask
+        const __m256d neg = _mm256_castsi256_pd(_mm256_sub_epi64(_mm256_setzero_si256(), a));
+        return _mm256_castpd_si256(_mm256_blendv_pd(_mm256_castsi256_pd(a), neg, _mm256_castsi256_pd(a)));
+    }
+#endif
+
+
+//=================================================================================================
+// Absolute difference
+//
+// Same semantics as their 128-bit counterparts, see sse.h. AVX2 has min & max up to 32-bit lanes.
+
+// Negates the lanes of b - a where a > b, given as a mask
+#define INTERNAL_RMGR_FIB_ABSDIFF256_EPI64(a, b, gt)  _mm256_sub_epi64(_mm256_xor_si256(_mm256_sub_epi64((b), (a)), (gt)), (gt))
+
+// 8-bit
+static RMGR_FORCEINLINE __m256i _mm256_absdiff_epu8(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_absdiff_epi8(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_sub_epi8(_mm256_max_epi8(a, b), _mm256_min_epi8(a, b));
+}
+
+// 16-bit
+static RMGR_FORCEINLINE __m256i _mm256_absdiff_epu16(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_or_si256(_mm256_subs_epu16(a, b), _mm256_subs_epu16(b, a));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_absdiff_epi16(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_sub_epi16(_mm256_max_epi16(a, b), _mm256_min_epi16(a, b));
+}
+
+// 32-bit
+static RMGR_FORCEINLINE __m256i _mm256_absdiff_epu32(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_sub_epi32(_mm256_max_epu32(a, b), _mm256_min_epu32(a, b));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_absdiff_epi32(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_sub_epi32(_mm256_max_epi32(a, b), _mm256_min_epi32(a, b));
+}
+
+// 64-bit
+static RMGR_FORCEINLINE __m256i _mm256_absdiff_epu64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm256_sub_epi64(_mm256_max_epu64(a, b), _mm256_min_epu64(a, b));
+#else
+    return INTERNAL_RMGR_FIB_ABSDIFF256_EPI64(a, b, _mm256_cmpgt_epu64(a, b));
+#endif
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_absdiff_epi64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm256_sub_epi64(_mm256_max_epi64(a, b), _mm256_min_epi64(a, b));
+#else
+    return INTERNAL_RMGR_FIB_ABSDIFF256_EPI64(a, b, _mm256_cmpgt_epi64(a, b));
+#endif
+}
+
+#undef INTERNAL_RMGR_FIB_ABSDIFF256_EPI64
+
+// Sums of absolute differences
+static inline __m256i _mm256_sad_epu16(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    // Sum the low and high bytes separately with psadbw, then recombine them
+    const __m256i d    = _mm256_absdiff_epu16(a, b);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lo   = _mm256_sad_epu8(_mm256_and_si256(d, _mm256_set1_epi16(0x00FF)), zero);
+    const __m256i hi   = _mm256_sad_epu8(_mm256_srli_epi16(d, 8), zero);
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 8));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_sad_epu32(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    const __m256i d = _mm256_absdiff_epu32(a, b);
+    return _mm256_add_epi64(_mm256_and_si256(d, _mm256_set1_epi64x(0xFFFFFFFF)), _mm256_srli_epi64(d, 32));
+}
+
+
+//=================================================================================================
+// Averages
+//
+// Same semantics as their 128-bit counterparts, see sse.h.
+
+// 8-bit
+static RMGR_FORCEINLINE __m256i _mm256_avg_epi8(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    const __m256i flip = _mm256_set1_epi8(-128);
+    return _mm256_xor_si256(_mm256_avg_epu8(_mm256_xor_si256(a, flip), _mm256_xor_si256(b, flip)), flip);
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_avg_floor_epu8(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    // Undo the rounding where the sum is odd
+    return _mm256_sub_epi8(_mm256_avg_epu8(a, b), _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_set1_epi8(1)));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_avg_floor_epi8(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    const __m256i flip = _mm256_set1_epi8(-128);
+    return _mm256_xor_si256(_mm256_avg_floor_epu8(_mm256_xor_si256(a, flip), _mm256_xor_si256(b, flip)), flip);
+}
+
+// 16-bit
+static RMGR_FORCEINLINE __m256i _mm256_avg_epi16(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    const __m256i flip = _mm256_set1_epi16(-0x8000);
+    return _mm256_xor_si256(_mm256_avg_epu16(_mm256_xor_si256(a, flip), _mm256_xor_si256(b, flip)), flip);
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_avg_floor_epu16(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    // Undo the rounding where the sum is odd
+    return _mm256_sub_epi16(_mm256_avg_epu16(a, b), _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_set1_epi16(1)));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_avg_floor_epi16(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_add_epi16(_mm256_and_si256(a, b), _mm256_srai_epi16(_mm256_xor_si256(a, b), 1));
+}
+
+// 32-bit
+static RMGR_FORCEINLINE __m256i _mm256_avg_epu32(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_sub_epi32(_mm256_or_si256(a, b), _mm256_srli_epi32(_mm256_xor_si256(a, b), 1));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_avg_epi32(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_sub_epi32(_mm256_or_si256(a, b), _mm256_srai_epi32(_mm256_xor_si256(a, b), 1));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_avg_floor_epu32(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_add_epi32(_mm256_and_si256(a, b), _mm256_srli_epi32(_mm256_xor_si256(a, b), 1));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_avg_floor_epi32(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_add_epi32(_mm256_and_si256(a, b), _mm256_srai_epi32(_mm256_xor_si256(a, b), 1));
+}
+
+// 64-bit
+static RMGR_FORCEINLINE __m256i _mm256_avg_epu64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_sub_epi64(_mm256_or_si256(a, b), _mm256_srli_epi64(_mm256_xor_si256(a, b), 1));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_avg_epi64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_sub_epi64(_mm256_or_si256(a, b), _mm256_srai_epi64(_mm256_xor_si256(a, b), 1));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_avg_floor_epu64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_add_epi64(_mm256_and_si256(a, b), _mm256_srli_epi64(_mm256_xor_si256(a, b), 1));
+}
+
+static RMGR_FORCEINLINE __m256i _mm256_avg_floor_epi64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return _mm256_add_epi64(_mm256_and_si256(a, b), _mm256_srai_epi64(_mm256_xor_si256(a, b), 1));
+}
+
+
+//=================================================================================================
+// Multiplication
+//
+// See sse.h as to why _mm256_mullo_epi32() isn't used.
+
+// 64-bit low
+#if !(INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define _mm256_mullo_epi64  rmgr_fib_mm256_mullo_epi64
+
+    static inline __m256i rmgr_fib_mm256_mullo_epi64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+    {
+        // _mm256_mul_epu32() ignores the upper halves, so a shuffle is enough to bring them down
+        const __m256i aHi   = _mm256_shuffle_epi32(a, _MM_SHUFFLE(3,3,1,1));
+        const __m256i bHi   = _mm256_shuffle_epi32(b, _MM_SHUFFLE(3,3,1,1));
+        const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(aHi, b), _mm256_mul_epu32(a, bHi));
+        return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32));
+    }
+#endif
+
+// 64-bit unsigned high
+static inline __m256i _mm256_mulhi_epu64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    const __m256i aHi = _mm256_shuffle_epi32(a, _MM_SHUFFLE(3,3,1,1));
+    const __m256i bHi = _mm256_shuffle_epi32(b, _MM_SHUFFLE(3,3,1,1));
+    const __m256i ll  = _mm256_mul_epu32(a,   b);
+    const __m256i lh  = _mm256_mul_epu32(a,   bHi);
+    const __m256i hl  = _mm256_mul_epu32(aHi, b);
+    const __m256i hh  = _mm256_mul_epu32(aHi, bHi);
+
+    // None of the following sums can overflow: (2^32-1)^2 + 2*(2^32-1) < 2^64
+    const __m256i t   = _mm256_add_epi64(hl, _mm256_srli_epi64(ll, 32));
+    const __m256i tLo = _mm256_blend_epi32(t, _mm256_setzero_si256(), 0xAA);
+    const __m256i u   = _mm256_add_epi64(lh, tLo);
+    return _mm256_add_epi64(_mm256_add_epi64(hh, _mm256_srli_epi64(t, 32)), _mm256_srli_epi64(u, 32));
+}
+
+// 64-bit signed high
+static inline __m256i _mm256_mulhi_epi64(const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    // Signed high product = unsigned high product - (a<0 ? b : 0) - (b<0 ? a : 0)
+    const __m256i hi = _mm256_mulhi_epu64(a, b);
+    const __m256i sa = _mm256_cmpgt_epi64(_mm256_setzero_si256(), a);
+    const __m256i sb = _mm256_cmpgt_epi64(_mm256_setzero_si256(), b);
+    return _mm256_sub_epi64(hi, _mm256_add_epi64(_mm256_and_si256(sa, b), _mm256_and_si256(sb, a)));
+}
+
+
+//=================================================================================================
+// Population count
+//
+// See sse.h for the details.
+
+#if !(INTERNAL_RMGR_FIB_USE_AVX512BITALG && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define _mm256_popcnt_epi8   rmgr_fib_mm256_popcnt_epi8
+    #define _mm256_popcnt_epi16  rmgr_fib_mm256_popcnt_epi16
+
+    // 8-bit
+    static inline __m256i rmgr_fib_mm256_popcnt_epi8(const __m256i& a) RMGR_NOEXCEPT
+    {
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+        const __m256i table  = _mm256_setr_epi8(0,1,1,2, 1,2,2,3, 1,2,2,3, 2,3,3,4, 0,1,1,2, 1,2,2,3, 1,2,2,3, 2,3,3,4);
+        const __m256i lo     = _mm256_shuffle_epi8(table, _mm256_and_si256(a, nibble));
+        const __m256i hi     = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(a, 4), nibble));
+        return _mm256_add_epi8(lo, hi);
+    }
+
+    // 16-bit
+    static inline __m256i rmgr_fib_mm256_popcnt_epi16(const __m256i& a) RMGR_NOEXCEPT
+    {
+        return _mm256_maddubs_epi16(rmgr_fib_mm256_popcnt_epi8(a), _mm256_set1_epi8(1));
+    }
+#endif
+
+#if !(INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define _mm256_popcnt_epi32  rmgr_fib_mm256_popcnt_epi32
+    #define _mm256_popcnt_epi64  rmgr_fib_mm256_popcnt_epi64
+
+    // 32-bit
+    static inline __m256i rmgr_fib_mm256_popcnt_epi32(const __m256i& a) RMGR_NOEXCEPT
+    {
+        return _mm256_madd_epi16(_mm256_popcnt_epi16(a), _mm256_set1_epi16(1));
+    }
+
+    // 64-bit
+    static inline __m256i rmgr_fib_mm256_popcnt_epi64(const __m256i& a) RMGR_NOEXCEPT
+    {
+        return _mm256_sad_epu8(_mm256_popcnt_epi8(a), _mm256_setzero_si256());
+    }
+#endif
+
+
+//=================================================================================================
+// Leading & trailing zero counts
+//
+// See sse.h for the details.
+
+// 8-bit
+static inline __m256i _mm256_lzcnt_epi8(const __m256i& a) RMGR_NOEXCEPT
+{
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i table  = _mm256_setr_epi8(4,3,2,2, 1,1,1,1, 0,0,0,0, 0,0,0,0, 4,3,2,2, 1,1,1,1, 0,0,0,0, 0,0,0,0);
+    const __m256i hi     = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(a, 4), nibble));
+    const __m256i lo     = _mm256_shuffle_epi8(table, _mm256_and_si256(a, nibble));
+    return _mm256_add_epi8(hi, _mm256_and_si256(lo, _mm256_cmpeq_epi8(hi, _mm256_set1_epi8(4))));
+}
+
+static inline __m256i _mm256_tzcnt_epi8(const __m256i& a) RMGR_NOEXCEPT
+{
+    return _mm256_popcnt_epi8(_mm256_andnot_si256(a, _mm256_sub_epi8(a, _mm256_set1_epi8(1))));
+}
+
+// 16-bit
+static inline __m256i _mm256_lzcnt_epi16(const __m256i& a) RMGR_NOEXCEPT
+{
+    // Unpacking and packing both work within 128-bit halves, so the lanes end up in place
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lo   = _mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(_mm256_unpacklo_epi16(a, zero))), 23);
+    const __m256i hi   = _mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(_mm256_unpackhi_epi16(a, zero))), 23);
+    return _mm256_min_epi16(_mm256_sub_epi16(_mm256_set1_epi16(127 + 15), _mm256_packs_epi32(lo, hi)), _mm256_set1_epi16(16));
+}
+
+static inline __m256i _mm256_tzcnt_epi16(const __m256i& a) RMGR_NOEXCEPT
+{
+    return _mm256_popcnt_epi16(_mm256_andnot_si256(a, _mm256_sub_epi16(a, _mm256_set1_epi16(1))));
+}
+
+// 32 & 64-bit leading zeros
+#if !(INTERNAL_RMGR_FIB_USE_AVX512CD && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define _mm256_lzcnt_epi32  rmgr_fib_mm256_lzcnt_epi32
+    #define _mm256_lzcnt_epi64  rmgr_fib_mm256_lzcnt_epi64
+
+    static inline __m256i rmgr_fib_mm256_lzcnt_epi32(const __m256i& a) RMGR_NOEXCEPT
+    {
+        const __m256i x = _mm256_andnot_si256(_mm256_srli_epi32(a, 1), a);
+        const __m256i e = _mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(x)), 23);
+        const __m256i n = _mm256_min_epi32(_mm256_sub_epi32(_mm256_set1_epi32(127 + 31), e), _mm256_set1_epi32(32));
+        return _mm256_andnot_si256(_mm256_srai_epi32(a, 31), n);
+    }
+
+    static inline __m256i rmgr_fib_mm256_lzcnt_epi64(const __m256i& a) RMGR_NOEXCEPT
+    {
+        const __m256i n  = rmgr_fib_mm256_lzcnt_epi32(a);
+        const __m256i hi = _mm256_srli_epi64(n, 32);
+        return _mm256_add_epi64(hi, _mm256_and_si256(n, _mm256_cmpeq_epi32(hi, _mm256_set1_epi32(32))));
+    }
+#endif
+
+// 32 & 64-bit trailing zeros
+static inline __m256i _mm256_tzcnt_epi32(const __m256i& a) RMGR_NOEXCEPT
+{
+    const __m256i below = _mm256_andnot_si256(a, _mm256_sub_epi32(a, _mm256_set1_epi32(1)));
+#if INTERNAL_RMGR_FIB_USE_AVX512CD && INTERNAL_RMGR_FIB_USE_AVX512VL && !INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ
+    return _mm256_sub_epi32(_mm256_set1_epi32(32), _mm256_lzcnt_epi32(below));
+#else
+    return _mm256_popcnt_epi32(below);
+#endif
+}
+
+static inline __m256i _mm256_tzcnt_epi64(const __m256i& a) RMGR_NOEXCEPT
+{
+    const __m256i below = _mm256_andnot_si256(a, _mm256_sub_epi64(a, _mm256_set1_epi64x(1)));
+#if INTERNAL_RMGR_FIB_USE_AVX512CD && INTERNAL_RMGR_FIB_USE_AVX512VL && !INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ
+    return _mm256_sub_epi64(_mm256_set1_epi64x(64), _mm256_lzcnt_epi64(below));
+#else
+    return _mm256_popcnt_epi64(below);
+#endif
+}
+
+#endif // INTERNAL_RMGR_FIB_USE_AVX2
+
+
+RMGR_WARNING_POP()
+
+
+#endif // RMGR_FIB_AVX_H
@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2022, Romain Bailly
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef RMGR_FIB_DISPATCH_H
+#define RMGR_FIB_DISPATCH_H
+
+
+/*
+ * Runtime dispatch lets a single binary use the best instruction set available on the machine it
+ * runs on. The principle is the following:
+ *
+ *  1. A kernel is written against the `sse.h` API, inside the `RMGR_FIB_IS_NAMESPACE` namespace.
+ *  2. The kernel is compiled once per instruction set, with the matching `RMGR_FIB_ENABLE_*` macro
+ *     and compiler flags (the `rmgr_fib_target_variants()` CMake function takes care of that).
+ *     Each compilation yields a variant of the kernel in its own namespace (`sse2`, `sse41`...).
+ *  3. A dispatching function, compiled for the baseline instruction set, lists the variants from
+ *     best to worst and forwards to `RMGR_FIB_DISPATCH(variants)`. The first call selects the best
+ *     variant supported by the CPU; subsequent calls cost a single indirect call.
+ *
+ * Example:
+ *
+ *     // kernel.cpp, compiled once per instruction set
+ *     #include <rmgr/fib/dispatch.h>
+ *     namespace my { namespace RMGR_FIB_IS_NAMESPACE {
+ *         int sum(const int* values, size_t count) { ... }
+ *     }}
+ *
+ *     // dispatch.cpp, compiled once
+ *     #include <rmgr/fib/dispatch.h>
+ *     namespace my {
+ *         namespace avx2  { int sum(const int* values, size_t count); }
+ *         namespace sse41 { int sum(const int* values, size_t count); }
+ *         namespace sse2  { int sum(const int* values, size_t count); }
+ *
+ *         static const rmgr::fib::variant<int(const int*, size_t)> sum_variants[] =
+ *         {
+ *             { rmgr::fib::CPU_AVX2,  &avx2::sum  },
+ *             { rmgr::fib::CPU_SSE41, &sse41::sum },
+ *             { rmgr::fib::CPU_SSE2,  &sse2::sum  },
+ *         };
+ *
+ *         int sum(const int* values, size_t count)
+ *         {
+ *             return RMGR_FIB_DISPATCH(sum_variants)(values, count);
+ *         }
+ *     }
+ *
+ * Everything in this file has internal linkage or lives in `RMGR_FIB_IS_NAMESPACE`, so that
+ * translation units compiled with different flags never get their definitions mixed up by the linker.
+ */
+
+
+#include "sse.h"
+#include <cstddef>
+#if RMGR_COMPILER_IS_MSVC
+    #include <intrin.h>
+#else
+    #include <cpuid.h>
+#endif
+#if RMGR_CPP_VERSION >= RMGR_CPP_VERSION_2011
+    #include <atomic>
+#endif
+
+
+//=================================================================================================
+// Variant naming
+
+/**
+ * @brief Name of the namespace holding the kernels compiled for the current instruction set
+ */
+#ifndef RMGR_FIB_IS_NAMESPACE
+    #if   INTERNAL_RMGR_FIB_USE_AVX512BW && INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL \
+       && INTERNAL_RMGR_FIB_USE_AVX512CD && INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ && INTERNAL_RMGR_FIB_USE_AVX512BITALG
+        #define RMGR_FIB_IS_NAMESPACE  avx512icl
+    #elif INTERNAL_RMGR_FIB_USE_AVX512BW && INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL
+        #define RMGR_FIB_IS_NAMESPACE  avx512bwdqvl
+    #elif INTERNAL_RMGR_FIB_USE_AVX512BW && INTERNAL_RMGR_FIB_USE_AVX512VL
+        #define RMGR_FIB_IS_NAMESPACE  avx512bwvl
+    #elif INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL
+        #define RMGR_FIB_IS_NAMESPACE  avx512dqvl
+    #elif INTERNAL_RMGR_FIB_USE_AVX512VL
+        #define RMGR_FIB_IS_NAMESPACE  avx512vl
+    #elif INTERNAL_RMGR_FIB_USE_AVX512DQ
+        #define RMGR_FIB_IS_NAMESPACE  avx512dq
+    #elif INTERNAL_RMGR_FIB_USE_AVX512BW
+        #define RMGR_FIB_IS_NAMESPACE  avx512bw
+    #elif INTERNAL_RMGR_FIB_USE_AVX512F
+        #define RMGR_FIB_IS_NAMESPACE  avx512f
+    #elif INTERNAL_RMGR_FIB_USE_AVX2
+        #define RMGR_FIB_IS_NAMESPACE  avx2
+    #elif INTERNAL_RMGR_FIB_USE_FMA
+        #define RMGR_FIB_IS_NAMESPACE  fma
+    #elif INTERNAL_RMGR_FIB_USE_AVX
+        #define RMGR_FIB_IS_NAMESPACE  avx
+    #elif INTERNAL_RMGR_FIB_USE_SSE42
+        #define RMGR_FIB_IS_NAMESPACE  sse42
+    #elif INTERNAL_RMGR_FIB_USE_SSE41
+        #define RMGR_FIB_IS_NAMESPACE  sse41
+    #elif INTERNAL_RMGR_FIB_USE_SSSE3
+        #define RMGR_FIB_IS_NAMESPACE  ssse3
+    #elif INTERNAL_RMGR_FIB_USE_SSE3
+        #define RMGR_FIB_IS_NAMESPACE  sse3
+    #else
+        #define RMGR_FIB_IS_NAMESPACE  sse2
+    #endif
+#endif
+
+/**
+ * @brief The CPU features required by the code compiled for the current instruction set
+ */
+#define RMGR_FIB_REQUIRED_CPU_FEATURES                                                  \
+    (  (INTERNAL_RMGR_FIB_USE_SSE2            ? ::rmgr::fib::CPU_SSE2            : 0u) \
+     | (INTERNAL_RMGR_FIB_USE_SSE3            ? ::rmgr::fib::CPU_SSE3            : 0u) \
+     | (INTERNAL_RMGR_FIB_USE_SSSE3           ? ::rmgr::fib::CPU_SSSE3           : 0u) \
+     | (INTERNAL_RMGR_FIB_USE_SSE41           ? ::rmgr::fib::CPU_SSE41           : 0u) \
+     | (INTERNAL_RMGR_FIB_USE_SSE42           ? ::rmgr::fib::CPU_SSE42           : 0u) \
+     | (INTERNAL_RMGR_FIB_USE_AVX             ? ::rmgr::fib::CPU_AVX             : 0u) \
+     | (INTERNAL_RMGR_FIB_USE_FMA             ? ::rmgr::fib::CPU_FMA             : 0u) \
+     | (INTERNAL_RMGR_FIB_USE_AVX2            ? ::rmgr::fib::CPU_AVX2            : 0u) \
+     | (INTERNAL_RMGR_FIB_USE_AVX512F         ? ::rmgr::fib::CPU_AVX512F         : 0u) \
+     | (INTERNAL_RMGR_FIB_USE_AVX512DQ        ? ::rmgr::fib::CPU_AVX512DQ        : 0u) \
+     | (INTERNAL_RMGR_FIB_USE_AVX512VL        ? ::rmgr::fib::CPU_AVX512VL        : 0u) \
+     | (INTERNAL_RMGR_FIB_USE_AVX512BW        ? ::rmgr::fib::CPU_AVX512BW        : 0u) \
+     | (INTERNAL_RMGR_FIB_USE_AVX512CD        ? ::rmgr::fib::CPU_AVX512CD        : 0u) \
+     | (INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ ? ::rmgr::fib::CPU_AVX512VPOPCNTDQ : 0u) \
+     | (INTERNAL_RMGR_FIB_USE_AVX512BITALG    ? ::rmgr::fib::CPU_AVX512BITALG    : 0u))
+
+
+namespace rmgr { namespace fib {
+
+
+//=================================================================================================
+// CPU detection
+
+/// CPU features, as reported by `cpu_features()`
+enum cpu_feature
+{
+    CPU_SSE2            = 1u <<  0,
+    CPU_SSE3            = 1u <<  1,
+    CPU_SSSE3           = 1u <<  2,
+    CPU_SSE41           = 1u <<  3,
+    CPU_SSE42           = 1u <<  4,
+    CPU_AVX             = 1u <<  5, ///< Only reported if the OS saves the YMM registers
+    CPU_FMA             = 1u <<  6, ///< Only reported if the OS saves the YMM registers
+    CPU_AVX2            = 1u <<  7, ///< Only reported if the OS saves the YMM registers
+    CPU_AVX512F         = 1u <<  8, ///< Only reported if the OS saves the ZMM and opmask registers
+    CPU_AVX512DQ        = 1u <<  9, ///< Only reported if the OS saves the ZMM and opmask registers
+    CPU_AVX512VL        = 1u << 10, ///< Only reported if the OS saves the ZMM and opmask registers
+    CPU_AVX512BW        = 1u << 11, ///< Only reported if the OS saves the ZMM and opmask registers
+    CPU_AVX512VPOPCNTDQ = 1u << 12, ///< Only reported if the OS saves the ZMM and opmask registers
+    CPU_AVX512BITALG    = 1u << 13, ///< Only reported if the OS saves the ZMM and opmask registers
+    CPU_AVX512CD        = 1u << 14  ///< Only reported if the OS saves the ZMM and opmask registers
+};
+
+namespace internal {
+
+static inline void cpuid(uint32_t regs[4], uint32_t leaf, uint32_t subleaf) RMGR_NOEXCEPT
+{
+#if RMGR_COMPILER_IS_MSVC
+    int r[4];
+    __cpuidex(r, int(leaf), int(subleaf));
+    regs[0] = uint32_t(r[0]);
+    regs[1] = uint32_t(r[1]);
+    regs[2] = uint32_t(r[2]);
+    regs[3] = uint32_t(r[3]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+/// Reads the XCR0 register, telling which register states the OS saves on context switches
+static inline uint64_t xgetbv0() RMGR_NOEXCEPT
+{
+#if RMGR_COMPILER_IS_MSVC
+    return _xgetbv(0);
+#else
+    // Spelled out rather than using _xgetbv(), which requires -mxsave
+    uint32_t eax, edx;
+    __asm__ volatile(".byte 0x0F, 0x01, 0xD0" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (uint64_t(edx) << 32) | eax;
+#endif
+}
+
+static inline uint32_t detect_cpu_features() RMGR_NOEXCEPT
+{
+    uint32_t regs[4];
+    cpuid(regs, 0, 0);
+    const uint32_t maxLeaf = regs[0];
+    if (maxLeaf < 1)
+        return 0;
+
+    uint32_t features = 0;
+    cpuid(regs, 1, 0);
+    const uint32_t ecx1 = regs[2];
+    const uint32_t edx1 = regs[3];
+    if (edx1 & (1u << 26))  features |= CPU_SSE2;
+    if (ecx1 & (1u <<  0))  features |= CPU_SSE3;
+    if (ecx1 & (1u <<  9))  features |= CPU_SSSE3;
+    if (ecx1 & (1u << 19))  features |= CPU_SSE41;
+    if (ecx1 & (1u << 20))  features |= CPU_SSE42;
+
+    // AVX and later are unusable unless the OS saves the extended register states (OSXSAVE)
+    if (!(ecx1 & (1u << 27)))
+        return features;
+    const uint64_t xcr0      = xgetbv0();
+    const bool     ymmState  = ((xcr0 & 0x06) == 0x06); // XMM & YMM
+    const bool     zmmState  = ((xcr0 & 0xE6) == 0xE6); // XMM, YMM, opmask, ZMM_Hi256 & Hi16_ZMM
+    if (!ymmState)
+        return features;
+    if (ecx1 & (1u << 28))  features |= CPU_AVX;
+    if (ecx1 & (1u << 12))  features |= CPU_FMA;
+
+    if (maxLeaf < 7)
+        return features;
+    cpuid(regs, 7, 0);
+    const uint32_t ebx7 = regs[1];
+    const uint32_t ecx7 = regs[2];
+    if (ebx7 & (1u <<  5))  features |= CPU_AVX2;
+    if (zmmState)
+    {
+        if (ebx7 & (1u << 16))  features |= CPU_AVX512F;
+        if (ebx7 & (1u << 17))  features |= CPU_AVX512DQ;
+        if (ebx7 & (1u << 28))  features |= CPU_AVX512CD;
+        if (ebx7 & (1u << 30))  features |= CPU_AVX512BW;
+        if (ebx7 & (1u << 31))  features |= CPU_AVX512VL;
+        if (ecx7 & (1u << 12))  features |= CPU_AVX512BITALG;
+        if (ecx7 & (1u << 14))  features |= CPU_AVX512VPOPCNTDQ;
+    }
+    return features;
+}
+
+} // namespace internal
+
+
+/**
+ * @brief Returns the features supported by the CPU, as a combination of `cpu_feature` flags
+ *
+ * Detection is performed once, on first call.
+ */
+static inline uint32_t cpu_features() RMGR_NOEXCEPT
+{
+    static const uint32_t features = internal::detect_cpu_features();
+    return features;
+}
+
+/// Returns whether the CPU supports all the specified features
+static inline bool cpu_supports(uint32_t features) RMGR_NOEXCEPT
+{
+    return (cpu_features() & features) == features;
+}
+
+
+//=================================================================================================
+// Dispatch
+
+/// A variant of a kernel, along with the CPU features it requires
+template<typename Function>
+struct variant
+{
+    uint32_t  features; ///< Combination of `cpu_feature` flags
+    Function* function;
+};
+
+/**
+ * @brief Selects the first variant supported by the CPU
+ *
+ * The last variant is the baseline: it is selected when no other is supported, even if the CPU
+ * lacks its features, so that the result is never null. It should require nothing beyond SSE2.
+ *
+ * @param variants  The variants, from best to worst
+ * @return The selected function
+ */
+template<typename Function, size_t N>
+static inline Function* select_variant(const variant<Function> (&variants)[N]) RMGR_NOEXCEPT
+{
+    const uint32_t supported = cpu_features();
+    for (size_t i=0; i<N-1; ++i)
+    {
+        if ((variants[i].features & supported) == variants[i].features)
+            return variants[i].function;
+    }
+    return variants[N-1].function;
+}
+
+
+#if RMGR_CPP_VERSION >= RMGR_CPP_VERSION_2011
+
+    namespace internal {
+
+    template<typename Variants, Variants& variants>
+    class dispatcher;
+
+    template<typename R, typename... Args, size_t N, const variant<R(Args...)> (&variants)[N]>
+    class dispatcher<const variant<R(Args...)>[N], variants>
+    {
+    public:
+
+        typedef R (*function_ptr)(Args...);
+
+        static RMGR_FORCEINLINE function_ptr get() RMGR_NOEXCEPT
+        {
+            return s_function.load(std::memory_order_relaxed);
+        }
+
+    private:
+
+        // Initial value of s_function: binds the best variant then forwards the call to it.
+        // Concurrent first calls all store the same pointer, hence the relaxed ordering.
+        static R resolve(Args... args)
+        {
+            const function_ptr function = select_variant(variants);
+            s_function.store(function, std::memory_order_relaxed);
+            return function(static_cast<Args&&>(args)...);
+        }
+
+        static std::atomic<function_ptr> s_function;
+    };
+
+    template<typename R, typename... Args, size_t N, const variant<R(Args...)> (&variants)[N]>
+    std::atomic<R(*)(Args...)> dispatcher<const variant<R(Args...)>[N], variants>::s_function(&dispatcher::resolve);
+
+    } // namespace internal
+
+    /**
+     * @brief Returns the function to call for a given array of variants
+     *
+     * The array must have static storage duration. On first call, the returned function selects the
+     * best variant and binds it, so that subsequent calls go straight to the selected variant.
+     */
+    #define RMGR_FIB_DISPATCH(variants)  (::rmgr::fib::internal::dispatcher<decltype(variants), variants>::get())
+
+#endif
+
+
+}} // namespace rmgr::fib
+
+
+#endif // RMGR_FIB_DISPATCH_H
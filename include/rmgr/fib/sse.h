@@ -31,9 +31,14 @@
  *  - RMGR_FIB_ENABLE_SSE42
  *  - RMGR_FIB_ENABLE_AVX
  *  - RMGR_FIB_ENABLE_FMA
+ *  - RMGR_FIB_ENABLE_AVX2
  *  - RMGR_FIB_ENABLE_AVX512F
  *  - RMGR_FIB_ENABLE_AVX512VL
  *  - RMGR_FIB_ENABLE_AVX512DQ
+ *  - RMGR_FIB_ENABLE_AVX512BW
+ *  - RMGR_FIB_ENABLE_AVX512CD
+ *  - RMGR_FIB_ENABLE_AVX512VPOPCNTDQ
+ *  - RMGR_FIB_ENABLE_AVX512BITALG
  *
  * If none of the above is defined, auto-configuration will be performed. Auto-configuration is reliable
  * with GCC and Clang but not so much with Visual C++, so you are encouraged to always use manual
@@ -264,7 +269,9 @@
 
 // Auto-detection
 #if    !defined(RMGR_FIB_ENABLE_SSE2) && !defined(RMGR_FIB_ENABLE_SSE3) && !defined(RMGR_FIB_ENABLE_SSSE3)   && !defined(RMGR_FIB_ENABLE_SSE41)    && !defined(RMGR_FIB_ENABLE_SSE42) \
-    && !defined(RMGR_FIB_ENABLE_AVX)  && !defined(RMGR_FIB_ENABLE_FMA)  && !defined(RMGR_FIB_ENABLE_AVX512F) && !defined(RMGR_FIB_ENABLE_AVX512VL) && !defined(RMGR_FIB_ENABLE_AVX512DQ)
+    && !defined(RMGR_FIB_ENABLE_AVX)  && !defined(RMGR_FIB_ENABLE_FMA)  && !defined(RMGR_FIB_ENABLE_AVX2)    && !defined(RMGR_FIB_ENABLE_AVX512F)  && !defined(RMGR_FIB_ENABLE_AVX512VL) \
+    && !defined(RMGR_FIB_ENABLE_AVX512DQ) && !defined(RMGR_FIB_ENABLE_AVX512BW) && !defined(RMGR_FIB_ENABLE_AVX512CD) \
+    && !defined(RMGR_FIB_ENABLE_AVX512VPOPCNTDQ) && !defined(RMGR_FIB_ENABLE_AVX512BITALG)
 
     #if defined(__SSE2__) || INTERNAL_RMGR_FIB_USE_SSE3
         #define INTERNAL_RMGR_FIB_USE_SSE2      1
@@ -299,6 +306,18 @@
     #if defined(__AVX512VL__)
         #define INTERNAL_RMGR_FIB_USE_AVX512VL  1
     #endif
+    #if defined(__AVX512BW__)
+        #define INTERNAL_RMGR_FIB_USE_AVX512BW  1
+    #endif
+    #if defined(__AVX512CD__)
+        #define INTERNAL_RMGR_FIB_USE_AVX512CD         1
+    #endif
+    #if defined(__AVX512VPOPCNTDQ__)
+        #define INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ  1
+    #endif
+    #if defined(__AVX512BITALG__)
+        #define INTERNAL_RMGR_FIB_USE_AVX512BITALG     1
+    #endif
 
  // Manual configuration
  #else
@@ -322,7 +341,7 @@
         #define INTERNAL_RMGR_FIB_USE_AVX       RMGR_FIB_ENABLE_AVX
     #endif
     #if defined(RMGR_FIB_ENABLE_FMA)
-        #define INTERNAL_RMGR_FIB_USE_FMA       RMGR_FIB_ENABLE_AVX512F
+        #define INTERNAL_RMGR_FIB_USE_FMA       RMGR_FIB_ENABLE_FMA
     #endif
     #if defined(RMGR_FIB_ENABLE_AVX2)
         #define INTERNAL_RMGR_FIB_USE_AVX2      RMGR_FIB_ENABLE_AVX2
@@ -336,18 +355,42 @@
     #if defined(RMGR_FIB_ENABLE_AVX512VL)
         #define INTERNAL_RMGR_FIB_USE_AVX512VL  RMGR_FIB_ENABLE_AVX512VL
     #endif
+    #if defined(RMGR_FIB_ENABLE_AVX512BW)
+        #define INTERNAL_RMGR_FIB_USE_AVX512BW  RMGR_FIB_ENABLE_AVX512BW
+    #endif
+    #if defined(RMGR_FIB_ENABLE_AVX512CD)
+        #define INTERNAL_RMGR_FIB_USE_AVX512CD         RMGR_FIB_ENABLE_AVX512CD
+    #endif
+    #if defined(RMGR_FIB_ENABLE_AVX512VPOPCNTDQ)
+        #define INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ  RMGR_FIB_ENABLE_AVX512VPOPCNTDQ
+    #endif
+    #if defined(RMGR_FIB_ENABLE_AVX512BITALG)
+        #define INTERNAL_RMGR_FIB_USE_AVX512BITALG     RMGR_FIB_ENABLE_AVX512BITALG
+    #endif
 #endif
 
 
 // Instruction set dependencies
+#ifndef INTERNAL_RMGR_FIB_USE_AVX512CD
+    #define INTERNAL_RMGR_FIB_USE_AVX512CD         0
+#endif
+#ifndef INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ
+    #define INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ  0
+#endif
+#ifndef INTERNAL_RMGR_FIB_USE_AVX512BITALG
+    #define INTERNAL_RMGR_FIB_USE_AVX512BITALG     0
+#endif
 #ifndef INTERNAL_RMGR_FIB_USE_AVX512VL
     #define INTERNAL_RMGR_FIB_USE_AVX512VL  0
 #endif
 #ifndef INTERNAL_RMGR_FIB_USE_AVX512DQ
     #define INTERNAL_RMGR_FIB_USE_AVX512DQ  0
 #endif
+#ifndef INTERNAL_RMGR_FIB_USE_AVX512BW
+    #define INTERNAL_RMGR_FIB_USE_AVX512BW  INTERNAL_RMGR_FIB_USE_AVX512BITALG
+#endif
 #ifndef INTERNAL_RMGR_FIB_USE_AVX512F
-    #define INTERNAL_RMGR_FIB_USE_AVX512F   (INTERNAL_RMGR_FIB_USE_AVX512DQ || INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define INTERNAL_RMGR_FIB_USE_AVX512F   (INTERNAL_RMGR_FIB_USE_AVX512DQ || INTERNAL_RMGR_FIB_USE_AVX512VL || INTERNAL_RMGR_FIB_USE_AVX512BW || INTERNAL_RMGR_FIB_USE_AVX512CD || INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ)
 #endif
 #ifndef INTERNAL_RMGR_FIB_USE_AVX2
     #define INTERNAL_RMGR_FIB_USE_AVX2      INTERNAL_RMGR_FIB_USE_AVX512F
@@ -405,6 +448,18 @@
 #if INTERNAL_RMGR_FIB_USE_AVX512VL && !INTERNAL_RMGR_FIB_USE_AVX512F
     #error Configuration error, you cannot enable AVX512-VL while disabling AVX512-F
 #endif
+#if INTERNAL_RMGR_FIB_USE_AVX512BW && !INTERNAL_RMGR_FIB_USE_AVX512F
+    #error Configuration error, you cannot enable AVX512-BW while disabling AVX512-F
+#endif
+#if INTERNAL_RMGR_FIB_USE_AVX512CD && !INTERNAL_RMGR_FIB_USE_AVX512F
+    #error Configuration error, you cannot enable AVX512-CD while disabling AVX512-F
+#endif
+#if INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ && !INTERNAL_RMGR_FIB_USE_AVX512F
+    #error Configuration error, you cannot enable AVX512-VPOPCNTDQ while disabling AVX512-F
+#endif
+#if INTERNAL_RMGR_FIB_USE_AVX512BITALG && !INTERNAL_RMGR_FIB_USE_AVX512BW
+    #error Configuration error, you cannot enable AVX512-BITALG while disabling AVX512-BW
+#endif
 
 
 //=================================================================================================
@@ -446,7 +501,9 @@
 //=================================================================================================
 // Includes
 
-#if   INTERNAL_RMGR_FIB_USE_SSE42
+#if   INTERNAL_RMGR_FIB_USE_AVX
+    #include <immintrin.h>
+#elif INTERNAL_RMGR_FIB_USE_SSE42
     #include <nmmintrin.h>
 #elif INTERNAL_RMGR_FIB_USE_SSE41
     #include <smmintrin.h>
@@ -458,6 +515,7 @@
     #include <emmintrin.h>
 #endif
 #include <cstdint>
+#include <cstring>
 
 
 //=================================================================================================
@@ -470,7 +528,18 @@ RMGR_WARNING_MSVC_DISABLE(4505) // unreferenced function with internal linkage h
 //=================================================================================================
 // Utility stuff
 
-#if INTERNAL_RMGR_FIB_USE_SSE41
+// When targeting AVX-512BW+VL, GCC (at least up to 12) loses the inversion of the mask when
+// folding the blendv of an inverted byte comparison, which then selects the wrong operand. This
+// depends on what the compiler targets, not on which instructions the library was configured to
+// use, hence INTERNAL_RMGR_FIB_USE_AVX512BW/VL cannot detect it: an SSE4.1 build compiled with
+// -march=icelake-server is affected too. The bitwise form compiles to a single vpternlog anyway.
+#if RMGR_COMPILER_IS_GCC && defined(__AVX512BW__) && defined(__AVX512VL__)
+    #define INTERNAL_RMGR_FIB_GCC_BLENDV_BUG  1
+#else
+    #define INTERNAL_RMGR_FIB_GCC_BLENDV_BUG  0
+#endif
+
+#if INTERNAL_RMGR_FIB_USE_SSE41 && !INTERNAL_RMGR_FIB_GCC_BLENDV_BUG
     #define INTERNAL_RMGR_FIB_SELECT(mask, a, b)  _mm_blendv_epi8((b), (a), (mask))
 #else
     #define INTERNAL_RMGR_FIB_SELECT(mask, a, b)  _mm_or_si128(_mm_and_si128((mask),(a)), _mm_andnot_si128((mask),(b)))
@@ -480,384 +549,3825 @@ RMGR_WARNING_MSVC_DISABLE(4505) // unreferenced function with internal linkage h
 //=================================================================================================
 // Bitwise NOT and negation
 
-#define _mm_not_si128(a)  _mm_xor_si128((a), _mm_cmpeq_epi32((a),(a))
+static RMGR_FORCEINLINE __m128i _mm_not_si128(const __m128i& a) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm_ternarylogic_epi32(a, a, a, 0x55); // Doesn't need a register of all ones
+#else
+    return _mm_xor_si128(a, _mm_cmpeq_epi32(a,a));
+#endif
+}
 
-#define _mm_neg_epi8( a)  _mm_sub_epi8( _mm_setzero_si128(), (a))
-#define _mm_neg_epi16(a)  _mm_sub_epi16(_mm_setzero_si128(), (a))
-#define _mm_neg_epi32(a)  _mm_sub_epi32(_mm_setzero_si128(), (a))
-#define _mm_neg_epi64(a)  _mm_sub_epi64(_mm_setzero_si128(), (a))
-#define _mm_neg_epi64(a)  _mm_sub_epi64(_mm_setzero_si128(), (a))
-#define _mm_neg_epi64(a)  _mm_sub_epi64(_mm_setzero_si128(), (a))
-#define _mm_neg_ps(   a)  _mm_sub_ps(   _mm_setzero_ps(),    (a))
-#define _mm_neg_pd(   a)  _mm_sub_pd(   _mm_setzero_pd(),    (a))
+static RMGR_FORCEINLINE __m128i _mm_neg_epi8(const __m128i& a) RMGR_NOEXCEPT
+{
+    return _mm_sub_epi8(_mm_setzero_si128(), a);
+}
 
+static RMGR_FORCEINLINE __m128i _mm_neg_epi16(const __m128i& a) RMGR_NOEXCEPT
+{
+    return _mm_sub_epi16(_mm_setzero_si128(), a);
+}
 
-//=================================================================================================
-// 32-bit x86 compat layer
+static RMGR_FORCEINLINE __m128i _mm_neg_epi32(const __m128i& a) RMGR_NOEXCEPT
+{
+    return _mm_sub_epi32(_mm_setzero_si128(), a);
+}
 
-#if RMGR_ARCH_IS_X86_32
-    #define _mm_set_epi64x(e1,e0)  _mm_set_epi32(int32_t(int64_t(e1)>>32), int32_t(int64_t(e1)&UINT64_C(0xFFFFFFFF)), int32_t(int64_t(e0)>>32), int32_t(int64_t(e0)&UINT64_C(0xFFFFFFFF)))
-    #define _mm_set1_epi64x(a)     _mm_set_epi64x((a), (a))
-    #define _mm_cvtsi128_si64(a)   int64_t((uint64_t(_mm_extract_epi32((a),1)) << 32) | uint32_t(_mm_cvtsi128_si32(a)))
-#endif
+static RMGR_FORCEINLINE __m128i _mm_neg_epi64(const __m128i& a) RMGR_NOEXCEPT
+{
+    return _mm_sub_epi64(_mm_setzero_si128(), a);
+}
+
+static RMGR_FORCEINLINE __m128 _mm_neg_ps(const __m128& a) RMGR_NOEXCEPT
+{
+    return _mm_sub_ps(_mm_setzero_ps(), a);
+}
+
+static RMGR_FORCEINLINE __m128d _mm_neg_pd(const __m128d& a) RMGR_NOEXCEPT
+{
+    return _mm_sub_pd(_mm_setzero_pd(), a);
+}
 
 
 //=================================================================================================
-// Lane access
+// Ternary logic
+//
+// _mm_ternarylogic_epi32/64(a, b, c, imm8) compute any bitwise function of three inputs, bit
+// (a << 2 | b << 1 | c) of imm8 being the result for those input bits. Without AVX512-VL, each of
+// the 256 functions is one of its shortest and/or/xor/andnot expressions, as found by an
+// exhaustive search (NOT being a xor with all ones). None needs more than 5 operations, three
+// quarters of them need 3 or less. The expressions are written against the bitwise operations of
+// a register size, so that avx.h reuses them for 256 bits. pblendvb is of no help here, it only
+// looks at the MSB of each byte.
 
-#if !INTERNAL_RMGR_FIB_USE_SSE41
-    #define _mm_extract_epi8( a, imm8)  ((_mm_extract_epi16((a), (imm8)/2) >> (((imm8)%2)*8)) & 255)
-    #define _mm_extract_epi32(a, imm8)  _mm_cvtsi128_si32(_mm_srli_si128((a), (imm8)*4))
-    #define _mm_extract_epi64(a, imm8)  _mm_cvtsi128_si64(_mm_srli_si128((a), (imm8)*8))
-#endif
+// The bitwise operations of a register size (not type, GCC drops its attributes as a template argument)
+template<int size>
+struct rmgr_fib_bitwise;
 
-#if RMGR_ARCH_IS_X86_32 && INTERNAL_RMGR_FIB_USE_SSE41
-    #define _mm_extract_epi64(a, imm8)  int64_t((uint64_t(uint32_t(_mm_extract_epi32((a),2*(imm8)+1))) << 32) | uint32_t(_mm_extract_epi32((a), 2*(imm8))))
-#endif
+template<>
+struct rmgr_fib_bitwise<sizeof(__m128i)>
+{
+    static RMGR_FORCEINLINE __m128i zero()                                     RMGR_NOEXCEPT { return _mm_setzero_si128(); }
+    static RMGR_FORCEINLINE __m128i ones()                                     RMGR_NOEXCEPT { return _mm_set1_epi32(-1); }
+    static RMGR_FORCEINLINE __m128i not_(const __m128i& a)                     RMGR_NOEXCEPT { return _mm_xor_si128(a, ones()); }
+    static RMGR_FORCEINLINE __m128i and_(const __m128i& a, const __m128i& b)   RMGR_NOEXCEPT { return _mm_and_si128(a, b); }
+    static RMGR_FORCEINLINE __m128i or_(const __m128i& a, const __m128i& b)    RMGR_NOEXCEPT { return _mm_or_si128(a, b); }
+    static RMGR_FORCEINLINE __m128i xor_(const __m128i& a, const __m128i& b)   RMGR_NOEXCEPT { return _mm_xor_si128(a, b); }
+    static RMGR_FORCEINLINE __m128i andnot(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT { return _mm_andnot_si128(a, b); } // ~a & b
+};
 
+// The function whose truth table is imm
+template<int imm>
+struct rmgr_fib_ternarylogic;
 
-//=================================================================================================
-// Comparisons
+#define INTERNAL_RMGR_FIB_TERNARYLOGIC(imm, expr)                                                                     \
+    template<>                                                                                                        \
+    struct rmgr_fib_ternarylogic<imm>                                                                                 \
+    {                                                                                                                 \
+        template<typename op, typename Reg>                                                                           \
+        static RMGR_FORCEINLINE Reg apply(const Reg& a, const Reg& b, const Reg& c) RMGR_NOEXCEPT                     \
+        {                                                                                                             \
+            (void)a; (void)b; (void)c;                                                                                \
+            return expr;                                                                                              \
+        }                                                                                                             \
+    };
 
-// 8-bit signed
-#define _mm_cmpneq_epi8(a,b)   _mm_xor_si128(_mm_cmpeq_epi8((a),(b)), _mm_cmpeq_epi8((a),(a)))
-#define _mm_cmpge_epi8(a,b)    _mm_xor_si128(_mm_cmpgt_epi8((b),(a)), _mm_cmpeq_epi8((a),(a)))
-#define _mm_cmple_epi8(a,b)    _mm_cmpge_epi8((b), (a))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x00, op::zero())
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x01, op::andnot(op::or_(b, c), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x02, op::andnot(op::or_(a, b), c))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x03, op::not_(op::or_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x04, op::andnot(c, op::andnot(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x05, op::not_(op::or_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x06, op::andnot(a, op::xor_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x07, op::andnot(op::and_(b, c), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x08, op::and_(c, op::andnot(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x09, op::andnot(op::xor_(b, c), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x0A, op::andnot(a, c))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x0B, op::andnot(op::andnot(c, b), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x0C, op::andnot(a, b))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x0D, op::andnot(op::andnot(b, c), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x0E, op::andnot(a, op::or_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x0F, op::not_(a))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x10, op::andnot(c, op::andnot(b, a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x11, op::not_(op::or_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x12, op::andnot(b, op::xor_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x13, op::andnot(op::and_(a, c), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x14, op::andnot(c, op::xor_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x15, op::andnot(op::and_(a, b), op::not_(c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x16, op::xor_(op::or_(a, b), op::or_(c, op::and_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x17, op::andnot(op::and_(c, op::or_(a, b)), op::not_(op::and_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x18, op::and_(op::xor_(a, b), op::xor_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x19, op::xor_(op::andnot(op::and_(a, b), c), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x1A, op::andnot(op::and_(a, b), op::xor_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x1B, op::xor_(op::and_(c, op::xor_(a, b)), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x1C, op::andnot(op::and_(a, c), op::xor_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x1D, op::xor_(op::and_(b, op::xor_(a, c)), op::not_(c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x1E, op::xor_(a, op::or_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x1F, op::not_(op::and_(a, op::or_(b, c))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x20, op::and_(c, op::andnot(b, a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x21, op::andnot(op::xor_(a, c), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x22, op::andnot(b, c))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x23, op::andnot(op::andnot(c, a), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x24, op::andnot(op::xor_(a, c), op::xor_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x25, op::xor_(op::andnot(op::and_(a, b), c), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x26, op::andnot(op::and_(a, b), op::xor_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x27, op::xor_(op::and_(c, op::xor_(a, b)), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x28, op::and_(c, op::xor_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x29, op::andnot(op::xor_(c, op::or_(a, b)), op::not_(op::and_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x2A, op::andnot(op::and_(a, b), c))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x2B, op::andnot(op::andnot(c, op::or_(a, b)), op::not_(op::and_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x2C, op::andnot(op::andnot(c, a), op::xor_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x2D, op::xor_(op::andnot(b, c), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x2E, op::xor_(op::and_(a, b), op::or_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x2F, op::or_(op::andnot(b, c), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x30, op::andnot(b, a))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x31, op::andnot(op::andnot(a, c), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x32, op::andnot(b, op::or_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x33, op::not_(b))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x34, op::andnot(op::andnot(a, c), op::xor_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x35, op::xor_(op::and_(a, op::xor_(b, c)), op::not_(c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x36, op::xor_(b, op::or_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x37, op::not_(op::and_(b, op::or_(a, c))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x38, op::and_(op::or_(a, c), op::xor_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x39, op::xor_(op::andnot(a, c), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x3A, op::xor_(op::and_(a, b), op::or_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x3B, op::or_(op::andnot(a, c), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x3C, op::xor_(a, b))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x3D, op::xor_(op::andnot(b, op::or_(a, c)), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x3E, op::or_(op::andnot(a, c), op::xor_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x3F, op::not_(op::and_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x40, op::andnot(c, op::and_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x41, op::andnot(op::xor_(a, b), op::not_(c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x42, op::andnot(op::xor_(a, b), op::xor_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x43, op::xor_(op::andnot(op::and_(a, c), b), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x44, op::andnot(c, b))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x45, op::andnot(op::andnot(b, a), op::not_(c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x46, op::andnot(op::andnot(b, a), op::xor_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x47, op::xor_(op::and_(b, op::xor_(a, c)), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x48, op::and_(b, op::xor_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x49, op::xor_(op::andnot(op::andnot(b, a), c), op::not_(op::xor_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x4A, op::andnot(op::andnot(b, a), op::xor_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x4B, op::xor_(op::andnot(c, b), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x4C, op::andnot(op::and_(a, c), b))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x4D, op::xor_(op::andnot(op::xor_(a, b), c), op::not_(op::andnot(b, a))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x4E, op::xor_(op::and_(a, c), op::or_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x4F, op::or_(op::andnot(c, b), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x50, op::andnot(c, a))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x51, op::andnot(op::andnot(a, b), op::not_(c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x52, op::andnot(op::andnot(a, b), op::xor_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x53, op::xor_(op::and_(a, op::xor_(b, c)), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x54, op::andnot(c, op::or_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x55, op::not_(c))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x56, op::xor_(c, op::or_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x57, op::not_(op::and_(c, op::or_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x58, op::and_(op::or_(a, b), op::xor_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x59, op::xor_(op::andnot(a, b), op::not_(c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x5A, op::xor_(a, c))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x5B, op::xor_(op::andnot(c, op::or_(a, b)), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x5C, op::xor_(op::and_(a, c), op::or_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x5D, op::or_(op::andnot(a, b), op::not_(c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x5E, op::or_(op::andnot(a, b), op::xor_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x5F, op::not_(op::and_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x60, op::and_(a, op::xor_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x61, op::xor_(op::andnot(op::andnot(a, b), c), op::not_(op::xor_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x62, op::andnot(op::andnot(a, b), op::xor_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x63, op::xor_(op::andnot(c, a), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x64, op::and_(op::or_(a, b), op::xor_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x65, op::xor_(op::andnot(b, a), op::not_(c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x66, op::xor_(b, c))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x67, op::xor_(op::andnot(c, op::or_(a, b)), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x68, op::and_(op::or_(a, b), op::xor_(c, op::and_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x69, op::xor_(op::not_(a), op::xor_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x6A, op::xor_(c, op::and_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x6B, op::xor_(op::andnot(c, op::or_(a, b)), op::not_(op::and_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x6C, op::xor_(b, op::and_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x6D, op::xor_(op::not_(op::xor_(a, b)), op::or_(c, op::andnot(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x6E, op::or_(op::andnot(a, b), op::xor_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x6F, op::or_(op::not_(a), op::xor_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x70, op::andnot(op::and_(b, c), a))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x71, op::xor_(op::not_(op::andnot(b, a)), op::or_(c, op::xor_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x72, op::xor_(op::and_(b, c), op::or_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x73, op::or_(op::andnot(c, a), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x74, op::xor_(op::and_(b, c), op::or_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x75, op::or_(op::andnot(b, a), op::not_(c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x76, op::or_(op::andnot(b, a), op::xor_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x77, op::not_(op::and_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x78, op::xor_(a, op::and_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x79, op::xor_(op::not_(op::xor_(a, b)), op::or_(c, op::andnot(b, a))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x7A, op::or_(op::andnot(b, a), op::xor_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x7B, op::or_(op::not_(b), op::xor_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x7C, op::or_(op::andnot(c, a), op::xor_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x7D, op::or_(op::not_(c), op::xor_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x7E, op::or_(op::xor_(a, b), op::xor_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x7F, op::not_(op::and_(c, op::and_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x80, op::and_(c, op::and_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x81, op::andnot(op::xor_(a, c), op::not_(op::xor_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x82, op::andnot(op::xor_(a, b), c))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x83, op::xor_(op::andnot(op::andnot(c, b), a), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x84, op::andnot(op::xor_(a, c), b))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x85, op::xor_(op::andnot(op::andnot(b, a), c), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x86, op::andnot(op::andnot(b, a), op::xor_(c, op::xor_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x87, op::xor_(op::and_(b, c), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x88, op::and_(b, c))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x89, op::xor_(op::not_(b), op::or_(c, op::andnot(b, a))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x8A, op::andnot(op::andnot(b, a), c))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x8B, op::xor_(op::not_(c), op::or_(b, op::xor_(a, c))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x8C, op::andnot(op::andnot(c, a), b))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x8D, op::xor_(op::not_(b), op::or_(c, op::xor_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x8E, op::xor_(op::andnot(b, a), op::or_(c, op::xor_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x8F, op::or_(op::and_(b, c), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x90, op::andnot(op::xor_(b, c), a))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x91, op::xor_(op::andnot(op::andnot(a, b), c), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x92, op::andnot(op::andnot(a, b), op::xor_(c, op::xor_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x93, op::xor_(op::and_(a, c), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x94, op::andnot(op::xor_(c, op::and_(a, b)), op::or_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x95, op::xor_(op::and_(a, b), op::not_(c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x96, op::xor_(c, op::xor_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x97, op::xor_(op::and_(c, op::or_(a, b)), op::not_(op::and_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x98, op::andnot(op::xor_(b, c), op::or_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x99, op::not_(op::xor_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x9A, op::xor_(c, op::andnot(b, a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x9B, op::xor_(op::and_(c, op::or_(a, b)), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x9C, op::xor_(b, op::andnot(c, a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x9D, op::xor_(op::not_(b), op::or_(c, op::andnot(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x9E, op::or_(op::andnot(a, b), op::xor_(c, op::xor_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0x9F, op::not_(op::and_(a, op::xor_(b, c))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xA0, op::and_(a, c))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xA1, op::xor_(op::not_(a), op::or_(c, op::andnot(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xA2, op::andnot(op::andnot(a, b), c))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xA3, op::xor_(op::andnot(op::xor_(b, c), a), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xA4, op::andnot(op::xor_(a, c), op::or_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xA5, op::not_(op::xor_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xA6, op::xor_(c, op::andnot(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xA7, op::xor_(op::and_(c, op::or_(a, b)), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xA8, op::and_(c, op::or_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xA9, op::xor_(op::not_(c), op::or_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xAA, c)
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xAB, op::not_(op::andnot(c, op::or_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xAC, op::or_(op::and_(a, c), op::andnot(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xAD, op::xor_(op::andnot(op::andnot(a, b), c), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xAE, op::or_(c, op::andnot(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xAF, op::not_(op::andnot(c, a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xB0, op::andnot(op::andnot(c, b), a))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xB1, op::xor_(op::not_(a), op::or_(c, op::xor_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xB2, op::xor_(op::andnot(a, b), op::or_(c, op::xor_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xB3, op::or_(op::and_(a, c), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xB4, op::xor_(a, op::andnot(c, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xB5, op::xor_(op::not_(a), op::or_(c, op::andnot(b, a))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xB6, op::or_(op::andnot(b, a), op::xor_(c, op::xor_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xB7, op::not_(op::and_(b, op::xor_(a, c))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xB8, op::or_(op::and_(b, c), op::andnot(b, a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xB9, op::xor_(op::andnot(op::andnot(b, a), c), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xBA, op::or_(c, op::andnot(b, a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xBB, op::not_(op::andnot(c, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xBC, op::or_(op::and_(a, c), op::xor_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xBD, op::or_(op::not_(op::xor_(a, c)), op::xor_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xBE, op::or_(c, op::xor_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xBF, op::not_(op::andnot(c, op::and_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xC0, op::and_(a, b))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xC1, op::xor_(op::not_(b), op::or_(a, op::andnot(b, c))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xC2, op::andnot(op::xor_(a, b), op::or_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xC3, op::not_(op::xor_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xC4, op::andnot(op::andnot(a, c), b))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xC5, op::xor_(op::andnot(op::xor_(b, c), a), op::not_(c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xC6, op::xor_(b, op::andnot(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xC7, op::xor_(op::and_(b, op::or_(a, c)), op::not_(a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xC8, op::and_(b, op::or_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xC9, op::xor_(op::not_(b), op::or_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xCA, op::xor_(op::andnot(b, a), op::or_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xCB, op::xor_(op::not_(b), op::or_(a, op::and_(b, c))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xCC, b)
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xCD, op::not_(op::andnot(b, op::or_(a, c))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xCE, op::or_(b, op::andnot(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xCF, op::not_(op::andnot(b, a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xD0, op::andnot(op::andnot(b, c), a))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xD1, op::xor_(op::not_(a), op::or_(b, op::xor_(a, c))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xD2, op::xor_(a, op::andnot(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xD3, op::xor_(op::and_(a, op::or_(b, c)), op::not_(b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xD4, op::andnot(op::andnot(op::and_(a, b), c), op::or_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xD5, op::or_(op::and_(a, b), op::not_(c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xD6, op::xor_(op::or_(c, op::and_(a, b)), op::xor_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xD7, op::not_(op::and_(c, op::xor_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xD8, op::or_(op::and_(b, c), op::andnot(c, a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xD9, op::xor_(op::not_(b), op::or_(c, op::and_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xDA, op::or_(op::and_(a, b), op::xor_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xDB, op::or_(op::not_(op::xor_(a, b)), op::xor_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xDC, op::or_(b, op::andnot(c, a)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xDD, op::not_(op::andnot(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xDE, op::or_(b, op::xor_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xDF, op::not_(op::and_(c, op::andnot(b, a))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xE0, op::and_(a, op::or_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xE1, op::xor_(op::not_(a), op::or_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xE2, op::xor_(op::andnot(a, b), op::or_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xE3, op::xor_(op::not_(a), op::or_(b, op::and_(a, c))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xE4, op::xor_(op::andnot(a, c), op::or_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xE5, op::xor_(op::not_(a), op::or_(c, op::and_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xE6, op::or_(op::and_(a, b), op::xor_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xE7, op::or_(op::not_(op::xor_(a, b)), op::xor_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xE8, op::and_(op::or_(a, b), op::or_(c, op::and_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xE9, op::xor_(op::not_(op::or_(a, b)), op::or_(c, op::and_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xEA, op::or_(c, op::and_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xEB, op::not_(op::andnot(c, op::xor_(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xEC, op::or_(b, op::and_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xED, op::not_(op::andnot(b, op::xor_(a, c))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xEE, op::or_(b, c))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xEF, op::or_(op::not_(a), op::or_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xF0, a)
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xF1, op::not_(op::andnot(a, op::or_(b, c))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xF2, op::or_(a, op::andnot(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xF3, op::not_(op::andnot(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xF4, op::or_(a, op::andnot(c, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xF5, op::not_(op::andnot(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xF6, op::or_(a, op::xor_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xF7, op::not_(op::and_(c, op::andnot(a, b))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xF8, op::or_(a, op::and_(b, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xF9, op::not_(op::andnot(a, op::xor_(b, c))))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xFA, op::or_(a, c))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xFB, op::or_(op::not_(b), op::or_(a, c)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xFC, op::or_(a, b))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xFD, op::or_(op::not_(c), op::or_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xFE, op::or_(c, op::or_(a, b)))
+INTERNAL_RMGR_FIB_TERNARYLOGIC(0xFF, op::ones())
 
-// 8-bit unsigned
-#define _mm_cmpeq_epu8         _mm_cmpeq_epi8
-#define _mm_cmpneq_epu8        _mm_cmpneq_epi8
-#define _mm_cmpge_epu8(a,b)    _mm_cmpeq_epi8((a), _mm_max_epu8((a), (b)))
-#define _mm_cmple_epu8(a,b)    _mm_cmpge_epu8((b), (a))
-#define _mm_cmpgt_epu8(a,b)    _mm_xor_si128(_mm_cmpge_epu8((b),(a)), _mm_cmpeq_epi8((a),(a)))
-#define _mm_cmplt_epu8(a,b)    _mm_cmpgt_epu8((b), (a))
+#undef INTERNAL_RMGR_FIB_TERNARYLOGIC
 
-// 16-bit signed
-#define _mm_cmpneq_epi16(a,b)  _mm_xor_si128(_mm_cmpeq_epi16((a),(b)), _mm_cmpeq_epi16((a),(a)))
-#define _mm_cmpge_epi16(a,b)   _mm_xor_si128(_mm_cmpgt_epi16((b),(a)), _mm_cmpeq_epi16((a),(a)))
-#define _mm_cmple_epi16(a,b)   _mm_cmpge_epi16((b), (a))
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    // GCC declares them as macros in unoptimized builds, even without AVX512VL
+    #undef  _mm_ternarylogic_epi32
+    #undef  _mm_ternarylogic_epi64
+    #define _mm_ternarylogic_epi32(a, b, c, imm8)  rmgr_fib_mm_ternarylogic_epi32<(imm8) & 0xFF>(a, b, c)
+    #define _mm_ternarylogic_epi64(a, b, c, imm8)  rmgr_fib_mm_ternarylogic_epi32<(imm8) & 0xFF>(a, b, c)
 
-// 16-bit unsigned
-#define _mm_cmpeq_epu16        _mm_cmpeq_epi16
-#define _mm_cmpneq_epu16       _mm_cmpneq_epi16
-#define _mm_cmple_epu16(a,b)   _mm_cmpge_epu16((b), (a))
-#define _mm_cmplt_epu16(a,b)   _mm_cmpgt_epu16((b), (a))
-#if INTERNAL_RMGR_FIB_USE_SSE41
-    #define _mm_cmpge_epu16(a,b)    _mm_cmpeq_epi16((a), _mm_max_epu16((a), (b)))
-    #define _mm_cmpgt_epu16(a,b)    _mm_xor_si128(_mm_cmpge_epu16((b),(a)), _mm_cmpeq_epi16((a),(a)))
-#else
-    #define _mm_cmpgt_epu16         rmgr_fib_mm_cmpgt_epu16
-    #define _mm_cmpge_epu16(a,b)    _mm_cmpeq_epi16(_mm_subs_epu16((b),(a)), _mm_setzero_si128())
-    static inline __m128i rmgr_fib_mm_cmpgt_epu16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    // Without a mask, the lane size makes no difference
+    template<int imm>
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_ternarylogic_epi32(const __m128i& a, const __m128i& b, const __m128i& c) RMGR_NOEXCEPT
     {
-        const __m128i flip = _mm_set1_epi16(0x8000u);
-        return _mm_cmpgt_epi16(_mm_xor_si128(a,flip), _mm_xor_si128(b,flip));
+        return rmgr_fib_ternarylogic<imm>::template apply<rmgr_fib_bitwise<sizeof(__m128i)> >(a, b, c);
     }
 #endif
 
-// 32-bit signed
-#define _mm_cmpneq_epi32(a,b)  _mm_xor_si128(_mm_cmpeq_epi32((a),(b)), _mm_cmpeq_epi32((a),(a)))
-#define _mm_cmpge_epi32(a,b)   _mm_xor_si128(_mm_cmpgt_epi32((b),(a)), _mm_cmpeq_epi32((a),(a)))
-#define _mm_cmple_epi32(a,b)   _mm_cmpge_epi32((b), (a))
 
-// 32-bit unsigned
-#define _mm_cmpeq_epu32        _mm_cmpeq_epi32
-#define _mm_cmpneq_epu32       _mm_cmpneq_epi32
-#define _mm_cmple_epu32(a,b)   _mm_cmpge_epu32((b), (a))
-#define _mm_cmplt_epu32(a,b)   _mm_cmpgt_epu32((b), (a))
-#if INTERNAL_RMGR_FIB_USE_SSE41
-    #define _mm_cmpge_epu32(a,b)    _mm_cmpeq_epi32((a), _mm_max_epu32((a), (b)))
-    #define _mm_cmpgt_epu32(a,b)    _mm_xor_si128(_mm_cmpge_epu32((b),(a)), _mm_cmpeq_epi32((a),(a)))
-#else
-    #define _mm_cmpgt_epu32         rmgr_fib_mm_cmpgt_epu32
-    #define _mm_cmpge_epu32(a,b)    _mm_xor_si128(_mm_cmpgt_epu32((b),(a)), _mm_cmpeq_epi32((a),(a)))
-    static inline __m128i rmgr_fib_mm_cmpgt_epu32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+//=================================================================================================
+// 32-bit x86 compat layer
+
+#if RMGR_ARCH_IS_X86_32
+    #define _mm_set_epi64x     rmgr_fib_mm_set_epi64x
+    #define _mm_set1_epi64x    rmgr_fib_mm_set1_epi64x
+    #define _mm_cvtsi128_si64  rmgr_fib_mm_cvtsi128_si64
+
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_set_epi64x(int64_t e1, int64_t e0) RMGR_NOEXCEPT
     {
-        const __m128i flip = _mm_set1_epi32(0x80000000u);
-        return _mm_cmpgt_epi32(_mm_xor_si128(a,flip), _mm_xor_si128(b,flip));
+        return _mm_set_epi32(int32_t(e1>>32), int32_t(e1&UINT64_C(0xFFFFFFFF)), int32_t(e0>>32), int32_t(e0&UINT64_C(0xFFFFFFFF)));
     }
-#endif
 
-// 64-bit signed
-#define _mm_cmpneq_epi64(a,b)  _mm_xor_si128(_mm_cmpeq_epi64((a),(b)), _mm_cmpeq_epi32((a),(a)))
-#define _mm_cmpge_epi64(a,b)   _mm_xor_si128(_mm_cmpgt_epi64((b),(a)), _mm_cmpeq_epi32((a),(a)))
-#define _mm_cmplt_epi64(a,b)   _mm_cmpgt_epi64((b), (a))
-#define _mm_cmple_epi64(a,b)   _mm_cmpge_epi64((b), (a))
-#if !INTERNAL_RMGR_FIB_USE_SSE41
-    #define _mm_cmpeq_epi64    rmgr_fib_mm_cmpeq_epi64
-    static inline __m128i rmgr_fib_mm_cmpeq_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_set1_epi64x(int64_t a) RMGR_NOEXCEPT
     {
-        const __m128i eq32 = _mm_cmpeq_epi32(a,b);
-        return _mm_and_si128(eq32, _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2,3,0,1)));
+        return rmgr_fib_mm_set_epi64x(a, a);
     }
-#endif
-#if !INTERNAL_RMGR_FIB_USE_SSE42
-    #define _mm_cmpgt_epi64   rmgr_fib_mm_cmpgt_epi64
-    static inline __m128i rmgr_fib_mm_cmpgt_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+
+    static RMGR_FORCEINLINE int64_t rmgr_fib_mm_cvtsi128_si64(const __m128i& a) RMGR_NOEXCEPT
     {
-        // See https://stackoverflow.com/a/65460455
-        const __m128i s = _mm_xor_si128(a, b);
-        const __m128i d = _mm_sub_epi64(b, a);
-        const __m128i r = INTERNAL_RMGR_FIB_SELECT(s, b, d);
-        return _mm_shuffle_epi32(_mm_srai_epi32(r,31), _MM_SHUFFLE(3,3,1,1));
+        #if INTERNAL_RMGR_FIB_USE_SSE41
+            const int32_t hi = _mm_extract_epi32(a, 1);
+        #else
+            const int32_t hi = _mm_cvtsi128_si32(_mm_srli_si128(a, 4));
+        #endif
+        return int64_t((uint64_t(uint32_t(hi)) << 32) | uint32_t(_mm_cvtsi128_si32(a)));
     }
 #endif
 
-// 64-bit unsigned
-#define _mm_cmpeq_epu64        _mm_cmpeq_epi64
-#define _mm_cmpneq_epu64       _mm_cmpneq_epi64
-#define _mm_cmpge_epu64(a,b)   _mm_xor_si128(_mm_cmpgt_epu64((b),(a)), _mm_cmpeq_epi32((a),(a)))
-#define _mm_cmplt_epu64(a,b)   _mm_cmpgt_epu64((b), (a))
-#define _mm_cmple_epu64(a,b)   _mm_cmpge_epu64((b), (a))
-static inline __m128i _mm_cmpgt_epu64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
-{
-#if INTERNAL_RMGR_FIB_USE_SSE42
-    const __m128i flip = _mm_set1_epi64x(0x8000000000000000ll);
-    return _mm_cmpgt_epi64(_mm_xor_si128(a,flip), _mm_xor_si128(b,flip));
-#else
-    // See https://stackoverflow.com/a/65460455
-    const __m128i s = _mm_xor_si128(a, b);
-    const __m128i d = _mm_sub_epi64(b, a);
-    const __m128i r = INTERNAL_RMGR_FIB_SELECT(s, a, d);
-    return _mm_shuffle_epi32(_mm_srai_epi32(r,31), _MM_SHUFFLE(3,3,1,1));
-#endif
-}
-
 
 //=================================================================================================
-// Shifts
-
-// 8-bit shifts
-#define _mm_slli_epi8(a, imm8)   _mm_and_si128(_mm_slli_epi16((a),(imm8)), _mm_set1_epi8(uint8_t(255 & (255<<((imm8)&7)))))
-#define _mm_srli_epi8(a, imm8)   _mm_and_si128(_mm_srli_epi16((a),(imm8)), _mm_set1_epi8(int8_t(255u>>((imm8)&7))))
-#define _mm_srai_epi8(a, imm8)   _mm_packs_epi16(_mm_srai_epi16(_mm_unpacklo_epi8((a),(a)), (imm8)+8), _mm_srai_epi16(_mm_unpackhi_epi8((a),(a)), (imm8)+8))
+// Blends
 
-static inline __m128i _mm_sll_epi8(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
-{
-    const __m128i twoFiftySix = _mm_set1_epi16(256);
-    const __m128i mask        = _mm_sub_epi16(_mm_sll_epi16(twoFiftySix, count), twoFiftySix);
-    return _mm_andnot_si128(mask, _mm_sll_epi16(a, count));
-}
-
-static inline __m128i _mm_srl_epi8(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
-{
-    const __m128i twoFiftySix = _mm_set1_epi16(256);
-    const __m128i mask        = _mm_sub_epi16(twoFiftySix, _mm_srl_epi16(twoFiftySix, count));
-    return _mm_andnot_si128(mask, _mm_srl_epi16(a, count));
-}
+// Without SSE 4.1, a blend is an and/andnot/or with a mask. When the immediate picks whole 64-bit
+// halves (or the low 32-bit lane), movsd/shufpd (or movss) do the same in a single instruction.
 
-static inline __m128i _mm_sra_epi8(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
-{
-    const __m128i count16 = _mm_add_epi64(count, _mm_set1_epi64x(8));
-    return _mm_packs_epi16(_mm_sra_epi16(_mm_unpacklo_epi8(a,a), count16), _mm_sra_epi16(_mm_unpackhi_epi8(a,a), count16));
-}
+#if !INTERNAL_RMGR_FIB_USE_SSE41
+    #define _mm_blendv_epi8                 rmgr_fib_mm_blendv_epi8
+    #define _mm_blendv_ps                   rmgr_fib_mm_blendv_ps
+    #define _mm_blendv_pd                   rmgr_fib_mm_blendv_pd
+    #define _mm_blend_epi16(a, b, imm8)     rmgr_fib_mm_blend_epi16<(imm8)>((a), (b))
+    #define _mm_blend_ps(a, b, imm8)        rmgr_fib_mm_blend_ps<(imm8)>((a), (b))
+    #define _mm_blend_pd(a, b, imm8)        rmgr_fib_mm_blend_pd<(imm8)>((a), (b))
 
+    // Variable blends, by the MSB of each lane of mask
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_blendv_epi8(const __m128i& a, const __m128i& b, const __m128i& mask) RMGR_NOEXCEPT
+    {
+        const __m128i m = _mm_cmplt_epi8(mask, _mm_setzero_si128());
+        return _mm_or_si128(_mm_and_si128(m, b), _mm_andnot_si128(m, a));
+    }
 
-// 64-bit arithmetic right shift
-#if !INTERNAL_RMGR_FIB_USE_AVX512VL
-    #define _mm_srai_epi64(a, imm8)  rmgr_fib_mm_srai_epi64<(imm8)>(a)
-    #define _mm_sra_epi64            rmgr_fib_mm_sra_epi64
+    static RMGR_FORCEINLINE __m128 rmgr_fib_mm_blendv_ps(const __m128& a, const __m128& b, const __m128& mask) RMGR_NOEXCEPT
+    {
+        const __m128 m = _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(mask), 31));
+        return _mm_or_ps(_mm_and_ps(m, b), _mm_andnot_ps(m, a));
+    }
 
-    static __m128i rmgr_fib_mm_sra_epi64(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+    static RMGR_FORCEINLINE __m128d rmgr_fib_mm_blendv_pd(const __m128d& a, const __m128d& b, const __m128d& mask) RMGR_NOEXCEPT
     {
-        #if INTERNAL_RMGR_FIB_USE_SSE42
-            const __m128i sign = _mm_cmpgt_epi64(_mm_setzero_si128(), a);
-        #else
-            const __m128i sign = _mm_shuffle_epi32(_mm_cmpgt_epi32(_mm_setzero_si128(), a), _MM_SHUFFLE(3,3,1,1));
-        #endif
-        return _mm_or_si128(_mm_srl_epi64(a,count), _mm_sll_epi64(sign,_mm_sub_epi64(_mm_set1_epi64x(63),count)));
+        const __m128d m = _mm_castsi128_pd(_mm_shuffle_epi32(_mm_srai_epi32(_mm_castpd_si128(mask), 31), _MM_SHUFFLE(3,3,1,1)));
+        return _mm_or_pd(_mm_and_pd(m, b), _mm_andnot_pd(m, a));
     }
 
-    template<unsigned N>
-    static __m128i rmgr_fib_mm_srai_epi64(const __m128i& a) RMGR_NOEXCEPT
+    // Immediate blends, the lanes whose bit is set in N come from b
+    template<int N>
+    static RMGR_FORCEINLINE __m128d rmgr_fib_mm_blend_pd(const __m128d& a, const __m128d& b) RMGR_NOEXCEPT
     {
-        #if INTERNAL_RMGR_FIB_USE_SSE42
-            const __m128i sign = _mm_cmpgt_epi64(_mm_setzero_si128(), a);
-        #else
-            const __m128i sign = _mm_shuffle_epi32(_mm_cmpgt_epi32(_mm_setzero_si128(), a), _MM_SHUFFLE(3,3,1,1));
-        #endif
-        return _mm_or_si128(_mm_srli_epi64(a,N), _mm_slli_epi64(sign,63-N));
+        return rmgr_fib_mm_blend_pd<N & 3>(a, b); // Only the 2 low bits matter, all of their values are specialized below
     }
 
     template<>
-    __m128i rmgr_fib_mm_srai_epi64<0u>(const __m128i& a) RMGR_NOEXCEPT
+    RMGR_FORCEINLINE __m128d rmgr_fib_mm_blend_pd<0>(const __m128d& a, const __m128d&) RMGR_NOEXCEPT
     {
         return a;
     }
 
     template<>
-    __m128i rmgr_fib_mm_srai_epi64<63u>(const __m128i& a) RMGR_NOEXCEPT
+    RMGR_FORCEINLINE __m128d rmgr_fib_mm_blend_pd<1>(const __m128d& a, const __m128d& b) RMGR_NOEXCEPT
     {
-        #if INTERNAL_RMGR_FIB_USE_SSE42
-            return _mm_cmpgt_epi64(_mm_setzero_si128(), a);
-        #else
-            return _mm_shuffle_epi32(_mm_cmpgt_epi32(_mm_setzero_si128(), a), _MM_SHUFFLE(3,3,1,1));
-        #endif
+        return _mm_move_sd(a, b);
     }
-#endif
 
+    template<>
+    RMGR_FORCEINLINE __m128d rmgr_fib_mm_blend_pd<2>(const __m128d& a, const __m128d& b) RMGR_NOEXCEPT
+    {
+        return _mm_shuffle_pd(a, b, _MM_SHUFFLE2(1,0));
+    }
 
-//=================================================================================================
-// Min & max
-
-// 8-bit signed
-#if !INTERNAL_RMGR_FIB_USE_SSE41
-    #define _mm_min_epi8   rmgr_fib_mm_min_epi8
-    #define _mm_max_epi8   rmgr_fib_mm_max_epi8
+    template<>
+    RMGR_FORCEINLINE __m128d rmgr_fib_mm_blend_pd<3>(const __m128d&, const __m128d& b) RMGR_NOEXCEPT
+    {
+        return b;
+    }
 
-    static inline __m128i rmgr_fib_mm_min_epi8(const __m128i& a, const __m128i b) RMGR_NOEXCEPT
+    template<int N>
+    static RMGR_FORCEINLINE __m128 rmgr_fib_mm_blend_ps(const __m128& a, const __m128& b) RMGR_NOEXCEPT
     {
-        const __m128i mask = _mm_cmpgt_epi8(a, b);
-        return INTERNAL_RMGR_FIB_SELECT(mask, b, a);
+        const __m128 m = _mm_castsi128_ps(_mm_setr_epi32(-(N&1), -((N>>1)&1), -((N>>2)&1), -((N>>3)&1)));
+        return _mm_or_ps(_mm_and_ps(m, b), _mm_andnot_ps(m, a));
     }
 
-    static inline __m128i rmgr_fib_mm_max_epi8(const __m128i& a, const __m128i b) RMGR_NOEXCEPT
+    template<>
+    RMGR_FORCEINLINE __m128 rmgr_fib_mm_blend_ps<0x0>(const __m128& a, const __m128&) RMGR_NOEXCEPT
     {
-        const __m128i mask = _mm_cmpgt_epi8(a, b);
-        return INTERNAL_RMGR_FIB_SELECT(mask, a, b);
+        return a;
     }
-#endif
 
-// 16-bit unsigned
-#if !INTERNAL_RMGR_FIB_USE_SSE41
-    #define _mm_min_epu16(a,b)  _mm_sub_epi16((a), _mm_subs_epu16((a),(b)))
-    #define _mm_max_epu16(a,b)  _mm_add_epi16((b), _mm_subs_epu16((a),(b)))
-#endif
+    template<>
+    RMGR_FORCEINLINE __m128 rmgr_fib_mm_blend_ps<0x1>(const __m128& a, const __m128& b) RMGR_NOEXCEPT
+    {
+        return _mm_move_ss(a, b);
+    }
 
-// 32-bit unsigned
-#if !INTERNAL_RMGR_FIB_USE_SSE41
-    #define _mm_min_epu32   rmgr_fib_mm_min_epu32
-    #define _mm_max_epu32   rmgr_fib_mm_max_epu32
+    template<>
+    RMGR_FORCEINLINE __m128 rmgr_fib_mm_blend_ps<0x3>(const __m128& a, const __m128& b) RMGR_NOEXCEPT
+    {
+        return _mm_castpd_ps(rmgr_fib_mm_blend_pd<1>(_mm_castps_pd(a), _mm_castps_pd(b)));
+    }
 
-    static inline __m128i rmgr_fib_mm_min_epu32(const __m128i& a, const __m128i b) RMGR_NOEXCEPT
+    template<>
+    RMGR_FORCEINLINE __m128 rmgr_fib_mm_blend_ps<0xC>(const __m128& a, const __m128& b) RMGR_NOEXCEPT
     {
-        const __m128i mask = _mm_cmpgt_epu32(a, b);
-        return INTERNAL_RMGR_FIB_SELECT(mask, b, a);
+        return _mm_castpd_ps(rmgr_fib_mm_blend_pd<2>(_mm_castps_pd(a), _mm_castps_pd(b)));
     }
 
-    static inline __m128i rmgr_fib_mm_max_epu32(const __m128i& a, const __m128i b) RMGR_NOEXCEPT
+    template<>
+    RMGR_FORCEINLINE __m128 rmgr_fib_mm_blend_ps<0xE>(const __m128& a, const __m128& b) RMGR_NOEXCEPT
     {
-        const __m128i mask = _mm_cmpgt_epu32(a, b);
-        return INTERNAL_RMGR_FIB_SELECT(mask, a, b);
+        return _mm_move_ss(b, a);
     }
-#endif
 
-// 64-bit signed
-#if !INTERNAL_RMGR_FIB_USE_AVX512VL
-    #define _mm_min_epi64  rmgr_fib_mm_min_epi64
-    #define _mm_max_epi64  rmgr_fib_mm_max_epi64
+    template<>
+    RMGR_FORCEINLINE __m128 rmgr_fib_mm_blend_ps<0xF>(const __m128&, const __m128& b) RMGR_NOEXCEPT
+    {
+        return b;
+    }
 
-    static inline __m128i rmgr_fib_mm_min_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    template<int N>
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_blend_epi16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
     {
-        #if INTERNAL_RMGR_FIB_USE_SSE41
-            // _mm_blendv_pd() allows us to save two instructions compared to calling _mm_cmpgt_epi64()
-            const __m128i s = _mm_xor_si128(a, b);
-            const __m128i d = _mm_sub_epi64(b, a);
-            const __m128i m = _mm_blendv_epi8(d, b, s);
-            return _mm_castpd_si128(_mm_blendv_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b), _mm_castsi128_pd(m)));
-        #else
-            const __m128i m = _mm_cmpgt_epi64(a, b);
-            return INTERNAL_RMGR_FIB_SELECT(m, b, a);
-        #endif
+        const __m128i m = _mm_setr_epi16(short(-(N&1)),      short(-((N>>1)&1)), short(-((N>>2)&1)), short(-((N>>3)&1)),
+                                         short(-((N>>4)&1)), short(-((N>>5)&1)), short(-((N>>6)&1)), short(-((N>>7)&1)));
+        return _mm_or_si128(_mm_and_si128(m, b), _mm_andnot_si128(m, a));
     }
 
-    static inline __m128i rmgr_fib_mm_max_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    template<>
+    RMGR_FORCEINLINE __m128i rmgr_fib_mm_blend_epi16<0x00>(const __m128i& a, const __m128i&) RMGR_NOEXCEPT
     {
-        #if INTERNAL_RMGR_FIB_USE_SSE41
-            // _mm_blendv_pd() allows us to save two instructions compared to calling _mm_cmpgt_epi64()
-            const __m128i s = _mm_xor_si128(a, b);
-            const __m128i d = _mm_sub_epi64(b, a);
-            const __m128i m = _mm_blendv_epi8(d, b, s);
-            return _mm_castpd_si128(_mm_blendv_pd(_mm_castsi128_pd(b), _mm_castsi128_pd(a), _mm_castsi128_pd(m)));
-        #else
-            const __m128i m = _mm_cmpgt_epi64(a, b);
-            return INTERNAL_RMGR_FIB_SELECT(m, a, b);
-        #endif
+        return a;
     }
-#endif
 
-// 64-bit unsigned
-#if !INTERNAL_RMGR_FIB_USE_AVX512VL
-    #define _mm_min_epu64  rmgr_fib_mm_min_epu64
-    #define _mm_max_epu64  rmgr_fib_mm_max_epu64
+    template<>
+    RMGR_FORCEINLINE __m128i rmgr_fib_mm_blend_epi16<0x03>(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        return _mm_castps_si128(rmgr_fib_mm_blend_ps<0x1>(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
 
-    static inline __m128i rmgr_fib_mm_min_epu64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    template<>
+    RMGR_FORCEINLINE __m128i rmgr_fib_mm_blend_epi16<0x0F>(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
     {
-        #if INTERNAL_RMGR_FIB_USE_SSE41
-            // _mm_blendv_pd() allows us to save two instructions compared to calling _mm_cmpgt_epu64()
-            const __m128i s = _mm_xor_si128(a, b);
-            const __m128i d = _mm_sub_epi64(b, a);
-            const __m128i m = _mm_blendv_epi8(d, a, s);
-            return _mm_castpd_si128(_mm_blendv_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b), _mm_castsi128_pd(m)));
-        #else
-            const __m128i m = _mm_cmpgt_epu64(a, b);
-            return INTERNAL_RMGR_FIB_SELECT(m, b, a);
-        #endif
+        return _mm_castpd_si128(rmgr_fib_mm_blend_pd<1>(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
     }
 
-    static inline __m128i rmgr_fib_mm_max_epu64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    template<>
+    RMGR_FORCEINLINE __m128i rmgr_fib_mm_blend_epi16<0xF0>(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
     {
-        #if INTERNAL_RMGR_FIB_USE_SSE41
+        return _mm_castpd_si128(rmgr_fib_mm_blend_pd<2>(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+
+    template<>
+    RMGR_FORCEINLINE __m128i rmgr_fib_mm_blend_epi16<0xFC>(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        return _mm_castps_si128(rmgr_fib_mm_blend_ps<0xE>(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+
+    template<>
+    RMGR_FORCEINLINE __m128i rmgr_fib_mm_blend_epi16<0xFF>(const __m128i&, const __m128i& b) RMGR_NOEXCEPT
+    {
+        return b;
+    }
+#endif
+
+#if !INTERNAL_RMGR_FIB_USE_AVX2
+    #undef  _mm_blend_epi32  // GCC declares it as a macro in unoptimized builds, even without AVX2
+    #define _mm_blend_epi32(a, b, imm8)     rmgr_fib_mm_blend_epi32<(imm8)>((a), (b))
+
+    template<int N>
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_blend_epi32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        // Each bit of N stands for two 16-bit lanes
+        return _mm_blend_epi16(a, b, ((N&1) ? 0x03 : 0) | ((N&2) ? 0x0C : 0) | ((N&4) ? 0x30 : 0) | ((N&8) ? 0xC0 : 0));
+    }
+#endif
+
+
+//=================================================================================================
+// Lane access
+
+#if !INTERNAL_RMGR_FIB_USE_SSE41
+    #define _mm_extract_epi8( a, imm8)  rmgr_fib_mm_extract_epi8<(imm8)>(a)
+    #define _mm_extract_epi32(a, imm8)  rmgr_fib_mm_extract_epi32<(imm8)>(a)
+    #define _mm_extract_epi64(a, imm8)  rmgr_fib_mm_extract_epi64<(imm8)>(a)
+
+    template<int N>
+    static RMGR_FORCEINLINE int rmgr_fib_mm_extract_epi8(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return (_mm_extract_epi16(a, N/2) >> ((N%2)*8)) & 255;
+    }
+
+    template<int N>
+    static RMGR_FORCEINLINE int rmgr_fib_mm_extract_epi32(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return _mm_cvtsi128_si32(_mm_srli_si128(a, N*4));
+    }
+
+    template<int N>
+    static RMGR_FORCEINLINE int64_t rmgr_fib_mm_extract_epi64(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return _mm_cvtsi128_si64(_mm_srli_si128(a, N*8));
+    }
+
+    // Lane insertions go through registers: pinsrw, or a movd/movq followed by a shuffle
+    #define _mm_insert_epi8( a, i, imm8)  rmgr_fib_mm_insert_epi8<(imm8) & 15>((a), (i))
+    #define _mm_insert_epi32(a, i, imm8)  rmgr_fib_mm_insert_epi32<(imm8) & 3>((a), (i))
+    #define _mm_insert_epi64(a, i, imm8)  rmgr_fib_mm_insert_epi64<(imm8) & 1>((a), (i))
+    #define _mm_extract_ps(  a,    imm8)  rmgr_fib_mm_extract_epi32<(imm8) & 3>(_mm_castps_si128(a))
+    #define _mm_insert_ps(   a, b, imm8)  rmgr_fib_mm_insert_ps<(imm8) & 0xFF>((a), (b))
+
+    template<int N>
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_insert_epi8(const __m128i& a, int i) RMGR_NOEXCEPT
+    {
+        // Merge the byte into its 16-bit lane
+        const int word = _mm_extract_epi16(a, N/2);
+        const int merged = (N % 2) ? ((word & 0x00FF) | ((i & 255) << 8)) : ((word & 0xFF00) | (i & 255));
+        return _mm_insert_epi16(a, merged, N/2);
+    }
+
+    template<int N>
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_insert_epi32(const __m128i& a, int i) RMGR_NOEXCEPT
+    {
+        if (N == 0)
+            return _mm_castps_si128(_mm_move_ss(_mm_castsi128_ps(a), _mm_castsi128_ps(_mm_cvtsi32_si128(i))));
+        return _mm_insert_epi16(_mm_insert_epi16(a, i & 0xFFFF, 2*N), (i >> 16) & 0xFFFF, 2*N+1);
+    }
+
+    template<int N>
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_insert_epi64(const __m128i& a, int64_t i) RMGR_NOEXCEPT
+    {
+        const __m128i v = _mm_set_epi64x(0, i);
+        if (N == 0)
+            return _mm_castpd_si128(_mm_move_sd(_mm_castsi128_pd(a), _mm_castsi128_pd(v)));
+        return _mm_unpacklo_epi64(a, v);
+    }
+
+    // Bits 7:6 of imm pick the lane of b, bits 5:4 the lane of a it replaces, bits 3:0 the lanes to zero
+    template<int imm>
+    static RMGR_FORCEINLINE __m128 rmgr_fib_mm_insert_ps(const __m128& a, const __m128& b) RMGR_NOEXCEPT
+    {
+        const int src = (imm >> 6) & 3;
+        const int dst = (imm >> 4) & 3;
+        __m128 r;
+        if (dst == 0)
+            r = _mm_move_ss(a, (src == 0) ? b : _mm_shuffle_ps(b, b, _MM_SHUFFLE(src,src,src,src)));
+        else if (dst == 1)
+            r = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(src,src,0,0)), a, _MM_SHUFFLE(3,2,2,0)); // a0 a0 bs bs, then a0 bs a2 a3
+        else if (dst == 2)
+            r = _mm_shuffle_ps(a, _mm_shuffle_ps(b, a, _MM_SHUFFLE(3,3,src,src)), _MM_SHUFFLE(2,0,1,0)); // bs bs a3 a3, then a0 a1 bs a3
+        else
+            r = _mm_shuffle_ps(a, _mm_shuffle_ps(b, a, _MM_SHUFFLE(2,2,src,src)), _MM_SHUFFLE(0,2,1,0)); // bs bs a2 a2, then a0 a1 a2 bs
+        if (imm & 15)
+        {
+            const __m128i keep = _mm_setr_epi32((imm & 1) ? 0 : -1, (imm & 2) ? 0 : -1, (imm & 4) ? 0 : -1, (imm & 8) ? 0 : -1);
+            r = _mm_and_ps(r, _mm_castsi128_ps(keep));
+        }
+        return r;
+    }
+#endif
+
+#if RMGR_ARCH_IS_X86_32 && INTERNAL_RMGR_FIB_USE_SSE41
+    #define _mm_extract_epi64(a, imm8)    rmgr_fib_mm_extract_epi64<(imm8)>(a)
+    #define _mm_insert_epi64(a, i, imm8)  rmgr_fib_mm_insert_epi64<(imm8) & 1>((a), (i))
+
+    template<int N>
+    static RMGR_FORCEINLINE int64_t rmgr_fib_mm_extract_epi64(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return int64_t((uint64_t(uint32_t(_mm_extract_epi32(a, 2*N+1))) << 32) | uint32_t(_mm_extract_epi32(a, 2*N)));
+    }
+
+    template<int N>
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_insert_epi64(const __m128i& a, int64_t i) RMGR_NOEXCEPT
+    {
+        return _mm_insert_epi32(_mm_insert_epi32(a, int32_t(i & UINT64_C(0xFFFFFFFF)), 2*N), int32_t(i >> 32), 2*N+1);
+    }
+#endif
+
+
+//=================================================================================================
+// SSSE3
+//
+// SSE2 has no variable byte permutation, so _mm_shuffle_epi8() goes through memory. When the
+// control mask is known at compile time, _mm_shuffle_epi8_const() does better: dword permutations
+// are a single pshufd, other masks OR the source shifted by each distinct offset between source
+// and destination bytes, masked to the bytes that move by that offset. Even a byte reversal, the
+// worst case with 16 offsets, has half the latency of the trip through memory.
+
+#if !INTERNAL_RMGR_FIB_USE_SSSE3
+    #define _mm_shuffle_epi8            rmgr_fib_mm_shuffle_epi8
+    #define _mm_alignr_epi8(a, b, imm8) rmgr_fib_mm_alignr_epi8<(imm8)>((a), (b))
+    #define _mm_hadd_epi16              rmgr_fib_mm_hadd_epi16
+    #define _mm_hadd_epi32              rmgr_fib_mm_hadd_epi32
+    #define _mm_hadds_epi16             rmgr_fib_mm_hadds_epi16
+    #define _mm_hsub_epi16              rmgr_fib_mm_hsub_epi16
+    #define _mm_hsub_epi32              rmgr_fib_mm_hsub_epi32
+    #define _mm_hsubs_epi16             rmgr_fib_mm_hsubs_epi16
+    #define _mm_sign_epi8               rmgr_fib_mm_sign_epi8
+    #define _mm_sign_epi16              rmgr_fib_mm_sign_epi16
+    #define _mm_sign_epi32              rmgr_fib_mm_sign_epi32
+    #define _mm_mulhrs_epi16            rmgr_fib_mm_mulhrs_epi16
+    #define _mm_maddubs_epi16           rmgr_fib_mm_maddubs_epi16
+
+    // Byte shuffle
+    static inline __m128i rmgr_fib_mm_shuffle_epi8(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        // Indices with their MSB set are clamped to 16, which reads a zero
+        const __m128i table[2] = {a, _mm_setzero_si128()};
+        const __m128i index    = _mm_min_epu8(_mm_and_si128(b, _mm_set1_epi8(char(0x8F))), _mm_set1_epi8(16));
+        __m128i       result;
+        const uint8_t* t = reinterpret_cast<const uint8_t*>(table);
+        const uint8_t* i = reinterpret_cast<const uint8_t*>(&index);
+        uint8_t*       r = reinterpret_cast<uint8_t*>(&result);
+        for (int n=0; n<16; ++n)
+            r[n] = t[i[n]];
+        return result;
+    }
+
+    // Byte alignment
+    template<int N>
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_alignr_epi8(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        // The unused shifts get clamped counts, as immediates must be in range
+        if (N < 16)
+            return _mm_or_si128(_mm_srli_si128(b, (N < 16) ? N : 0), _mm_slli_si128(a, (N < 16) ? 16 - N : 0));
+        return _mm_srli_si128(a, (N >= 16) ? N - 16 : 0);
+    }
+
+    // Horizontal additions & subtractions: pmaddwd sums pairs of 16-bit lanes into 32-bit ones,
+    // which are either wrapped around or saturated back to 16 bits
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_wrap_epi32_epi16(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+    }
+
+    static inline __m128i rmgr_fib_mm_hadd_epi16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        const __m128i one = _mm_set1_epi16(1);
+        return _mm_packs_epi32(rmgr_fib_mm_wrap_epi32_epi16(_mm_madd_epi16(a, one)), rmgr_fib_mm_wrap_epi32_epi16(_mm_madd_epi16(b, one)));
+    }
+
+    static inline __m128i rmgr_fib_mm_hadds_epi16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        const __m128i one = _mm_set1_epi16(1);
+        return _mm_packs_epi32(_mm_madd_epi16(a, one), _mm_madd_epi16(b, one));
+    }
+
+    static inline __m128i rmgr_fib_mm_hsub_epi16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        const __m128i oneMinusOne = _mm_set1_epi32(0xFFFF0001);
+        return _mm_packs_epi32(rmgr_fib_mm_wrap_epi32_epi16(_mm_madd_epi16(a, oneMinusOne)), rmgr_fib_mm_wrap_epi32_epi16(_mm_madd_epi16(b, oneMinusOne)));
+    }
+
+    static inline __m128i rmgr_fib_mm_hsubs_epi16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        const __m128i oneMinusOne = _mm_set1_epi32(0xFFFF0001);
+        return _mm_packs_epi32(_mm_madd_epi16(a, oneMinusOne), _mm_madd_epi16(b, oneMinusOne));
+    }
+
+    static inline __m128i rmgr_fib_mm_hadd_epi32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        const __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2,0,2,0));
+        const __m128 odd  = _mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(3,1,3,1));
+        return _mm_add_epi32(_mm_castps_si128(even), _mm_castps_si128(odd));
+    }
+
+    static inline __m128i rmgr_fib_mm_hsub_epi32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        const __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2,0,2,0));
+        const __m128 odd  = _mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(3,1,3,1));
+        return _mm_sub_epi32(_mm_castps_si128(even), _mm_castps_si128(odd));
+    }
+
+    // Sign transfer: a is negated where b is negative and zeroed where b is zero
+    static inline __m128i rmgr_fib_mm_sign_epi8(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i s    = _mm_cmpgt_epi8(zero, b);
+        return _mm_andnot_si128(_mm_cmpeq_epi8(b, zero), _mm_sub_epi8(_mm_xor_si128(a, s), s));
+    }
+
+    static inline __m128i rmgr_fib_mm_sign_epi16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        const __m128i s = _mm_srai_epi16(b, 15);
+        return _mm_andnot_si128(_mm_cmpeq_epi16(b, _mm_setzero_si128()), _mm_sub_epi16(_mm_xor_si128(a, s), s));
+    }
+
+    static inline __m128i rmgr_fib_mm_sign_epi32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        const __m128i s = _mm_srai_epi32(b, 31);
+        return _mm_andnot_si128(_mm_cmpeq_epi32(b, _mm_setzero_si128()), _mm_sub_epi32(_mm_xor_si128(a, s), s));
+    }
+
+    // Multiplications
+    static inline __m128i rmgr_fib_mm_mulhrs_epi16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        // ((p >> 14) + 1) >> 1 == (p >> 15) + bit 14 of p, only the low 16 bits of which are needed
+        const __m128i lo = _mm_mullo_epi16(a, b);
+        const __m128i hi = _mm_mulhi_epi16(a, b);
+        const __m128i p  = _mm_or_si128(_mm_slli_epi16(hi, 1), _mm_srli_epi16(lo, 15));
+        return _mm_add_epi16(p, _mm_and_si128(_mm_srli_epi16(lo, 14), _mm_set1_epi16(1)));
+    }
+
+    static inline __m128i rmgr_fib_mm_maddubs_epi16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        // Unsigned bytes of a times signed bytes of b fit in 16 bits, only their sums saturate
+        const __m128i evenA = _mm_and_si128(a, _mm_set1_epi16(0x00FF));
+        const __m128i oddA  = _mm_srli_epi16(a, 8);
+        const __m128i evenB = _mm_srai_epi16(_mm_slli_epi16(b, 8), 8);
+        const __m128i oddB  = _mm_srai_epi16(b, 8);
+        return _mm_adds_epi16(_mm_mullo_epi16(evenA, evenB), _mm_mullo_epi16(oddA, oddB));
+    }
+#endif
+
+// Byte shuffle by a compile-time control mask, given in memory order like for _mm_setr_epi8()
+#define _mm_shuffle_epi8_const(a, i0, i1, i2, i3, i4, i5, i6, i7, i8, i9, i10, i11, i12, i13, i14, i15) \
+    rmgr_fib_shuffle_epi8_const<(i0), (i1), (i2), (i3), (i4), (i5), (i6), (i7), (i8), (i9), (i10), (i11), (i12), (i13), (i14), (i15)>::apply(a)
+
+template<int i0, int i1, int i2, int i3, int i4, int i5, int i6, int i7, int i8, int i9, int i10, int i11, int i12, int i13, int i14, int i15>
+struct rmgr_fib_shuffle_epi8_const
+{
+    #define INTERNAL_RMGR_FIB_ALL_BYTES(macro, arg)                                                          \
+        macro(i0,0,arg),   macro(i1,1,arg),   macro(i2,2,arg),   macro(i3,3,arg),   macro(i4,4,arg),   macro(i5,5,arg),   \
+        macro(i6,6,arg),   macro(i7,7,arg),   macro(i8,8,arg),   macro(i9,9,arg),   macro(i10,10,arg), macro(i11,11,arg), \
+        macro(i12,12,arg), macro(i13,13,arg), macro(i14,14,arg), macro(i15,15,arg)
+    #define INTERNAL_RMGR_FIB_ANY_BYTE(macro, arg)                                                           \
+        (macro(i0,0,arg)   || macro(i1,1,arg)   || macro(i2,2,arg)   || macro(i3,3,arg)   || macro(i4,4,arg)   || macro(i5,5,arg)   || \
+         macro(i6,6,arg)   || macro(i7,7,arg)   || macro(i8,8,arg)   || macro(i9,9,arg)   || macro(i10,10,arg) || macro(i11,11,arg) || \
+         macro(i12,12,arg) || macro(i13,13,arg) || macro(i14,14,arg) || macro(i15,15,arg))
+
+    // -1 if destination byte d is read from source byte d + offset, 0 otherwise
+    #define INTERNAL_RMGR_FIB_MOVED_BY(i, d, offset)  char((((i) & 0x80) == 0 && ((i) & 15) == (d) + (offset)) ? -1 : 0)
+
+    // ORs the source bytes moved to their destination by offset into r, then recurses to the next offset
+    template<int offset, bool end = (offset > 15)>
+    struct moved
+    {
+        enum {any = INTERNAL_RMGR_FIB_ANY_BYTE(INTERNAL_RMGR_FIB_MOVED_BY, offset)};
+
+        static RMGR_FORCEINLINE __m128i apply(const __m128i& a, const __m128i& r) RMGR_NOEXCEPT
+        {
+            // A single recursive call site, or inlining would double at each offset
+            __m128i result = r;
+            if (any)
+            {
+                const __m128i shifted = (offset >= 0) ? _mm_srli_si128(a, (offset >= 0) ? offset : 0) : _mm_slli_si128(a, (offset < 0) ? -offset : 0);
+                const __m128i mask    = _mm_setr_epi8(INTERNAL_RMGR_FIB_ALL_BYTES(INTERNAL_RMGR_FIB_MOVED_BY, offset));
+                result = _mm_or_si128(result, _mm_and_si128(shifted, mask));
+            }
+            return moved<offset + 1>::apply(a, result);
+        }
+    };
+
+    template<int offset>
+    struct moved<offset, true>
+    {
+        static RMGR_FORCEINLINE __m128i apply(const __m128i&, const __m128i& r) RMGR_NOEXCEPT
+        {
+            return r;
+        }
+    };
+
+    // Whether destination byte d is read from the same dword of the source as the first byte of its own dword
+    #define INTERNAL_RMGR_FIB_IN_DWORD(i, d, first)  (((i) & 0x80) == 0 && ((i) & 3) == (d) % 4 && ((i) & 15) / 4 == ((first) & 15) / 4)
+    enum
+    {
+        isDwordShuffle = INTERNAL_RMGR_FIB_IN_DWORD(i0,0,i0)   && INTERNAL_RMGR_FIB_IN_DWORD(i1,1,i0)   && INTERNAL_RMGR_FIB_IN_DWORD(i2,2,i0)   && INTERNAL_RMGR_FIB_IN_DWORD(i3,3,i0)   &&
+                         INTERNAL_RMGR_FIB_IN_DWORD(i4,4,i4)   && INTERNAL_RMGR_FIB_IN_DWORD(i5,5,i4)   && INTERNAL_RMGR_FIB_IN_DWORD(i6,6,i4)   && INTERNAL_RMGR_FIB_IN_DWORD(i7,7,i4)   &&
+                         INTERNAL_RMGR_FIB_IN_DWORD(i8,8,i8)   && INTERNAL_RMGR_FIB_IN_DWORD(i9,9,i8)   && INTERNAL_RMGR_FIB_IN_DWORD(i10,10,i8) && INTERNAL_RMGR_FIB_IN_DWORD(i11,11,i8) &&
+                         INTERNAL_RMGR_FIB_IN_DWORD(i12,12,i12) && INTERNAL_RMGR_FIB_IN_DWORD(i13,13,i12) && INTERNAL_RMGR_FIB_IN_DWORD(i14,14,i12) && INTERNAL_RMGR_FIB_IN_DWORD(i15,15,i12),
+        dwordShuffle   = _MM_SHUFFLE((i12 & 15) / 4, (i8 & 15) / 4, (i4 & 15) / 4, (i0 & 15) / 4)
+    };
+
+    static RMGR_FORCEINLINE __m128i apply(const __m128i& a) RMGR_NOEXCEPT
+    {
+    #if INTERNAL_RMGR_FIB_USE_SSSE3
+        return _mm_shuffle_epi8(a, _mm_setr_epi8(char(i0), char(i1), char(i2),  char(i3),  char(i4),  char(i5),  char(i6),  char(i7),
+                                                 char(i8), char(i9), char(i10), char(i11), char(i12), char(i13), char(i14), char(i15)));
+    #else
+        if (isDwordShuffle)
+            return _mm_shuffle_epi32(a, dwordShuffle);
+        return moved<-15>::apply(a, _mm_setzero_si128());
+    #endif
+    }
+
+    #undef INTERNAL_RMGR_FIB_ALL_BYTES
+    #undef INTERNAL_RMGR_FIB_ANY_BYTE
+    #undef INTERNAL_RMGR_FIB_MOVED_BY
+    #undef INTERNAL_RMGR_FIB_IN_DWORD
+};
+
+
+//=================================================================================================
+// Comparisons
+
+// 8-bit signed
+static RMGR_FORCEINLINE __m128i _mm_cmpneq_epi8(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_not_si128(_mm_cmpeq_epi8(a,b));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmpge_epi8(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_not_si128(_mm_cmpgt_epi8(b,a));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmple_epi8(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_cmpge_epi8(b, a);
+}
+
+// 8-bit unsigned
+#define _mm_cmpeq_epu8         _mm_cmpeq_epi8
+#define _mm_cmpneq_epu8        _mm_cmpneq_epi8
+
+static RMGR_FORCEINLINE __m128i _mm_cmpge_epu8(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_cmpeq_epi8(a, _mm_max_epu8(a,b));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmple_epu8(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_cmpge_epu8(b, a);
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmpgt_epu8(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_not_si128(_mm_cmpge_epu8(b,a));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmplt_epu8(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_cmpgt_epu8(b, a);
+}
+
+// 16-bit signed
+static RMGR_FORCEINLINE __m128i _mm_cmpneq_epi16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_not_si128(_mm_cmpeq_epi16(a,b));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmpge_epi16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_not_si128(_mm_cmpgt_epi16(b,a));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmple_epi16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_cmpge_epi16(b, a);
+}
+
+// 16-bit unsigned
+#define _mm_cmpeq_epu16        _mm_cmpeq_epi16
+#define _mm_cmpneq_epu16       _mm_cmpneq_epi16
+
+static RMGR_FORCEINLINE __m128i _mm_cmpge_epu16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    return _mm_cmpeq_epi16(a, _mm_max_epu16(a,b));
+#else
+    return _mm_cmpeq_epi16(_mm_subs_epu16(b,a), _mm_setzero_si128());
+#endif
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmpgt_epu16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    return _mm_not_si128(_mm_cmpge_epu16(b,a));
+#else
+    const __m128i flip = _mm_set1_epi16(0x8000u);
+    return _mm_cmpgt_epi16(_mm_xor_si128(a,flip), _mm_xor_si128(b,flip));
+#endif
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmple_epu16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_cmpge_epu16(b, a);
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmplt_epu16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_cmpgt_epu16(b, a);
+}
+
+// 32-bit signed
+static RMGR_FORCEINLINE __m128i _mm_cmpneq_epi32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_not_si128(_mm_cmpeq_epi32(a,b));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmpge_epi32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_not_si128(_mm_cmpgt_epi32(b,a));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmple_epi32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_cmpge_epi32(b, a);
+}
+
+// 32-bit unsigned
+#define _mm_cmpeq_epu32        _mm_cmpeq_epi32
+#define _mm_cmpneq_epu32       _mm_cmpneq_epi32
+
+static RMGR_FORCEINLINE __m128i _mm_cmpgt_epu32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    return _mm_not_si128(_mm_cmpeq_epi32(b, _mm_max_epu32(b,a)));
+#else
+    const __m128i flip = _mm_set1_epi32(0x80000000u);
+    return _mm_cmpgt_epi32(_mm_xor_si128(a,flip), _mm_xor_si128(b,flip));
+#endif
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmpge_epu32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    return _mm_cmpeq_epi32(a, _mm_max_epu32(a,b));
+#else
+    return _mm_not_si128(_mm_cmpgt_epu32(b,a));
+#endif
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmple_epu32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_cmpge_epu32(b, a);
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmplt_epu32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_cmpgt_epu32(b, a);
+}
+
+// 64-bit signed
+#if !INTERNAL_RMGR_FIB_USE_SSE41
+    #define _mm_cmpeq_epi64    rmgr_fib_mm_cmpeq_epi64
+    static inline __m128i rmgr_fib_mm_cmpeq_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        const __m128i eq32 = _mm_cmpeq_epi32(a,b);
+        return _mm_and_si128(eq32, _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2,3,0,1)));
+    }
+#endif
+#if !INTERNAL_RMGR_FIB_USE_SSE42
+    #define _mm_cmpgt_epi64   rmgr_fib_mm_cmpgt_epi64
+    static inline __m128i rmgr_fib_mm_cmpgt_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        // See https://stackoverflow.com/a/65460455
+        const __m128i s = _mm_xor_si128(a, b);
+        const __m128i d = _mm_sub_epi64(b, a);
+        const __m128i r = INTERNAL_RMGR_FIB_SELECT(s, b, d);
+        return _mm_shuffle_epi32(_mm_srai_epi32(r,31), _MM_SHUFFLE(3,3,1,1));
+    }
+#endif
+
+static RMGR_FORCEINLINE __m128i _mm_cmpneq_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_not_si128(_mm_cmpeq_epi64(a,b));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmpge_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_not_si128(_mm_cmpgt_epi64(b,a));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmplt_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_cmpgt_epi64(b, a);
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmple_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_cmpge_epi64(b, a);
+}
+
+// 64-bit unsigned
+#define _mm_cmpeq_epu64        _mm_cmpeq_epi64
+#define _mm_cmpneq_epu64       _mm_cmpneq_epi64
+
+static inline __m128i _mm_cmpgt_epu64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSE42
+    const __m128i flip = _mm_set1_epi64x(0x8000000000000000ll);
+    return _mm_cmpgt_epi64(_mm_xor_si128(a,flip), _mm_xor_si128(b,flip));
+#else
+    // See https://stackoverflow.com/a/65460455
+    const __m128i s = _mm_xor_si128(a, b);
+    const __m128i d = _mm_sub_epi64(b, a);
+    const __m128i r = INTERNAL_RMGR_FIB_SELECT(s, a, d);
+    return _mm_shuffle_epi32(_mm_srai_epi32(r,31), _MM_SHUFFLE(3,3,1,1));
+#endif
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmpge_epu64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_not_si128(_mm_cmpgt_epu64(b,a));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmplt_epu64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_cmpgt_epu64(b, a);
+}
+
+static RMGR_FORCEINLINE __m128i _mm_cmple_epu64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_cmpge_epu64(b, a);
+}
+
+
+//=================================================================================================
+// Shifts
+
+// 8-bit shifts
+#define _mm_slli_epi8(a, imm8)   rmgr_fib_mm_slli_epi8<(imm8)>(a)
+#define _mm_srli_epi8(a, imm8)   rmgr_fib_mm_srli_epi8<(imm8)>(a)
+#define _mm_srai_epi8(a, imm8)   rmgr_fib_mm_srai_epi8<(imm8)>(a)
+
+template<int N>
+static RMGR_FORCEINLINE __m128i rmgr_fib_mm_slli_epi8(const __m128i& a) RMGR_NOEXCEPT
+{
+    return _mm_and_si128(_mm_slli_epi16(a,N), _mm_set1_epi8(uint8_t(255 & (255<<(N&7)))));
+}
+
+template<int N>
+static RMGR_FORCEINLINE __m128i rmgr_fib_mm_srli_epi8(const __m128i& a) RMGR_NOEXCEPT
+{
+    return _mm_and_si128(_mm_srli_epi16(a,N), _mm_set1_epi8(int8_t(255u>>(N&7))));
+}
+
+template<int N>
+static RMGR_FORCEINLINE __m128i rmgr_fib_mm_srai_epi8(const __m128i& a) RMGR_NOEXCEPT
+{
+    return _mm_packs_epi16(_mm_srai_epi16(_mm_unpacklo_epi8(a,a), N+8), _mm_srai_epi16(_mm_unpackhi_epi8(a,a), N+8));
+}
+
+static inline __m128i _mm_sll_epi8(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+{
+    const __m128i twoFiftySix = _mm_set1_epi16(256);
+    const __m128i mask        = _mm_sub_epi16(_mm_sll_epi16(twoFiftySix, count), twoFiftySix);
+    return _mm_andnot_si128(mask, _mm_sll_epi16(a, count));
+}
+
+static inline __m128i _mm_srl_epi8(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+{
+    const __m128i twoFiftySix = _mm_set1_epi16(256);
+    const __m128i mask        = _mm_sub_epi16(twoFiftySix, _mm_srl_epi16(twoFiftySix, count));
+    return _mm_andnot_si128(mask, _mm_srl_epi16(a, count));
+}
+
+static inline __m128i _mm_sra_epi8(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+{
+    const __m128i count16 = _mm_add_epi64(count, _mm_set1_epi64x(8));
+    return _mm_packs_epi16(_mm_sra_epi16(_mm_unpacklo_epi8(a,a), count16), _mm_sra_epi16(_mm_unpackhi_epi8(a,a), count16));
+}
+
+
+// 64-bit arithmetic right shift
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    #undef  _mm_srai_epi64  // GCC declares it as a macro in unoptimized builds, even without AVX512VL
+    #define _mm_srai_epi64(a, imm8)  rmgr_fib_mm_srai_epi64<(imm8)>(a)
+    #define _mm_sra_epi64            rmgr_fib_mm_sra_epi64
+
+    static inline __m128i rmgr_fib_mm_sra_epi64(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+    {
+        #if INTERNAL_RMGR_FIB_USE_SSE42
+            const __m128i sign = _mm_cmpgt_epi64(_mm_setzero_si128(), a);
+        #else
+            const __m128i sign = _mm_shuffle_epi32(_mm_cmpgt_epi32(_mm_setzero_si128(), a), _MM_SHUFFLE(3,3,1,1));
+        #endif
+        return _mm_or_si128(_mm_srl_epi64(a,count), _mm_sll_epi64(sign,_mm_sub_epi64(_mm_set1_epi64x(63),count)));
+    }
+
+    template<unsigned N>
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_srai_epi64(const __m128i& a) RMGR_NOEXCEPT
+    {
+        #if INTERNAL_RMGR_FIB_USE_SSE42
+            const __m128i sign = _mm_cmpgt_epi64(_mm_setzero_si128(), a);
+        #else
+            const __m128i sign = _mm_shuffle_epi32(_mm_cmpgt_epi32(_mm_setzero_si128(), a), _MM_SHUFFLE(3,3,1,1));
+        #endif
+        return _mm_or_si128(_mm_srli_epi64(a,N), _mm_slli_epi64(sign,63-N));
+    }
+
+    template<>
+    RMGR_FORCEINLINE __m128i rmgr_fib_mm_srai_epi64<0u>(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return a;
+    }
+
+    template<>
+    RMGR_FORCEINLINE __m128i rmgr_fib_mm_srai_epi64<1u>(const __m128i& a) RMGR_NOEXCEPT
+    {
+        // The sign bit just stays in place
+        return _mm_or_si128(_mm_srli_epi64(a,1), _mm_and_si128(a, _mm_set1_epi64x(0x8000000000000000ll)));
+    }
+
+    template<>
+    RMGR_FORCEINLINE __m128i rmgr_fib_mm_srai_epi64<63u>(const __m128i& a) RMGR_NOEXCEPT
+    {
+        #if INTERNAL_RMGR_FIB_USE_SSE42
+            return _mm_cmpgt_epi64(_mm_setzero_si128(), a);
+        #else
+            return _mm_shuffle_epi32(_mm_cmpgt_epi32(_mm_setzero_si128(), a), _MM_SHUFFLE(3,3,1,1));
+        #endif
+    }
+#endif
+
+
+//=================================================================================================
+// Variable shifts
+//
+// Each lane is shifted by the matching lane of count, which is treated as unsigned: counts greater
+// than the lane width minus one give 0 for logical shifts and a copy of the sign bit for arithmetic
+// ones, just like AVX2 does.
+
+// Selects the bytes of a whose matching byte in mask has its MSB set, the bytes of b otherwise
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    #define INTERNAL_RMGR_FIB_SELECT_MSB8(mask, a, b)  _mm_blendv_epi8((b), (a), (mask))
+#else
+    #define INTERNAL_RMGR_FIB_SELECT_MSB8(mask, a, b)  INTERNAL_RMGR_FIB_SELECT(_mm_cmpgt_epi8(_mm_setzero_si128(), (mask)), (a), (b))
+#endif
+
+// 8-bit
+static inline __m128i _mm_sllv_epi8(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+{
+    #if INTERNAL_RMGR_FIB_USE_SSSE3
+        // Multiply by 2^count (looked up in a table), even and odd bytes being multiplied separately
+        const __m128i table    = _mm_setr_epi8(1,2,4,8,16,32,64,-128, 0,0,0,0,0,0,0,0);
+        const __m128i pow2     = _mm_shuffle_epi8(table, _mm_min_epu8(count, _mm_set1_epi8(8)));
+        const __m128i lowBytes = _mm_set1_epi16(0x00FF);
+        const __m128i lo       = _mm_mullo_epi16(a, pow2);
+        const __m128i hi       = _mm_mullo_epi16(_mm_andnot_si128(lowBytes, a), _mm_srli_epi16(pow2, 8));
+        return _mm_or_si128(_mm_and_si128(lo, lowBytes), hi);
+    #else
+        // Shift by 4, 2 and 1, selecting each step with a bit of count brought to the MSB
+        __m128i c = _mm_slli_epi16(count, 5);
+        __m128i r = INTERNAL_RMGR_FIB_SELECT_MSB8(c, _mm_slli_epi8(a, 4), a);
+        c = _mm_add_epi8(c, c);
+        r = INTERNAL_RMGR_FIB_SELECT_MSB8(c, _mm_slli_epi8(r, 2), r);
+        c = _mm_add_epi8(c, c);
+        r = INTERNAL_RMGR_FIB_SELECT_MSB8(c, _mm_add_epi8(r, r), r);
+        const __m128i seven = _mm_set1_epi8(7);
+        return _mm_and_si128(r, _mm_cmpeq_epi8(_mm_min_epu8(count, seven), count));
+    #endif
+}
+
+static inline __m128i _mm_srlv_epi8(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+{
+    // Shift by 4, 2 and 1, selecting each step with a bit of count brought to the MSB
+    __m128i c = _mm_slli_epi16(count, 5);
+    __m128i r = INTERNAL_RMGR_FIB_SELECT_MSB8(c, _mm_srli_epi8(a, 4), a);
+    c = _mm_add_epi8(c, c);
+    r = INTERNAL_RMGR_FIB_SELECT_MSB8(c, _mm_srli_epi8(r, 2), r);
+    c = _mm_add_epi8(c, c);
+    r = INTERNAL_RMGR_FIB_SELECT_MSB8(c, _mm_srli_epi8(r, 1), r);
+    const __m128i seven = _mm_set1_epi8(7);
+    return _mm_and_si128(r, _mm_cmpeq_epi8(_mm_min_epu8(count, seven), count));
+}
+
+static inline __m128i _mm_srav_epi8(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+{
+    // Flipping negative values turns the arithmetic shift into a logical one
+    const __m128i s = _mm_cmpgt_epi8(_mm_setzero_si128(), a);
+    return _mm_xor_si128(_mm_srlv_epi8(_mm_xor_si128(a, s), count), s);
+}
+
+// 16-bit
+#if !(INTERNAL_RMGR_FIB_USE_AVX512BW && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define _mm_sllv_epi16  rmgr_fib_mm_sllv_epi16
+    #define _mm_srlv_epi16  rmgr_fib_mm_srlv_epi16
+    #define _mm_srav_epi16  rmgr_fib_mm_srav_epi16
+
+    #if INTERNAL_RMGR_FIB_USE_SSSE3
+    // Returns 2^count, or 0 if count > 15
+    static inline __m128i rmgr_fib_mm_pow2_epi16(const __m128i& count) RMGR_NOEXCEPT
+    {
+        // The low byte looks up count and the high byte count^8, so a single table is enough
+        const __m128i table   = _mm_setr_epi8(1,2,4,8,16,32,64,-128, 0,0,0,0,0,0,0,0);
+        const __m128i index   = _mm_xor_si128(_mm_or_si128(count, _mm_slli_epi16(count, 8)), _mm_set1_epi16(0x0800));
+        const __m128i inRange = _mm_cmpeq_epi16(_mm_srli_epi16(count, 4), _mm_setzero_si128());
+        return _mm_and_si128(_mm_shuffle_epi8(table, index), inRange);
+    }
+    #endif
+
+    static inline __m128i rmgr_fib_mm_sllv_epi16(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+    {
+        #if INTERNAL_RMGR_FIB_USE_AVX2
+            // Even and odd lanes are shifted separately as 32-bit lanes
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i even = _mm_sllv_epi32(a, _mm_blend_epi16(count, zero, 0xAA));
+            const __m128i odd  = _mm_sllv_epi32(_mm_blend_epi16(zero, a, 0xAA), _mm_srli_epi32(count, 16));
+            return _mm_blend_epi16(even, odd, 0xAA);
+        #elif INTERNAL_RMGR_FIB_USE_SSSE3
+            return _mm_mullo_epi16(a, rmgr_fib_mm_pow2_epi16(count));
+        #else
+            // Shift by 8, 4, 2 and 1, selecting each step with a bit of count brought to the MSB
+            __m128i c = _mm_slli_epi16(count, 12);
+            __m128i r = INTERNAL_RMGR_FIB_SELECT(_mm_srai_epi16(c, 15), _mm_slli_epi16(a, 8), a);
+            c = _mm_add_epi16(c, c);
+            r = INTERNAL_RMGR_FIB_SELECT(_mm_srai_epi16(c, 15), _mm_slli_epi16(r, 4), r);
+            c = _mm_add_epi16(c, c);
+            r = INTERNAL_RMGR_FIB_SELECT(_mm_srai_epi16(c, 15), _mm_slli_epi16(r, 2), r);
+            c = _mm_add_epi16(c, c);
+            r = INTERNAL_RMGR_FIB_SELECT(_mm_srai_epi16(c, 15), _mm_add_epi16(r, r), r);
+            return _mm_and_si128(r, _mm_cmpeq_epi16(_mm_srli_epi16(count, 4), _mm_setzero_si128()));
+        #endif
+    }
+
+    static inline __m128i rmgr_fib_mm_srlv_epi16(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+    {
+        #if INTERNAL_RMGR_FIB_USE_AVX2
+            // Even and odd lanes are shifted separately as 32-bit lanes
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i even = _mm_srlv_epi32(_mm_blend_epi16(a, zero, 0xAA), _mm_blend_epi16(count, zero, 0xAA));
+            const __m128i odd  = _mm_srlv_epi32(a, _mm_srli_epi32(count, 16));
+            return _mm_blend_epi16(even, odd, 0xAA);
+        #elif INTERNAL_RMGR_FIB_USE_SSSE3
+            // a >> count is the high half of a * 2^(16-count), except for count == 0 because 2^16 doesn't fit
+            const __m128i pow2 = rmgr_fib_mm_pow2_epi16(_mm_sub_epi16(_mm_set1_epi16(16), count));
+            const __m128i same = _mm_and_si128(a, _mm_cmpeq_epi16(count, _mm_setzero_si128()));
+            return _mm_or_si128(_mm_mulhi_epu16(a, pow2), same);
+        #else
+            // Shift by 8, 4, 2 and 1, selecting each step with a bit of count brought to the MSB
+            __m128i c = _mm_slli_epi16(count, 12);
+            __m128i r = INTERNAL_RMGR_FIB_SELECT(_mm_srai_epi16(c, 15), _mm_srli_epi16(a, 8), a);
+            c = _mm_add_epi16(c, c);
+            r = INTERNAL_RMGR_FIB_SELECT(_mm_srai_epi16(c, 15), _mm_srli_epi16(r, 4), r);
+            c = _mm_add_epi16(c, c);
+            r = INTERNAL_RMGR_FIB_SELECT(_mm_srai_epi16(c, 15), _mm_srli_epi16(r, 2), r);
+            c = _mm_add_epi16(c, c);
+            r = INTERNAL_RMGR_FIB_SELECT(_mm_srai_epi16(c, 15), _mm_srli_epi16(r, 1), r);
+            return _mm_and_si128(r, _mm_cmpeq_epi16(_mm_srli_epi16(count, 4), _mm_setzero_si128()));
+        #endif
+    }
+
+    static inline __m128i rmgr_fib_mm_srav_epi16(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+    {
+        // Flipping negative values turns the arithmetic shift into a logical one
+        const __m128i s = _mm_srai_epi16(a, 15);
+        return _mm_xor_si128(rmgr_fib_mm_srlv_epi16(_mm_xor_si128(a, s), count), s);
+    }
+#endif
+
+// 32-bit
+#if !INTERNAL_RMGR_FIB_USE_AVX2
+    #define _mm_sllv_epi32  rmgr_fib_mm_sllv_epi32
+    #define _mm_srlv_epi32  rmgr_fib_mm_srlv_epi32
+    #define _mm_srav_epi32  rmgr_fib_mm_srav_epi32
+
+    // Returns lane i of ri
+    static inline __m128i rmgr_fib_mm_blend_diag_epi32(const __m128i& r0, const __m128i& r1, const __m128i& r2, const __m128i& r3) RMGR_NOEXCEPT
+    {
+        #if INTERNAL_RMGR_FIB_USE_SSE41
+            return _mm_blend_epi16(_mm_blend_epi16(r0, r1, 0x0C), _mm_blend_epi16(r2, r3, 0xC0), 0xF0);
+        #else
+            const __m128 lo = _mm_shuffle_ps(_mm_castsi128_ps(r0), _mm_castsi128_ps(r1), _MM_SHUFFLE(1,1,0,0));
+            const __m128 hi = _mm_shuffle_ps(_mm_castsi128_ps(r2), _mm_castsi128_ps(r3), _MM_SHUFFLE(3,3,2,2));
+            return _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2,0,2,0)));
+        #endif
+    }
+
+    static inline __m128i rmgr_fib_mm_sllv_epi32(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+    {
+        // Multiply by 2^count, built by stuffing count into the exponent of a float
+        const __m128i one  = _mm_castps_si128(_mm_set1_ps(1.0f));
+        const __m128i pow2 = _mm_cvttps_epi32(_mm_castsi128_ps(_mm_add_epi32(_mm_slli_epi32(count, 23), one)));
+        #if INTERNAL_RMGR_FIB_USE_SSE41
+            const __m128i r = _mm_mullo_epi32(a, pow2);
+        #else
+            const __m128i even = _mm_mul_epu32(a, pow2);
+            const __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(pow2, 32));
+            const __m128i r    = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(3,1,2,0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(3,1,2,0)));
+        #endif
+        return _mm_and_si128(r, _mm_cmpeq_epi32(_mm_srli_epi32(count, 5), _mm_setzero_si128()));
+    }
+
+    static inline __m128i rmgr_fib_mm_srlv_epi32(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+    {
+        // Shift the whole vector once per lane, each count being zero-extended to 64 bits
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i r0   = _mm_srl_epi32(a, _mm_unpacklo_epi32(count, zero));
+        const __m128i r1   = _mm_srl_epi32(a, _mm_srli_epi64(count, 32));
+        const __m128i r2   = _mm_srl_epi32(a, _mm_unpackhi_epi32(count, zero));
+        const __m128i r3   = _mm_srl_epi32(a, _mm_srli_si128(count, 12));
+        return rmgr_fib_mm_blend_diag_epi32(r0, r1, r2, r3);
+    }
+
+    static inline __m128i rmgr_fib_mm_srav_epi32(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+    {
+        // Shift the whole vector once per lane, each count being zero-extended to 64 bits
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i r0   = _mm_sra_epi32(a, _mm_unpacklo_epi32(count, zero));
+        const __m128i r1   = _mm_sra_epi32(a, _mm_srli_epi64(count, 32));
+        const __m128i r2   = _mm_sra_epi32(a, _mm_unpackhi_epi32(count, zero));
+        const __m128i r3   = _mm_sra_epi32(a, _mm_srli_si128(count, 12));
+        return rmgr_fib_mm_blend_diag_epi32(r0, r1, r2, r3);
+    }
+#endif
+
+// 64-bit logical
+#if !INTERNAL_RMGR_FIB_USE_AVX2
+    #define _mm_sllv_epi64  rmgr_fib_mm_sllv_epi64
+    #define _mm_srlv_epi64  rmgr_fib_mm_srlv_epi64
+
+    // Returns the low lane of lo and the high lane of hi
+    static inline __m128i rmgr_fib_mm_blend_hi_epi64(const __m128i& lo, const __m128i& hi) RMGR_NOEXCEPT
+    {
+        #if INTERNAL_RMGR_FIB_USE_SSE41
+            return _mm_blend_epi16(lo, hi, 0xF0);
+        #else
+            return _mm_castpd_si128(_mm_move_sd(_mm_castsi128_pd(hi), _mm_castsi128_pd(lo)));
+        #endif
+    }
+
+    static inline __m128i rmgr_fib_mm_sllv_epi64(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+    {
+        return rmgr_fib_mm_blend_hi_epi64(_mm_sll_epi64(a, count), _mm_sll_epi64(a, _mm_unpackhi_epi64(count, count)));
+    }
+
+    static inline __m128i rmgr_fib_mm_srlv_epi64(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+    {
+        return rmgr_fib_mm_blend_hi_epi64(_mm_srl_epi64(a, count), _mm_srl_epi64(a, _mm_unpackhi_epi64(count, count)));
+    }
+#endif
+
+// 64-bit arithmetic
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    #define _mm_srav_epi64  rmgr_fib_mm_srav_epi64
+
+    static inline __m128i rmgr_fib_mm_srav_epi64(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+    {
+        // Flipping negative values turns the arithmetic shift into a logical one
+        const __m128i s = _mm_srai_epi64(a, 63);
+        return _mm_xor_si128(_mm_srlv_epi64(_mm_xor_si128(a, s), count), s);
+    }
+#endif
+
+
+//=================================================================================================
+// Rotates
+//
+// Lanes are rotated by their count modulo their width, like AVX-512 does, so a right rotate is a
+// left rotate by the opposite count. Immediate rotates by whole bytes are byte permutations, a
+// single pshufb with SSSE3. Other rotates OR a left and a right shift, the variable ones using the
+// variable shifts above, except where a multiplication by 2^count gets both shifts at once.
+
+// Rotates each lane of bits bits left by N bytes
+template<int bits, int N>
+static RMGR_FORCEINLINE __m128i rmgr_fib_mm_rol_bytes(const __m128i& a) RMGR_NOEXCEPT
+{
+    // Destination byte d is read from byte d - N of the same lane
+    #define INTERNAL_RMGR_FIB_ROL_BYTE(d)  ((d) - (d) % (bits/8) + ((d) % (bits/8) + bits/8 - N) % (bits/8))
+    return _mm_shuffle_epi8_const(a, INTERNAL_RMGR_FIB_ROL_BYTE(0),  INTERNAL_RMGR_FIB_ROL_BYTE(1),  INTERNAL_RMGR_FIB_ROL_BYTE(2),  INTERNAL_RMGR_FIB_ROL_BYTE(3),
+                                     INTERNAL_RMGR_FIB_ROL_BYTE(4),  INTERNAL_RMGR_FIB_ROL_BYTE(5),  INTERNAL_RMGR_FIB_ROL_BYTE(6),  INTERNAL_RMGR_FIB_ROL_BYTE(7),
+                                     INTERNAL_RMGR_FIB_ROL_BYTE(8),  INTERNAL_RMGR_FIB_ROL_BYTE(9),  INTERNAL_RMGR_FIB_ROL_BYTE(10), INTERNAL_RMGR_FIB_ROL_BYTE(11),
+                                     INTERNAL_RMGR_FIB_ROL_BYTE(12), INTERNAL_RMGR_FIB_ROL_BYTE(13), INTERNAL_RMGR_FIB_ROL_BYTE(14), INTERNAL_RMGR_FIB_ROL_BYTE(15));
+    #undef INTERNAL_RMGR_FIB_ROL_BYTE
+}
+
+// 8-bit
+#define _mm_rol_epi8(a, imm8)  rmgr_fib_mm_rol_epi8<(imm8)>(a)
+#define _mm_ror_epi8(a, imm8)  rmgr_fib_mm_rol_epi8<-(imm8)>(a)
+
+template<int N>
+static RMGR_FORCEINLINE __m128i rmgr_fib_mm_rol_epi8(const __m128i& a) RMGR_NOEXCEPT
+{
+    // 16-bit shifts are right for the bits that don't cross a byte boundary, a bitwise select picks them
+    const int n = N & 7;
+    if (n == 0)
+        return a;
+    const __m128i mask = _mm_set1_epi8(char(255 & (255 << n)));
+    return _mm_ternarylogic_epi32(mask, _mm_slli_epi16(a, n), _mm_srli_epi16(a, (8 - n) & 7), 0xCA);
+}
+
+static inline __m128i _mm_rolv_epi8(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+{
+    const __m128i n = _mm_and_si128(count, _mm_set1_epi8(7));
+    return _mm_or_si128(_mm_sllv_epi8(a, n), _mm_srlv_epi8(a, _mm_sub_epi8(_mm_set1_epi8(8), n)));
+}
+
+static inline __m128i _mm_rorv_epi8(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+{
+    return _mm_rolv_epi8(a, _mm_sub_epi8(_mm_setzero_si128(), count));
+}
+
+// 16-bit
+#define _mm_rol_epi16(a, imm8)  rmgr_fib_mm_rol_epi16<(imm8)>(a)
+#define _mm_ror_epi16(a, imm8)  rmgr_fib_mm_rol_epi16<-(imm8)>(a)
+
+template<int N>
+static RMGR_FORCEINLINE __m128i rmgr_fib_mm_rol_epi16(const __m128i& a) RMGR_NOEXCEPT
+{
+    const int n = N & 15;
+    if (n == 0)
+        return a;
+#if INTERNAL_RMGR_FIB_USE_SSSE3
+    if (n == 8)
+        return rmgr_fib_mm_rol_bytes<16, 1>(a);
+#endif
+    return _mm_or_si128(_mm_slli_epi16(a, n), _mm_srli_epi16(a, (16 - n) & 15));
+}
+
+static inline __m128i _mm_rolv_epi16(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+{
+    const __m128i n = _mm_and_si128(count, _mm_set1_epi16(15));
+    #if INTERNAL_RMGR_FIB_USE_SSSE3 && !(INTERNAL_RMGR_FIB_USE_AVX512BW && INTERNAL_RMGR_FIB_USE_AVX512VL)
+        // The 32-bit product of a and 2^n holds a << n in its low half and a >> (16-n) in its high half
+        const __m128i pow2 = rmgr_fib_mm_pow2_epi16(n);
+        return _mm_or_si128(_mm_mullo_epi16(a, pow2), _mm_mulhi_epu16(a, pow2));
+    #else
+        return _mm_or_si128(_mm_sllv_epi16(a, n), _mm_srlv_epi16(a, _mm_sub_epi16(_mm_set1_epi16(16), n)));
+    #endif
+}
+
+static inline __m128i _mm_rorv_epi16(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+{
+    return _mm_rolv_epi16(a, _mm_sub_epi16(_mm_setzero_si128(), count));
+}
+
+// 32 & 64-bit
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    // GCC declares them as macros in unoptimized builds, even without AVX512VL
+    #undef  _mm_rol_epi32
+    #undef  _mm_ror_epi32
+    #undef  _mm_rol_epi64
+    #undef  _mm_ror_epi64
+    #define _mm_rol_epi32(a, imm8)  rmgr_fib_mm_rol_epi32<(imm8)>(a)
+    #define _mm_ror_epi32(a, imm8)  rmgr_fib_mm_rol_epi32<-(imm8)>(a)
+    #define _mm_rol_epi64(a, imm8)  rmgr_fib_mm_rol_epi64<(imm8)>(a)
+    #define _mm_ror_epi64(a, imm8)  rmgr_fib_mm_rol_epi64<-(imm8)>(a)
+    #define _mm_rolv_epi32          rmgr_fib_mm_rolv_epi32
+    #define _mm_rorv_epi32          rmgr_fib_mm_rorv_epi32
+    #define _mm_rolv_epi64          rmgr_fib_mm_rolv_epi64
+    #define _mm_rorv_epi64          rmgr_fib_mm_rorv_epi64
+
+    template<int N>
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_rol_epi32(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const int n = N & 31;
+        if (n == 0)
+            return a;
+        #if INTERNAL_RMGR_FIB_USE_SSSE3
+            if (n % 8 == 0)
+                return rmgr_fib_mm_rol_bytes<32, n / 8>(a);
+        #else
+            if (n == 16)
+                return _mm_shufflehi_epi16(_mm_shufflelo_epi16(a, _MM_SHUFFLE(2,3,0,1)), _MM_SHUFFLE(2,3,0,1));
+        #endif
+        return _mm_or_si128(_mm_slli_epi32(a, n), _mm_srli_epi32(a, (32 - n) & 31));
+    }
+
+    template<int N>
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_rol_epi64(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const int n = N & 63;
+        if (n == 0)
+            return a;
+        if (n == 32)
+            return _mm_shuffle_epi32(a, _MM_SHUFFLE(2,3,0,1));
+        #if INTERNAL_RMGR_FIB_USE_SSSE3
+            if (n % 8 == 0)
+                return rmgr_fib_mm_rol_bytes<64, n / 8>(a);
+        #endif
+        return _mm_or_si128(_mm_slli_epi64(a, n), _mm_srli_epi64(a, (64 - n) & 63));
+    }
+
+    static inline __m128i rmgr_fib_mm_rolv_epi32(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+    {
+        const __m128i n = _mm_and_si128(count, _mm_set1_epi32(31));
+        #if INTERNAL_RMGR_FIB_USE_AVX2
+            return _mm_or_si128(_mm_sllv_epi32(a, n), _mm_srlv_epi32(a, _mm_sub_epi32(_mm_set1_epi32(32), n)));
+        #else
+            // The 64-bit product of a and 2^n holds a << n in its low half and a >> (32-n) in its high half,
+            // 2^n being built by stuffing n into the exponent of a float (2^31 overflows to 0x80000000 as wanted)
+            const __m128i one   = _mm_castps_si128(_mm_set1_ps(1.0f));
+            const __m128i pow2  = _mm_cvttps_epi32(_mm_castsi128_ps(_mm_add_epi32(_mm_slli_epi32(n, 23), one)));
+            const __m128i even  = _mm_mul_epu32(a, pow2);
+            const __m128i odd   = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(pow2, 32));
+            const __m128i evenR = _mm_or_si128(even, _mm_shuffle_epi32(even, _MM_SHUFFLE(2,3,0,1)));
+            const __m128i oddR  = _mm_or_si128(odd,  _mm_shuffle_epi32(odd,  _MM_SHUFFLE(2,3,0,1)));
+            return rmgr_fib_mm_blend_diag_epi32(evenR, oddR, evenR, oddR);
+        #endif
+    }
+
+    static inline __m128i rmgr_fib_mm_rorv_epi32(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+    {
+        return rmgr_fib_mm_rolv_epi32(a, _mm_sub_epi32(_mm_setzero_si128(), count));
+    }
+
+    static inline __m128i rmgr_fib_mm_rolv_epi64(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+    {
+        const __m128i n = _mm_and_si128(count, _mm_set1_epi64x(63));
+        return _mm_or_si128(_mm_sllv_epi64(a, n), _mm_srlv_epi64(a, _mm_sub_epi64(_mm_set1_epi64x(64), n)));
+    }
+
+    static inline __m128i rmgr_fib_mm_rorv_epi64(const __m128i& a, const __m128i& count) RMGR_NOEXCEPT
+    {
+        return rmgr_fib_mm_rolv_epi64(a, _mm_sub_epi64(_mm_setzero_si128(), count));
+    }
+#endif
+
+
+//=================================================================================================
+// Min & max
+
+// 8-bit signed
+#if !INTERNAL_RMGR_FIB_USE_SSE41
+    #define _mm_min_epi8   rmgr_fib_mm_min_epi8
+    #define _mm_max_epi8   rmgr_fib_mm_max_epi8
+
+    static inline __m128i rmgr_fib_mm_min_epi8(const __m128i& a, const __m128i b) RMGR_NOEXCEPT
+    {
+        const __m128i mask = _mm_cmpgt_epi8(a, b);
+        return INTERNAL_RMGR_FIB_SELECT(mask, b, a);
+    }
+
+    static inline __m128i rmgr_fib_mm_max_epi8(const __m128i& a, const __m128i b) RMGR_NOEXCEPT
+    {
+        const __m128i mask = _mm_cmpgt_epi8(a, b);
+        return INTERNAL_RMGR_FIB_SELECT(mask, a, b);
+    }
+#endif
+
+// 16-bit unsigned
+#if !INTERNAL_RMGR_FIB_USE_SSE41
+    #define _mm_min_epu16  rmgr_fib_mm_min_epu16
+    #define _mm_max_epu16  rmgr_fib_mm_max_epu16
+
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_min_epu16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        return _mm_sub_epi16(a, _mm_subs_epu16(a,b));
+    }
+
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_max_epu16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        return _mm_add_epi16(b, _mm_subs_epu16(a,b));
+    }
+#endif
+
+// 32-bit signed
+#if !INTERNAL_RMGR_FIB_USE_SSE41
+    #define _mm_min_epi32   rmgr_fib_mm_min_epi32
+    #define _mm_max_epi32   rmgr_fib_mm_max_epi32
+
+    static inline __m128i rmgr_fib_mm_min_epi32(const __m128i& a, const __m128i b) RMGR_NOEXCEPT
+    {
+        const __m128i mask = _mm_cmpgt_epi32(a, b);
+        return INTERNAL_RMGR_FIB_SELECT(mask, b, a);
+    }
+
+    static inline __m128i rmgr_fib_mm_max_epi32(const __m128i& a, const __m128i b) RMGR_NOEXCEPT
+    {
+        const __m128i mask = _mm_cmpgt_epi32(a, b);
+        return INTERNAL_RMGR_FIB_SELECT(mask, a, b);
+    }
+#endif
+
+// 32-bit unsigned
+#if !INTERNAL_RMGR_FIB_USE_SSE41
+    #define _mm_min_epu32   rmgr_fib_mm_min_epu32
+    #define _mm_max_epu32   rmgr_fib_mm_max_epu32
+
+    static inline __m128i rmgr_fib_mm_min_epu32(const __m128i& a, const __m128i b) RMGR_NOEXCEPT
+    {
+        const __m128i mask = _mm_cmpgt_epu32(a, b);
+        return INTERNAL_RMGR_FIB_SELECT(mask, b, a);
+    }
+
+    static inline __m128i rmgr_fib_mm_max_epu32(const __m128i& a, const __m128i b) RMGR_NOEXCEPT
+    {
+        const __m128i mask = _mm_cmpgt_epu32(a, b);
+        return INTERNAL_RMGR_FIB_SELECT(mask, a, b);
+    }
+#endif
+
+// 64-bit signed
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    #define _mm_min_epi64  rmgr_fib_mm_min_epi64
+    #define _mm_max_epi64  rmgr_fib_mm_max_epi64
+
+    static inline __m128i rmgr_fib_mm_min_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        #if INTERNAL_RMGR_FIB_USE_SSE41
+            // _mm_blendv_pd() allows us to save two instructions compared to calling _mm_cmpgt_epi64()
+            const __m128i s = _mm_xor_si128(a, b);
+            const __m128i d = _mm_sub_epi64(b, a);
+            const __m128i m = _mm_blendv_epi8(d, b, s);
+            return _mm_castpd_si128(_mm_blendv_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b), _mm_castsi128_pd(m)));
+        #else
+            const __m128i m = _mm_cmpgt_epi64(a, b);
+            return INTERNAL_RMGR_FIB_SELECT(m, b, a);
+        #endif
+    }
+
+    static inline __m128i rmgr_fib_mm_max_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        #if INTERNAL_RMGR_FIB_USE_SSE41
+            // _mm_blendv_pd() allows us to save two instructions compared to calling _mm_cmpgt_epi64()
+            const __m128i s = _mm_xor_si128(a, b);
+            const __m128i d = _mm_sub_epi64(b, a);
+            const __m128i m = _mm_blendv_epi8(d, b, s);
+            return _mm_castpd_si128(_mm_blendv_pd(_mm_castsi128_pd(b), _mm_castsi128_pd(a), _mm_castsi128_pd(m)));
+        #else
+            const __m128i m = _mm_cmpgt_epi64(a, b);
+            return INTERNAL_RMGR_FIB_SELECT(m, a, b);
+        #endif
+    }
+#endif
+
+// 64-bit unsigned
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    #define _mm_min_epu64  rmgr_fib_mm_min_epu64
+    #define _mm_max_epu64  rmgr_fib_mm_max_epu64
+
+    static inline __m128i rmgr_fib_mm_min_epu64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        #if INTERNAL_RMGR_FIB_USE_SSE41
+            // _mm_blendv_pd() allows us to save two instructions compared to calling _mm_cmpgt_epu64()
+            const __m128i s = _mm_xor_si128(a, b);
+            const __m128i d = _mm_sub_epi64(b, a);
+            const __m128i m = _mm_blendv_epi8(d, a, s);
+            return _mm_castpd_si128(_mm_blendv_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b), _mm_castsi128_pd(m)));
+        #else
+            const __m128i m = _mm_cmpgt_epu64(a, b);
+            return INTERNAL_RMGR_FIB_SELECT(m, b, a);
+        #endif
+    }
+
+    static inline __m128i rmgr_fib_mm_max_epu64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        #if INTERNAL_RMGR_FIB_USE_SSE41
             // _mm_blendv_pd() allows us to save two instructions compared to calling _mm_cmpgt_epu64()
             const __m128i s = _mm_xor_si128(a, b);
             const __m128i d = _mm_sub_epi64(b, a);
             const __m128i m = _mm_blendv_epi8(d, a, s);
             return _mm_castpd_si128(_mm_blendv_pd(_mm_castsi128_pd(b), _mm_castsi128_pd(a), _mm_castsi128_pd(m)));
         #else
-            const __m128i m = _mm_cmpgt_epu64(a, b);
-            return INTERNAL_RMGR_FIB_SELECT(m, a, b);
+            const __m128i m = _mm_cmpgt_epu64(a, b);
+            return INTERNAL_RMGR_FIB_SELECT(m, a, b);
+        #endif
+    }
+#endif
+
+
+//=================================================================================================
+// Absolute value
+
+// 8, 16 & 32-bit
+#if !INTERNAL_RMGR_FIB_USE_SSSE3
+    #define _mm_abs_epi8   rmgr_fib_mm_abs_epi8
+    #define _mm_abs_epi16  rmgr_fib_mm_abs_epi16
+    #define _mm_abs_epi32  rmgr_fib_mm_abs_epi32
+
+    static inline __m128i rmgr_fib_mm_abs_epi8(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const __m128i s = _mm_cmpgt_epi8(_mm_setzero_si128(), a);
+        return _mm_sub_epi8(_mm_xor_si128(a, s), s);
+    }
+
+    static inline __m128i rmgr_fib_mm_abs_epi16(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const __m128i s = _mm_srai_epi16(a, 15);
+        return _mm_sub_epi16(_mm_xor_si128(a, s), s);
+    }
+
+    static inline __m128i rmgr_fib_mm_abs_epi32(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const __m128i s = _mm_srai_epi32(a, 31);
+        return _mm_sub_epi32(_mm_xor_si128(a, s), s);
+    }
+#endif
+
+// 64-bit
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    #define _mm_abs_epi64  rmgr_fib_mm_abs_epi64
+
+    static inline __m128i rmgr_fib_mm_abs_epi64(const __m128i& a) RMGR_NOEXCEPT
+    {
+        #if INTERNAL_RMGR_FIB_USE_SSE42
+            const __m128i s = _mm_cmpgt_epi64(_mm_setzero_si128(), a);
+        #else
+            const __m128i s = _mm_shuffle_epi32(_mm_srai_epi32(a,31), _MM_SHUFFLE(3,3,1,1));
+        #endif
+        return _mm_sub_epi64(_mm_xor_si128(a, s), s);
+    }
+#endif
+
+// floating point
+static RMGR_FORCEINLINE __m128 _mm_abs_ps(const __m128& a) RMGR_NOEXCEPT
+{
+    return _mm_and_ps(a, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFFu)));
+}
+
+static RMGR_FORCEINLINE __m128d _mm_abs_pd(const __m128d& a) RMGR_NOEXCEPT
+{
+    return _mm_and_pd(a, _mm_castsi128_pd(_mm_set1_epi64x(UINT64_C(0x7FFFFFFFFFFFFFFF))));
+}
+
+
+//=================================================================================================
+// Absolute difference
+//
+// |a - b| always fits in the unsigned lane of the same width, even for signed lanes, so that's how
+// the result is to be read. Unsigned 8 and 16-bit lanes OR both saturated differences. Lanes with
+// native min & max subtract the min from the max. The others negate b - a where a > b, which takes
+// a single comparison where min & max would take two. With SSE 4.1, the 64-bit comparison is the
+// same blendv trick as for _mm_min_epi64().
+//
+// _mm_sad_epu16() and _mm_sad_epu32() are the wider counterparts of _mm_sad_epu8(): the absolute
+// differences of each 64-bit half are summed into its 64-bit lane, which cannot overflow.
+
+// Negates the lanes of b - a where a > b, given as a mask
+#define INTERNAL_RMGR_FIB_ABSDIFF_EPI32(a, b, gt)  _mm_sub_epi32(_mm_xor_si128(_mm_sub_epi32((b), (a)), (gt)), (gt))
+#define INTERNAL_RMGR_FIB_ABSDIFF_EPI64(a, b, gt)  _mm_sub_epi64(_mm_xor_si128(_mm_sub_epi64((b), (a)), (gt)), (gt))
+
+// 8-bit
+static RMGR_FORCEINLINE __m128i _mm_absdiff_epu8(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_absdiff_epi8(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    return _mm_sub_epi8(_mm_max_epi8(a, b), _mm_min_epi8(a, b));
+#else
+    // Flipping the sign bits preserves the distance and makes the lanes unsigned
+    const __m128i flip = _mm_set1_epi8(-128);
+    return _mm_absdiff_epu8(_mm_xor_si128(a, flip), _mm_xor_si128(b, flip));
+#endif
+}
+
+// 16-bit
+static RMGR_FORCEINLINE __m128i _mm_absdiff_epu16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_or_si128(_mm_subs_epu16(a, b), _mm_subs_epu16(b, a));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_absdiff_epi16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_sub_epi16(_mm_max_epi16(a, b), _mm_min_epi16(a, b));
+}
+
+// 32-bit
+static RMGR_FORCEINLINE __m128i _mm_absdiff_epu32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    return _mm_sub_epi32(_mm_max_epu32(a, b), _mm_min_epu32(a, b));
+#else
+    return INTERNAL_RMGR_FIB_ABSDIFF_EPI32(a, b, _mm_cmpgt_epu32(a, b));
+#endif
+}
+
+static RMGR_FORCEINLINE __m128i _mm_absdiff_epi32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    return _mm_sub_epi32(_mm_max_epi32(a, b), _mm_min_epi32(a, b));
+#else
+    return INTERNAL_RMGR_FIB_ABSDIFF_EPI32(a, b, _mm_cmpgt_epi32(a, b));
+#endif
+}
+
+// 64-bit
+static inline __m128i _mm_absdiff_epu64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm_sub_epi64(_mm_max_epu64(a, b), _mm_min_epu64(a, b));
+#elif INTERNAL_RMGR_FIB_USE_SSE41
+    // The sign bit of m is set where a > b, which is all _mm_blendv_pd() looks at
+    const __m128i d = _mm_sub_epi64(b, a);
+    const __m128i m = _mm_blendv_epi8(d, a, _mm_xor_si128(a, b));
+    return _mm_castpd_si128(_mm_blendv_pd(_mm_castsi128_pd(d), _mm_castsi128_pd(_mm_sub_epi64(_mm_setzero_si128(), d)), _mm_castsi128_pd(m)));
+#else
+    return INTERNAL_RMGR_FIB_ABSDIFF_EPI64(a, b, _mm_cmpgt_epu64(a, b));
+#endif
+}
+
+static inline __m128i _mm_absdiff_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm_sub_epi64(_mm_max_epi64(a, b), _mm_min_epi64(a, b));
+#elif INTERNAL_RMGR_FIB_USE_SSE41
+    // The sign bit of m is set where a > b, which is all _mm_blendv_pd() looks at
+    const __m128i d = _mm_sub_epi64(b, a);
+    const __m128i m = _mm_blendv_epi8(d, b, _mm_xor_si128(a, b));
+    return _mm_castpd_si128(_mm_blendv_pd(_mm_castsi128_pd(d), _mm_castsi128_pd(_mm_sub_epi64(_mm_setzero_si128(), d)), _mm_castsi128_pd(m)));
+#else
+    return INTERNAL_RMGR_FIB_ABSDIFF_EPI64(a, b, _mm_cmpgt_epi64(a, b));
+#endif
+}
+
+#undef INTERNAL_RMGR_FIB_ABSDIFF_EPI32
+#undef INTERNAL_RMGR_FIB_ABSDIFF_EPI64
+
+// Sums of absolute differences
+static inline __m128i _mm_sad_epu16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    // Sum the low and high bytes separately with psadbw, then recombine them
+    const __m128i d    = _mm_absdiff_epu16(a, b);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo   = _mm_sad_epu8(_mm_and_si128(d, _mm_set1_epi16(0x00FF)), zero);
+    const __m128i hi   = _mm_sad_epu8(_mm_srli_epi16(d, 8), zero);
+    return _mm_add_epi64(lo, _mm_slli_epi64(hi, 8));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_sad_epu32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    const __m128i d = _mm_absdiff_epu32(a, b);
+    return _mm_add_epi64(_mm_and_si128(d, _mm_set1_epi64x(0xFFFFFFFF)), _mm_srli_epi64(d, 32));
+}
+
+
+//=================================================================================================
+// Averages
+//
+// _mm_avg_xxx() round half up like _mm_avg_epu8(), (a + b + 1) >> 1, _mm_avg_floor_xxx() round
+// down, (a + b) >> 1, both without the wider intermediate sum. Lanes without pavgb/pavgw use
+// the usual identities: a + b = 2 * (a & b) + (a ^ b) = 2 * (a | b) - (a ^ b).
+//
+// Signed 8 and 16-bit lanes flip their sign bits to reuse the unsigned averages, as adding 2^(n-1)
+// to both operands adds it to the average too.
+
+// 8-bit
+static RMGR_FORCEINLINE __m128i _mm_avg_epi8(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    const __m128i flip = _mm_set1_epi8(-128);
+    return _mm_xor_si128(_mm_avg_epu8(_mm_xor_si128(a, flip), _mm_xor_si128(b, flip)), flip);
+}
+
+static RMGR_FORCEINLINE __m128i _mm_avg_floor_epu8(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    // Undo the rounding where the sum is odd
+    return _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_avg_floor_epi8(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    const __m128i flip = _mm_set1_epi8(-128);
+    return _mm_xor_si128(_mm_avg_floor_epu8(_mm_xor_si128(a, flip), _mm_xor_si128(b, flip)), flip);
+}
+
+// 16-bit
+static RMGR_FORCEINLINE __m128i _mm_avg_epi16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    const __m128i flip = _mm_set1_epi16(-0x8000);
+    return _mm_xor_si128(_mm_avg_epu16(_mm_xor_si128(a, flip), _mm_xor_si128(b, flip)), flip);
+}
+
+static RMGR_FORCEINLINE __m128i _mm_avg_floor_epu16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    // Undo the rounding where the sum is odd
+    return _mm_sub_epi16(_mm_avg_epu16(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi16(1)));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_avg_floor_epi16(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_add_epi16(_mm_and_si128(a, b), _mm_srai_epi16(_mm_xor_si128(a, b), 1));
+}
+
+// 32-bit
+static RMGR_FORCEINLINE __m128i _mm_avg_epu32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_sub_epi32(_mm_or_si128(a, b), _mm_srli_epi32(_mm_xor_si128(a, b), 1));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_avg_epi32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_sub_epi32(_mm_or_si128(a, b), _mm_srai_epi32(_mm_xor_si128(a, b), 1));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_avg_floor_epu32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_add_epi32(_mm_and_si128(a, b), _mm_srli_epi32(_mm_xor_si128(a, b), 1));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_avg_floor_epi32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_add_epi32(_mm_and_si128(a, b), _mm_srai_epi32(_mm_xor_si128(a, b), 1));
+}
+
+// 64-bit
+static RMGR_FORCEINLINE __m128i _mm_avg_epu64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_sub_epi64(_mm_or_si128(a, b), _mm_srli_epi64(_mm_xor_si128(a, b), 1));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_avg_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_sub_epi64(_mm_or_si128(a, b), _mm_srai_epi64(_mm_xor_si128(a, b), 1));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_avg_floor_epu64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_add_epi64(_mm_and_si128(a, b), _mm_srli_epi64(_mm_xor_si128(a, b), 1));
+}
+
+static RMGR_FORCEINLINE __m128i _mm_avg_floor_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return _mm_add_epi64(_mm_and_si128(a, b), _mm_srai_epi64(_mm_xor_si128(a, b), 1));
+}
+
+
+//=================================================================================================
+// Multiplication
+//
+// All 64-bit products are built from 32x32->64 _mm_mul_epu32() partial products. This also holds
+// when SSE4.1 is available: _mm_mullo_epi32() is 2 uops with twice the latency on most cores, and the
+// horizontal add needed to sum its cross products makes the sequence longer, not shorter.
+
+// 32-bit low
+#if !INTERNAL_RMGR_FIB_USE_SSE41
+    #define _mm_mullo_epi32  rmgr_fib_mm_mullo_epi32
+
+    static inline __m128i rmgr_fib_mm_mullo_epi32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        const __m128i even = _mm_mul_epu32(a, b);
+        const __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(3,1,2,0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(3,1,2,0)));
+    }
+#endif
+
+// 32-bit unsigned high
+static inline __m128i _mm_mulhi_epu32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    const __m128i even = _mm_srli_epi64(_mm_mul_epu32(a, b), 32);
+    const __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    return _mm_blend_epi16(even, odd, 0xCC);
+#else
+    return _mm_or_si128(even, _mm_and_si128(odd, _mm_set1_epi64x(INT64_C(-0x100000000))));
+#endif
+}
+
+// 32-bit signed high
+static inline __m128i _mm_mulhi_epi32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    const __m128i even = _mm_srli_epi64(_mm_mul_epi32(a, b), 32);
+    const __m128i odd  = _mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_blend_epi16(even, odd, 0xCC);
+#else
+    // Signed high product = unsigned high product - (a<0 ? b : 0) - (b<0 ? a : 0)
+    const __m128i hi = _mm_mulhi_epu32(a, b);
+    const __m128i sa = _mm_srai_epi32(a, 31);
+    const __m128i sb = _mm_srai_epi32(b, 31);
+    return _mm_sub_epi32(hi, _mm_add_epi32(_mm_and_si128(sa, b), _mm_and_si128(sb, a)));
+#endif
+}
+
+// 64-bit low
+#if !(INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define _mm_mullo_epi64  rmgr_fib_mm_mullo_epi64
+
+    static inline __m128i rmgr_fib_mm_mullo_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        // _mm_mul_epu32() ignores the upper halves, so a shuffle is enough to bring them down
+        const __m128i aHi   = _mm_shuffle_epi32(a, _MM_SHUFFLE(3,3,1,1));
+        const __m128i bHi   = _mm_shuffle_epi32(b, _MM_SHUFFLE(3,3,1,1));
+        const __m128i cross = _mm_add_epi64(_mm_mul_epu32(aHi, b), _mm_mul_epu32(a, bHi));
+        return _mm_add_epi64(_mm_mul_epu32(a, b), _mm_slli_epi64(cross, 32));
+    }
+#endif
+
+// 64-bit unsigned high
+static inline __m128i _mm_mulhi_epu64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    const __m128i aHi = _mm_shuffle_epi32(a, _MM_SHUFFLE(3,3,1,1));
+    const __m128i bHi = _mm_shuffle_epi32(b, _MM_SHUFFLE(3,3,1,1));
+    const __m128i ll  = _mm_mul_epu32(a,   b);
+    const __m128i lh  = _mm_mul_epu32(a,   bHi);
+    const __m128i hl  = _mm_mul_epu32(aHi, b);
+    const __m128i hh  = _mm_mul_epu32(aHi, bHi);
+
+    // None of the following sums can overflow: (2^32-1)^2 + 2*(2^32-1) < 2^64
+    const __m128i t = _mm_add_epi64(hl, _mm_srli_epi64(ll, 32));
+    #if INTERNAL_RMGR_FIB_USE_SSE41
+        const __m128i tLo = _mm_blend_epi16(t, _mm_setzero_si128(), 0xCC); // Saves loading a mask
+    #else
+        const __m128i tLo = _mm_and_si128(t, _mm_set1_epi64x(0xFFFFFFFFll));
+    #endif
+    const __m128i u = _mm_add_epi64(lh, tLo);
+    return _mm_add_epi64(_mm_add_epi64(hh, _mm_srli_epi64(t, 32)), _mm_srli_epi64(u, 32));
+}
+
+// 64-bit signed high
+static inline __m128i _mm_mulhi_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    // Signed high product = unsigned high product - (a<0 ? b : 0) - (b<0 ? a : 0)
+    const __m128i hi = _mm_mulhi_epu64(a, b);
+    const __m128i sa = _mm_srai_epi64(a, 63);
+    const __m128i sb = _mm_srai_epi64(b, 63);
+    return _mm_sub_epi64(hi, _mm_add_epi64(_mm_and_si128(sa, b), _mm_and_si128(sb, a)));
+}
+
+
+//=================================================================================================
+// Saturated arithmetic
+//
+// Unsigned lanes clamp the wrapped-around result with a comparison telling whether it overflowed,
+// or with a min when it is native. Signed lanes overflow when the operands of an addition (resp.
+// subtraction) have the same (resp. different) signs and the result has a different sign than `a`;
+// the saturated value is then INT_MAX + (a<0), i.e. INT_MIN for negative `a`.
+
+// Sign bit set in the lanes where a signed addition (resp. subtraction) overflowed
+static RMGR_FORCEINLINE __m128i rmgr_fib_mm_adds_overflow(const __m128i& a, const __m128i& b, const __m128i& r) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm_ternarylogic_epi32(a, b, r, 0x42); // ~(a^b) & (a^r)
+#else
+    return _mm_andnot_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, r));
+#endif
+}
+
+static RMGR_FORCEINLINE __m128i rmgr_fib_mm_subs_overflow(const __m128i& a, const __m128i& b, const __m128i& r) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm_ternarylogic_epi32(a, b, r, 0x18); // (a^b) & (a^r)
+#else
+    return _mm_and_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, r));
+#endif
+}
+
+// Picks `saturated` in the lanes whose sign bit is set in `overflow`
+static RMGR_FORCEINLINE __m128i rmgr_fib_mm_saturate_epi32(const __m128i& overflow, const __m128i& saturated, const __m128i& r) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    return _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(r), _mm_castsi128_ps(saturated), _mm_castsi128_ps(overflow)));
+#else
+    return INTERNAL_RMGR_FIB_SELECT(_mm_srai_epi32(overflow, 31), saturated, r);
+#endif
+}
+
+static RMGR_FORCEINLINE __m128i rmgr_fib_mm_saturate_epi64(const __m128i& overflow, const __m128i& saturated, const __m128i& r) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    return _mm_castpd_si128(_mm_blendv_pd(_mm_castsi128_pd(r), _mm_castsi128_pd(saturated), _mm_castsi128_pd(overflow)));
+#else
+    return INTERNAL_RMGR_FIB_SELECT(_mm_srai_epi32(_mm_shuffle_epi32(overflow, _MM_SHUFFLE(3,3,1,1)), 31), saturated, r);
+#endif
+}
+
+// 32-bit signed
+static inline __m128i _mm_adds_epi32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    const __m128i r         = _mm_add_epi32(a, b);
+    const __m128i saturated = _mm_add_epi32(_mm_srli_epi32(a, 31), _mm_set1_epi32(INT32_MAX));
+    return rmgr_fib_mm_saturate_epi32(rmgr_fib_mm_adds_overflow(a, b, r), saturated, r);
+}
+
+static inline __m128i _mm_subs_epi32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    const __m128i r         = _mm_sub_epi32(a, b);
+    const __m128i saturated = _mm_add_epi32(_mm_srli_epi32(a, 31), _mm_set1_epi32(INT32_MAX));
+    return rmgr_fib_mm_saturate_epi32(rmgr_fib_mm_subs_overflow(a, b, r), saturated, r);
+}
+
+// 32-bit unsigned
+static inline __m128i _mm_adds_epu32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    return _mm_add_epi32(a, _mm_min_epu32(b, _mm_not_si128(a))); // ~a is the headroom of a
+#else
+    const __m128i r = _mm_add_epi32(a, b);
+    return _mm_or_si128(r, _mm_cmpgt_epu32(a, r));
+#endif
+}
+
+static inline __m128i _mm_subs_epu32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    return _mm_sub_epi32(_mm_max_epu32(a, b), b);
+#else
+    return _mm_andnot_si128(_mm_cmpgt_epu32(b, a), _mm_sub_epi32(a, b));
+#endif
+}
+
+// 64-bit signed
+static inline __m128i _mm_adds_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    const __m128i r         = _mm_add_epi64(a, b);
+    const __m128i saturated = _mm_add_epi64(_mm_srli_epi64(a, 63), _mm_set1_epi64x(INT64_MAX));
+    return rmgr_fib_mm_saturate_epi64(rmgr_fib_mm_adds_overflow(a, b, r), saturated, r);
+}
+
+static inline __m128i _mm_subs_epi64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    const __m128i r         = _mm_sub_epi64(a, b);
+    const __m128i saturated = _mm_add_epi64(_mm_srli_epi64(a, 63), _mm_set1_epi64x(INT64_MAX));
+    return rmgr_fib_mm_saturate_epi64(rmgr_fib_mm_subs_overflow(a, b, r), saturated, r);
+}
+
+// 64-bit unsigned
+static inline __m128i _mm_adds_epu64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm_add_epi64(a, _mm_min_epu64(b, _mm_not_si128(a))); // ~a is the headroom of a
+#else
+    const __m128i r = _mm_add_epi64(a, b);
+    return _mm_or_si128(r, _mm_cmpgt_epu64(a, r));
+#endif
+}
+
+static inline __m128i _mm_subs_epu64(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm_sub_epi64(_mm_max_epu64(a, b), b);
+#else
+    return _mm_andnot_si128(_mm_cmpgt_epu64(b, a), _mm_sub_epi64(a, b));
+#endif
+}
+
+
+//=================================================================================================
+// Horizontal reductions
+//
+// Named after the AVX-512 sequence intrinsics. Recent compilers declare some of them for 128-bit
+// vectors too, hence the renaming macros. Generic reductions halve the vector at each step and
+// return lane 0; SSE 4.1's phminposuw handles 8 and 16-bit min/max in a single instruction once
+// the lanes are biased to unsigned ones, and psadbw sums bytes.
+
+#define _mm_reduce_add_epi8   rmgr_fib_mm_reduce_add_epi8
+#define _mm_reduce_add_epi16  rmgr_fib_mm_reduce_add_epi16
+#define _mm_reduce_add_epi32  rmgr_fib_mm_reduce_add_epi32
+#define _mm_reduce_add_epi64  rmgr_fib_mm_reduce_add_epi64
+#define _mm_reduce_and_epi8   rmgr_fib_mm_reduce_and_epi8
+#define _mm_reduce_and_epi16  rmgr_fib_mm_reduce_and_epi16
+#define _mm_reduce_and_epi32  rmgr_fib_mm_reduce_and_epi32
+#define _mm_reduce_and_epi64  rmgr_fib_mm_reduce_and_epi64
+#define _mm_reduce_or_epi8    rmgr_fib_mm_reduce_or_epi8
+#define _mm_reduce_or_epi16   rmgr_fib_mm_reduce_or_epi16
+#define _mm_reduce_or_epi32   rmgr_fib_mm_reduce_or_epi32
+#define _mm_reduce_or_epi64   rmgr_fib_mm_reduce_or_epi64
+#define _mm_reduce_min_epi8   rmgr_fib_mm_reduce_min_epi8
+#define _mm_reduce_min_epu8   rmgr_fib_mm_reduce_min_epu8
+#define _mm_reduce_min_epi16  rmgr_fib_mm_reduce_min_epi16
+#define _mm_reduce_min_epu16  rmgr_fib_mm_reduce_min_epu16
+#define _mm_reduce_min_epi32  rmgr_fib_mm_reduce_min_epi32
+#define _mm_reduce_min_epu32  rmgr_fib_mm_reduce_min_epu32
+#define _mm_reduce_min_epi64  rmgr_fib_mm_reduce_min_epi64
+#define _mm_reduce_min_epu64  rmgr_fib_mm_reduce_min_epu64
+#define _mm_reduce_max_epi8   rmgr_fib_mm_reduce_max_epi8
+#define _mm_reduce_max_epu8   rmgr_fib_mm_reduce_max_epu8
+#define _mm_reduce_max_epi16  rmgr_fib_mm_reduce_max_epi16
+#define _mm_reduce_max_epu16  rmgr_fib_mm_reduce_max_epu16
+#define _mm_reduce_max_epi32  rmgr_fib_mm_reduce_max_epi32
+#define _mm_reduce_max_epu32  rmgr_fib_mm_reduce_max_epu32
+#define _mm_reduce_max_epi64  rmgr_fib_mm_reduce_max_epi64
+#define _mm_reduce_max_epu64  rmgr_fib_mm_reduce_max_epu64
+
+// Declares the halving reduction of lanes of the given width with a lane-wise operation
+#define INTERNAL_RMGR_FIB_REDUCE(name, Scalar, bits, op)                                            \
+    static inline Scalar rmgr_fib_mm_reduce_##name(const __m128i& a) RMGR_NOEXCEPT                  \
+    {                                                                                               \
+        __m128i x = op(a, _mm_unpackhi_epi64(a, a));                                                \
+        if (bits <= 32)                                                                             \
+            x = op(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1,1,1,1)));                                  \
+        if (bits <= 16)                                                                             \
+            x = op(x, _mm_srli_epi32(x, 16));                                                       \
+        if (bits <= 8)                                                                              \
+            x = op(x, _mm_srli_epi16(x, 8));                                                        \
+        return (bits == 64) ? Scalar(_mm_cvtsi128_si64(x)) : Scalar(_mm_cvtsi128_si32(x));          \
+    }
+
+// Sums
+static inline int8_t rmgr_fib_mm_reduce_add_epi8(const __m128i& a) RMGR_NOEXCEPT
+{
+    const __m128i x = _mm_sad_epu8(a, _mm_setzero_si128()); // The low byte of the sum is all we need
+    return int8_t(_mm_cvtsi128_si32(_mm_add_epi32(x, _mm_unpackhi_epi64(x, x))));
+}
+
+INTERNAL_RMGR_FIB_REDUCE(add_epi16, int16_t,  16, _mm_add_epi16)
+INTERNAL_RMGR_FIB_REDUCE(add_epi32, int32_t,  32, _mm_add_epi32)
+INTERNAL_RMGR_FIB_REDUCE(add_epi64, int64_t,  64, _mm_add_epi64)
+
+// Bitwise
+INTERNAL_RMGR_FIB_REDUCE(and_epi8,  int8_t,    8, _mm_and_si128)
+INTERNAL_RMGR_FIB_REDUCE(and_epi16, int16_t,  16, _mm_and_si128)
+INTERNAL_RMGR_FIB_REDUCE(and_epi32, int32_t,  32, _mm_and_si128)
+INTERNAL_RMGR_FIB_REDUCE(and_epi64, int64_t,  64, _mm_and_si128)
+INTERNAL_RMGR_FIB_REDUCE(or_epi8,   int8_t,    8, _mm_or_si128)
+INTERNAL_RMGR_FIB_REDUCE(or_epi16,  int16_t,  16, _mm_or_si128)
+INTERNAL_RMGR_FIB_REDUCE(or_epi32,  int32_t,  32, _mm_or_si128)
+INTERNAL_RMGR_FIB_REDUCE(or_epi64,  int64_t,  64, _mm_or_si128)
+
+// 8 & 16-bit min & max
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    // Min of the unsigned bytes, in the low byte of the result (the higher ones hold garbage)
+    static RMGR_FORCEINLINE int rmgr_fib_mm_minpos_epu8(const __m128i& a) RMGR_NOEXCEPT
+    {
+        // Once the bytes of each pair are reduced into a 16-bit lane, its high byte is 0
+        return _mm_cvtsi128_si32(_mm_minpos_epu16(_mm_min_epu8(a, _mm_srli_epi16(a, 8))));
+    }
+
+    static inline int8_t rmgr_fib_mm_reduce_min_epi8(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return int8_t(rmgr_fib_mm_minpos_epu8(_mm_xor_si128(a, _mm_set1_epi8(-0x80))) ^ 0x80);
+    }
+
+    static inline int8_t rmgr_fib_mm_reduce_max_epi8(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return int8_t(rmgr_fib_mm_minpos_epu8(_mm_xor_si128(a, _mm_set1_epi8(0x7F))) ^ 0x7F);
+    }
+
+    static inline uint8_t rmgr_fib_mm_reduce_min_epu8(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return uint8_t(rmgr_fib_mm_minpos_epu8(a));
+    }
+
+    static inline uint8_t rmgr_fib_mm_reduce_max_epu8(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return uint8_t(~rmgr_fib_mm_minpos_epu8(_mm_not_si128(a)));
+    }
+
+    static inline int16_t rmgr_fib_mm_reduce_min_epi16(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return int16_t(_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(a, _mm_set1_epi16(-0x8000)))) ^ 0x8000);
+    }
+
+    static inline int16_t rmgr_fib_mm_reduce_max_epi16(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return int16_t(_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(a, _mm_set1_epi16(0x7FFF)))) ^ 0x7FFF);
+    }
+
+    static inline uint16_t rmgr_fib_mm_reduce_min_epu16(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return uint16_t(_mm_cvtsi128_si32(_mm_minpos_epu16(a)));
+    }
+
+    static inline uint16_t rmgr_fib_mm_reduce_max_epu16(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return uint16_t(~_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_not_si128(a))));
+    }
+#else
+    INTERNAL_RMGR_FIB_REDUCE(min_epi8,  int8_t,    8, _mm_min_epi8)
+    INTERNAL_RMGR_FIB_REDUCE(max_epi8,  int8_t,    8, _mm_max_epi8)
+    INTERNAL_RMGR_FIB_REDUCE(min_epu8,  uint8_t,   8, _mm_min_epu8)
+    INTERNAL_RMGR_FIB_REDUCE(max_epu8,  uint8_t,   8, _mm_max_epu8)
+    INTERNAL_RMGR_FIB_REDUCE(min_epi16, int16_t,  16, _mm_min_epi16)
+    INTERNAL_RMGR_FIB_REDUCE(max_epi16, int16_t,  16, _mm_max_epi16)
+    INTERNAL_RMGR_FIB_REDUCE(min_epu16, uint16_t, 16, _mm_min_epu16)
+    INTERNAL_RMGR_FIB_REDUCE(max_epu16, uint16_t, 16, _mm_max_epu16)
+#endif
+
+// 32 & 64-bit min & max
+INTERNAL_RMGR_FIB_REDUCE(min_epi32, int32_t,  32, _mm_min_epi32)
+INTERNAL_RMGR_FIB_REDUCE(max_epi32, int32_t,  32, _mm_max_epi32)
+INTERNAL_RMGR_FIB_REDUCE(min_epu32, uint32_t, 32, _mm_min_epu32)
+INTERNAL_RMGR_FIB_REDUCE(max_epu32, uint32_t, 32, _mm_max_epu32)
+#if !INTERNAL_RMGR_FIB_USE_SSE41 && RMGR_ARCH_IS_X86_64
+    // With only two lanes, moving them to GPRs beats the long emulated 64-bit comparison
+    static inline int64_t rmgr_fib_mm_reduce_min_epi64(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const int64_t lo = _mm_cvtsi128_si64(a), hi = _mm_cvtsi128_si64(_mm_unpackhi_epi64(a, a));
+        return (hi < lo) ? hi : lo;
+    }
+
+    static inline int64_t rmgr_fib_mm_reduce_max_epi64(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const int64_t lo = _mm_cvtsi128_si64(a), hi = _mm_cvtsi128_si64(_mm_unpackhi_epi64(a, a));
+        return (hi > lo) ? hi : lo;
+    }
+
+    static inline uint64_t rmgr_fib_mm_reduce_min_epu64(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const uint64_t lo = uint64_t(_mm_cvtsi128_si64(a)), hi = uint64_t(_mm_cvtsi128_si64(_mm_unpackhi_epi64(a, a)));
+        return (hi < lo) ? hi : lo;
+    }
+
+    static inline uint64_t rmgr_fib_mm_reduce_max_epu64(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const uint64_t lo = uint64_t(_mm_cvtsi128_si64(a)), hi = uint64_t(_mm_cvtsi128_si64(_mm_unpackhi_epi64(a, a)));
+        return (hi > lo) ? hi : lo;
+    }
+#else
+    INTERNAL_RMGR_FIB_REDUCE(min_epi64, int64_t,  64, _mm_min_epi64)
+    INTERNAL_RMGR_FIB_REDUCE(max_epi64, int64_t,  64, _mm_max_epi64)
+    INTERNAL_RMGR_FIB_REDUCE(min_epu64, uint64_t, 64, _mm_min_epu64)
+    INTERNAL_RMGR_FIB_REDUCE(max_epu64, uint64_t, 64, _mm_max_epu64)
+#endif
+
+#undef INTERNAL_RMGR_FIB_REDUCE
+
+
+//=================================================================================================
+// Population count
+//
+// Bytes are counted first, either by looking up each nibble with pshufb or with the usual SWAR
+// steps, and wider lanes then add their bytes up: pmaddubsw/pmaddwd for 16/32-bit and psadbw for
+// 64-bit lanes.
+
+#if !(INTERNAL_RMGR_FIB_USE_AVX512BITALG && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define _mm_popcnt_epi8   rmgr_fib_mm_popcnt_epi8
+    #define _mm_popcnt_epi16  rmgr_fib_mm_popcnt_epi16
+
+    // 8-bit
+    static inline __m128i rmgr_fib_mm_popcnt_epi8(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const __m128i nibble = _mm_set1_epi8(0x0F);
+    #if INTERNAL_RMGR_FIB_USE_SSSE3
+        const __m128i table  = _mm_setr_epi8(0,1,1,2, 1,2,2,3, 1,2,2,3, 2,3,3,4);
+        const __m128i lo     = _mm_shuffle_epi8(table, _mm_and_si128(a, nibble));
+        const __m128i hi     = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(a, 4), nibble));
+        return _mm_add_epi8(lo, hi);
+    #else
+        __m128i x = _mm_sub_epi8(a, _mm_and_si128(_mm_srli_epi16(a, 1), _mm_set1_epi8(0x55)));
+        x = _mm_add_epi8(_mm_and_si128(x, _mm_set1_epi8(0x33)), _mm_and_si128(_mm_srli_epi16(x, 2), _mm_set1_epi8(0x33)));
+        return _mm_and_si128(_mm_add_epi8(x, _mm_srli_epi16(x, 4)), nibble);
+    #endif
+    }
+
+    // 16-bit
+    static inline __m128i rmgr_fib_mm_popcnt_epi16(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const __m128i bytes = rmgr_fib_mm_popcnt_epi8(a);
+    #if INTERNAL_RMGR_FIB_USE_SSSE3
+        return _mm_maddubs_epi16(bytes, _mm_set1_epi8(1));
+    #else
+        return _mm_add_epi16(_mm_and_si128(bytes, _mm_set1_epi16(0x00FF)), _mm_srli_epi16(bytes, 8));
+    #endif
+    }
+#endif
+
+#if !(INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define _mm_popcnt_epi32  rmgr_fib_mm_popcnt_epi32
+    #define _mm_popcnt_epi64  rmgr_fib_mm_popcnt_epi64
+
+    // 32-bit
+    static inline __m128i rmgr_fib_mm_popcnt_epi32(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return _mm_madd_epi16(_mm_popcnt_epi16(a), _mm_set1_epi16(1));
+    }
+
+    // 64-bit
+    static inline __m128i rmgr_fib_mm_popcnt_epi64(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return _mm_sad_epu8(_mm_popcnt_epi8(a), _mm_setzero_si128());
+    }
+#endif
+
+
+//=================================================================================================
+// Leading & trailing zero counts
+//
+// With SSSE3, 8-bit lanes look the leading zeros of each nibble up with pshufb. Wider lanes are
+// converted to float and the count is read from the exponent, once the bits right below set bits
+// have been cleared so that rounding can't bump it (for 16-bit lanes, this beats combining byte
+// counts). Trailing zeros are the population count of the mask below the lowest set bit, ~a & (a-1),
+// or its width minus its leading zeros.
+//
+// Instruction counts, constants aside:
+//
+//     | Width  | lzcnt SSE2 | lzcnt SSSE3 | tzcnt SSE2 | tzcnt SSSE3 | Native lzcnt   |
+//     |--------|------------|-------------|------------|-------------|----------------|
+//     | 8-bit  |         21 |           8 |         13 |           9 |                |
+//     | 16-bit |         10 |          10 |         16 |          10 |                |
+//     | 32-bit |          8 |           8 |         12 |          11 | AVX512-CD + VL |
+//     | 64-bit |         12 |          12 |         15 |          11 | AVX512-CD + VL |
+//
+// With AVX512-CD + VL, 32 and 64-bit trailing zeros are derived from the native leading zeros.
+
+// 8-bit
+static inline __m128i _mm_lzcnt_epi8(const __m128i& a) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSSE3
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i table  = _mm_setr_epi8(4,3,2,2, 1,1,1,1, 0,0,0,0, 0,0,0,0);
+    const __m128i hi     = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(a, 4), nibble));
+    const __m128i lo     = _mm_shuffle_epi8(table, _mm_and_si128(a, nibble));
+    return _mm_add_epi8(hi, _mm_and_si128(lo, _mm_cmpeq_epi8(hi, _mm_set1_epi8(4)))); // The low nibble only counts if the high one is 0
+#else
+    // Converting bytes to float would take 4 conversions, smearing the leading one to the right is cheaper
+    __m128i x = _mm_or_si128(a, _mm_and_si128(_mm_srli_epi16(a, 1), _mm_set1_epi8(0x7F)));
+    x = _mm_or_si128(x, _mm_and_si128(_mm_srli_epi16(x, 2), _mm_set1_epi8(0x3F)));
+    x = _mm_or_si128(x, _mm_and_si128(_mm_srli_epi16(x, 4), _mm_set1_epi8(0x0F)));
+    return _mm_popcnt_epi8(_mm_not_si128(x));
+#endif
+}
+
+static inline __m128i _mm_tzcnt_epi8(const __m128i& a) RMGR_NOEXCEPT
+{
+    return _mm_popcnt_epi8(_mm_andnot_si128(a, _mm_sub_epi8(a, _mm_set1_epi8(1))));
+}
+
+// 16-bit
+static inline __m128i _mm_lzcnt_epi16(const __m128i& a) RMGR_NOEXCEPT
+{
+    // Zero-extended to 32 bits, lanes convert to float exactly. The biased exponent is then 127 plus
+    // the position of the leading one, or 0 if there's none.
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo   = _mm_srli_epi32(_mm_castps_si128(_mm_cvtepi32_ps(_mm_unpacklo_epi16(a, zero))), 23);
+    const __m128i hi   = _mm_srli_epi32(_mm_castps_si128(_mm_cvtepi32_ps(_mm_unpackhi_epi16(a, zero))), 23);
+    return _mm_min_epi16(_mm_sub_epi16(_mm_set1_epi16(127 + 15), _mm_packs_epi32(lo, hi)), _mm_set1_epi16(16));
+}
+
+static inline __m128i _mm_tzcnt_epi16(const __m128i& a) RMGR_NOEXCEPT
+{
+    return _mm_popcnt_epi16(_mm_andnot_si128(a, _mm_sub_epi16(a, _mm_set1_epi16(1))));
+}
+
+// 32 & 64-bit leading zeros
+#if !(INTERNAL_RMGR_FIB_USE_AVX512CD && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define _mm_lzcnt_epi32  rmgr_fib_mm_lzcnt_epi32
+    #define _mm_lzcnt_epi64  rmgr_fib_mm_lzcnt_epi64
+
+    static inline __m128i rmgr_fib_mm_lzcnt_epi32(const __m128i& a) RMGR_NOEXCEPT
+    {
+        // Lanes with the MSB set convert to negative floats, their count is forced to 0 in the end
+        const __m128i x = _mm_andnot_si128(_mm_srli_epi32(a, 1), a);
+        const __m128i e = _mm_srli_epi32(_mm_castps_si128(_mm_cvtepi32_ps(x)), 23);
+        const __m128i n = _mm_min_epi16(_mm_sub_epi32(_mm_set1_epi32(127 + 31), e), _mm_set1_epi32(32)); // Counts fit in 16 bits
+        return _mm_andnot_si128(_mm_srai_epi32(a, 31), n);
+    }
+
+    static inline __m128i rmgr_fib_mm_lzcnt_epi64(const __m128i& a) RMGR_NOEXCEPT
+    {
+        // The low half only counts if the high one is 0
+        const __m128i n  = rmgr_fib_mm_lzcnt_epi32(a);
+        const __m128i hi = _mm_srli_epi64(n, 32);
+        return _mm_add_epi64(hi, _mm_and_si128(n, _mm_cmpeq_epi32(hi, _mm_set1_epi32(32))));
+    }
+#endif
+
+// 32 & 64-bit trailing zeros
+static inline __m128i _mm_tzcnt_epi32(const __m128i& a) RMGR_NOEXCEPT
+{
+    const __m128i below = _mm_andnot_si128(a, _mm_sub_epi32(a, _mm_set1_epi32(1)));
+#if (INTERNAL_RMGR_FIB_USE_AVX512CD && INTERNAL_RMGR_FIB_USE_AVX512VL && !INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ) || !INTERNAL_RMGR_FIB_USE_SSSE3
+    return _mm_sub_epi32(_mm_set1_epi32(32), _mm_lzcnt_epi32(below));
+#else
+    return _mm_popcnt_epi32(below);
+#endif
+}
+
+static inline __m128i _mm_tzcnt_epi64(const __m128i& a) RMGR_NOEXCEPT
+{
+    const __m128i below = _mm_andnot_si128(a, _mm_sub_epi64(a, _mm_set1_epi64x(1)));
+#if INTERNAL_RMGR_FIB_USE_AVX512CD && INTERNAL_RMGR_FIB_USE_AVX512VL && !INTERNAL_RMGR_FIB_USE_AVX512VPOPCNTDQ
+    return _mm_sub_epi64(_mm_set1_epi64x(64), _mm_lzcnt_epi64(below));
+#else
+    return _mm_popcnt_epi64(below);
+#endif
+}
+
+
+//=================================================================================================
+// Rounding
+//
+// Adding then subtracting 2^23 (2^52 for doubles), with the sign of the input, rounds away the
+// fractional part of any |x| < 2^23 in the current MXCSR mode. That result is either the floor or
+// the ceiling of x, the explicit rounding modes then fix it up so they don't depend on MXCSR.
+// The result always has the sign of x, even when rounding to zero (x - x is -0 when rounding
+// down). Larger magnitudes and infinities are already integers and are returned as is, NaNs go
+// through the arithmetic which quiets them like roundps does.
+// _MM_FROUND_NO_EXC cannot be honored: the precision exception is always raised (it is masked by
+// default).
+
+#if !INTERNAL_RMGR_FIB_USE_SSE41
+    #ifndef _MM_FROUND_TO_NEAREST_INT
+        #define _MM_FROUND_TO_NEAREST_INT  0x00
+        #define _MM_FROUND_TO_NEG_INF      0x01
+        #define _MM_FROUND_TO_POS_INF      0x02
+        #define _MM_FROUND_TO_ZERO         0x03
+        #define _MM_FROUND_CUR_DIRECTION   0x04
+        #define _MM_FROUND_RAISE_EXC       0x00
+        #define _MM_FROUND_NO_EXC          0x08
+        #define _MM_FROUND_NINT            (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_RAISE_EXC)
+        #define _MM_FROUND_FLOOR           (_MM_FROUND_TO_NEG_INF     | _MM_FROUND_RAISE_EXC)
+        #define _MM_FROUND_CEIL            (_MM_FROUND_TO_POS_INF     | _MM_FROUND_RAISE_EXC)
+        #define _MM_FROUND_TRUNC           (_MM_FROUND_TO_ZERO        | _MM_FROUND_RAISE_EXC)
+        #define _MM_FROUND_RINT            (_MM_FROUND_CUR_DIRECTION  | _MM_FROUND_RAISE_EXC)
+        #define _MM_FROUND_NEARBYINT       (_MM_FROUND_CUR_DIRECTION  | _MM_FROUND_NO_EXC)
+    #endif
+
+    #define _mm_round_ps(a, rounding)     rmgr_fib_mm_round_ps<(rounding)>(a)
+    #define _mm_round_pd(a, rounding)     rmgr_fib_mm_round_pd<(rounding)>(a)
+    #define _mm_round_ss(a, b, rounding)  _mm_move_ss((a), rmgr_fib_mm_round_ps<(rounding)>(b))
+    #define _mm_round_sd(a, b, rounding)  _mm_move_sd((a), rmgr_fib_mm_round_pd<(rounding)>(b))
+    #define _mm_floor_ps(a)               _mm_round_ps((a), _MM_FROUND_FLOOR)
+    #define _mm_floor_pd(a)               _mm_round_pd((a), _MM_FROUND_FLOOR)
+    #define _mm_floor_ss(a, b)            _mm_round_ss((a), (b), _MM_FROUND_FLOOR)
+    #define _mm_floor_sd(a, b)            _mm_round_sd((a), (b), _MM_FROUND_FLOOR)
+    #define _mm_ceil_ps(a)                _mm_round_ps((a), _MM_FROUND_CEIL)
+    #define _mm_ceil_pd(a)                _mm_round_pd((a), _MM_FROUND_CEIL)
+    #define _mm_ceil_ss(a, b)             _mm_round_ss((a), (b), _MM_FROUND_CEIL)
+    #define _mm_ceil_sd(a, b)             _mm_round_sd((a), (b), _MM_FROUND_CEIL)
+
+    template<int rounding>
+    static RMGR_FORCEINLINE __m128 rmgr_fib_mm_round_ps(const __m128& a) RMGR_NOEXCEPT
+    {
+        const __m128 magic = _mm_set1_ps(8388608.0f); // 2^23
+        const __m128 one   = _mm_set1_ps(1.0f);
+        const __m128 sign  = _mm_and_ps(a, _mm_set1_ps(-0.0f));
+        const __m128 abs   = _mm_xor_ps(a, sign);
+        const __m128 m     = _mm_or_ps(magic, sign);
+        __m128       r     = _mm_sub_ps(_mm_add_ps(a, m), m);
+        const int mode = (rounding & _MM_FROUND_CUR_DIRECTION) ? _MM_FROUND_CUR_DIRECTION : (rounding & 3);
+        if (mode == _MM_FROUND_TO_NEG_INF)
+            r = _mm_sub_ps(r, _mm_and_ps(_mm_cmpgt_ps(r, a), one));
+        else if (mode == _MM_FROUND_TO_POS_INF)
+            r = _mm_add_ps(r, _mm_and_ps(_mm_cmplt_ps(r, a), one));
+        else if (mode == _MM_FROUND_TO_ZERO)
+            r = _mm_sub_ps(r, _mm_and_ps(_mm_cmpgt_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), r), abs), _mm_or_ps(one, sign)));
+        else if (mode == _MM_FROUND_TO_NEAREST_INT)
+        {
+            // Moves r towards x if it is more than half away, or exactly half away but odd
+            const __m128  d    = _mm_sub_ps(a, r);
+            const __m128  absD = _mm_andnot_ps(_mm_set1_ps(-0.0f), d);
+            const __m128  half = _mm_set1_ps(0.5f);
+            const __m128i lsb  = _mm_slli_epi32(_mm_castps_si128(_mm_add_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), r), magic)), 31);
+            const __m128  odd  = _mm_castsi128_ps(_mm_srai_epi32(lsb, 31));
+            const __m128  move = _mm_or_ps(_mm_cmpgt_ps(absD, half), _mm_and_ps(_mm_cmpeq_ps(absD, half), odd));
+            r = _mm_add_ps(r, _mm_and_ps(move, _mm_or_ps(one, _mm_and_ps(d, _mm_set1_ps(-0.0f)))));
+        }
+        const __m128 large = _mm_cmpge_ps(abs, magic);
+        r = _mm_or_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), r), sign);
+        return _mm_or_ps(_mm_and_ps(large, a), _mm_andnot_ps(large, r));
+    }
+
+    template<int rounding>
+    static RMGR_FORCEINLINE __m128d rmgr_fib_mm_round_pd(const __m128d& a) RMGR_NOEXCEPT
+    {
+        const __m128d magic = _mm_set1_pd(4503599627370496.0); // 2^52
+        const __m128d one   = _mm_set1_pd(1.0);
+        const __m128d sign  = _mm_and_pd(a, _mm_set1_pd(-0.0));
+        const __m128d abs   = _mm_xor_pd(a, sign);
+        const __m128d m     = _mm_or_pd(magic, sign);
+        __m128d       r     = _mm_sub_pd(_mm_add_pd(a, m), m);
+        const int mode = (rounding & _MM_FROUND_CUR_DIRECTION) ? _MM_FROUND_CUR_DIRECTION : (rounding & 3);
+        if (mode == _MM_FROUND_TO_NEG_INF)
+            r = _mm_sub_pd(r, _mm_and_pd(_mm_cmpgt_pd(r, a), one));
+        else if (mode == _MM_FROUND_TO_POS_INF)
+            r = _mm_add_pd(r, _mm_and_pd(_mm_cmplt_pd(r, a), one));
+        else if (mode == _MM_FROUND_TO_ZERO)
+            r = _mm_sub_pd(r, _mm_and_pd(_mm_cmpgt_pd(_mm_andnot_pd(_mm_set1_pd(-0.0), r), abs), _mm_or_pd(one, sign)));
+        else if (mode == _MM_FROUND_TO_NEAREST_INT)
+        {
+            // Moves r towards x if it is more than half away, or exactly half away but odd
+            const __m128d d    = _mm_sub_pd(a, r);
+            const __m128d absD = _mm_andnot_pd(_mm_set1_pd(-0.0), d);
+            const __m128d half = _mm_set1_pd(0.5);
+            const __m128i lsb  = _mm_slli_epi32(_mm_castpd_si128(_mm_add_pd(_mm_andnot_pd(_mm_set1_pd(-0.0), r), magic)), 31);
+            const __m128d odd  = _mm_castsi128_pd(_mm_shuffle_epi32(_mm_srai_epi32(lsb, 31), _MM_SHUFFLE(2,2,0,0)));
+            const __m128d move = _mm_or_pd(_mm_cmpgt_pd(absD, half), _mm_and_pd(_mm_cmpeq_pd(absD, half), odd));
+            r = _mm_add_pd(r, _mm_and_pd(move, _mm_or_pd(one, _mm_and_pd(d, _mm_set1_pd(-0.0)))));
+        }
+        const __m128d large = _mm_cmpge_pd(abs, magic);
+        r = _mm_or_pd(_mm_andnot_pd(_mm_set1_pd(-0.0), r), sign);
+        return _mm_or_pd(_mm_and_pd(large, a), _mm_andnot_pd(large, r));
+    }
+#endif
+
+
+//=================================================================================================
+// Integer <-> floating point conversions
+//
+// Integers are turned into floating point values by OR-ing their bits into the mantissa of a
+// power of two which is then subtracted: 2^23 for 16-bit halves of 32-bit lanes, 2^52 and 2^84 for
+// the low and high 32-bit halves of 64-bit lanes. Only the final addition rounds, so the results
+// are correctly rounded. Truncating conversions shift the mantissa by the unbiased exponent, and
+// return the integer indefinite value (INT64_MIN, resp. UINT64_MAX) for NaNs and out of range
+// inputs, like AVX-512 does. On x86-64, signed 64-bit lanes are converted to float and truncated
+// one at a time in GPRs instead, which is cheaper.
+//
+// The _fast variants are cheaper but only valid for a limited range: |x| < 2^51 for signed
+// conversions, 0 <= x < 2^52 for unsigned ones. Results outside of that range are unspecified.
+// They just forward to the native instructions when there are some.
+
+// Returns the double whose bits are given
+static RMGR_FORCEINLINE __m128d rmgr_fib_mm_set1_pd_bits(long long bits) RMGR_NOEXCEPT
+{
+    return _mm_castsi128_pd(_mm_set1_epi64x(bits));
+}
+
+// 32-bit unsigned to float
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    #define _mm_cvtepu32_ps  rmgr_fib_mm_cvtepu32_ps
+
+    static inline __m128 rmgr_fib_mm_cvtepu32_ps(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const __m128i hi = _mm_or_si128(_mm_srli_epi32(a, 16), _mm_set1_epi32(0x53000000)); // 2^39 + hi*2^16
+    #if INTERNAL_RMGR_FIB_USE_SSE41
+        const __m128i lo = _mm_blend_epi16(a, _mm_set1_epi32(0x4B000000), 0xAA);            // 2^23 + lo
+    #else
+        const __m128i lo = _mm_or_si128(_mm_and_si128(a, _mm_set1_epi32(0xFFFF)), _mm_set1_epi32(0x4B000000));
+    #endif
+        const __m128 h = _mm_sub_ps(_mm_castsi128_ps(hi), _mm_castsi128_ps(_mm_set1_epi32(0x53000080))); // Exact
+        return _mm_add_ps(h, _mm_castsi128_ps(lo));
+    }
+#endif
+
+// 64-bit to double, float & back
+#if !(INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define _mm_cvtepi64_pd   rmgr_fib_mm_cvtepi64_pd
+    #define _mm_cvtepu64_pd   rmgr_fib_mm_cvtepu64_pd
+    #define _mm_cvtepi64_ps   rmgr_fib_mm_cvtepi64_ps
+    #define _mm_cvttpd_epi64  rmgr_fib_mm_cvttpd_epi64
+    #define _mm_cvttpd_epu64  rmgr_fib_mm_cvttpd_epu64
+
+    // 2^52 + the low 32 bits of each lane
+    static RMGR_FORCEINLINE __m128d rmgr_fib_mm_cvtlo32_pd(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const __m128i magic = _mm_set1_epi64x(0x4330000000000000ll);
+        #if INTERNAL_RMGR_FIB_USE_SSE41
+            return _mm_castsi128_pd(_mm_blend_epi16(a, magic, 0xCC));
+        #else
+            return _mm_castsi128_pd(_mm_or_si128(_mm_and_si128(a, _mm_set1_epi64x(0xFFFFFFFFll)), magic));
         #endif
     }
+
+    static inline __m128d rmgr_fib_mm_cvtepi64_pd(const __m128i& a) RMGR_NOEXCEPT
+    {
+        // 2^84 + (hi + 2^31) * 2^32, the signed high half being biased to an unsigned one
+        const __m128i hi = _mm_xor_si128(_mm_srli_epi64(a, 32), _mm_set1_epi64x(0x4530000080000000ll));
+        const __m128d h  = _mm_sub_pd(_mm_castsi128_pd(hi), rmgr_fib_mm_set1_pd_bits(0x4530000080100000ll)); // 2^84 + 2^63 + 2^52
+        return _mm_add_pd(h, rmgr_fib_mm_cvtlo32_pd(a));
+    }
+
+    static inline __m128d rmgr_fib_mm_cvtepu64_pd(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const __m128i hi = _mm_or_si128(_mm_srli_epi64(a, 32), _mm_set1_epi64x(0x4530000000000000ll));
+        const __m128d h  = _mm_sub_pd(_mm_castsi128_pd(hi), rmgr_fib_mm_set1_pd_bits(0x4530000000100000ll)); // 2^84 + 2^52
+        return _mm_add_pd(h, rmgr_fib_mm_cvtlo32_pd(a));
+    }
+
+    static inline __m128 rmgr_fib_mm_cvtepi64_ps(const __m128i& a) RMGR_NOEXCEPT
+    {
+    #if RMGR_ARCH_IS_X86_64
+        // With only two lanes, converting them one at a time in GPRs beats the vector sequence
+        const __m128 lo = _mm_cvtsi64_ss(_mm_setzero_ps(), _mm_cvtsi128_si64(a));
+        const __m128 hi = _mm_cvtsi64_ss(_mm_setzero_ps(), _mm_cvtsi128_si64(_mm_unpackhi_epi64(a, a)));
+        return _mm_unpacklo_ps(lo, hi);
+    #else
+        // Going through double would round twice for lanes that don't fit in 53 bits. Outside of
+        // [-2^47, 2^47), the low 11 bits are rounded to odd into bit 11 instead: the value then fits
+        // in a double and still rounds to the same float.
+        const __m128i small = _mm_srli_epi64(_mm_cmpeq_epi32(_mm_srai_epi32(a, 15), _mm_srai_epi32(a, 31)), 32);
+        const __m128i low   = _mm_andnot_si128(small, _mm_set1_epi64x(0x7FF));
+        const __m128i x     = _mm_andnot_si128(low, _mm_or_si128(a, _mm_add_epi64(_mm_and_si128(a, low), low)));
+        return _mm_cvtpd_ps(rmgr_fib_mm_cvtepi64_pd(x));
+    #endif
+    }
+
+    // Absolute value of the truncated value of each lane, valid for |a| < 2^64
+    static RMGR_FORCEINLINE __m128i rmgr_fib_mm_cvttpd_abs_epu64(const __m128d& a) RMGR_NOEXCEPT
+    {
+        const __m128i bits  = _mm_castpd_si128(a);
+        const __m128i m     = _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi64x(0x000FFFFFFFFFFFFFll)), _mm_set1_epi64x(0x0010000000000000ll));
+        const __m128i e     = _mm_and_si128(_mm_srli_epi64(bits, 52), _mm_set1_epi64x(0x7FF));
+        const __m128i shift = _mm_sub_epi64(e, _mm_set1_epi64x(1023 + 52));
+        // Negative counts are huge unsigned ones, for which the shifts give 0
+        return _mm_or_si128(_mm_sllv_epi64(m, shift), _mm_srlv_epi64(m, _mm_sub_epi64(_mm_setzero_si128(), shift)));
+    }
+
+    static inline __m128i rmgr_fib_mm_cvttpd_epi64(const __m128d& a) RMGR_NOEXCEPT
+    {
+    #if RMGR_ARCH_IS_X86_64
+        // Same as above, cvttsd2si returns the integer indefinite value as well
+        const __m128i lo = _mm_cvtsi64_si128(_mm_cvttsd_si64(a));
+        const __m128i hi = _mm_cvtsi64_si128(_mm_cvttsd_si64(_mm_unpackhi_pd(a, a)));
+        return _mm_unpacklo_epi64(lo, hi);
+    #else
+        const __m128i abs = rmgr_fib_mm_cvttpd_abs_epu64(a);
+        const __m128i s   = _mm_castpd_si128(_mm_cmplt_pd(a, _mm_setzero_pd()));
+        const __m128i out = _mm_castpd_si128(_mm_cmpnlt_pd(_mm_abs_pd(a), _mm_set1_pd(9223372036854775808.0))); // Also true for NaNs
+        const __m128i r   = _mm_sub_epi64(_mm_xor_si128(abs, s), s);
+        return INTERNAL_RMGR_FIB_SELECT(out, _mm_slli_epi64(out, 63), r);
+    #endif
+    }
+
+    static inline __m128i rmgr_fib_mm_cvttpd_epu64(const __m128d& a) RMGR_NOEXCEPT
+    {
+        // Values in ]-1, 0] truncate to 0, smaller ones are out of range
+        const __m128d high = _mm_cmpnlt_pd(a, _mm_set1_pd(18446744073709551616.0)); // Also true for NaNs
+        const __m128d low  = _mm_cmple_pd(a, _mm_set1_pd(-1.0));
+        return _mm_or_si128(rmgr_fib_mm_cvttpd_abs_epu64(a), _mm_castpd_si128(_mm_or_pd(high, low)));
+    }
+#endif
+
+// Limited range conversions
+static inline __m128d _mm_cvtepi64_pd_fast(const __m128i& a) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm_cvtepi64_pd(a);
+#else
+    const __m128i magic = _mm_set1_epi64x(0x4338000000000000ll); // 2^52 + 2^51
+    return _mm_sub_pd(_mm_castsi128_pd(_mm_add_epi64(a, magic)), _mm_castsi128_pd(magic));
+#endif
+}
+
+static inline __m128d _mm_cvtepu64_pd_fast(const __m128i& a) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm_cvtepu64_pd(a);
+#else
+    const __m128i magic = _mm_set1_epi64x(0x4330000000000000ll); // 2^52
+    return _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(a, magic)), _mm_castsi128_pd(magic));
+#endif
+}
+
+static inline __m128 _mm_cvtepi64_ps_fast(const __m128i& a) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm_cvtepi64_ps(a);
+#else
+    return _mm_cvtpd_ps(_mm_cvtepi64_pd_fast(a)); // Exact conversion to double, so a single rounding
+#endif
+}
+
+static inline __m128i _mm_cvttpd_epi64_fast(const __m128d& a) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm_cvttpd_epi64(a);
+#elif INTERNAL_RMGR_FIB_USE_SSE41
+    const __m128d magic = rmgr_fib_mm_set1_pd_bits(0x4338000000000000ll); // 2^52 + 2^51
+    const __m128d t     = _mm_add_pd(_mm_round_pd(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC), magic);
+    return _mm_sub_epi64(_mm_castpd_si128(t), _mm_castpd_si128(magic));
+#elif RMGR_ARCH_IS_X86_64
+    return _mm_cvttpd_epi64(a); // Converting lanes in GPRs is cheaper than the sequence below
+#else
+    // Adding 2^52 rounds |a| to the nearest integer, which is then decremented if it went up
+    const __m128d magic = rmgr_fib_mm_set1_pd_bits(0x4330000000000000ll); // 2^52
+    const __m128d abs   = _mm_abs_pd(a);
+    const __m128d r     = _mm_add_pd(abs, magic);
+    const __m128i up    = _mm_castpd_si128(_mm_cmpgt_pd(_mm_sub_pd(r, magic), abs));
+    const __m128i t     = _mm_add_epi64(_mm_sub_epi64(_mm_castpd_si128(r), _mm_castpd_si128(magic)), up);
+    const __m128i s     = _mm_castpd_si128(_mm_cmplt_pd(a, _mm_setzero_pd()));
+    return _mm_sub_epi64(_mm_xor_si128(t, s), s);
+#endif
+}
+
+static inline __m128i _mm_cvttpd_epu64_fast(const __m128d& a) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm_cvttpd_epu64(a);
+#else
+    const __m128d magic = rmgr_fib_mm_set1_pd_bits(0x4330000000000000ll); // 2^52
+    #if INTERNAL_RMGR_FIB_USE_SSE41
+        const __m128d r = _mm_add_pd(_mm_round_pd(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC), magic);
+        return _mm_sub_epi64(_mm_castpd_si128(r), _mm_castpd_si128(magic));
+    #else
+        // Adding 2^52 rounds to the nearest integer, which is then decremented if it went up
+        const __m128d r  = _mm_add_pd(a, magic);
+        const __m128i up = _mm_castpd_si128(_mm_cmpgt_pd(_mm_sub_pd(r, magic), a));
+        return _mm_add_epi64(_mm_sub_epi64(_mm_castpd_si128(r), _mm_castpd_si128(magic)), up);
+    #endif
+#endif
+}
+
+
+//=================================================================================================
+// Widening & narrowing
+//
+// Zero extension interleaves the low lanes with zeros, or gathers them with a single pshufb when
+// there's more than one unpack to do. Sign extension interleaves the lanes with themselves and
+// shifts them right arithmetically, 64-bit lanes then get their high halves from the sign of their
+// low ones.
+
+#if !INTERNAL_RMGR_FIB_USE_SSE41
+    #define _mm_cvtepu8_epi16   rmgr_fib_mm_cvtepu8_epi16
+    #define _mm_cvtepu8_epi32   rmgr_fib_mm_cvtepu8_epi32
+    #define _mm_cvtepu8_epi64   rmgr_fib_mm_cvtepu8_epi64
+    #define _mm_cvtepu16_epi32  rmgr_fib_mm_cvtepu16_epi32
+    #define _mm_cvtepu16_epi64  rmgr_fib_mm_cvtepu16_epi64
+    #define _mm_cvtepu32_epi64  rmgr_fib_mm_cvtepu32_epi64
+    #define _mm_cvtepi8_epi16   rmgr_fib_mm_cvtepi8_epi16
+    #define _mm_cvtepi8_epi32   rmgr_fib_mm_cvtepi8_epi32
+    #define _mm_cvtepi8_epi64   rmgr_fib_mm_cvtepi8_epi64
+    #define _mm_cvtepi16_epi32  rmgr_fib_mm_cvtepi16_epi32
+    #define _mm_cvtepi16_epi64  rmgr_fib_mm_cvtepi16_epi64
+    #define _mm_cvtepi32_epi64  rmgr_fib_mm_cvtepi32_epi64
+    #define _mm_packus_epi32    rmgr_fib_mm_packus_epi32
+
+    // Zero extension
+    static inline __m128i rmgr_fib_mm_cvtepu8_epi16(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return _mm_unpacklo_epi8(a, _mm_setzero_si128());
+    }
+
+    static inline __m128i rmgr_fib_mm_cvtepu8_epi32(const __m128i& a) RMGR_NOEXCEPT
+    {
+    #if INTERNAL_RMGR_FIB_USE_SSSE3
+        return _mm_shuffle_epi8(a, _mm_setr_epi8(0,-1,-1,-1, 1,-1,-1,-1, 2,-1,-1,-1, 3,-1,-1,-1));
+    #else
+        const __m128i zero = _mm_setzero_si128();
+        return _mm_unpacklo_epi16(_mm_unpacklo_epi8(a, zero), zero);
+    #endif
+    }
+
+    static inline __m128i rmgr_fib_mm_cvtepu8_epi64(const __m128i& a) RMGR_NOEXCEPT
+    {
+    #if INTERNAL_RMGR_FIB_USE_SSSE3
+        return _mm_shuffle_epi8(a, _mm_setr_epi8(0,-1,-1,-1,-1,-1,-1,-1, 1,-1,-1,-1,-1,-1,-1,-1));
+    #else
+        const __m128i zero = _mm_setzero_si128();
+        return _mm_unpacklo_epi32(_mm_unpacklo_epi16(_mm_unpacklo_epi8(a, zero), zero), zero);
+    #endif
+    }
+
+    static inline __m128i rmgr_fib_mm_cvtepu16_epi32(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return _mm_unpacklo_epi16(a, _mm_setzero_si128());
+    }
+
+    static inline __m128i rmgr_fib_mm_cvtepu16_epi64(const __m128i& a) RMGR_NOEXCEPT
+    {
+    #if INTERNAL_RMGR_FIB_USE_SSSE3
+        return _mm_shuffle_epi8(a, _mm_setr_epi8(0,1,-1,-1,-1,-1,-1,-1, 2,3,-1,-1,-1,-1,-1,-1));
+    #else
+        const __m128i zero = _mm_setzero_si128();
+        return _mm_unpacklo_epi32(_mm_unpacklo_epi16(a, zero), zero);
+    #endif
+    }
+
+    static inline __m128i rmgr_fib_mm_cvtepu32_epi64(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return _mm_unpacklo_epi32(a, _mm_setzero_si128());
+    }
+
+    // Sign extension
+    static inline __m128i rmgr_fib_mm_cvtepi8_epi16(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return _mm_srai_epi16(_mm_unpacklo_epi8(a, a), 8);
+    }
+
+    static inline __m128i rmgr_fib_mm_cvtepi8_epi32(const __m128i& a) RMGR_NOEXCEPT
+    {
+    #if INTERNAL_RMGR_FIB_USE_SSSE3
+        return _mm_srai_epi32(_mm_shuffle_epi8(a, _mm_setr_epi8(-1,-1,-1,0, -1,-1,-1,1, -1,-1,-1,2, -1,-1,-1,3)), 24);
+    #else
+        const __m128i x = _mm_unpacklo_epi8(a, a);
+        return _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 24);
+    #endif
+    }
+
+    static inline __m128i rmgr_fib_mm_cvtepi8_epi64(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const __m128i x = rmgr_fib_mm_cvtepi8_epi32(a);
+        return _mm_unpacklo_epi32(x, _mm_srai_epi32(x, 31));
+    }
+
+    static inline __m128i rmgr_fib_mm_cvtepi16_epi32(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return _mm_srai_epi32(_mm_unpacklo_epi16(a, a), 16);
+    }
+
+    static inline __m128i rmgr_fib_mm_cvtepi16_epi64(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const __m128i x = rmgr_fib_mm_cvtepi16_epi32(a);
+        return _mm_unpacklo_epi32(x, _mm_srai_epi32(x, 31));
+    }
+
+    static inline __m128i rmgr_fib_mm_cvtepi32_epi64(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return _mm_unpacklo_epi32(a, _mm_srai_epi32(a, 31));
+    }
+
+    // Unsigned saturation
+    static inline __m128i rmgr_fib_mm_packus_epi32(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        // Once negative lanes are zeroed, biasing by -32768 lets the signed saturation do the job
+        const __m128i bias = _mm_set1_epi32(32768);
+        const __m128i x    = _mm_sub_epi32(_mm_andnot_si128(_mm_srai_epi32(a, 31), a), bias);
+        const __m128i y    = _mm_sub_epi32(_mm_andnot_si128(_mm_srai_epi32(b, 31), b), bias);
+        return _mm_xor_si128(_mm_packs_epi32(x, y), _mm_set1_epi16(-32768));
+    }
+#endif
+
+// Truncation & saturation to the low lanes, the upper ones being zeroed
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    #define _mm_cvtepi32_epi8     rmgr_fib_mm_cvtepi32_epi8
+    #define _mm_cvtsepi64_epi32   rmgr_fib_mm_cvtsepi64_epi32
+    #define _mm_cvtusepi64_epi32  rmgr_fib_mm_cvtusepi64_epi32
+
+    static inline __m128i rmgr_fib_mm_cvtepi32_epi8(const __m128i& a) RMGR_NOEXCEPT
+    {
+    #if INTERNAL_RMGR_FIB_USE_SSSE3
+        return _mm_shuffle_epi8(a, _mm_setr_epi8(0,4,8,12, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1));
+    #else
+        // Saturation can't kick in once the lanes have been masked
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i x    = _mm_packs_epi32(_mm_and_si128(a, _mm_set1_epi32(0xFF)), zero);
+        return _mm_packus_epi16(x, zero);
+    #endif
+    }
+
+    static inline __m128i rmgr_fib_mm_cvtsepi64_epi32(const __m128i& a) RMGR_NOEXCEPT
+    {
+        // Lanes fit if their high half is the sign extension of their low one
+        const __m128i lo   = _mm_shuffle_epi32(a, _MM_SHUFFLE(3,1,2,0));
+        const __m128i hi   = _mm_unpackhi_epi64(lo, lo);
+        const __m128i fits = _mm_cmpeq_epi32(hi, _mm_srai_epi32(lo, 31));
+        const __m128i sat  = _mm_xor_si128(_mm_srai_epi32(hi, 31), _mm_set1_epi32(INT32_MAX));
+        return _mm_move_epi64(INTERNAL_RMGR_FIB_SELECT(fits, lo, sat));
+    }
+
+    static inline __m128i rmgr_fib_mm_cvtusepi64_epi32(const __m128i& a) RMGR_NOEXCEPT
+    {
+        const __m128i lo = _mm_shuffle_epi32(a, _MM_SHUFFLE(3,1,2,0));
+        const __m128i hi = _mm_unpackhi_epi64(lo, lo);
+        return _mm_move_epi64(_mm_or_si128(lo, _mm_not_si128(_mm_cmpeq_epi32(hi, _mm_setzero_si128()))));
+    }
 #endif
 
 
 //=================================================================================================
-// Absolute value
+// AVX-512 style masks
+//
+// Lane i of a vector maps to bit i of a mask. The mask types are declared here with the same
+// definitions as the compilers' own headers, so that both can be included in any order.
 
-// 8, 16 & 32-bit
-#if !INTERNAL_RMGR_FIB_USE_SSSE3
-    #define _mm_abs_epi8   rmgr_fib_mm_abs_epi8
-    #define _mm_abs_epi16  rmgr_fib_mm_abs_epi16
-    #define _mm_abs_epi32  rmgr_fib_mm_abs_epi32
+typedef unsigned char  __mmask8;
+typedef unsigned short __mmask16;
 
-    static inline __m128i rmgr_fib_mm_abs_epi8(const __m128i& a) RMGR_NOEXCEPT
+// Vector to integer, from the MSB of each lane, the counterparts of _mm_movemask_epi8() for wider
+// lanes. They have no native equivalent, the float movemasks are as cheap as it gets anyway.
+#define _mm_movemask_epi16  rmgr_fib_mm_movemask_epi16
+#define _mm_movemask_epi32  rmgr_fib_mm_movemask_epi32
+#define _mm_movemask_epi64  rmgr_fib_mm_movemask_epi64
+
+static inline int rmgr_fib_mm_movemask_epi16(const __m128i& a) RMGR_NOEXCEPT
+{
+    // Signed saturation preserves the sign
+    return _mm_movemask_epi8(_mm_packs_epi16(a, _mm_setzero_si128()));
+}
+
+static inline int rmgr_fib_mm_movemask_epi32(const __m128i& a) RMGR_NOEXCEPT
+{
+    return _mm_movemask_ps(_mm_castsi128_ps(a));
+}
+
+static inline int rmgr_fib_mm_movemask_epi64(const __m128i& a) RMGR_NOEXCEPT
+{
+    return _mm_movemask_pd(_mm_castsi128_pd(a));
+}
+
+// Vector to mask, from the MSB of each lane
+#if !(INTERNAL_RMGR_FIB_USE_AVX512BW && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define _mm_movepi8_mask   rmgr_fib_mm_movepi8_mask
+    #define _mm_movepi16_mask  rmgr_fib_mm_movepi16_mask
+
+    static inline __mmask16 rmgr_fib_mm_movepi8_mask(const __m128i& a) RMGR_NOEXCEPT
     {
-        const __m128i s = _mm_cmpgt_epi8(_mm_setzero_si128(), a);
-        return _mm_sub_epi8(_mm_xor_si128(a, s), s);
+        return __mmask16(_mm_movemask_epi8(a));
     }
 
-    static inline __m128i rmgr_fib_mm_abs_epi16(const __m128i& a) RMGR_NOEXCEPT
+    static inline __mmask8 rmgr_fib_mm_movepi16_mask(const __m128i& a) RMGR_NOEXCEPT
     {
-        const __m128i s = _mm_srai_epi16(a, 15);
-        return _mm_sub_epi16(_mm_xor_si128(a, s), s);
+        return __mmask8(rmgr_fib_mm_movemask_epi16(a));
     }
+#endif
 
-    static inline __m128i rmgr_fib_mm_abs_epi32(const __m128i& a) RMGR_NOEXCEPT
+#if !(INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define _mm_movepi32_mask  rmgr_fib_mm_movepi32_mask
+    #define _mm_movepi64_mask  rmgr_fib_mm_movepi64_mask
+
+    static inline __mmask8 rmgr_fib_mm_movepi32_mask(const __m128i& a) RMGR_NOEXCEPT
     {
-        const __m128i s = _mm_srai_epi32(a, 31);
-        return _mm_sub_epi32(_mm_xor_si128(a, s), s);
+        return __mmask8(rmgr_fib_mm_movemask_epi32(a));
+    }
+
+    static inline __mmask8 rmgr_fib_mm_movepi64_mask(const __m128i& a) RMGR_NOEXCEPT
+    {
+        return __mmask8(rmgr_fib_mm_movemask_epi64(a));
     }
 #endif
 
-// 64-bit
+// Mask to vector, each lane is set to all ones if its bit is set, to zero otherwise. The
+// rmgr_fib_mm_movm_xxx() helpers are always available, for the other emulations to use.
+#if !(INTERNAL_RMGR_FIB_USE_AVX512BW && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define _mm_movm_epi8   rmgr_fib_mm_movm_epi8
+    #define _mm_movm_epi16  rmgr_fib_mm_movm_epi16
+#endif
+
+#if !(INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define _mm_movm_epi32  rmgr_fib_mm_movm_epi32
+    #define _mm_movm_epi64  rmgr_fib_mm_movm_epi64
+#endif
+
+static inline __m128i rmgr_fib_mm_movm_epi8(__mmask16 k) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512BW && INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm_movm_epi8(k);
+#else
+    // Broadcasts the low byte of k to the low 8 lanes and its high byte to the high 8 lanes
+    #if INTERNAL_RMGR_FIB_USE_SSSE3
+        const __m128i v = _mm_shuffle_epi8(_mm_cvtsi32_si128(k), _mm_set_epi64x(0x0101010101010101ll, 0));
+    #else
+        __m128i v = _mm_cvtsi32_si128(k);
+        v = _mm_unpacklo_epi8( v, v);
+        v = _mm_unpacklo_epi16(v, v);
+        v = _mm_unpacklo_epi32(v, v);
+    #endif
+    const __m128i bits = _mm_set1_epi64x(static_cast<long long>(0x8040201008040201ull));
+    return _mm_cmpeq_epi8(_mm_and_si128(v, bits), bits);
+#endif
+}
+
+static inline __m128i rmgr_fib_mm_movm_epi16(__mmask8 k) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512BW && INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm_movm_epi16(k);
+#else
+    const __m128i bits = _mm_set_epi16(128, 64, 32, 16, 8, 4, 2, 1);
+    return _mm_cmpeq_epi16(_mm_and_si128(_mm_set1_epi16(k), bits), bits);
+#endif
+}
+
+static inline __m128i rmgr_fib_mm_movm_epi32(__mmask8 k) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm_movm_epi32(k);
+#else
+    const __m128i bits = _mm_set_epi32(8, 4, 2, 1);
+    return _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(k), bits), bits);
+#endif
+}
+
+static inline __m128i rmgr_fib_mm_movm_epi64(__mmask8 k) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_AVX512DQ && INTERNAL_RMGR_FIB_USE_AVX512VL
+    return _mm_movm_epi64(k);
+#else
+    const __m128i bits = _mm_set_epi32(2, 2, 1, 1);
+    return _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(k), bits), bits);
+#endif
+}
+
+
+//=================================================================================================
+// Comparisons to masks
+//
+// _mm_cmp_epXX_mask() takes one of the _MM_CMPINT_XX predicates of <immintrin.h> (or its value):
+// EQ=0, LT=1, LE=2, FALSE=3, NE=4, NLT=5, NLE=6, TRUE=7.
+
+// Declares the named and predicate-based comparisons of a lane type
+#define INTERNAL_RMGR_FIB_CMP_MASK(suffix, lanes, Mask, all)                                                           \
+    static RMGR_FORCEINLINE Mask rmgr_fib_mm_cmpeq_##suffix##_mask(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT   \
+    {                                                                                                                  \
+        return _mm_movepi##lanes##_mask(_mm_cmpeq_##suffix(a, b));                                                     \
+    }                                                                                                                  \
+    static RMGR_FORCEINLINE Mask rmgr_fib_mm_cmpneq_##suffix##_mask(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT  \
+    {                                                                                                                  \
+        return _mm_movepi##lanes##_mask(_mm_cmpneq_##suffix(a, b));                                                    \
+    }                                                                                                                  \
+    static RMGR_FORCEINLINE Mask rmgr_fib_mm_cmplt_##suffix##_mask(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT   \
+    {                                                                                                                  \
+        return _mm_movepi##lanes##_mask(_mm_cmplt_##suffix(a, b));                                                     \
+    }                                                                                                                  \
+    static RMGR_FORCEINLINE Mask rmgr_fib_mm_cmple_##suffix##_mask(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT   \
+    {                                                                                                                  \
+        return _mm_movepi##lanes##_mask(_mm_cmple_##suffix(a, b));                                                     \
+    }                                                                                                                  \
+    static RMGR_FORCEINLINE Mask rmgr_fib_mm_cmpgt_##suffix##_mask(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT   \
+    {                                                                                                                  \
+        return _mm_movepi##lanes##_mask(_mm_cmpgt_##suffix(a, b));                                                     \
+    }                                                                                                                  \
+    static RMGR_FORCEINLINE Mask rmgr_fib_mm_cmpge_##suffix##_mask(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT   \
+    {                                                                                                                  \
+        return _mm_movepi##lanes##_mask(_mm_cmpge_##suffix(a, b));                                                     \
+    }                                                                                                                  \
+    template<int P>                                                                                                    \
+    static RMGR_FORCEINLINE Mask rmgr_fib_mm_cmp_##suffix##_mask(const __m128i& a, const __m128i& b) RMGR_NOEXCEPT     \
+    {                                                                                                                  \
+        switch (P & 7)                                                                                                 \
+        {                                                                                                              \
+            case 0:  return rmgr_fib_mm_cmpeq_##suffix##_mask(a, b);                                                   \
+            case 1:  return rmgr_fib_mm_cmplt_##suffix##_mask(a, b);                                                   \
+            case 2:  return rmgr_fib_mm_cmple_##suffix##_mask(a, b);                                                   \
+            case 3:  return Mask(0);                                                                                   \
+            case 4:  return rmgr_fib_mm_cmpneq_##suffix##_mask(a, b);                                                  \
+            case 5:  return rmgr_fib_mm_cmpge_##suffix##_mask(a, b);                                                   \
+            case 6:  return rmgr_fib_mm_cmpgt_##suffix##_mask(a, b);                                                   \
+            default: return Mask(all);                                                                                 \
+        }                                                                                                              \
+    }
+
+// 8 & 16-bit
+#if !(INTERNAL_RMGR_FIB_USE_AVX512BW && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    #define _mm_cmpeq_epi8_mask    rmgr_fib_mm_cmpeq_epi8_mask
+    #define _mm_cmpneq_epi8_mask   rmgr_fib_mm_cmpneq_epi8_mask
+    #define _mm_cmplt_epi8_mask    rmgr_fib_mm_cmplt_epi8_mask
+    #define _mm_cmple_epi8_mask    rmgr_fib_mm_cmple_epi8_mask
+    #define _mm_cmpgt_epi8_mask    rmgr_fib_mm_cmpgt_epi8_mask
+    #define _mm_cmpge_epi8_mask    rmgr_fib_mm_cmpge_epi8_mask
+    #define _mm_cmpeq_epu8_mask    rmgr_fib_mm_cmpeq_epu8_mask
+    #define _mm_cmpneq_epu8_mask   rmgr_fib_mm_cmpneq_epu8_mask
+    #define _mm_cmplt_epu8_mask    rmgr_fib_mm_cmplt_epu8_mask
+    #define _mm_cmple_epu8_mask    rmgr_fib_mm_cmple_epu8_mask
+    #define _mm_cmpgt_epu8_mask    rmgr_fib_mm_cmpgt_epu8_mask
+    #define _mm_cmpge_epu8_mask    rmgr_fib_mm_cmpge_epu8_mask
+
+    #define _mm_cmpeq_epi16_mask   rmgr_fib_mm_cmpeq_epi16_mask
+    #define _mm_cmpneq_epi16_mask  rmgr_fib_mm_cmpneq_epi16_mask
+    #define _mm_cmplt_epi16_mask   rmgr_fib_mm_cmplt_epi16_mask
+    #define _mm_cmple_epi16_mask   rmgr_fib_mm_cmple_epi16_mask
+    #define _mm_cmpgt_epi16_mask   rmgr_fib_mm_cmpgt_epi16_mask
+    #define _mm_cmpge_epi16_mask   rmgr_fib_mm_cmpge_epi16_mask
+    #define _mm_cmpeq_epu16_mask   rmgr_fib_mm_cmpeq_epu16_mask
+    #define _mm_cmpneq_epu16_mask  rmgr_fib_mm_cmpneq_epu16_mask
+    #define _mm_cmplt_epu16_mask   rmgr_fib_mm_cmplt_epu16_mask
+    #define _mm_cmple_epu16_mask   rmgr_fib_mm_cmple_epu16_mask
+    #define _mm_cmpgt_epu16_mask   rmgr_fib_mm_cmpgt_epu16_mask
+    #define _mm_cmpge_epu16_mask   rmgr_fib_mm_cmpge_epu16_mask
+
+    // GCC declares these as macros in unoptimized builds, even without AVX512BW
+    #undef  _mm_cmp_epi8_mask
+    #undef  _mm_cmp_epu8_mask
+    #undef  _mm_cmp_epi16_mask
+    #undef  _mm_cmp_epu16_mask
+    #define _mm_cmp_epi8_mask(a, b, imm8)   rmgr_fib_mm_cmp_epi8_mask<(imm8)>((a), (b))
+    #define _mm_cmp_epu8_mask(a, b, imm8)   rmgr_fib_mm_cmp_epu8_mask<(imm8)>((a), (b))
+    #define _mm_cmp_epi16_mask(a, b, imm8)  rmgr_fib_mm_cmp_epi16_mask<(imm8)>((a), (b))
+    #define _mm_cmp_epu16_mask(a, b, imm8)  rmgr_fib_mm_cmp_epu16_mask<(imm8)>((a), (b))
+
+    INTERNAL_RMGR_FIB_CMP_MASK(epi8,  8,  __mmask16, 0xFFFF)
+    INTERNAL_RMGR_FIB_CMP_MASK(epu8,  8,  __mmask16, 0xFFFF)
+    INTERNAL_RMGR_FIB_CMP_MASK(epi16, 16, __mmask8,  0xFF)
+    INTERNAL_RMGR_FIB_CMP_MASK(epu16, 16, __mmask8,  0xFF)
+#endif
+
+// 32 & 64-bit
 #if !INTERNAL_RMGR_FIB_USE_AVX512VL
-    #define _mm_abs_epi64  rmgr_fib_mm_abs_epi64
+    #define _mm_cmpeq_epi32_mask   rmgr_fib_mm_cmpeq_epi32_mask
+    #define _mm_cmpneq_epi32_mask  rmgr_fib_mm_cmpneq_epi32_mask
+    #define _mm_cmplt_epi32_mask   rmgr_fib_mm_cmplt_epi32_mask
+    #define _mm_cmple_epi32_mask   rmgr_fib_mm_cmple_epi32_mask
+    #define _mm_cmpgt_epi32_mask   rmgr_fib_mm_cmpgt_epi32_mask
+    #define _mm_cmpge_epi32_mask   rmgr_fib_mm_cmpge_epi32_mask
+    #define _mm_cmpeq_epu32_mask   rmgr_fib_mm_cmpeq_epu32_mask
+    #define _mm_cmpneq_epu32_mask  rmgr_fib_mm_cmpneq_epu32_mask
+    #define _mm_cmplt_epu32_mask   rmgr_fib_mm_cmplt_epu32_mask
+    #define _mm_cmple_epu32_mask   rmgr_fib_mm_cmple_epu32_mask
+    #define _mm_cmpgt_epu32_mask   rmgr_fib_mm_cmpgt_epu32_mask
+    #define _mm_cmpge_epu32_mask   rmgr_fib_mm_cmpge_epu32_mask
 
-    static inline __m128i rmgr_fib_mm_abs_epi64(const __m128i& a) RMGR_NOEXCEPT
+    #define _mm_cmpeq_epi64_mask   rmgr_fib_mm_cmpeq_epi64_mask
+    #define _mm_cmpneq_epi64_mask  rmgr_fib_mm_cmpneq_epi64_mask
+    #define _mm_cmplt_epi64_mask   rmgr_fib_mm_cmplt_epi64_mask
+    #define _mm_cmple_epi64_mask   rmgr_fib_mm_cmple_epi64_mask
+    #define _mm_cmpgt_epi64_mask   rmgr_fib_mm_cmpgt_epi64_mask
+    #define _mm_cmpge_epi64_mask   rmgr_fib_mm_cmpge_epi64_mask
+    #define _mm_cmpeq_epu64_mask   rmgr_fib_mm_cmpeq_epu64_mask
+    #define _mm_cmpneq_epu64_mask  rmgr_fib_mm_cmpneq_epu64_mask
+    #define _mm_cmplt_epu64_mask   rmgr_fib_mm_cmplt_epu64_mask
+    #define _mm_cmple_epu64_mask   rmgr_fib_mm_cmple_epu64_mask
+    #define _mm_cmpgt_epu64_mask   rmgr_fib_mm_cmpgt_epu64_mask
+    #define _mm_cmpge_epu64_mask   rmgr_fib_mm_cmpge_epu64_mask
+
+    // GCC declares these as macros in unoptimized builds, even without AVX512VL
+    #undef  _mm_cmp_epi32_mask
+    #undef  _mm_cmp_epu32_mask
+    #undef  _mm_cmp_epi64_mask
+    #undef  _mm_cmp_epu64_mask
+    #define _mm_cmp_epi32_mask(a, b, imm8)  rmgr_fib_mm_cmp_epi32_mask<(imm8)>((a), (b))
+    #define _mm_cmp_epu32_mask(a, b, imm8)  rmgr_fib_mm_cmp_epu32_mask<(imm8)>((a), (b))
+    #define _mm_cmp_epi64_mask(a, b, imm8)  rmgr_fib_mm_cmp_epi64_mask<(imm8)>((a), (b))
+    #define _mm_cmp_epu64_mask(a, b, imm8)  rmgr_fib_mm_cmp_epu64_mask<(imm8)>((a), (b))
+
+    INTERNAL_RMGR_FIB_CMP_MASK(epi32, 32, __mmask8, 0x0F)
+    INTERNAL_RMGR_FIB_CMP_MASK(epu32, 32, __mmask8, 0x0F)
+    INTERNAL_RMGR_FIB_CMP_MASK(epi64, 64, __mmask8, 0x03)
+    INTERNAL_RMGR_FIB_CMP_MASK(epu64, 64, __mmask8, 0x03)
+#endif
+
+#undef INTERNAL_RMGR_FIB_CMP_MASK
+
+
+//=================================================================================================
+// Masked operations
+//
+// The _mm_mask_xxx() forms take the lanes whose mask bit is clear from src, the _mm_maskz_xxx()
+// forms zero them.
+
+// Declares both masked forms of a binary operation
+#define INTERNAL_RMGR_FIB_MASK_OP(op, suffix, lanes, Mask)                                                                   \
+    static inline __m128i rmgr_fib_mm_mask_##op##_##suffix(const __m128i& src, Mask k, const __m128i& a, const __m128i& b) RMGR_NOEXCEPT \
+    {                                                                                                                      \
+        return INTERNAL_RMGR_FIB_SELECT(rmgr_fib_mm_movm_##lanes(k), _mm_##op##_##suffix(a, b), src);                      \
+    }                                                                                                                      \
+    static inline __m128i rmgr_fib_mm_maskz_##op##_##suffix(Mask k, const __m128i& a, const __m128i& b) RMGR_NOEXCEPT    \
+    {                                                                                                                      \
+        return _mm_and_si128(rmgr_fib_mm_movm_##lanes(k), _mm_##op##_##suffix(a, b));                                     \
+    }
+
+// 8 & 16-bit
+#if !(INTERNAL_RMGR_FIB_USE_AVX512BW && INTERNAL_RMGR_FIB_USE_AVX512VL)
+    // GCC declares the blends as macros in unoptimized builds, even without AVX512BW
+    #undef  _mm_mask_blend_epi8
+    #undef  _mm_mask_blend_epi16
+    #define _mm_mask_blend_epi8   rmgr_fib_mm_mask_blend_epi8
+    #define _mm_mask_blend_epi16  rmgr_fib_mm_mask_blend_epi16
+
+    #define _mm_mask_add_epi8     rmgr_fib_mm_mask_add_epi8
+    #define _mm_maskz_add_epi8    rmgr_fib_mm_maskz_add_epi8
+    #define _mm_mask_sub_epi8     rmgr_fib_mm_mask_sub_epi8
+    #define _mm_maskz_sub_epi8    rmgr_fib_mm_maskz_sub_epi8
+    #define _mm_mask_min_epi8     rmgr_fib_mm_mask_min_epi8
+    #define _mm_maskz_min_epi8    rmgr_fib_mm_maskz_min_epi8
+    #define _mm_mask_max_epi8     rmgr_fib_mm_mask_max_epi8
+    #define _mm_maskz_max_epi8    rmgr_fib_mm_maskz_max_epi8
+    #define _mm_mask_min_epu8     rmgr_fib_mm_mask_min_epu8
+    #define _mm_maskz_min_epu8    rmgr_fib_mm_maskz_min_epu8
+    #define _mm_mask_max_epu8     rmgr_fib_mm_mask_max_epu8
+    #define _mm_maskz_max_epu8    rmgr_fib_mm_maskz_max_epu8
+
+    #define _mm_mask_add_epi16    rmgr_fib_mm_mask_add_epi16
+    #define _mm_maskz_add_epi16   rmgr_fib_mm_maskz_add_epi16
+    #define _mm_mask_sub_epi16    rmgr_fib_mm_mask_sub_epi16
+    #define _mm_maskz_sub_epi16   rmgr_fib_mm_maskz_sub_epi16
+    #define _mm_mask_min_epi16    rmgr_fib_mm_mask_min_epi16
+    #define _mm_maskz_min_epi16   rmgr_fib_mm_maskz_min_epi16
+    #define _mm_mask_max_epi16    rmgr_fib_mm_mask_max_epi16
+    #define _mm_maskz_max_epi16   rmgr_fib_mm_maskz_max_epi16
+    #define _mm_mask_min_epu16    rmgr_fib_mm_mask_min_epu16
+    #define _mm_maskz_min_epu16   rmgr_fib_mm_maskz_min_epu16
+    #define _mm_mask_max_epu16    rmgr_fib_mm_mask_max_epu16
+    #define _mm_maskz_max_epu16   rmgr_fib_mm_maskz_max_epu16
+
+    static inline __m128i rmgr_fib_mm_mask_blend_epi8(__mmask16 k, const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
     {
-        #if INTERNAL_RMGR_FIB_USE_SSE42
-            const __m128i s = _mm_cmpgt_epi64(_mm_setzero_si128(), a);
-        #else
-            const __m128i s = _mm_shuffle_epi32(_mm_srai_epi32(a,31), _MM_SHUFFLE(3,3,1,1));
-        #endif
-        return _mm_sub_epi64(_mm_xor_si128(a, s), s);
+        return INTERNAL_RMGR_FIB_SELECT(rmgr_fib_mm_movm_epi8(k), b, a);
+    }
+
+    static inline __m128i rmgr_fib_mm_mask_blend_epi16(__mmask8 k, const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        return INTERNAL_RMGR_FIB_SELECT(rmgr_fib_mm_movm_epi16(k), b, a);
     }
+
+    INTERNAL_RMGR_FIB_MASK_OP(add, epi8,  epi8,  __mmask16)
+    INTERNAL_RMGR_FIB_MASK_OP(sub, epi8,  epi8,  __mmask16)
+    INTERNAL_RMGR_FIB_MASK_OP(min, epi8,  epi8,  __mmask16)
+    INTERNAL_RMGR_FIB_MASK_OP(max, epi8,  epi8,  __mmask16)
+    INTERNAL_RMGR_FIB_MASK_OP(min, epu8,  epi8,  __mmask16)
+    INTERNAL_RMGR_FIB_MASK_OP(max, epu8,  epi8,  __mmask16)
+    INTERNAL_RMGR_FIB_MASK_OP(add, epi16, epi16, __mmask8)
+    INTERNAL_RMGR_FIB_MASK_OP(sub, epi16, epi16, __mmask8)
+    INTERNAL_RMGR_FIB_MASK_OP(min, epi16, epi16, __mmask8)
+    INTERNAL_RMGR_FIB_MASK_OP(max, epi16, epi16, __mmask8)
+    INTERNAL_RMGR_FIB_MASK_OP(min, epu16, epi16, __mmask8)
+    INTERNAL_RMGR_FIB_MASK_OP(max, epu16, epi16, __mmask8)
 #endif
 
-// floating point
-#define _mm_abs_ps(a)  _mm_and_ps((a), _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFFu)))
-#define _mm_abs_pd(a)  _mm_and_pd((a), _mm_castsi128_pd(_mm_set1_epi64x(UINT64_C(0x7FFFFFFFFFFFFFFF))))
+// 32 & 64-bit
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    // GCC declares the blends as macros in unoptimized builds, even without AVX512VL
+    #undef  _mm_mask_blend_epi32
+    #undef  _mm_mask_blend_epi64
+    #undef  _mm_mask_blend_ps
+    #undef  _mm_mask_blend_pd
+    #define _mm_mask_blend_epi32  rmgr_fib_mm_mask_blend_epi32
+    #define _mm_mask_blend_epi64  rmgr_fib_mm_mask_blend_epi64
+    #define _mm_mask_blend_ps     rmgr_fib_mm_mask_blend_ps
+    #define _mm_mask_blend_pd     rmgr_fib_mm_mask_blend_pd
+
+    #define _mm_mask_add_epi32    rmgr_fib_mm_mask_add_epi32
+    #define _mm_maskz_add_epi32   rmgr_fib_mm_maskz_add_epi32
+    #define _mm_mask_sub_epi32    rmgr_fib_mm_mask_sub_epi32
+    #define _mm_maskz_sub_epi32   rmgr_fib_mm_maskz_sub_epi32
+    #define _mm_mask_min_epi32    rmgr_fib_mm_mask_min_epi32
+    #define _mm_maskz_min_epi32   rmgr_fib_mm_maskz_min_epi32
+    #define _mm_mask_max_epi32    rmgr_fib_mm_mask_max_epi32
+    #define _mm_maskz_max_epi32   rmgr_fib_mm_maskz_max_epi32
+    #define _mm_mask_min_epu32    rmgr_fib_mm_mask_min_epu32
+    #define _mm_maskz_min_epu32   rmgr_fib_mm_maskz_min_epu32
+    #define _mm_mask_max_epu32    rmgr_fib_mm_mask_max_epu32
+    #define _mm_maskz_max_epu32   rmgr_fib_mm_maskz_max_epu32
+
+    #define _mm_mask_add_epi64    rmgr_fib_mm_mask_add_epi64
+    #define _mm_maskz_add_epi64   rmgr_fib_mm_maskz_add_epi64
+    #define _mm_mask_sub_epi64    rmgr_fib_mm_mask_sub_epi64
+    #define _mm_maskz_sub_epi64   rmgr_fib_mm_maskz_sub_epi64
+    #define _mm_mask_min_epi64    rmgr_fib_mm_mask_min_epi64
+    #define _mm_maskz_min_epi64   rmgr_fib_mm_maskz_min_epi64
+    #define _mm_mask_max_epi64    rmgr_fib_mm_mask_max_epi64
+    #define _mm_maskz_max_epi64   rmgr_fib_mm_maskz_max_epi64
+    #define _mm_mask_min_epu64    rmgr_fib_mm_mask_min_epu64
+    #define _mm_maskz_min_epu64   rmgr_fib_mm_maskz_min_epu64
+    #define _mm_mask_max_epu64    rmgr_fib_mm_mask_max_epu64
+    #define _mm_maskz_max_epu64   rmgr_fib_mm_maskz_max_epu64
+
+    static inline __m128i rmgr_fib_mm_mask_blend_epi32(__mmask8 k, const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        return INTERNAL_RMGR_FIB_SELECT(rmgr_fib_mm_movm_epi32(k), b, a);
+    }
+
+    static inline __m128i rmgr_fib_mm_mask_blend_epi64(__mmask8 k, const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+    {
+        return INTERNAL_RMGR_FIB_SELECT(rmgr_fib_mm_movm_epi64(k), b, a);
+    }
+
+    static inline __m128 rmgr_fib_mm_mask_blend_ps(__mmask8 k, const __m128& a, const __m128& b) RMGR_NOEXCEPT
+    {
+        const __m128i mask = rmgr_fib_mm_movm_epi32(k);
+        return _mm_castsi128_ps(INTERNAL_RMGR_FIB_SELECT(mask, _mm_castps_si128(b), _mm_castps_si128(a)));
+    }
+
+    static inline __m128d rmgr_fib_mm_mask_blend_pd(__mmask8 k, const __m128d& a, const __m128d& b) RMGR_NOEXCEPT
+    {
+        const __m128i mask = rmgr_fib_mm_movm_epi64(k);
+        return _mm_castsi128_pd(INTERNAL_RMGR_FIB_SELECT(mask, _mm_castpd_si128(b), _mm_castpd_si128(a)));
+    }
+
+    INTERNAL_RMGR_FIB_MASK_OP(add, epi32, epi32, __mmask8)
+    INTERNAL_RMGR_FIB_MASK_OP(sub, epi32, epi32, __mmask8)
+    INTERNAL_RMGR_FIB_MASK_OP(min, epi32, epi32, __mmask8)
+    INTERNAL_RMGR_FIB_MASK_OP(max, epi32, epi32, __mmask8)
+    INTERNAL_RMGR_FIB_MASK_OP(min, epu32, epi32, __mmask8)
+    INTERNAL_RMGR_FIB_MASK_OP(max, epu32, epi32, __mmask8)
+    INTERNAL_RMGR_FIB_MASK_OP(add, epi64, epi64, __mmask8)
+    INTERNAL_RMGR_FIB_MASK_OP(sub, epi64, epi64, __mmask8)
+    INTERNAL_RMGR_FIB_MASK_OP(min, epi64, epi64, __mmask8)
+    INTERNAL_RMGR_FIB_MASK_OP(max, epi64, epi64, __mmask8)
+    INTERNAL_RMGR_FIB_MASK_OP(min, epu64, epi64, __mmask8)
+    INTERNAL_RMGR_FIB_MASK_OP(max, epu64, epi64, __mmask8)
+#endif
+
+#undef INTERNAL_RMGR_FIB_MASK_OP
+
+
+//=================================================================================================
+// Compress & expand
+//
+// Compressing packs the lanes whose mask bit is set into the low lanes, in order, expanding does
+// the opposite and spreads the low lanes to the positions of the set bits. compressstoreu() only
+// writes the lanes that were selected.
+//
+// With SSSE3, these are single pshufbs whose controls are looked up by 8 bits of mask at a time.
+// 16-bit lanes widen the controls of 8 byte lanes, 32-bit lanes have their own small table, and 16
+// byte lanes are done as two halves which are then joined together. Without SSSE3, each selected
+// lane moves down by the number of unselected lanes below it, one bit of that count at a time
+// starting from the lowest, which never makes two lanes collide. Expanding runs the same network
+// backwards. 64-bit lanes, with only 4 masks, are simple blends.
+//
+// There is no AVX512-VBMI2 support, hence 8 and 16-bit lanes are always emulated.
+
+// Number of bits set in a 16-bit mask
+static RMGR_FORCEINLINE unsigned rmgr_fib_mask_popcnt(unsigned k) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSE42
+    return unsigned(_mm_popcnt_u32(k));
+#else
+    k = k - ((k >> 1) & 0x5555);
+    k = (k & 0x3333) + ((k >> 2) & 0x3333);
+    k = (k + (k >> 4)) & 0x0F0F;
+    return (k + (k >> 8)) & 0x1F;
+#endif
+}
+
+#if INTERNAL_RMGR_FIB_USE_SSSE3
+    // pshufb controls for 8 byte lanes, indexed by mask, unused lanes being zeroed (0x80), and the
+    // same already widened for 4 32-bit lanes. Being members of a template lets them be defined in
+    // a header.
+    template<int dummy>
+    struct rmgr_fib_compress_tables
+    {
+        static const uint64_t compress[256];  // Byte i is the index of the i-th bit set
+        static const uint64_t expand[256];    // Byte i is the number of bits set below bit i
+        static const uint64_t compress32[32];
+        static const uint64_t expand32[32];
+    };
+
+    template<int dummy>
+    const uint64_t rmgr_fib_compress_tables<dummy>::compress[256] =
+    {
+        0x8080808080808080ull, 0x8080808080808000ull, 0x8080808080808001ull, 0x8080808080800100ull,
+        0x8080808080808002ull, 0x8080808080800200ull, 0x8080808080800201ull, 0x8080808080020100ull,
+        0x8080808080808003ull, 0x8080808080800300ull, 0x8080808080800301ull, 0x8080808080030100ull,
+        0x8080808080800302ull, 0x8080808080030200ull, 0x8080808080030201ull, 0x8080808003020100ull,
+        0x8080808080808004ull, 0x8080808080800400ull, 0x8080808080800401ull, 0x8080808080040100ull,
+        0x8080808080800402ull, 0x8080808080040200ull, 0x8080808080040201ull, 0x8080808004020100ull,
+        0x8080808080800403ull, 0x8080808080040300ull, 0x8080808080040301ull, 0x8080808004030100ull,
+        0x8080808080040302ull, 0x8080808004030200ull, 0x8080808004030201ull, 0x8080800403020100ull,
+        0x8080808080808005ull, 0x8080808080800500ull, 0x8080808080800501ull, 0x8080808080050100ull,
+        0x8080808080800502ull, 0x8080808080050200ull, 0x8080808080050201ull, 0x8080808005020100ull,
+        0x8080808080800503ull, 0x8080808080050300ull, 0x8080808080050301ull, 0x8080808005030100ull,
+        0x8080808080050302ull, 0x8080808005030200ull, 0x8080808005030201ull, 0x8080800503020100ull,
+        0x8080808080800504ull, 0x8080808080050400ull, 0x8080808080050401ull, 0x8080808005040100ull,
+        0x8080808080050402ull, 0x8080808005040200ull, 0x8080808005040201ull, 0x8080800504020100ull,
+        0x8080808080050403ull, 0x8080808005040300ull, 0x8080808005040301ull, 0x8080800504030100ull,
+        0x8080808005040302ull, 0x8080800504030200ull, 0x8080800504030201ull, 0x8080050403020100ull,
+        0x8080808080808006ull, 0x8080808080800600ull, 0x8080808080800601ull, 0x8080808080060100ull,
+        0x8080808080800602ull, 0x8080808080060200ull, 0x8080808080060201ull, 0x8080808006020100ull,
+        0x8080808080800603ull, 0x8080808080060300ull, 0x8080808080060301ull, 0x8080808006030100ull,
+        0x8080808080060302ull, 0x8080808006030200ull, 0x8080808006030201ull, 0x8080800603020100ull,
+        0x8080808080800604ull, 0x8080808080060400ull, 0x8080808080060401ull, 0x8080808006040100ull,
+        0x8080808080060402ull, 0x8080808006040200ull, 0x8080808006040201ull, 0x8080800604020100ull,
+        0x8080808080060403ull, 0x8080808006040300ull, 0x8080808006040301ull, 0x8080800604030100ull,
+        0x8080808006040302ull, 0x8080800604030200ull, 0x8080800604030201ull, 0x8080060403020100ull,
+        0x8080808080800605ull, 0x8080808080060500ull, 0x8080808080060501ull, 0x8080808006050100ull,
+        0x8080808080060502ull, 0x8080808006050200ull, 0x8080808006050201ull, 0x8080800605020100ull,
+        0x8080808080060503ull, 0x8080808006050300ull, 0x8080808006050301ull, 0x8080800605030100ull,
+        0x8080808006050302ull, 0x8080800605030200ull, 0x8080800605030201ull, 0x8080060503020100ull,
+        0x8080808080060504ull, 0x8080808006050400ull, 0x8080808006050401ull, 0x8080800605040100ull,
+        0x8080808006050402ull, 0x8080800605040200ull, 0x8080800605040201ull, 0x8080060504020100ull,
+        0x8080808006050403ull, 0x8080800605040300ull, 0x8080800605040301ull, 0x8080060504030100ull,
+        0x8080800605040302ull, 0x8080060504030200ull, 0x8080060504030201ull, 0x8006050403020100ull,
+        0x8080808080808007ull, 0x8080808080800700ull, 0x8080808080800701ull, 0x8080808080070100ull,
+        0x8080808080800702ull, 0x8080808080070200ull, 0x8080808080070201ull, 0x8080808007020100ull,
+        0x8080808080800703ull, 0x8080808080070300ull, 0x8080808080070301ull, 0x8080808007030100ull,
+        0x8080808080070302ull, 0x8080808007030200ull, 0x8080808007030201ull, 0x8080800703020100ull,
+        0x8080808080800704ull, 0x8080808080070400ull, 0x8080808080070401ull, 0x8080808007040100ull,
+        0x8080808080070402ull, 0x8080808007040200ull, 0x8080808007040201ull, 0x8080800704020100ull,
+        0x8080808080070403ull, 0x8080808007040300ull, 0x8080808007040301ull, 0x8080800704030100ull,
+        0x8080808007040302ull, 0x8080800704030200ull, 0x8080800704030201ull, 0x8080070403020100ull,
+        0x8080808080800705ull, 0x8080808080070500ull, 0x8080808080070501ull, 0x8080808007050100ull,
+        0x8080808080070502ull, 0x8080808007050200ull, 0x8080808007050201ull, 0x8080800705020100ull,
+        0x8080808080070503ull, 0x8080808007050300ull, 0x8080808007050301ull, 0x8080800705030100ull,
+        0x8080808007050302ull, 0x8080800705030200ull, 0x8080800705030201ull, 0x8080070503020100ull,
+        0x8080808080070504ull, 0x8080808007050400ull, 0x8080808007050401ull, 0x8080800705040100ull,
+        0x8080808007050402ull, 0x8080800705040200ull, 0x8080800705040201ull, 0x8080070504020100ull,
+        0x8080808007050403ull, 0x8080800705040300ull, 0x8080800705040301ull, 0x8080070504030100ull,
+        0x8080800705040302ull, 0x8080070504030200ull, 0x8080070504030201ull, 0x8007050403020100ull,
+        0x8080808080800706ull, 0x8080808080070600ull, 0x8080808080070601ull, 0x8080808007060100ull,
+        0x8080808080070602ull, 0x8080808007060200ull, 0x8080808007060201ull, 0x8080800706020100ull,
+        0x8080808080070603ull, 0x8080808007060300ull, 0x8080808007060301ull, 0x8080800706030100ull,
+        0x8080808007060302ull, 0x8080800706030200ull, 0x8080800706030201ull, 0x8080070603020100ull,
+        0x8080808080070604ull, 0x8080808007060400ull, 0x8080808007060401ull, 0x8080800706040100ull,
+        0x8080808007060402ull, 0x8080800706040200ull, 0x8080800706040201ull, 0x8080070604020100ull,
+        0x8080808007060403ull, 0x8080800706040300ull, 0x8080800706040301ull, 0x8080070604030100ull,
+        0x8080800706040302ull, 0x8080070604030200ull, 0x8080070604030201ull, 0x8007060403020100ull,
+        0x8080808080070605ull, 0x8080808007060500ull, 0x8080808007060501ull, 0x8080800706050100ull,
+        0x8080808007060502ull, 0x8080800706050200ull, 0x8080800706050201ull, 0x8080070605020100ull,
+        0x8080808007060503ull, 0x8080800706050300ull, 0x8080800706050301ull, 0x8080070605030100ull,
+        0x8080800706050302ull, 0x8080070605030200ull, 0x8080070605030201ull, 0x8007060503020100ull,
+        0x8080808007060504ull, 0x8080800706050400ull, 0x8080800706050401ull, 0x8080070605040100ull,
+        0x8080800706050402ull, 0x8080070605040200ull, 0x8080070605040201ull, 0x8007060504020100ull,
+        0x8080800706050403ull, 0x8080070605040300ull, 0x8080070605040301ull, 0x8007060504030100ull,
+        0x8080070605040302ull, 0x8007060504030200ull, 0x8007060504030201ull, 0x0706050403020100ull
+    };
+
+    template<int dummy>
+    const uint64_t rmgr_fib_compress_tables<dummy>::expand[256] =
+    {
+        0x8080808080808080ull, 0x8080808080808000ull, 0x8080808080800080ull, 0x8080808080800100ull,
+        0x8080808080008080ull, 0x8080808080018000ull, 0x8080808080010080ull, 0x8080808080020100ull,
+        0x8080808000808080ull, 0x8080808001808000ull, 0x8080808001800080ull, 0x8080808002800100ull,
+        0x8080808001008080ull, 0x8080808002018000ull, 0x8080808002010080ull, 0x8080808003020100ull,
+        0x8080800080808080ull, 0x8080800180808000ull, 0x8080800180800080ull, 0x8080800280800100ull,
+        0x8080800180008080ull, 0x8080800280018000ull, 0x8080800280010080ull, 0x8080800380020100ull,
+        0x8080800100808080ull, 0x8080800201808000ull, 0x8080800201800080ull, 0x8080800302800100ull,
+        0x8080800201008080ull, 0x8080800302018000ull, 0x8080800302010080ull, 0x8080800403020100ull,
+        0x8080008080808080ull, 0x8080018080808000ull, 0x8080018080800080ull, 0x8080028080800100ull,
+        0x8080018080008080ull, 0x8080028080018000ull, 0x8080028080010080ull, 0x8080038080020100ull,
+        0x8080018000808080ull, 0x8080028001808000ull, 0x8080028001800080ull, 0x8080038002800100ull,
+        0x8080028001008080ull, 0x8080038002018000ull, 0x8080038002010080ull, 0x8080048003020100ull,
+        0x8080010080808080ull, 0x8080020180808000ull, 0x8080020180800080ull, 0x8080030280800100ull,
+        0x8080020180008080ull, 0x8080030280018000ull, 0x8080030280010080ull, 0x8080040380020100ull,
+        0x8080020100808080ull, 0x8080030201808000ull, 0x8080030201800080ull, 0x8080040302800100ull,
+        0x8080030201008080ull, 0x8080040302018000ull, 0x8080040302010080ull, 0x8080050403020100ull,
+        0x8000808080808080ull, 0x8001808080808000ull, 0x8001808080800080ull, 0x8002808080800100ull,
+        0x8001808080008080ull, 0x8002808080018000ull, 0x8002808080010080ull, 0x8003808080020100ull,
+        0x8001808000808080ull, 0x8002808001808000ull, 0x8002808001800080ull, 0x8003808002800100ull,
+        0x8002808001008080ull, 0x8003808002018000ull, 0x8003808002010080ull, 0x8004808003020100ull,
+        0x8001800080808080ull, 0x8002800180808000ull, 0x8002800180800080ull, 0x8003800280800100ull,
+        0x8002800180008080ull, 0x8003800280018000ull, 0x8003800280010080ull, 0x8004800380020100ull,
+        0x8002800100808080ull, 0x8003800201808000ull, 0x8003800201800080ull, 0x8004800302800100ull,
+        0x8003800201008080ull, 0x8004800302018000ull, 0x8004800302010080ull, 0x8005800403020100ull,
+        0x8001008080808080ull, 0x8002018080808000ull, 0x8002018080800080ull, 0x8003028080800100ull,
+        0x8002018080008080ull, 0x8003028080018000ull, 0x8003028080010080ull, 0x8004038080020100ull,
+        0x8002018000808080ull, 0x8003028001808000ull, 0x8003028001800080ull, 0x8004038002800100ull,
+        0x8003028001008080ull, 0x8004038002018000ull, 0x8004038002010080ull, 0x8005048003020100ull,
+        0x8002010080808080ull, 0x8003020180808000ull, 0x8003020180800080ull, 0x8004030280800100ull,
+        0x8003020180008080ull, 0x8004030280018000ull, 0x8004030280010080ull, 0x8005040380020100ull,
+        0x8003020100808080ull, 0x8004030201808000ull, 0x8004030201800080ull, 0x8005040302800100ull,
+        0x8004030201008080ull, 0x8005040302018000ull, 0x8005040302010080ull, 0x8006050403020100ull,
+        0x0080808080808080ull, 0x0180808080808000ull, 0x0180808080800080ull, 0x0280808080800100ull,
+        0x0180808080008080ull, 0x0280808080018000ull, 0x0280808080010080ull, 0x0380808080020100ull,
+        0x0180808000808080ull, 0x0280808001808000ull, 0x0280808001800080ull, 0x0380808002800100ull,
+        0x0280808001008080ull, 0x0380808002018000ull, 0x0380808002010080ull, 0x0480808003020100ull,
+        0x0180800080808080ull, 0x0280800180808000ull, 0x0280800180800080ull, 0x0380800280800100ull,
+        0x0280800180008080ull, 0x0380800280018000ull, 0x0380800280010080ull, 0x0480800380020100ull,
+        0x0280800100808080ull, 0x0380800201808000ull, 0x0380800201800080ull, 0x0480800302800100ull,
+        0x0380800201008080ull, 0x0480800302018000ull, 0x0480800302010080ull, 0x0580800403020100ull,
+        0x0180008080808080ull, 0x0280018080808000ull, 0x0280018080800080ull, 0x0380028080800100ull,
+        0x0280018080008080ull, 0x0380028080018000ull, 0x0380028080010080ull, 0x0480038080020100ull,
+        0x0280018000808080ull, 0x0380028001808000ull, 0x0380028001800080ull, 0x0480038002800100ull,
+        0x0380028001008080ull, 0x0480038002018000ull, 0x0480038002010080ull, 0x0580048003020100ull,
+        0x0280010080808080ull, 0x0380020180808000ull, 0x0380020180800080ull, 0x0480030280800100ull,
+        0x0380020180008080ull, 0x0480030280018000ull, 0x0480030280010080ull, 0x0580040380020100ull,
+        0x0380020100808080ull, 0x0480030201808000ull, 0x0480030201800080ull, 0x0580040302800100ull,
+        0x0480030201008080ull, 0x0580040302018000ull, 0x0580040302010080ull, 0x0680050403020100ull,
+        0x0100808080808080ull, 0x0201808080808000ull, 0x0201808080800080ull, 0x0302808080800100ull,
+        0x0201808080008080ull, 0x0302808080018000ull, 0x0302808080010080ull, 0x0403808080020100ull,
+        0x0201808000808080ull, 0x0302808001808000ull, 0x0302808001800080ull, 0x0403808002800100ull,
+        0x0302808001008080ull, 0x0403808002018000ull, 0x0403808002010080ull, 0x0504808003020100ull,
+        0x0201800080808080ull, 0x0302800180808000ull, 0x0302800180800080ull, 0x0403800280800100ull,
+        0x0302800180008080ull, 0x0403800280018000ull, 0x0403800280010080ull, 0x0504800380020100ull,
+        0x0302800100808080ull, 0x0403800201808000ull, 0x0403800201800080ull, 0x0504800302800100ull,
+        0x0403800201008080ull, 0x0504800302018000ull, 0x0504800302010080ull, 0x0605800403020100ull,
+        0x0201008080808080ull, 0x0302018080808000ull, 0x0302018080800080ull, 0x0403028080800100ull,
+        0x0302018080008080ull, 0x0403028080018000ull, 0x0403028080010080ull, 0x0504038080020100ull,
+        0x0302018000808080ull, 0x0403028001808000ull, 0x0403028001800080ull, 0x0504038002800100ull,
+        0x0403028001008080ull, 0x0504038002018000ull, 0x0504038002010080ull, 0x0605048003020100ull,
+        0x0302010080808080ull, 0x0403020180808000ull, 0x0403020180800080ull, 0x0504030280800100ull,
+        0x0403020180008080ull, 0x0504030280018000ull, 0x0504030280010080ull, 0x0605040380020100ull,
+        0x0403020100808080ull, 0x0504030201808000ull, 0x0504030201800080ull, 0x0605040302800100ull,
+        0x0504030201008080ull, 0x0605040302018000ull, 0x0605040302010080ull, 0x0706050403020100ull
+    };
+
+    template<int dummy>
+    const uint64_t rmgr_fib_compress_tables<dummy>::compress32[32] =
+    {
+        0x8080808080808080ull, 0x8080808080808080ull, 0x8080808003020100ull, 0x8080808080808080ull,
+        0x8080808007060504ull, 0x8080808080808080ull, 0x0706050403020100ull, 0x8080808080808080ull,
+        0x808080800B0A0908ull, 0x8080808080808080ull, 0x0B0A090803020100ull, 0x8080808080808080ull,
+        0x0B0A090807060504ull, 0x8080808080808080ull, 0x0706050403020100ull, 0x808080800B0A0908ull,
+        0x808080800F0E0D0Cull, 0x8080808080808080ull, 0x0F0E0D0C03020100ull, 0x8080808080808080ull,
+        0x0F0E0D0C07060504ull, 0x8080808080808080ull, 0x0706050403020100ull, 0x808080800F0E0D0Cull,
+        0x0F0E0D0C0B0A0908ull, 0x8080808080808080ull, 0x0B0A090803020100ull, 0x808080800F0E0D0Cull,
+        0x0B0A090807060504ull, 0x808080800F0E0D0Cull, 0x0706050403020100ull, 0x0F0E0D0C0B0A0908ull
+    };
+
+    template<int dummy>
+    const uint64_t rmgr_fib_compress_tables<dummy>::expand32[32] =
+    {
+        0x8080808080808080ull, 0x8080808080808080ull, 0x8080808003020100ull, 0x8080808080808080ull,
+        0x0302010080808080ull, 0x8080808080808080ull, 0x0706050403020100ull, 0x8080808080808080ull,
+        0x8080808080808080ull, 0x8080808003020100ull, 0x8080808003020100ull, 0x8080808007060504ull,
+        0x0302010080808080ull, 0x8080808007060504ull, 0x0706050403020100ull, 0x808080800B0A0908ull,
+        0x8080808080808080ull, 0x0302010080808080ull, 0x8080808003020100ull, 0x0706050480808080ull,
+        0x0302010080808080ull, 0x0706050480808080ull, 0x0706050403020100ull, 0x0B0A090880808080ull,
+        0x8080808080808080ull, 0x0706050403020100ull, 0x8080808003020100ull, 0x0B0A090807060504ull,
+        0x0302010080808080ull, 0x0B0A090807060504ull, 0x0706050403020100ull, 0x0F0E0D0C0B0A0908ull
+    };
+
+    // Turns a control of byte lanes into one of twice wider lanes, zeroed lanes remaining so
+    static RMGR_FORCEINLINE __m128i rmgr_fib_widen_shuffle_control(const __m128i& c) RMGR_NOEXCEPT
+    {
+        const __m128i d = _mm_or_si128(_mm_add_epi8(c, c), _mm_and_si128(c, _mm_set1_epi8(char(0x80))));
+        return _mm_unpacklo_epi8(d, _mm_or_si128(d, _mm_set1_epi8(1)));
+    }
+
+    static RMGR_FORCEINLINE __m128i rmgr_fib_load_shuffle_control(const uint64_t& c) RMGR_NOEXCEPT
+    {
+        return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&c));
+    }
+#else
+    // Stage of the network moving the lanes whose count has the `lanes` bit set down by that many lanes
+    template<int bytes, int lanes>
+    static RMGR_FORCEINLINE void rmgr_fib_compress_stage(__m128i& v, __m128i& c) RMGR_NOEXCEPT
+    {
+        const __m128i bit = _mm_set1_epi8(char(lanes));
+        const __m128i m   = _mm_cmpeq_epi8(_mm_and_si128(c, bit), bit);
+        v = _mm_or_si128(_mm_andnot_si128(m, v), _mm_srli_si128(_mm_and_si128(m, v), bytes * lanes));
+        c = _mm_or_si128(_mm_andnot_si128(m, c), _mm_srli_si128(_mm_and_si128(m, c), bytes * lanes));
+    }
+
+    // Same, but moving them back up
+    template<int bytes, int lanes>
+    static RMGR_FORCEINLINE void rmgr_fib_expand_stage(__m128i& v, __m128i& c) RMGR_NOEXCEPT
+    {
+        const __m128i bit = _mm_set1_epi8(char(lanes));
+        const __m128i m   = _mm_cmpeq_epi8(_mm_and_si128(c, bit), bit);
+        v = _mm_or_si128(_mm_andnot_si128(m, v), _mm_slli_si128(_mm_and_si128(m, v), bytes * lanes));
+        c = _mm_or_si128(_mm_andnot_si128(m, c), _mm_slli_si128(_mm_and_si128(m, c), bytes * lanes));
+    }
+
+    // Moves the lanes of a which are set in sel down by the number of unselected lanes below them,
+    // the other lanes being zeroed. The counts are replicated in every byte of the lanes and carry
+    // the 0x80 flag, they travel along with the lanes and are returned in c.
+    template<int bytes>
+    static RMGR_FORCEINLINE __m128i rmgr_fib_compress_network(const __m128i& sel, const __m128i& a, __m128i& c) RMGR_NOEXCEPT
+    {
+        // Exclusive prefix sum of the unselected lanes, sel + 1 being 1 in each of their bytes
+        c = _mm_slli_si128(_mm_add_epi8(sel, _mm_set1_epi8(1)), bytes);
+        c = _mm_add_epi8(c, _mm_slli_si128(c, bytes));
+        if (bytes <= 4)
+            c = _mm_add_epi8(c, _mm_slli_si128(c, 2 * bytes));
+        if (bytes <= 2)
+            c = _mm_add_epi8(c, _mm_slli_si128(c, 4 * bytes));
+        if (bytes == 1)
+            c = _mm_add_epi8(c, _mm_slli_si128(c, 8));
+        c = _mm_and_si128(sel, _mm_or_si128(c, _mm_set1_epi8(char(0x80))));
+
+        __m128i v = _mm_and_si128(sel, a);
+        rmgr_fib_compress_stage<bytes, 1>(v, c);
+        if (bytes <= 4)
+            rmgr_fib_compress_stage<bytes, 2>(v, c);
+        if (bytes <= 2)
+            rmgr_fib_compress_stage<bytes, 4>(v, c);
+        if (bytes == 1)
+            rmgr_fib_compress_stage<bytes, 8>(v, c);
+        return v;
+    }
+
+    template<int bytes>
+    static RMGR_FORCEINLINE __m128i rmgr_fib_compress(const __m128i& sel, const __m128i& a) RMGR_NOEXCEPT
+    {
+        __m128i c;
+        return rmgr_fib_compress_network<bytes>(sel, a, c);
+    }
+
+    template<int bytes>
+    static RMGR_FORCEINLINE __m128i rmgr_fib_expand(const __m128i& sel, const __m128i& a) RMGR_NOEXCEPT
+    {
+        // Compressing the lanes tells where each of them ends up, the flags tell which low lanes of a are used
+        __m128i c;
+        rmgr_fib_compress_network<bytes>(sel, a, c);
+        __m128i v = _mm_and_si128(_mm_cmplt_epi8(c, _mm_setzero_si128()), a);
+        if (bytes == 1)
+            rmgr_fib_expand_stage<bytes, 8>(v, c);
+        if (bytes <= 2)
+            rmgr_fib_expand_stage<bytes, 4>(v, c);
+        if (bytes <= 4)
+            rmgr_fib_expand_stage<bytes, 2>(v, c);
+        rmgr_fib_expand_stage<bytes, 1>(v, c);
+        return v;
+    }
+#endif
+
+// Declares the merging and storing forms of compress & expand
+#define INTERNAL_RMGR_FIB_COMPRESS_OPS(suffix, lanes, Mask)                                                                  \
+    static inline __m128i rmgr_fib_mm_mask_compress_##suffix(const __m128i& src, Mask k, const __m128i& a) RMGR_NOEXCEPT \
+    {                                                                                                                      \
+        const unsigned n = rmgr_fib_mask_popcnt(k & ((1u << (lanes)) - 1));                                                \
+        return INTERNAL_RMGR_FIB_SELECT(rmgr_fib_mm_movm_##suffix(Mask((1u << n) - 1)), rmgr_fib_mm_maskz_compress_##suffix(k, a), src); \
+    }                                                                                                                      \
+    static inline void rmgr_fib_mm_mask_compressstoreu_##suffix(void* p, Mask k, const __m128i& a) RMGR_NOEXCEPT          \
+    {                                                                                                                      \
+        const unsigned n = rmgr_fib_mask_popcnt(k & ((1u << (lanes)) - 1));                                                \
+        uint8_t tmp[16];                                                                                                   \
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(tmp), rmgr_fib_mm_maskz_compress_##suffix(k, a));                      \
+        memcpy(p, tmp, n * (16 / (lanes)));                                                                                \
+    }                                                                                                                      \
+    static inline __m128i rmgr_fib_mm_mask_expand_##suffix(const __m128i& src, Mask k, const __m128i& a) RMGR_NOEXCEPT   \
+    {                                                                                                                      \
+        return INTERNAL_RMGR_FIB_SELECT(rmgr_fib_mm_movm_##suffix(k), rmgr_fib_mm_maskz_expand_##suffix(k, a), src);       \
+    }
+
+// 8 & 16-bit
+#define _mm_maskz_compress_epi8        rmgr_fib_mm_maskz_compress_epi8
+#define _mm_mask_compress_epi8         rmgr_fib_mm_mask_compress_epi8
+#define _mm_mask_compressstoreu_epi8   rmgr_fib_mm_mask_compressstoreu_epi8
+#define _mm_maskz_expand_epi8          rmgr_fib_mm_maskz_expand_epi8
+#define _mm_mask_expand_epi8           rmgr_fib_mm_mask_expand_epi8
+#define _mm_maskz_compress_epi16       rmgr_fib_mm_maskz_compress_epi16
+#define _mm_mask_compress_epi16        rmgr_fib_mm_mask_compress_epi16
+#define _mm_mask_compressstoreu_epi16  rmgr_fib_mm_mask_compressstoreu_epi16
+#define _mm_maskz_expand_epi16         rmgr_fib_mm_maskz_expand_epi16
+#define _mm_mask_expand_epi16          rmgr_fib_mm_mask_expand_epi16
+
+static inline __m128i rmgr_fib_mm_maskz_compress_epi8(__mmask16 k, const __m128i& a) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSSE3
+    // Both halves are compressed separately, then the high one is moved down next to the low one
+    typedef rmgr_fib_compress_tables<0> tables;
+    const __m128i hiCtrl = _mm_add_epi8(rmgr_fib_load_shuffle_control(tables::compress[k >> 8]), _mm_set1_epi8(8));
+    const __m128i v      = _mm_shuffle_epi8(a, _mm_unpacklo_epi64(rmgr_fib_load_shuffle_control(tables::compress[k & 0xFF]), hiCtrl));
+    const __m128i n      = _mm_set1_epi8(char(rmgr_fib_mask_popcnt(k & 0xFF)));
+    const __m128i hi     = _mm_shuffle_epi8(_mm_srli_si128(v, 8), _mm_sub_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), n));
+    return _mm_or_si128(_mm_move_epi64(v), hi);
+#else
+    return rmgr_fib_compress<1>(rmgr_fib_mm_movm_epi8(k), a);
+#endif
+}
+
+static inline __m128i rmgr_fib_mm_maskz_expand_epi8(__mmask16 k, const __m128i& a) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSSE3
+    // The high half starts after the lanes used by the low one
+    typedef rmgr_fib_compress_tables<0> tables;
+    const __m128i n      = _mm_set1_epi8(char(rmgr_fib_mask_popcnt(k & 0xFF)));
+    const __m128i hiCtrl = _mm_add_epi8(rmgr_fib_load_shuffle_control(tables::expand[k >> 8]), n);
+    return _mm_shuffle_epi8(a, _mm_unpacklo_epi64(rmgr_fib_load_shuffle_control(tables::expand[k & 0xFF]), hiCtrl));
+#else
+    return rmgr_fib_expand<1>(rmgr_fib_mm_movm_epi8(k), a);
+#endif
+}
+
+static inline __m128i rmgr_fib_mm_maskz_compress_epi16(__mmask8 k, const __m128i& a) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSSE3
+    const uint64_t& ctrl = rmgr_fib_compress_tables<0>::compress[k];
+    return _mm_shuffle_epi8(a, rmgr_fib_widen_shuffle_control(rmgr_fib_load_shuffle_control(ctrl)));
+#else
+    return rmgr_fib_compress<2>(rmgr_fib_mm_movm_epi16(k), a);
+#endif
+}
+
+static inline __m128i rmgr_fib_mm_maskz_expand_epi16(__mmask8 k, const __m128i& a) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSSE3
+    const uint64_t& ctrl = rmgr_fib_compress_tables<0>::expand[k];
+    return _mm_shuffle_epi8(a, rmgr_fib_widen_shuffle_control(rmgr_fib_load_shuffle_control(ctrl)));
+#else
+    return rmgr_fib_expand<2>(rmgr_fib_mm_movm_epi16(k), a);
+#endif
+}
+
+INTERNAL_RMGR_FIB_COMPRESS_OPS(epi8,  16, __mmask16)
+INTERNAL_RMGR_FIB_COMPRESS_OPS(epi16, 8,  __mmask8)
+
+// 32 & 64-bit
+#if !INTERNAL_RMGR_FIB_USE_AVX512VL
+    #define _mm_maskz_compress_epi32        rmgr_fib_mm_maskz_compress_epi32
+    #define _mm_mask_compress_epi32         rmgr_fib_mm_mask_compress_epi32
+    #define _mm_mask_compressstoreu_epi32   rmgr_fib_mm_mask_compressstoreu_epi32
+    #define _mm_maskz_expand_epi32          rmgr_fib_mm_maskz_expand_epi32
+    #define _mm_mask_expand_epi32           rmgr_fib_mm_mask_expand_epi32
+    #define _mm_maskz_compress_epi64        rmgr_fib_mm_maskz_compress_epi64
+    #define _mm_mask_compress_epi64         rmgr_fib_mm_mask_compress_epi64
+    #define _mm_mask_compressstoreu_epi64   rmgr_fib_mm_mask_compressstoreu_epi64
+    #define _mm_maskz_expand_epi64          rmgr_fib_mm_maskz_expand_epi64
+    #define _mm_mask_expand_epi64           rmgr_fib_mm_mask_expand_epi64
+
+    static inline __m128i rmgr_fib_mm_maskz_compress_epi32(__mmask8 k, const __m128i& a) RMGR_NOEXCEPT
+    {
+    #if INTERNAL_RMGR_FIB_USE_SSSE3
+        const uint64_t* ctrl = &rmgr_fib_compress_tables<0>::compress32[2 * (k & 0xF)];
+        return _mm_shuffle_epi8(a, _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)));
+    #else
+        return rmgr_fib_compress<4>(rmgr_fib_mm_movm_epi32(k), a);
+    #endif
+    }
+
+    static inline __m128i rmgr_fib_mm_maskz_expand_epi32(__mmask8 k, const __m128i& a) RMGR_NOEXCEPT
+    {
+    #if INTERNAL_RMGR_FIB_USE_SSSE3
+        const uint64_t* ctrl = &rmgr_fib_compress_tables<0>::expand32[2 * (k & 0xF)];
+        return _mm_shuffle_epi8(a, _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)));
+    #else
+        return rmgr_fib_expand<4>(rmgr_fib_mm_movm_epi32(k), a);
+    #endif
+    }
+
+    static inline __m128i rmgr_fib_mm_maskz_compress_epi64(__mmask8 k, const __m128i& a) RMGR_NOEXCEPT
+    {
+        // Only the high lane alone has to move
+        const __m128i v    = _mm_and_si128(rmgr_fib_mm_movm_epi64(k), a);
+        const __m128i move = _mm_set1_epi32(-int((k & 3) == 2));
+        return INTERNAL_RMGR_FIB_SELECT(move, _mm_srli_si128(v, 8), v);
+    }
+
+    static inline __m128i rmgr_fib_mm_maskz_expand_epi64(__mmask8 k, const __m128i& a) RMGR_NOEXCEPT
+    {
+        // Only the low lane alone has to move
+        const __m128i move = _mm_set1_epi32(-int((k & 3) == 2));
+        return _mm_and_si128(rmgr_fib_mm_movm_epi64(k), INTERNAL_RMGR_FIB_SELECT(move, _mm_unpacklo_epi64(a, a), a));
+    }
+
+    INTERNAL_RMGR_FIB_COMPRESS_OPS(epi32, 4, __mmask8)
+    INTERNAL_RMGR_FIB_COMPRESS_OPS(epi64, 2, __mmask8)
+#endif
 
+#undef INTERNAL_RMGR_FIB_COMPRESS_OPS
 
 RMGR_WARNING_POP()
 
@@ -0,0 +1,543 @@
+/*
+ * Copyright (c) 2022, Romain Bailly
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef RMGR_FIB_VEC_H
+#define RMGR_FIB_VEC_H
+
+
+/*
+ * `rmgr::fib::vec<T, N>` is a thin typed wrapper around a SIMD register: the lane type picks the
+ * right `_epi`/`_epu` intrinsic at compile time, so that a signed comparison can no longer be used
+ * on unsigned data by mistake. Every operator forwards to a single intrinsic of `sse.h` or `avx.h`
+ * (native or emulated) and is force-inlined, hence the generated code is the same as with the raw
+ * intrinsics.
+ *
+ * Supported lane types are `int8_t` to `uint64_t`, `float` and `double`, with `N` such that the
+ * vector is 128-bit wide, or 256-bit wide when AVX2 is enabled (AVX for `float` and `double`).
+ *
+ * Comparisons return a `vec_mask<T, N>`, which has all the bits of a lane set where the comparison
+ * holds and can be combined with `&`, `|`, `^`, `~` and fed to `select()`.
+ *
+ * Example:
+ *
+ *     typedef rmgr::fib::vec<uint8_t, 16> u8x16;
+ *     u8x16 a = u8x16::loadu(src);
+ *     u8x16 b = select(a > u8x16(200), u8x16(200), a); // Unsigned comparison, no _epu8 to remember
+ *
+ * The classes live in `RMGR_FIB_IS_NAMESPACE` (made visible in `rmgr::fib`), so that translation
+ * units compiled for different instruction sets never get their definitions mixed up by the linker.
+ */
+
+
+#include "avx.h"
+#include "dispatch.h"
+#include <type_traits>
+
+
+namespace rmgr { namespace fib {
+
+namespace RMGR_FIB_IS_NAMESPACE {
+
+namespace internal {
+
+//=================================================================================================
+// Lane traits
+
+/**
+ * @brief Maps the operations of a vector type onto intrinsics
+ *
+ * Only specialized for the supported vector types, any other one fails to compile.
+ */
+template<typename T, unsigned N>
+struct vec_traits;
+
+
+/**
+ * @brief Declares the traits of an integer vector type
+ *
+ * @param T    The lane type
+ * @param N    The number of lanes
+ * @param Reg  The register type
+ * @param mm   The intrinsics prefix (`_mm` or `_mm256`)
+ * @param si   The suffix of the whole-register intrinsics (`si128` or `si256`)
+ * @param epi  The suffix of the signedness-agnostic intrinsics (`epi8`...)
+ * @param set  The suffix of the broadcast intrinsic (`epi8`...`epi64x`)
+ * @param ep   The suffix of the signedness-aware intrinsics (`epi8` or `epu8`...)
+ * @param sr   The right shift matching the signedness (`sra` or `srl`)
+ * @param absf The absolute value function
+ * @param ones The `movemask` of a mask whose lanes are all set
+ */
+#define INTERNAL_RMGR_FIB_VEC_INT_TRAITS(T, N, Reg, mm, si, epi, set, ep, sr, absf, ones)                                                         \
+    template<>                                                                                                                                    \
+    struct vec_traits<T, N>                                                                                                                       \
+    {                                                                                                                                             \
+        typedef Reg register_type;                                                                                                                \
+        static RMGR_FORCEINLINE Reg zero()                            RMGR_NOEXCEPT { return mm##_setzero_##si(); }                               \
+        static RMGR_FORCEINLINE Reg set1(T s)                         RMGR_NOEXCEPT { return mm##_set1_##set(s); }                                \
+        static RMGR_FORCEINLINE Reg load(const T* p)                  RMGR_NOEXCEPT { return mm##_load_##si(reinterpret_cast<const Reg*>(p)); }   \
+        static RMGR_FORCEINLINE Reg loadu(const T* p)                 RMGR_NOEXCEPT { return mm##_loadu_##si(reinterpret_cast<const Reg*>(p)); }  \
+        static RMGR_FORCEINLINE void store(T* p, const Reg& a)        RMGR_NOEXCEPT { mm##_store_##si(reinterpret_cast<Reg*>(p), a); }            \
+        static RMGR_FORCEINLINE void storeu(T* p, const Reg& a)       RMGR_NOEXCEPT { mm##_storeu_##si(reinterpret_cast<Reg*>(p), a); }           \
+        static RMGR_FORCEINLINE Reg add(const Reg& a, const Reg& b)   RMGR_NOEXCEPT { return mm##_add_##epi(a, b); }                              \
+        static RMGR_FORCEINLINE Reg sub(const Reg& a, const Reg& b)   RMGR_NOEXCEPT { return mm##_sub_##epi(a, b); }                              \
+        static RMGR_FORCEINLINE Reg neg(const Reg& a)                 RMGR_NOEXCEPT { return mm##_neg_##epi(a); }                                 \
+        static RMGR_FORCEINLINE Reg bit_and(const Reg& a, const Reg& b) RMGR_NOEXCEPT { return mm##_and_##si(a, b); }                             \
+        static RMGR_FORCEINLINE Reg bit_or(const Reg& a, const Reg& b)  RMGR_NOEXCEPT { return mm##_or_##si(a, b); }                              \
+        static RMGR_FORCEINLINE Reg bit_xor(const Reg& a, const Reg& b) RMGR_NOEXCEPT { return mm##_xor_##si(a, b); }                             \
+        static RMGR_FORCEINLINE Reg bit_not(const Reg& a)             RMGR_NOEXCEPT { return mm##_not_##si(a); }                                  \
+        static RMGR_FORCEINLINE Reg shl(const Reg& a, int n)          RMGR_NOEXCEPT { return mm##_sll_##epi(a, _mm_cvtsi32_si128(n)); }           \
+        static RMGR_FORCEINLINE Reg shr(const Reg& a, int n)          RMGR_NOEXCEPT { return mm##_##sr##_##epi(a, _mm_cvtsi32_si128(n)); }        \
+        static RMGR_FORCEINLINE Reg shlv(const Reg& a, const Reg& n)  RMGR_NOEXCEPT { return mm##_sllv_##epi(a, n); }                             \
+        static RMGR_FORCEINLINE Reg shrv(const Reg& a, const Reg& n)  RMGR_NOEXCEPT { return mm##_##sr##v_##epi(a, n); }                          \
+        static RMGR_FORCEINLINE Reg cmpeq(const Reg& a, const Reg& b) RMGR_NOEXCEPT { return mm##_cmpeq_##ep(a, b); }                             \
+        static RMGR_FORCEINLINE Reg cmpneq(const Reg& a, const Reg& b) RMGR_NOEXCEPT { return mm##_cmpneq_##ep(a, b); }                           \
+        static RMGR_FORCEINLINE Reg cmplt(const Reg& a, const Reg& b) RMGR_NOEXCEPT { return mm##_cmplt_##ep(a, b); }                             \
+        static RMGR_FORCEINLINE Reg cmple(const Reg& a, const Reg& b) RMGR_NOEXCEPT { return mm##_cmple_##ep(a, b); }                             \
+        static RMGR_FORCEINLINE Reg cmpgt(const Reg& a, const Reg& b) RMGR_NOEXCEPT { return mm##_cmpgt_##ep(a, b); }                             \
+        static RMGR_FORCEINLINE Reg cmpge(const Reg& a, const Reg& b) RMGR_NOEXCEPT { return mm##_cmpge_##ep(a, b); }                             \
+        static RMGR_FORCEINLINE Reg min(const Reg& a, const Reg& b)   RMGR_NOEXCEPT { return mm##_min_##ep(a, b); }                               \
+        static RMGR_FORCEINLINE Reg max(const Reg& a, const Reg& b)   RMGR_NOEXCEPT { return mm##_max_##ep(a, b); }                               \
+        static RMGR_FORCEINLINE Reg abs(const Reg& a)                 RMGR_NOEXCEPT { return absf(a); }                                           \
+        static RMGR_FORCEINLINE bool any(const Reg& m)                RMGR_NOEXCEPT { return mm##_movemask_epi8(m) != 0; }                        \
+        static RMGR_FORCEINLINE bool all(const Reg& m)                RMGR_NOEXCEPT { return mm##_movemask_epi8(m) == ones; }                     \
+    };
+
+/// The absolute value of unsigned lanes
+template<typename Reg>
+static RMGR_FORCEINLINE Reg identity(const Reg& a) RMGR_NOEXCEPT
+{
+    return a;
+}
+
+INTERNAL_RMGR_FIB_VEC_INT_TRAITS(int8_t,   16, __m128i, _mm, si128, epi8,  epi8,   epi8,  sra, _mm_abs_epi8,  0xFFFF)
+INTERNAL_RMGR_FIB_VEC_INT_TRAITS(uint8_t,  16, __m128i, _mm, si128, epi8,  epi8,   epu8,  srl, identity,      0xFFFF)
+INTERNAL_RMGR_FIB_VEC_INT_TRAITS(int16_t,   8, __m128i, _mm, si128, epi16, epi16,  epi16, sra, _mm_abs_epi16, 0xFFFF)
+INTERNAL_RMGR_FIB_VEC_INT_TRAITS(uint16_t,  8, __m128i, _mm, si128, epi16, epi16,  epu16, srl, identity,      0xFFFF)
+INTERNAL_RMGR_FIB_VEC_INT_TRAITS(int32_t,   4, __m128i, _mm, si128, epi32, epi32,  epi32, sra, _mm_abs_epi32, 0xFFFF)
+INTERNAL_RMGR_FIB_VEC_INT_TRAITS(uint32_t,  4, __m128i, _mm, si128, epi32, epi32,  epu32, srl, identity,      0xFFFF)
+INTERNAL_RMGR_FIB_VEC_INT_TRAITS(int64_t,   2, __m128i, _mm, si128, epi64, epi64x, epi64, sra, _mm_abs_epi64, 0xFFFF)
+INTERNAL_RMGR_FIB_VEC_INT_TRAITS(uint64_t,  2, __m128i, _mm, si128, epi64, epi64x, epu64, srl, identity,      0xFFFF)
+
+#if INTERNAL_RMGR_FIB_USE_AVX2
+INTERNAL_RMGR_FIB_VEC_INT_TRAITS(int8_t,   32, __m256i, _mm256, si256, epi8,  epi8,   epi8,  sra, _mm256_abs_epi8,  -1)
+INTERNAL_RMGR_FIB_VEC_INT_TRAITS(uint8_t,  32, __m256i, _mm256, si256, epi8,  epi8,   epu8,  srl, identity,         -1)
+INTERNAL_RMGR_FIB_VEC_INT_TRAITS(int16_t,  16, __m256i, _mm256, si256, epi16, epi16,  epi16, sra, _mm256_abs_epi16, -1)
+INTERNAL_RMGR_FIB_VEC_INT_TRAITS(uint16_t, 16, __m256i, _mm256, si256, epi16, epi16,  epu16, srl, identity,         -1)
+INTERNAL_RMGR_FIB_VEC_INT_TRAITS(int32_t,   8, __m256i, _mm256, si256, epi32, epi32,  epi32, sra, _mm256_abs_epi32, -1)
+INTERNAL_RMGR_FIB_VEC_INT_TRAITS(uint32_t,  8, __m256i, _mm256, si256, epi32, epi32,  epu32, srl, identity,         -1)
+INTERNAL_RMGR_FIB_VEC_INT_TRAITS(int64_t,   4, __m256i, _mm256, si256, epi64, epi64x, epi64, sra, _mm256_abs_epi64, -1)
+INTERNAL_RMGR_FIB_VEC_INT_TRAITS(uint64_t,  4, __m256i, _mm256, si256, epi64, epi64x, epu64, srl, identity,         -1)
+#endif
+
+#undef INTERNAL_RMGR_FIB_VEC_INT_TRAITS
+
+
+/**
+ * @brief Declares the traits of a floating-point vector type
+ *
+ * @param T    The lane type
+ * @param N    The number of lanes
+ * @param Reg  The register type
+ * @param mm   The intrinsics prefix (`_mm` or `_mm256`)
+ * @param ps   The suffix of the intrinsics (`ps` or `pd`)
+ * @param ones The `movemask` of a mask whose lanes are all set
+ */
+#define INTERNAL_RMGR_FIB_VEC_FP_TRAITS(T, N, Reg, mm, ps, ones)                                                                                        \
+    template<>                                                                                                                                          \
+    struct vec_traits<T, N>                                                                                                                             \
+    {                                                                                                                                                   \
+        typedef Reg register_type;                                                                                                                      \
+        static RMGR_FORCEINLINE Reg zero()                            RMGR_NOEXCEPT { return mm##_setzero_##ps(); }                                     \
+        static RMGR_FORCEINLINE Reg set1(T s)                         RMGR_NOEXCEPT { return mm##_set1_##ps(s); }                                       \
+        static RMGR_FORCEINLINE Reg load(const T* p)                  RMGR_NOEXCEPT { return mm##_load_##ps(p); }                                       \
+        static RMGR_FORCEINLINE Reg loadu(const T* p)                 RMGR_NOEXCEPT { return mm##_loadu_##ps(p); }                                      \
+        static RMGR_FORCEINLINE void store(T* p, const Reg& a)        RMGR_NOEXCEPT { mm##_store_##ps(p, a); }                                          \
+        static RMGR_FORCEINLINE void storeu(T* p, const Reg& a)       RMGR_NOEXCEPT { mm##_storeu_##ps(p, a); }                                         \
+        static RMGR_FORCEINLINE Reg add(const Reg& a, const Reg& b)   RMGR_NOEXCEPT { return mm##_add_##ps(a, b); }                                     \
+        static RMGR_FORCEINLINE Reg sub(const Reg& a, const Reg& b)   RMGR_NOEXCEPT { return mm##_sub_##ps(a, b); }                                     \
+        static RMGR_FORCEINLINE Reg mul(const Reg& a, const Reg& b)   RMGR_NOEXCEPT { return mm##_mul_##ps(a, b); }                                     \
+        static RMGR_FORCEINLINE Reg div(const Reg& a, const Reg& b)   RMGR_NOEXCEPT { return mm##_div_##ps(a, b); }                                     \
+        static RMGR_FORCEINLINE Reg neg(const Reg& a)                 RMGR_NOEXCEPT { return mm##_neg_##ps(a); }                                        \
+        static RMGR_FORCEINLINE Reg bit_and(const Reg& a, const Reg& b) RMGR_NOEXCEPT { return mm##_and_##ps(a, b); }                                   \
+        static RMGR_FORCEINLINE Reg bit_or(const Reg& a, const Reg& b)  RMGR_NOEXCEPT { return mm##_or_##ps(a, b); }                                    \
+        static RMGR_FORCEINLINE Reg bit_xor(const Reg& a, const Reg& b) RMGR_NOEXCEPT { return mm##_xor_##ps(a, b); }                                   \
+        static RMGR_FORCEINLINE Reg bit_not(const Reg& a)             RMGR_NOEXCEPT { return mm##_xor_##ps(a, cmpeq(zero(), zero())); }                 \
+        static RMGR_FORCEINLINE Reg cmpeq(const Reg& a, const Reg& b) RMGR_NOEXCEPT { return INTERNAL_RMGR_FIB_VEC_CMP_##mm(ps, eq,  EQ_OQ,  a, b); }   \
+        static RMGR_FORCEINLINE Reg cmpneq(const Reg& a, const Reg& b) RMGR_NOEXCEPT { return INTERNAL_RMGR_FIB_VEC_CMP_##mm(ps, neq, NEQ_UQ, a, b); }  \
+        static RMGR_FORCEINLINE Reg cmplt(const Reg& a, const Reg& b) RMGR_NOEXCEPT { return INTERNAL_RMGR_FIB_VEC_CMP_##mm(ps, lt,  LT_OQ,  a, b); }   \
+        static RMGR_FORCEINLINE Reg cmple(const Reg& a, const Reg& b) RMGR_NOEXCEPT { return INTERNAL_RMGR_FIB_VEC_CMP_##mm(ps, le,  LE_OQ,  a, b); }   \
+        static RMGR_FORCEINLINE Reg cmpgt(const Reg& a, const Reg& b) RMGR_NOEXCEPT { return INTERNAL_RMGR_FIB_VEC_CMP_##mm(ps, gt,  GT_OQ,  a, b); }   \
+        static RMGR_FORCEINLINE Reg cmpge(const Reg& a, const Reg& b) RMGR_NOEXCEPT { return INTERNAL_RMGR_FIB_VEC_CMP_##mm(ps, ge,  GE_OQ,  a, b); }   \
+        static RMGR_FORCEINLINE Reg min(const Reg& a, const Reg& b)   RMGR_NOEXCEPT { return mm##_min_##ps(a, b); }                                     \
+        static RMGR_FORCEINLINE Reg max(const Reg& a, const Reg& b)   RMGR_NOEXCEPT { return mm##_max_##ps(a, b); }                                     \
+        static RMGR_FORCEINLINE Reg abs(const Reg& a)                 RMGR_NOEXCEPT { return mm##_abs_##ps(a); }                                        \
+        static RMGR_FORCEINLINE bool any(const Reg& m)                RMGR_NOEXCEPT { return mm##_movemask_##ps(m) != 0; }                              \
+        static RMGR_FORCEINLINE bool all(const Reg& m)                RMGR_NOEXCEPT { return mm##_movemask_##ps(m) == ones; }                           \
+    };
+
+// The 128-bit comparisons have named intrinsics, the 256-bit ones only exist as predicates
+#define INTERNAL_RMGR_FIB_VEC_CMP__mm(ps, op, predicate, a, b)     _mm_cmp##op##_##ps(a, b)
+#define INTERNAL_RMGR_FIB_VEC_CMP__mm256(ps, op, predicate, a, b)  _mm256_cmp_##ps(a, b, _CMP_##predicate)
+
+INTERNAL_RMGR_FIB_VEC_FP_TRAITS(float,  4, __m128,  _mm, ps, 0x0F)
+INTERNAL_RMGR_FIB_VEC_FP_TRAITS(double, 2, __m128d, _mm, pd, 0x03)
+
+#if INTERNAL_RMGR_FIB_USE_AVX
+INTERNAL_RMGR_FIB_VEC_FP_TRAITS(float,  8, __m256,  _mm256, ps, 0xFF)
+INTERNAL_RMGR_FIB_VEC_FP_TRAITS(double, 4, __m256d, _mm256, pd, 0x0F)
+#endif
+
+#undef INTERNAL_RMGR_FIB_VEC_FP_TRAITS
+#undef INTERNAL_RMGR_FIB_VEC_CMP__mm
+#undef INTERNAL_RMGR_FIB_VEC_CMP__mm256
+
+
+//=================================================================================================
+// Selection
+
+static RMGR_FORCEINLINE __m128i select(const __m128i& mask, const __m128i& a, const __m128i& b) RMGR_NOEXCEPT
+{
+    return INTERNAL_RMGR_FIB_SELECT(mask, a, b);
+}
+
+static RMGR_FORCEINLINE __m128 select(const __m128& mask, const __m128& a, const __m128& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    return _mm_blendv_ps(b, a, mask);
+#else
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+#endif
+}
+
+static RMGR_FORCEINLINE __m128d select(const __m128d& mask, const __m128d& a, const __m128d& b) RMGR_NOEXCEPT
+{
+#if INTERNAL_RMGR_FIB_USE_SSE41
+    return _mm_blendv_pd(b, a, mask);
+#else
+    return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+#endif
+}
+
+#if INTERNAL_RMGR_FIB_USE_AVX
+static RMGR_FORCEINLINE __m256 select(const __m256& mask, const __m256& a, const __m256& b) RMGR_NOEXCEPT
+{
+    return _mm256_blendv_ps(b, a, mask);
+}
+
+static RMGR_FORCEINLINE __m256d select(const __m256d& mask, const __m256d& a, const __m256d& b) RMGR_NOEXCEPT
+{
+    return _mm256_blendv_pd(b, a, mask);
+}
+#endif
+
+#if INTERNAL_RMGR_FIB_USE_AVX2
+static RMGR_FORCEINLINE __m256i select(const __m256i& mask, const __m256i& a, const __m256i& b) RMGR_NOEXCEPT
+{
+    return INTERNAL_RMGR_FIB_SELECT256(mask, a, b);
+}
+#endif
+
+} // namespace internal
+
+
+//=================================================================================================
+// Masks
+
+/**
+ * @brief The result of a comparison of `vec<T, N>`
+ *
+ * Each lane has either all its bits set (true) or none (false).
+ */
+template<typename T, unsigned N>
+class vec_mask
+{
+public:
+
+    typedef internal::vec_traits<T, N>       traits;
+    typedef typename traits::register_type register_type;
+
+    /// Leaves the lanes uninitialized
+    RMGR_FORCEINLINE vec_mask() RMGR_NOEXCEPT {}
+
+    /// Wraps a register, which must have either all or none of the bits of each lane set
+    explicit RMGR_FORCEINLINE vec_mask(const register_type& r) RMGR_NOEXCEPT : m_reg(r) {}
+
+    RMGR_FORCEINLINE const register_type& native() const RMGR_NOEXCEPT { return m_reg; }
+
+    /// Whether at least one lane is set
+    RMGR_FORCEINLINE bool any() const RMGR_NOEXCEPT { return traits::any(m_reg); }
+
+    /// Whether all lanes are set
+    RMGR_FORCEINLINE bool all() const RMGR_NOEXCEPT { return traits::all(m_reg); }
+
+    /// Whether no lane is set
+    RMGR_FORCEINLINE bool none() const RMGR_NOEXCEPT { return !traits::any(m_reg); }
+
+    friend RMGR_FORCEINLINE vec_mask operator&(const vec_mask& a, const vec_mask& b) RMGR_NOEXCEPT { return vec_mask(traits::bit_and(a.m_reg, b.m_reg)); }
+    friend RMGR_FORCEINLINE vec_mask operator|(const vec_mask& a, const vec_mask& b) RMGR_NOEXCEPT { return vec_mask(traits::bit_or( a.m_reg, b.m_reg)); }
+    friend RMGR_FORCEINLINE vec_mask operator^(const vec_mask& a, const vec_mask& b) RMGR_NOEXCEPT { return vec_mask(traits::bit_xor(a.m_reg, b.m_reg)); }
+    friend RMGR_FORCEINLINE vec_mask operator~(const vec_mask& a)                    RMGR_NOEXCEPT { return vec_mask(traits::bit_not(a.m_reg)); }
+
+private:
+
+    register_type m_reg;
+};
+
+
+//=================================================================================================
+// Vectors
+
+/**
+ * @brief A vector of `N` lanes of type `T`
+ *
+ * Converts implicitly to and from the underlying register type, so that it can be mixed with raw
+ * intrinsics. Arithmetic wraps around, like the intrinsics do.
+ */
+template<typename T, unsigned N>
+class vec
+{
+public:
+
+    typedef T                                value_type;
+    typedef vec_mask<T, N>                   mask_type;
+    typedef internal::vec_traits<T, N>       traits;
+    typedef typename traits::register_type register_type;
+
+    static const unsigned SIZE = N;
+
+    /// Leaves the lanes uninitialized
+    RMGR_FORCEINLINE vec() RMGR_NOEXCEPT {}
+
+    RMGR_FORCEINLINE vec(const register_type& r) RMGR_NOEXCEPT : m_reg(r) {}
+
+    /// Sets all lanes to the same value
+    explicit RMGR_FORCEINLINE vec(T s) RMGR_NOEXCEPT : m_reg(traits::set1(s)) {}
+
+    static RMGR_FORCEINLINE vec zero()           RMGR_NOEXCEPT { return vec(traits::zero()); }
+    static RMGR_FORCEINLINE vec load(const T* p)  RMGR_NOEXCEPT { return vec(traits::load(p)); }  ///< `p` must be aligned on the vector size
+    static RMGR_FORCEINLINE vec loadu(const T* p) RMGR_NOEXCEPT { return vec(traits::loadu(p)); }
+
+    RMGR_FORCEINLINE void store(T* p)  const RMGR_NOEXCEPT { traits::store(p, m_reg); }  ///< `p` must be aligned on the vector size
+    RMGR_FORCEINLINE void storeu(T* p) const RMGR_NOEXCEPT { traits::storeu(p, m_reg); }
+
+    RMGR_FORCEINLINE const register_type& native() const RMGR_NOEXCEPT { return m_reg; }
+    RMGR_FORCEINLINE operator const register_type&() const RMGR_NOEXCEPT { return m_reg; }
+
+    friend RMGR_FORCEINLINE vec operator+(const vec& a, const vec& b) RMGR_NOEXCEPT { return vec(traits::add(a.m_reg, b.m_reg)); }
+    friend RMGR_FORCEINLINE vec operator-(const vec& a, const vec& b) RMGR_NOEXCEPT { return vec(traits::sub(a.m_reg, b.m_reg)); }
+    friend RMGR_FORCEINLINE vec operator-(const vec& a)               RMGR_NOEXCEPT { return vec(traits::neg(a.m_reg)); }
+    friend RMGR_FORCEINLINE vec operator&(const vec& a, const vec& b) RMGR_NOEXCEPT { return vec(traits::bit_and(a.m_reg, b.m_reg)); }
+    friend RMGR_FORCEINLINE vec operator|(const vec& a, const vec& b) RMGR_NOEXCEPT { return vec(traits::bit_or( a.m_reg, b.m_reg)); }
+    friend RMGR_FORCEINLINE vec operator^(const vec& a, const vec& b) RMGR_NOEXCEPT { return vec(traits::bit_xor(a.m_reg, b.m_reg)); }
+    friend RMGR_FORCEINLINE vec operator~(const vec& a)               RMGR_NOEXCEPT { return vec(traits::bit_not(a.m_reg)); }
+
+    /// Floating-point vectors only
+    friend RMGR_FORCEINLINE vec operator*(const vec& a, const vec& b) RMGR_NOEXCEPT { return vec(traits::mul(a.m_reg, b.m_reg)); }
+    friend RMGR_FORCEINLINE vec operator/(const vec& a, const vec& b) RMGR_NOEXCEPT { return vec(traits::div(a.m_reg, b.m_reg)); }
+
+    /// Integer vectors only. Arithmetic for signed lanes, logical for unsigned ones
+    friend RMGR_FORCEINLINE vec operator<<(const vec& a, int n)       RMGR_NOEXCEPT { return vec(traits::shl(a.m_reg, n)); }
+    friend RMGR_FORCEINLINE vec operator>>(const vec& a, int n)       RMGR_NOEXCEPT { return vec(traits::shr(a.m_reg, n)); }
+    friend RMGR_FORCEINLINE vec operator<<(const vec& a, const vec& n) RMGR_NOEXCEPT { return vec(traits::shlv(a.m_reg, n.m_reg)); }
+    friend RMGR_FORCEINLINE vec operator>>(const vec& a, const vec& n) RMGR_NOEXCEPT { return vec(traits::shrv(a.m_reg, n.m_reg)); }
+
+    friend RMGR_FORCEINLINE mask_type operator==(const vec& a, const vec& b) RMGR_NOEXCEPT { return mask_type(traits::cmpeq( a.m_reg, b.m_reg)); }
+    friend RMGR_FORCEINLINE mask_type operator!=(const vec& a, const vec& b) RMGR_NOEXCEPT { return mask_type(traits::cmpneq(a.m_reg, b.m_reg)); }
+    friend RMGR_FORCEINLINE mask_type operator< (const vec& a, const vec& b) RMGR_NOEXCEPT { return mask_type(traits::cmplt( a.m_reg, b.m_reg)); }
+    friend RMGR_FORCEINLINE mask_type operator<=(const vec& a, const vec& b) RMGR_NOEXCEPT { return mask_type(traits::cmple( a.m_reg, b.m_reg)); }
+    friend RMGR_FORCEINLINE mask_type operator> (const vec& a, const vec& b) RMGR_NOEXCEPT { return mask_type(traits::cmpgt( a.m_reg, b.m_reg)); }
+    friend RMGR_FORCEINLINE mask_type operator>=(const vec& a, const vec& b) RMGR_NOEXCEPT { return mask_type(traits::cmpge( a.m_reg, b.m_reg)); }
+
+    RMGR_FORCEINLINE vec& operator+=(const vec& b) RMGR_NOEXCEPT { return *this = *this + b; }
+    RMGR_FORCEINLINE vec& operator-=(const vec& b) RMGR_NOEXCEPT { return *this = *this - b; }
+    RMGR_FORCEINLINE vec& operator*=(const vec& b) RMGR_NOEXCEPT { return *this = *this * b; }
+    RMGR_FORCEINLINE vec& operator/=(const vec& b) RMGR_NOEXCEPT { return *this = *this / b; }
+    RMGR_FORCEINLINE vec& operator&=(const vec& b) RMGR_NOEXCEPT { return *this = *this & b; }
+    RMGR_FORCEINLINE vec& operator|=(const vec& b) RMGR_NOEXCEPT { return *this = *this | b; }
+    RMGR_FORCEINLINE vec& operator^=(const vec& b) RMGR_NOEXCEPT { return *this = *this ^ b; }
+    RMGR_FORCEINLINE vec& operator<<=(int n)       RMGR_NOEXCEPT { return *this = *this << n; }
+    RMGR_FORCEINLINE vec& operator>>=(int n)       RMGR_NOEXCEPT { return *this = *this >> n; }
+
+    friend RMGR_FORCEINLINE vec min(const vec& a, const vec& b) RMGR_NOEXCEPT { return vec(traits::min(a.m_reg, b.m_reg)); }
+    friend RMGR_FORCEINLINE vec max(const vec& a, const vec& b) RMGR_NOEXCEPT { return vec(traits::max(a.m_reg, b.m_reg)); }
+
+    /// Identity for unsigned lanes. For signed ones, the absolute value of the minimum is itself
+    friend RMGR_FORCEINLINE vec abs(const vec& a) RMGR_NOEXCEPT { return vec(traits::abs(a.m_reg)); }
+
+    /// Picks the lanes of `a` where `mask` is set and those of `b` elsewhere
+    friend RMGR_FORCEINLINE vec select(const mask_type& mask, const vec& a, const vec& b) RMGR_NOEXCEPT
+    {
+        return vec(internal::select(mask.native(), a.m_reg, b.m_reg));
+    }
+
+private:
+
+    register_type m_reg;
+};
+
+//=================================================================================================
+// Division by an invariant divisor
+
+namespace internal {
+
+/// High half of the lane-wise product
+static RMGR_FORCEINLINE vec<uint16_t, 8> mulhi(const vec<uint16_t, 8>& a, const vec<uint16_t, 8>& b) RMGR_NOEXCEPT { return _mm_mulhi_epu16(a, b); }
+static RMGR_FORCEINLINE vec<int16_t,  8> mulhi(const vec<int16_t,  8>& a, const vec<int16_t,  8>& b) RMGR_NOEXCEPT { return _mm_mulhi_epi16(a, b); }
+static RMGR_FORCEINLINE vec<uint32_t, 4> mulhi(const vec<uint32_t, 4>& a, const vec<uint32_t, 4>& b) RMGR_NOEXCEPT { return _mm_mulhi_epu32(a, b); }
+static RMGR_FORCEINLINE vec<int32_t,  4> mulhi(const vec<int32_t,  4>& a, const vec<int32_t,  4>& b) RMGR_NOEXCEPT { return _mm_mulhi_epi32(a, b); }
+static RMGR_FORCEINLINE vec<uint64_t, 2> mulhi(const vec<uint64_t, 2>& a, const vec<uint64_t, 2>& b) RMGR_NOEXCEPT { return _mm_mulhi_epu64(a, b); }
+static RMGR_FORCEINLINE vec<int64_t,  2> mulhi(const vec<int64_t,  2>& a, const vec<int64_t,  2>& b) RMGR_NOEXCEPT { return _mm_mulhi_epi64(a, b); }
+
+/// Low half of the lane-wise product, which is the same for signed and unsigned lanes
+static RMGR_FORCEINLINE __m128i mullo(const __m128i& a, const __m128i& b, uint16_t) RMGR_NOEXCEPT { return _mm_mullo_epi16(a, b); }
+static RMGR_FORCEINLINE __m128i mullo(const __m128i& a, const __m128i& b, uint32_t) RMGR_NOEXCEPT { return _mm_mullo_epi32(a, b); }
+static RMGR_FORCEINLINE __m128i mullo(const __m128i& a, const __m128i& b, uint64_t) RMGR_NOEXCEPT { return _mm_mullo_epi64(a, b); }
+
+/// Number of bits needed to represent `x - 1`, i.e. ceil(log2(x))
+template<typename U>
+static unsigned ceil_log2(U x) RMGR_NOEXCEPT
+{
+    const unsigned bits = 8 * sizeof(U);
+    unsigned l = 0;
+    while (l < bits && U(U(1) << l) < x)
+        ++l;
+    return l;
+}
+
+/// floor((hi * 2^bits + lo) / d), which must fit in a `U`, i.e. `hi < d`
+template<typename U>
+static U div_wide(U hi, U lo, U d) RMGR_NOEXCEPT
+{
+    const unsigned bits = 8 * sizeof(U);
+    for (unsigned i=0; i<bits; ++i)
+    {
+        const bool carry = (hi >> (bits - 1)) != 0;
+        hi = U((hi << 1) | (lo >> (bits - 1)));
+        lo = U(lo << 1);
+        if (carry || hi >= d)
+        {
+            hi = U(hi - d);
+            lo = U(lo | 1);
+        }
+    }
+    return lo;
+}
+
+} // namespace internal
+
+
+/**
+ * @brief A divisor shared by all the lanes of a 128-bit `vec<T, N>`, for `T` of 16 to 64 bits
+ *
+ * Integer division has no SIMD instruction, but dividing by a divisor known in advance boils down to
+ * a multiplication by a "magic" number and shifts (see T. Granlund & P. L. Montgomery, "Division by
+ * Invariant Integers using Multiplication"). The magic numbers are computed once by the constructor,
+ * which makes it worth building the divisor outside of loops.
+ *
+ * Division truncates toward zero, like C++'s `/`, and the remainder has the sign of the dividend.
+ * The minimum signed value divided by -1 wraps around to itself, with a remainder of 0.
+ *
+ * Example:
+ *
+ *     typedef rmgr::fib::vec<uint32_t, 4> u32x4;
+ *     const rmgr::fib::divisor<uint32_t> shardCount(count);
+ *     for (size_t i=0; i<n; i+=4)
+ *         (u32x4::loadu(hashes + i) % shardCount).storeu(shards + i);
+ */
+template<typename T>
+class divisor
+{
+public:
+
+    typedef T                                         value_type;
+    typedef vec<T, 16 / sizeof(T)>                    vec_type;
+    typedef typename std::make_unsigned<T>::type      unsigned_type;
+
+    /// `d` must not be 0
+    explicit divisor(T d) RMGR_NOEXCEPT :
+        m_divisor(d)
+    {
+        typedef unsigned_type U;
+        const unsigned bits = 8 * sizeof(T);
+        if (std::is_signed<T>::value)
+        {
+            // m = 2^(bits+l-1) / |d| + 1 - 2^bits, the last term vanishing modulo 2^bits
+            const U        ad = (d < 0) ? U(0 - U(d)) : U(d);
+            const unsigned l  = (ad > 1) ? internal::ceil_log2(ad) : 1;
+            m_magic  = vec_type(T((ad == 1) ? U(1) : U(internal::div_wide(U(U(1) << (l - 1)), U(0), ad) + 1)));
+            m_shift1 = int(l - 1);
+            m_shift2 = 0;
+            m_sign   = vec_type(T((d < 0) ? -1 : 0));
+        }
+        else
+        {
+            // m = 2^bits * (2^l - d) / d + 1
+            const unsigned l = internal::ceil_log2(U(d));
+            m_magic  = vec_type(T(internal::div_wide(U((l < bits ? U(U(1) << l) : U(0)) - U(d)), U(0), U(d)) + 1));
+            m_shift1 = (l < 1) ? int(l) : 1;
+            m_shift2 = (l > 1) ? int(l - 1) : 0;
+            m_sign   = vec_type::zero();
+        }
+    }
+
+    RMGR_FORCEINLINE T value() const RMGR_NOEXCEPT { return m_divisor; }
+
+    /// The quotients of the lanes of `n`, truncated toward zero
+    RMGR_FORCEINLINE vec_type div(const vec_type& n) const RMGR_NOEXCEPT
+    {
+        if (std::is_signed<T>::value)
+        {
+            const vec_type q = (n + internal::mulhi(n, m_magic)) >> m_shift1;
+            const vec_type r = q - (n >> int(8*sizeof(T) - 1)); // +1 for negative dividends
+            return (r ^ m_sign) - m_sign;
+        }
+        else
+        {
+            const vec_type q = internal::mulhi(n, m_magic);
+            return (q + ((n - q) >> m_shift1)) >> m_shift2;
+        }
+    }
+
+    /// The remainders of the lanes of `n`
+    RMGR_FORCEINLINE vec_type mod(const vec_type& n) const RMGR_NOEXCEPT
+    {
+        return n - vec_type(internal::mullo(div(n), vec_type(m_divisor), unsigned_type()));
+    }
+
+    friend RMGR_FORCEINLINE vec_type operator/(const vec_type& n, const divisor& d) RMGR_NOEXCEPT { return d.div(n); }
+    friend RMGR_FORCEINLINE vec_type operator%(const vec_type& n, const divisor& d) RMGR_NOEXCEPT { return d.mod(n); }
+
+private:
+
+    vec_type m_magic;
+    vec_type m_sign;   ///< All ones for negative divisors
+    int      m_shift1;
+    int      m_shift2;
+    T        m_divisor;
+};
+
+} // namespace RMGR_FIB_IS_NAMESPACE
+
+using namespace RMGR_FIB_IS_NAMESPACE;
+
+}} // namespace rmgr::fib
+
+
+#endif // RMGR_FIB_VEC_H
@@ -0,0 +1,90 @@
+#include <rmgr/fib/algorithm.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+
+TEST(IS, popcount)
+{
+    // Every size up to a few blocks of 31 vectors, at every alignment, so that all loops and tails get exercised
+    std::vector<uint8_t> buffer(3 * 31 * 32 + 64 + 16);
+    uint64_t seed = 0x0123456789ABCDEFull;
+    for (size_t i=0; i<buffer.size(); ++i)
+    {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        buffer[i] = uint8_t(seed >> 56);
+    }
+    for (size_t offset=0; offset<16; ++offset)
+    {
+        uint64_t expected = 0;
+        for (size_t size=0; offset+size<=buffer.size(); ++size)
+        {
+            ASSERT_EQ(expected, rmgr::fib::popcount(&buffer[offset], size)) << "offset=" << offset << " size=" << size;
+            if (offset + size < buffer.size())
+                for (uint8_t byte = buffer[offset+size]; byte != 0; byte &= uint8_t(byte - 1))
+                    ++expected;
+        }
+    }
+
+    // All ones, which would overflow byte counters if they weren't flushed often enough
+    const std::vector<uint8_t> ones(100000, 0xFF);
+    ASSERT_EQ(uint64_t(800000), rmgr::fib::popcount(&ones[0], ones.size()));
+    ASSERT_EQ(uint64_t(0), rmgr::fib::popcount(NULL, 0));
+}
+
+
+
+/// Selects the lanes greater than a threshold
+template<typename T>
+struct greater_than
+{
+    typedef rmgr::fib::vec<T, 16 / sizeof(T)> vec_type;
+
+    explicit greater_than(T t) : threshold(t) {}
+    typename vec_type::mask_type operator()(const vec_type& v) const { return v > vec_type(threshold); }
+
+    T threshold;
+};
+
+
+/// Checks compress() against std::copy_if() for all sizes up to a few vectors, out of place and in place
+template<typename T>
+static RMGR_NOINLINE void assert_compress(T threshold)
+{
+    std::vector<T> src(67);
+    uint64_t seed = 0x0123456789ABCDEFull;
+    for (size_t i=0; i<src.size(); ++i)
+    {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        src[i] = T(seed >> 32);
+    }
+    for (size_t n=0; n<=src.size(); ++n)
+    {
+        std::vector<T> expected;
+        std::copy_if(src.begin(), src.begin() + n, std::back_inserter(expected), [threshold](T x) { return x > threshold; });
+
+        // Elements past n must be left untouched
+        std::vector<T> dst(src.size(), T(0x5A));
+        ASSERT_EQ(expected.size(), rmgr::fib::compress(&dst[0], &src[0], n, greater_than<T>(threshold))) << n;
+        ASSERT_TRUE(std::equal(expected.begin(), expected.end(), dst.begin())) << n;
+        ASSERT_TRUE(std::all_of(dst.begin() + n, dst.end(), [](T x) { return x == T(0x5A); })) << n;
+
+        std::vector<T> inPlace(src);
+        ASSERT_EQ(expected.size(), rmgr::fib::compress(&inPlace[0], &inPlace[0], n, greater_than<T>(threshold))) << n;
+        ASSERT_TRUE(std::equal(expected.begin(), expected.end(), inPlace.begin())) << n;
+    }
+}
+
+
+TEST(IS, compress)
+{
+    assert_compress<int8_t>(-20);
+    assert_compress<uint8_t>(100);
+    assert_compress<int16_t>(0);
+    assert_compress<uint16_t>(50000);
+    assert_compress<int32_t>(1000);
+    assert_compress<uint32_t>(0x80000000u);
+    assert_compress<int64_t>(-5);
+    assert_compress<uint64_t>(0);
+}
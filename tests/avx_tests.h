@@ -0,0 +1,493 @@
+#include <rmgr/fib/avx.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+
+
+#if INTERNAL_RMGR_FIB_USE_AVX
+
+TEST(IS, ps256_neg_abs)
+{
+    const __m256 a = _mm256_setr_ps(-FLT_MAX,-1,-0.0f,0,FLT_MIN,1,FLT_MAX,-FLT_MIN);
+    float bufA[8], bufNeg[8], bufAbs[8];
+    store(bufA,   a);
+    store(bufNeg, _mm256_neg_ps(a));
+    store(bufAbs, _mm256_abs_ps(a));
+    for (size_t i=0; i<8; ++i)
+    {
+        ASSERT_EQ(-bufA[i],          bufNeg[i]);
+        ASSERT_EQ(std::fabs(bufA[i]), bufAbs[i]);
+    }
+}
+
+
+TEST(IS, pd256_neg_abs)
+{
+    const __m256d a = _mm256_setr_pd(-DBL_MAX,-1,DBL_MIN,DBL_MAX);
+    double bufA[4], bufNeg[4], bufAbs[4];
+    store(bufA,   a);
+    store(bufNeg, _mm256_neg_pd(a));
+    store(bufAbs, _mm256_abs_pd(a));
+    for (size_t i=0; i<4; ++i)
+    {
+        ASSERT_EQ(-bufA[i],          bufNeg[i]);
+        ASSERT_EQ(std::fabs(bufA[i]), bufAbs[i]);
+    }
+}
+
+
+TEST(IS, epi64_256_set_extract)
+{
+    const __m256i a = _mm256_set_epi64x(INT64_MIN, -1, 1, INT64_MAX);
+    ASSERT_EQ(INT64_MAX, _mm256_extract_epi64(a,0));
+    ASSERT_EQ(1,         _mm256_extract_epi64(a,1));
+    ASSERT_EQ(-1,        _mm256_extract_epi64(a,2));
+    ASSERT_EQ(INT64_MIN, _mm256_extract_epi64(a,3));
+    ASSERT_EQ(-0x123456789ll, _mm256_extract_epi64(_mm256_set1_epi64x(-0x123456789ll), 3));
+
+    const __m256i b = _mm256_insert_epi64(_mm256_insert_epi64(a, -0x123456789ll, 2), 0x123456789ll, 1);
+    ASSERT_EQ(INT64_MAX,      _mm256_extract_epi64(b,0));
+    ASSERT_EQ(0x123456789ll,  _mm256_extract_epi64(b,1));
+    ASSERT_EQ(-0x123456789ll, _mm256_extract_epi64(b,2));
+    ASSERT_EQ(INT64_MIN,      _mm256_extract_epi64(b,3));
+}
+
+#endif // INTERNAL_RMGR_FIB_USE_AVX
+
+
+#if INTERNAL_RMGR_FIB_USE_AVX2
+
+TEST(IS, si256_not_neg)
+{
+    const __m256i a = _mm256_setr_epi64x(INT64_MIN, -1, 0x0123456789ABCDEFll, INT64_MAX);
+    int64_t bufA[4], bufNot[4];
+    store(bufA,   a);
+    store(bufNot, _mm256_not_si256(a));
+    for (size_t i=0; i<4; ++i)
+    {
+        ASSERT_EQ(~bufA[i], bufNot[i]);
+    }
+
+    int8_t  buf8[32],  bufNeg8[32];
+    int16_t buf16[16], bufNeg16[16];
+    int32_t buf32[8],  bufNeg32[8];
+    int64_t buf64[4],  bufNeg64[4];
+    store(buf8,  a); store(bufNeg8,  _mm256_neg_epi8(a));
+    store(buf16, a); store(bufNeg16, _mm256_neg_epi16(a));
+    store(buf32, a); store(bufNeg32, _mm256_neg_epi32(a));
+    store(buf64, a); store(bufNeg64, _mm256_neg_epi64(a));
+    for (size_t i=0; i<32; ++i)
+        ASSERT_EQ(int8_t(0u - uint8_t(buf8[i])), bufNeg8[i]);
+    for (size_t i=0; i<16; ++i)
+        ASSERT_EQ(int16_t(0u - uint16_t(buf16[i])), bufNeg16[i]);
+    for (size_t i=0; i<8; ++i)
+        ASSERT_EQ(int32_t(0u - uint32_t(buf32[i])), bufNeg32[i]);
+    for (size_t i=0; i<4; ++i)
+        ASSERT_EQ(int64_t(0u - uint64_t(buf64[i])), bufNeg64[i]);
+}
+
+
+namespace {
+
+/// Checks the 256-bit ternary logic for a given immediate
+struct TernaryLogicImmediates256
+{
+    template<int N>
+    static void run(const __m256i& a, const __m256i& b, const __m256i& c)
+    {
+        assert_ternarylogic(a, b, c, _mm256_ternarylogic_epi32(a, b, c, N), N);
+        assert_ternarylogic(a, b, c, _mm256_ternarylogic_epi64(a, b, c, N), N);
+    }
+};
+
+} // namespace
+
+
+TEST(IS, ternarylogic_256)
+{
+    const __m256i a = _mm256_setr_epi64x(INT64_MIN, -1, 0x0123456789ABCDEFll, 0);
+    const __m256i b = _mm256_setr_epi64x(0x7654321076543210ll, 0, -1, INT64_MAX);
+    const __m256i c = _mm256_setr_epi64x(0x5555555555555555ll, 0x0F0F0F0F0F0F0F0Fll, 0, -1);
+    ForEachImmediate<255>::run<TernaryLogicImmediates256>(a, b, c);
+}
+
+
+TEST(IS, epi8_256_comparisons)
+{
+    const __m256i a = _mm256_setr_epi8(-128,-128,-127,-127,-1,-1,0,0,1,1,2,2,126,126,127,127, 0,-1,-128,127,5,6,7,8,9,10,11,12,13,14,15,16);
+    const __m256i b = _mm256_setr_epi8(-128,-127,-128,-127,-2,-1,1,0,2,1,1,2,127,126,126,127, -1,0,127,-128,6,5,7,8,9,10,11,12,13,14,15,16);
+    assert_comparison<int8_t>(a, b, _mm256_cmpneq_epi8(a,b), COMP_NE);
+    assert_comparison<int8_t>(b, a, _mm256_cmpneq_epi8(b,a), COMP_NE);
+    assert_comparison<int8_t>(a, b, _mm256_cmplt_epi8(a,b),  COMP_LT);
+    assert_comparison<int8_t>(b, a, _mm256_cmplt_epi8(b,a),  COMP_LT);
+    assert_comparison<int8_t>(a, b, _mm256_cmple_epi8(a,b),  COMP_LE);
+    assert_comparison<int8_t>(b, a, _mm256_cmple_epi8(b,a),  COMP_LE);
+    assert_comparison<int8_t>(a, b, _mm256_cmpge_epi8(a,b),  COMP_GE);
+    assert_comparison<int8_t>(b, a, _mm256_cmpge_epi8(b,a),  COMP_GE);
+
+    assert_comparison<uint8_t>(a, b, _mm256_cmpeq_epu8(a,b),  COMP_EQ);
+    assert_comparison<uint8_t>(b, a, _mm256_cmpeq_epu8(b,a),  COMP_EQ);
+    assert_comparison<uint8_t>(a, b, _mm256_cmpneq_epu8(a,b), COMP_NE);
+    assert_comparison<uint8_t>(b, a, _mm256_cmpneq_epu8(b,a), COMP_NE);
+    assert_comparison<uint8_t>(a, b, _mm256_cmplt_epu8(a,b),  COMP_LT);
+    assert_comparison<uint8_t>(b, a, _mm256_cmplt_epu8(b,a),  COMP_LT);
+    assert_comparison<uint8_t>(a, b, _mm256_cmple_epu8(a,b),  COMP_LE);
+    assert_comparison<uint8_t>(b, a, _mm256_cmple_epu8(b,a),  COMP_LE);
+    assert_comparison<uint8_t>(a, b, _mm256_cmpgt_epu8(a,b),  COMP_GT);
+    assert_comparison<uint8_t>(b, a, _mm256_cmpgt_epu8(b,a),  COMP_GT);
+    assert_comparison<uint8_t>(a, b, _mm256_cmpge_epu8(a,b),  COMP_GE);
+    assert_comparison<uint8_t>(b, a, _mm256_cmpge_epu8(b,a),  COMP_GE);
+}
+
+
+TEST(IS, epi16_256_comparisons)
+{
+    const __m256i a = _mm256_setr_epi16(-32768,-32768,-32767,-1,0, 1,32767,32767, 0,-1,-32768,32767,5,6,7,8);
+    const __m256i b = _mm256_setr_epi16(-32768,-32767,-1,     1,0,-1,    0,32767, -1,0,32767,-32768,6,5,7,8);
+    assert_comparison<int16_t>(a, b, _mm256_cmpneq_epi16(a,b), COMP_NE);
+    assert_comparison<int16_t>(b, a, _mm256_cmpneq_epi16(b,a), COMP_NE);
+    assert_comparison<int16_t>(a, b, _mm256_cmplt_epi16(a,b),  COMP_LT);
+    assert_comparison<int16_t>(b, a, _mm256_cmplt_epi16(b,a),  COMP_LT);
+    assert_comparison<int16_t>(a, b, _mm256_cmple_epi16(a,b),  COMP_LE);
+    assert_comparison<int16_t>(b, a, _mm256_cmple_epi16(b,a),  COMP_LE);
+    assert_comparison<int16_t>(a, b, _mm256_cmpge_epi16(a,b),  COMP_GE);
+    assert_comparison<int16_t>(b, a, _mm256_cmpge_epi16(b,a),  COMP_GE);
+
+    assert_comparison<uint16_t>(a, b, _mm256_cmpeq_epu16(a,b),  COMP_EQ);
+    assert_comparison<uint16_t>(b, a, _mm256_cmpeq_epu16(b,a),  COMP_EQ);
+    assert_comparison<uint16_t>(a, b, _mm256_cmpneq_epu16(a,b), COMP_NE);
+    assert_comparison<uint16_t>(b, a, _mm256_cmpneq_epu16(b,a), COMP_NE);
+    assert_comparison<uint16_t>(a, b, _mm256_cmplt_epu16(a,b),  COMP_LT);
+    assert_comparison<uint16_t>(b, a, _mm256_cmplt_epu16(b,a),  COMP_LT);
+    assert_comparison<uint16_t>(a, b, _mm256_cmple_epu16(a,b),  COMP_LE);
+    assert_comparison<uint16_t>(b, a, _mm256_cmple_epu16(b,a),  COMP_LE);
+    assert_comparison<uint16_t>(a, b, _mm256_cmpgt_epu16(a,b),  COMP_GT);
+    assert_comparison<uint16_t>(b, a, _mm256_cmpgt_epu16(b,a),  COMP_GT);
+    assert_comparison<uint16_t>(a, b, _mm256_cmpge_epu16(a,b),  COMP_GE);
+    assert_comparison<uint16_t>(b, a, _mm256_cmpge_epu16(b,a),  COMP_GE);
+}
+
+
+TEST(IS, epi32_256_comparisons)
+{
+    const __m256i a = _mm256_setr_epi32(INT32_MIN,INT32_MIN,0,INT32_MAX, -1,0,5,INT32_MIN);
+    const __m256i b = _mm256_setr_epi32(INT32_MIN,-1,      -1,INT32_MIN, 0,-1,5,INT32_MAX);
+    assert_comparison<int32_t>(a, b, _mm256_cmpneq_epi32(a,b), COMP_NE);
+    assert_comparison<int32_t>(b, a, _mm256_cmpneq_epi32(b,a), COMP_NE);
+    assert_comparison<int32_t>(a, b, _mm256_cmplt_epi32(a,b),  COMP_LT);
+    assert_comparison<int32_t>(b, a, _mm256_cmplt_epi32(b,a),  COMP_LT);
+    assert_comparison<int32_t>(a, b, _mm256_cmple_epi32(a,b),  COMP_LE);
+    assert_comparison<int32_t>(b, a, _mm256_cmple_epi32(b,a),  COMP_LE);
+    assert_comparison<int32_t>(a, b, _mm256_cmpge_epi32(a,b),  COMP_GE);
+    assert_comparison<int32_t>(b, a, _mm256_cmpge_epi32(b,a),  COMP_GE);
+
+    assert_comparison<uint32_t>(a, b, _mm256_cmpeq_epu32(a,b),  COMP_EQ);
+    assert_comparison<uint32_t>(b, a, _mm256_cmpeq_epu32(b,a),  COMP_EQ);
+    assert_comparison<uint32_t>(a, b, _mm256_cmpneq_epu32(a,b), COMP_NE);
+    assert_comparison<uint32_t>(b, a, _mm256_cmpneq_epu32(b,a), COMP_NE);
+    assert_comparison<uint32_t>(a, b, _mm256_cmplt_epu32(a,b),  COMP_LT);
+    assert_comparison<uint32_t>(b, a, _mm256_cmplt_epu32(b,a),  COMP_LT);
+    assert_comparison<uint32_t>(a, b, _mm256_cmple_epu32(a,b),  COMP_LE);
+    assert_comparison<uint32_t>(b, a, _mm256_cmple_epu32(b,a),  COMP_LE);
+    assert_comparison<uint32_t>(a, b, _mm256_cmpgt_epu32(a,b),  COMP_GT);
+    assert_comparison<uint32_t>(b, a, _mm256_cmpgt_epu32(b,a),  COMP_GT);
+    assert_comparison<uint32_t>(a, b, _mm256_cmpge_epu32(a,b),  COMP_GE);
+    assert_comparison<uint32_t>(b, a, _mm256_cmpge_epu32(b,a),  COMP_GE);
+}
+
+
+TEST(IS, epi64_256_comparisons)
+{
+    const __m256i a = _mm256_setr_epi64x(INT64_MIN, INT64_MIN, 0,         INT64_MAX);
+    const __m256i b = _mm256_setr_epi64x(-1,        INT64_MIN, INT64_MAX, 0);
+    const __m256i c = _mm256_setr_epi64x(INT64_MAX, 0,         -1,        INT64_MAX);
+    const __m256i values[] = {a, b, c};
+    for (size_t i=0; i<3; ++i)
+    {
+        for (size_t j=0; j<3; ++j)
+        {
+            const __m256i x = values[i];
+            const __m256i y = values[j];
+            assert_comparison<int64_t>(x, y, _mm256_cmpneq_epi64(x,y), COMP_NE);
+            assert_comparison<int64_t>(x, y, _mm256_cmplt_epi64(x,y),  COMP_LT);
+            assert_comparison<int64_t>(x, y, _mm256_cmple_epi64(x,y),  COMP_LE);
+            assert_comparison<int64_t>(x, y, _mm256_cmpge_epi64(x,y),  COMP_GE);
+
+            assert_comparison<uint64_t>(x, y, _mm256_cmpeq_epu64(x,y),  COMP_EQ);
+            assert_comparison<uint64_t>(x, y, _mm256_cmpneq_epu64(x,y), COMP_NE);
+            assert_comparison<uint64_t>(x, y, _mm256_cmplt_epu64(x,y),  COMP_LT);
+            assert_comparison<uint64_t>(x, y, _mm256_cmple_epu64(x,y),  COMP_LE);
+            assert_comparison<uint64_t>(x, y, _mm256_cmpgt_epu64(x,y),  COMP_GT);
+            assert_comparison<uint64_t>(x, y, _mm256_cmpge_epu64(x,y),  COMP_GE);
+        }
+    }
+}
+
+
+TEST(IS, epi8_256_shifts)
+{
+    const __m256i v = _mm256_setr_epi8(-128,-128,-127,-127,-1,-1,0,0,1,1,2,2,126,126,127,127, 3,-3,64,-64,0x55,-0x56,0x0F,-0x10,4,5,6,7,8,9,10,11);
+    for (unsigned i=0; i<8u; ++i)
+    {
+        assert_left_shift< uint8_t>(v, _mm256_sll_epi8(v, _mm_set1_epi64x(i)), i);
+        assert_right_shift<uint8_t>(v, _mm256_srl_epi8(v, _mm_set1_epi64x(i)), i);
+        assert_right_shift<int8_t >(v, _mm256_sra_epi8(v, _mm_set1_epi64x(i)), i);
+    }
+    assert_left_shift< uint8_t>(v, _mm256_slli_epi8(v, 0), 0);
+    assert_left_shift< uint8_t>(v, _mm256_slli_epi8(v, 3), 3);
+    assert_left_shift< uint8_t>(v, _mm256_slli_epi8(v, 7), 7);
+    assert_right_shift<uint8_t>(v, _mm256_srli_epi8(v, 0), 0);
+    assert_right_shift<uint8_t>(v, _mm256_srli_epi8(v, 3), 3);
+    assert_right_shift<uint8_t>(v, _mm256_srli_epi8(v, 7), 7);
+    assert_right_shift<int8_t >(v, _mm256_srai_epi8(v, 0), 0);
+    assert_right_shift<int8_t >(v, _mm256_srai_epi8(v, 3), 3);
+    assert_right_shift<int8_t >(v, _mm256_srai_epi8(v, 7), 7);
+}
+
+
+TEST(IS, epi64_256_right_shift)
+{
+    const __m256i v = _mm256_setr_epi64x(0x0123456789ABCDEFll, 0xFEDCBA9876543210ll, -1, INT64_MIN);
+    for (unsigned i=0; i<64u; ++i)
+    {
+        assert_right_shift<int64_t>(v, _mm256_sra_epi64(v, _mm_set1_epi64x(i)), i);
+    }
+    assert_right_shift<int64_t>(v, _mm256_srai_epi64(v, 0),  0);
+    assert_right_shift<int64_t>(v, _mm256_srai_epi64(v, 1),  1);
+    assert_right_shift<int64_t>(v, _mm256_srai_epi64(v,31), 31);
+    assert_right_shift<int64_t>(v, _mm256_srai_epi64(v,32), 32);
+    assert_right_shift<int64_t>(v, _mm256_srai_epi64(v,33), 33);
+    assert_right_shift<int64_t>(v, _mm256_srai_epi64(v,62), 62);
+    assert_right_shift<int64_t>(v, _mm256_srai_epi64(v,63), 63);
+}
+
+
+TEST(IS, epi8_256_variable_shifts)
+{
+    const __m256i v       = _mm256_setr_epi8(-128,-127,-3,-2,-1,0,1,2,3,64,126,127,0x55,-0x56,0x0F,-0x10, 4,5,6,7,8,9,10,11,-4,-5,-6,-7,-8,-9,-10,-11);
+    const __m256i offsets = _mm256_setr_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15, 16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31);
+    for (unsigned i=0; i<256u; ++i)
+    {
+        const __m256i c = _mm256_add_epi8(_mm256_set1_epi8(int8_t(i)), offsets);
+        assert_variable_shifts<int8_t, uint8_t>(v, c, _mm256_sllv_epi8(v,c), _mm256_srlv_epi8(v,c), _mm256_srav_epi8(v,c));
+    }
+}
+
+
+TEST(IS, epi16_256_variable_shifts)
+{
+    const __m256i v       = _mm256_setr_epi16(-32768,-32767,-2,-1,0,1,0x1234,32767, -0x1234,2,3,4,-3,-4,0x4000,-0x4000);
+    const __m256i offsets = _mm256_setr_epi16(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+    for (unsigned i=0; i<65536u; ++i)
+    {
+        const __m256i c = _mm256_add_epi16(_mm256_set1_epi16(int16_t(i)), offsets);
+        assert_variable_shifts<int16_t, uint16_t>(v, c, _mm256_sllv_epi16(v,c), _mm256_srlv_epi16(v,c), _mm256_srav_epi16(v,c));
+    }
+}
+
+
+TEST(IS, epi64_256_variable_shifts)
+{
+    const __m256i  v        = _mm256_setr_epi64x(0x0123456789ABCDEFll, 0xFEDCBA9876543210ll, -1, INT64_MIN);
+    const uint64_t counts[] = {0x100, 0x13F, 0x100000000ull, 0x10000003Full, 0x8000000000000000ull, 0xFFFFFFFFFFFFFFFCull};
+    for (unsigned i=0; i<70u; ++i)
+    {
+        const __m256i c = _mm256_setr_epi64x(int64_t(i), int64_t(i+1), int64_t(i+2), int64_t(i+3));
+        assert_variable_shifts<int64_t, uint64_t>(v, c, _mm256_sllv_epi64(v,c), _mm256_srlv_epi64(v,c), _mm256_srav_epi64(v,c));
+    }
+    for (size_t i=0; i<sizeof(counts)/sizeof(counts[0]); ++i)
+    {
+        const __m256i c = _mm256_setr_epi64x(int64_t(counts[i]), int64_t(counts[i]+1), int64_t(counts[i]+2), int64_t(counts[i]+3));
+        assert_variable_shifts<int64_t, uint64_t>(v, c, _mm256_sllv_epi64(v,c), _mm256_srlv_epi64(v,c), _mm256_srav_epi64(v,c));
+    }
+}
+
+
+namespace {
+
+/// Checks the 256-bit rotates by a given immediate
+struct ImmediateRotates256
+{
+    template<int N>
+    static void run(const __m256i& a)
+    {
+        assert_rotates<uint8_t>( a, _mm256_set1_epi8(char(N)), _mm256_rol_epi8(a, N),  _mm256_ror_epi8(a, N));
+        assert_rotates<uint16_t>(a, _mm256_set1_epi16(N),      _mm256_rol_epi16(a, N), _mm256_ror_epi16(a, N));
+        assert_rotates<uint32_t>(a, _mm256_set1_epi32(N),      _mm256_rol_epi32(a, N), _mm256_ror_epi32(a, N));
+        assert_rotates<uint64_t>(a, _mm256_set1_epi64x(N),     _mm256_rol_epi64(a, N), _mm256_ror_epi64(a, N));
+    }
+};
+
+} // namespace
+
+
+TEST(IS, rotates_256)
+{
+    const __m256i a = _mm256_setr_epi64x(0x0123456789ABCDEFll, 0xFEDCBA9876543210ll, 0x0F1E2D3C4B5A6978ll, INT64_MIN);
+    ForEachImmediate<63>::run<ImmediateRotates256>(a);
+
+    uint64_t seed = 0x1F2E3D4C5B6A7988ull;
+    for (unsigned i=0; i<1000; ++i)
+    {
+        int64_t lanes[4];
+        for (int j=0; j<4; ++j)
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            lanes[j] = int64_t(seed);
+        }
+        const __m256i c = _mm256_setr_epi64x(lanes[0], lanes[1], lanes[2], lanes[3]);
+        const __m256i v = _mm256_shuffle_epi32(c, _MM_SHUFFLE(0,3,2,1));
+        assert_rotates<uint8_t>( v, c, _mm256_rolv_epi8(v, c),  _mm256_rorv_epi8(v, c));
+        assert_rotates<uint16_t>(v, c, _mm256_rolv_epi16(v, c), _mm256_rorv_epi16(v, c));
+        assert_rotates<uint32_t>(v, c, _mm256_rolv_epi32(v, c), _mm256_rorv_epi32(v, c));
+        assert_rotates<uint64_t>(v, c, _mm256_rolv_epi64(v, c), _mm256_rorv_epi64(v, c));
+    }
+}
+
+
+template<>
+void assert_absdiffs(const __m256i& a, const __m256i& b)
+{
+    assert_absdiff<int8_t,   uint8_t >(a, b, _mm256_absdiff_epi8(a, b));
+    assert_absdiff<uint8_t,  uint8_t >(a, b, _mm256_absdiff_epu8(a, b));
+    assert_absdiff<int16_t,  uint16_t>(a, b, _mm256_absdiff_epi16(a, b));
+    assert_absdiff<uint16_t, uint16_t>(a, b, _mm256_absdiff_epu16(a, b));
+    assert_absdiff<int32_t,  uint32_t>(a, b, _mm256_absdiff_epi32(a, b));
+    assert_absdiff<uint32_t, uint32_t>(a, b, _mm256_absdiff_epu32(a, b));
+    assert_absdiff<int64_t,  uint64_t>(a, b, _mm256_absdiff_epi64(a, b));
+    assert_absdiff<uint64_t, uint64_t>(a, b, _mm256_absdiff_epu64(a, b));
+    assert_sad<uint16_t>(a, b, _mm256_sad_epu16(a, b));
+    assert_sad<uint32_t>(a, b, _mm256_sad_epu32(a, b));
+}
+
+
+TEST(IS, absdiff_256)
+{
+    test_pairs<__m256i>(assert_absdiffs<__m256i>);
+}
+
+
+template<>
+void assert_averages(const __m256i& a, const __m256i& b)
+{
+    assert_avg<uint8_t >(a, b, _mm256_avg_epu8(a, b),        true);
+    assert_avg<int8_t  >(a, b, _mm256_avg_epi8(a, b),        true);
+    assert_avg<uint8_t >(a, b, _mm256_avg_floor_epu8(a, b),  false);
+    assert_avg<int8_t  >(a, b, _mm256_avg_floor_epi8(a, b),  false);
+    assert_avg<uint16_t>(a, b, _mm256_avg_epu16(a, b),       true);
+    assert_avg<int16_t >(a, b, _mm256_avg_epi16(a, b),       true);
+    assert_avg<uint16_t>(a, b, _mm256_avg_floor_epu16(a, b), false);
+    assert_avg<int16_t >(a, b, _mm256_avg_floor_epi16(a, b), false);
+    assert_avg<uint32_t>(a, b, _mm256_avg_epu32(a, b),       true);
+    assert_avg<int32_t >(a, b, _mm256_avg_epi32(a, b),       true);
+    assert_avg<uint32_t>(a, b, _mm256_avg_floor_epu32(a, b), false);
+    assert_avg<int32_t >(a, b, _mm256_avg_floor_epi32(a, b), false);
+    assert_avg<uint64_t>(a, b, _mm256_avg_epu64(a, b),       true);
+    assert_avg<int64_t >(a, b, _mm256_avg_epi64(a, b),       true);
+    assert_avg<uint64_t>(a, b, _mm256_avg_floor_epu64(a, b), false);
+    assert_avg<int64_t >(a, b, _mm256_avg_floor_epi64(a, b), false);
+}
+
+
+TEST(IS, avg_256)
+{
+    test_pairs<__m256i>(assert_averages<__m256i>);
+}
+
+
+TEST(IS, epi64_256_min_max_abs)
+{
+    const __m256i a = _mm256_setr_epi64x(INT64_MIN, INT64_MIN, 0,         INT64_MAX);
+    const __m256i b = _mm256_setr_epi64x(-1,        INT64_MIN, INT64_MAX, 0);
+    const __m256i c = _mm256_setr_epi64x(INT64_MAX, 0,         -1,        INT64_MIN+1);
+    const __m256i values[] = {a, b, c};
+    for (size_t i=0; i<3; ++i)
+    {
+        for (size_t j=0; j<3; ++j)
+        {
+            const __m256i x = values[i];
+            const __m256i y = values[j];
+            assert_min_max<int64_t>( x, y, _mm256_min_epi64(x,y), std::min);
+            assert_min_max<int64_t>( x, y, _mm256_max_epi64(x,y), std::max);
+            assert_min_max<uint64_t>(x, y, _mm256_min_epu64(x,y), std::min);
+            assert_min_max<uint64_t>(x, y, _mm256_max_epu64(x,y), std::max);
+        }
+        assert_abs<int64_t, uint64_t>(values[i], _mm256_abs_epi64(values[i]));
+    }
+}
+
+
+TEST(IS, epi64_256_mul)
+{
+    const int64_t values[] = {INT64_MIN, INT64_MIN+1, -0x100000001ll, -0x100000000ll, -0xFFFFFFFFll, -2, -1, 0, 1, 2,
+                              0xFFFFFFFFll, 0x100000000ll, 0x100000001ll, 0x0123456789ABCDEFll, INT64_MAX-1, INT64_MAX};
+    const size_t count = sizeof(values) / sizeof(values[0]);
+    for (size_t i=0; i<count; ++i)
+    {
+        for (size_t j=0; j<count; ++j)
+        {
+            const __m256i a = _mm256_setr_epi64x(values[i], values[j], values[count-1-i], values[j]);
+            const __m256i b = _mm256_setr_epi64x(values[j], values[i], values[i], values[count-1-j]);
+            assert_mul_epi64(a, b, _mm256_mullo_epi64(a,b), _mm256_mulhi_epu64(a,b), _mm256_mulhi_epi64(a,b));
+        }
+    }
+}
+
+
+TEST(IS, popcnt_256)
+{
+    // Each half must match the 128-bit version, which is checked thoroughly in sse_tests.h
+    uint64_t seed = 0x0123456789ABCDEFull;
+    for (unsigned i=0; i<1000; ++i)
+    {
+        int64_t values[4];
+        for (unsigned j=0; j<4; ++j)
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            values[j] = int64_t(seed >> (i % 64));
+        }
+        const __m256i a  = _mm256_setr_epi64x(values[0], values[1], values[2], values[3]);
+        const __m128i lo = _mm256_castsi256_si128(a);
+        const __m128i hi = _mm256_extracti128_si256(a, 1);
+        const __m256i expected[] = {_mm256_setr_m128i(_mm_popcnt_epi8(lo),  _mm_popcnt_epi8(hi)),
+                                    _mm256_setr_m128i(_mm_popcnt_epi16(lo), _mm_popcnt_epi16(hi)),
+                                    _mm256_setr_m128i(_mm_popcnt_epi32(lo), _mm_popcnt_epi32(hi)),
+                                    _mm256_setr_m128i(_mm_popcnt_epi64(lo), _mm_popcnt_epi64(hi))};
+        const __m256i actual[]   = {_mm256_popcnt_epi8(a), _mm256_popcnt_epi16(a), _mm256_popcnt_epi32(a), _mm256_popcnt_epi64(a)};
+        for (unsigned j=0; j<4; ++j)
+            ASSERT_EQ(0, memcmp(&expected[j], &actual[j], sizeof(__m256i)));
+    }
+}
+
+
+TEST(IS, zero_counts_256)
+{
+    // Each half must match the 128-bit version, which is checked thoroughly in sse_tests.h
+    uint64_t seed = 0x0123456789ABCDEFull;
+    for (unsigned i=0; i<1000; ++i)
+    {
+        int64_t values[4];
+        for (unsigned j=0; j<4; ++j)
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            values[j] = int64_t((seed >> (i % 64)) << ((i / 64) % 64));
+        }
+        const __m256i a  = _mm256_setr_epi64x(values[0], values[1], values[2], values[3]);
+        const __m128i lo = _mm256_castsi256_si128(a);
+        const __m128i hi = _mm256_extracti128_si256(a, 1);
+        const __m256i expected[] = {_mm256_setr_m128i(_mm_lzcnt_epi8(lo),  _mm_lzcnt_epi8(hi)),
+                                    _mm256_setr_m128i(_mm_lzcnt_epi16(lo), _mm_lzcnt_epi16(hi)),
+                                    _mm256_setr_m128i(_mm_lzcnt_epi32(lo), _mm_lzcnt_epi32(hi)),
+                                    _mm256_setr_m128i(_mm_lzcnt_epi64(lo), _mm_lzcnt_epi64(hi)),
+                                    _mm256_setr_m128i(_mm_tzcnt_epi8(lo),  _mm_tzcnt_epi8(hi)),
+                                    _mm256_setr_m128i(_mm_tzcnt_epi16(lo), _mm_tzcnt_epi16(hi)),
+                                    _mm256_setr_m128i(_mm_tzcnt_epi32(lo), _mm_tzcnt_epi32(hi)),
+                                    _mm256_setr_m128i(_mm_tzcnt_epi64(lo), _mm_tzcnt_epi64(hi))};
+        const __m256i actual[]   = {_mm256_lzcnt_epi8(a), _mm256_lzcnt_epi16(a), _mm256_lzcnt_epi32(a), _mm256_lzcnt_epi64(a),
+                                    _mm256_tzcnt_epi8(a), _mm256_tzcnt_epi16(a), _mm256_tzcnt_epi32(a), _mm256_tzcnt_epi64(a)};
+        for (unsigned j=0; j<8; ++j)
+            ASSERT_EQ(0, memcmp(&expected[j], &actual[j], sizeof(__m256i))) << j;
+    }
+}
+
+#endif // INTERNAL_RMGR_FIB_USE_AVX2
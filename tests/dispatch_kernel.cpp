@@ -0,0 +1,19 @@
+#include <rmgr/fib/dispatch.h>
+
+
+// Compiled once per instruction set, see dispatch_tests.cpp
+namespace dispatch_tests { namespace RMGR_FIB_IS_NAMESPACE {
+
+uint32_t required_features()
+{
+    return RMGR_FIB_REQUIRED_CPU_FEATURES;
+}
+
+int64_t max_epu64(uint64_t a, uint64_t b)
+{
+    const __m128i va = _mm_set1_epi64x(int64_t(a));
+    const __m128i vb = _mm_set1_epi64x(int64_t(b));
+    return _mm_cvtsi128_si64(_mm_max_epu64(va, vb));
+}
+
+}} // namespace dispatch_tests::RMGR_FIB_IS_NAMESPACE
@@ -0,0 +1,123 @@
+#include <rmgr/fib/dispatch.h>
+#include <gtest/gtest.h>
+
+
+namespace dispatch_tests {
+
+namespace sse2  { uint32_t required_features(); int64_t max_epu64(uint64_t a, uint64_t b); }
+namespace sse3  { uint32_t required_features(); int64_t max_epu64(uint64_t a, uint64_t b); }
+namespace ssse3 { uint32_t required_features(); int64_t max_epu64(uint64_t a, uint64_t b); }
+namespace sse41 { uint32_t required_features(); int64_t max_epu64(uint64_t a, uint64_t b); }
+namespace sse42 { uint32_t required_features(); int64_t max_epu64(uint64_t a, uint64_t b); }
+namespace avx   { uint32_t required_features(); int64_t max_epu64(uint64_t a, uint64_t b); }
+namespace avx2  { uint32_t required_features(); int64_t max_epu64(uint64_t a, uint64_t b); }
+
+// Each variant is compiled with the flags of an instruction set, so it can only be called once
+// the CPU is known to support the features it was compiled for
+static const uint32_t SSE2_FEATURES  = rmgr::fib::CPU_SSE2;
+static const uint32_t SSE3_FEATURES  = SSE2_FEATURES  | rmgr::fib::CPU_SSE3;
+static const uint32_t SSSE3_FEATURES = SSE3_FEATURES  | rmgr::fib::CPU_SSSE3;
+static const uint32_t SSE41_FEATURES = SSSE3_FEATURES | rmgr::fib::CPU_SSE41;
+static const uint32_t SSE42_FEATURES = SSE41_FEATURES | rmgr::fib::CPU_SSE42;
+static const uint32_t AVX_FEATURES   = SSE42_FEATURES | rmgr::fib::CPU_AVX;
+static const uint32_t AVX2_FEATURES  = AVX_FEATURES   | rmgr::fib::CPU_AVX2;
+
+static const rmgr::fib::variant<uint32_t()> required_features_variants[] =
+{
+    { AVX2_FEATURES,  &avx2::required_features  },
+    { AVX_FEATURES,   &avx::required_features   },
+    { SSE42_FEATURES, &sse42::required_features },
+    { SSE41_FEATURES, &sse41::required_features },
+    { SSSE3_FEATURES, &ssse3::required_features },
+    { SSE3_FEATURES,  &sse3::required_features  },
+    { SSE2_FEATURES,  &sse2::required_features  },
+};
+
+static const rmgr::fib::variant<int64_t(uint64_t, uint64_t)> max_epu64_variants[] =
+{
+    { rmgr::fib::CPU_AVX2,  &avx2::max_epu64  },
+    { rmgr::fib::CPU_AVX,   &avx::max_epu64   },
+    { rmgr::fib::CPU_SSE42, &sse42::max_epu64 },
+    { rmgr::fib::CPU_SSE41, &sse41::max_epu64 },
+    { rmgr::fib::CPU_SSSE3, &ssse3::max_epu64 },
+    { rmgr::fib::CPU_SSE3,  &sse3::max_epu64  },
+    { rmgr::fib::CPU_SSE2,  &sse2::max_epu64  },
+};
+
+static uint32_t required_features()
+{
+    return RMGR_FIB_DISPATCH(required_features_variants)();
+}
+
+static int64_t max_epu64(uint64_t a, uint64_t b)
+{
+    return RMGR_FIB_DISPATCH(max_epu64_variants)(a, b);
+}
+
+} // namespace dispatch_tests
+
+
+TEST(dispatch, cpu_features)
+{
+    const uint32_t features = rmgr::fib::cpu_features();
+    ASSERT_EQ(features, rmgr::fib::cpu_features());
+#if RMGR_ARCH_IS_X86_64
+    ASSERT_TRUE(rmgr::fib::cpu_supports(rmgr::fib::CPU_SSE2));
+#endif
+#if RMGR_COMPILER_IS_GCC_OR_CLANG
+    ASSERT_EQ(__builtin_cpu_supports("sse3")     != 0, rmgr::fib::cpu_supports(rmgr::fib::CPU_SSE3));
+    ASSERT_EQ(__builtin_cpu_supports("ssse3")    != 0, rmgr::fib::cpu_supports(rmgr::fib::CPU_SSSE3));
+    ASSERT_EQ(__builtin_cpu_supports("sse4.1")   != 0, rmgr::fib::cpu_supports(rmgr::fib::CPU_SSE41));
+    ASSERT_EQ(__builtin_cpu_supports("sse4.2")   != 0, rmgr::fib::cpu_supports(rmgr::fib::CPU_SSE42));
+    ASSERT_EQ(__builtin_cpu_supports("avx")      != 0, rmgr::fib::cpu_supports(rmgr::fib::CPU_AVX));
+    ASSERT_EQ(__builtin_cpu_supports("fma")      != 0, rmgr::fib::cpu_supports(rmgr::fib::CPU_FMA));
+    ASSERT_EQ(__builtin_cpu_supports("avx2")     != 0, rmgr::fib::cpu_supports(rmgr::fib::CPU_AVX2));
+    ASSERT_EQ(__builtin_cpu_supports("avx512f")  != 0, rmgr::fib::cpu_supports(rmgr::fib::CPU_AVX512F));
+    ASSERT_EQ(__builtin_cpu_supports("avx512dq") != 0, rmgr::fib::cpu_supports(rmgr::fib::CPU_AVX512DQ));
+    ASSERT_EQ(__builtin_cpu_supports("avx512vl") != 0, rmgr::fib::cpu_supports(rmgr::fib::CPU_AVX512VL));
+    ASSERT_EQ(__builtin_cpu_supports("avx512bw") != 0, rmgr::fib::cpu_supports(rmgr::fib::CPU_AVX512BW));
+    ASSERT_EQ(__builtin_cpu_supports("avx512cd")        != 0, rmgr::fib::cpu_supports(rmgr::fib::CPU_AVX512CD));
+    ASSERT_EQ(__builtin_cpu_supports("avx512vpopcntdq") != 0, rmgr::fib::cpu_supports(rmgr::fib::CPU_AVX512VPOPCNTDQ));
+    ASSERT_EQ(__builtin_cpu_supports("avx512bitalg")    != 0, rmgr::fib::cpu_supports(rmgr::fib::CPU_AVX512BITALG));
+#endif
+}
+
+
+TEST(dispatch, required_features)
+{
+    // Only the variants the CPU can run are called
+    for (size_t i=0; i<sizeof(dispatch_tests::required_features_variants)/sizeof(dispatch_tests::required_features_variants[0]); ++i)
+    {
+        const rmgr::fib::variant<uint32_t()>& variant = dispatch_tests::required_features_variants[i];
+        if (rmgr::fib::cpu_supports(variant.features))
+        {
+            ASSERT_EQ(variant.features, variant.function()) << i;
+        }
+    }
+}
+
+
+TEST(dispatch, best_variant)
+{
+    // The selected variant is the best one the CPU supports
+    uint32_t expected = 0;
+    for (size_t i=0; i<sizeof(dispatch_tests::required_features_variants)/sizeof(dispatch_tests::required_features_variants[0]); ++i)
+    {
+        if (rmgr::fib::cpu_supports(dispatch_tests::required_features_variants[i].features))
+        {
+            expected = dispatch_tests::required_features_variants[i].features;
+            break;
+        }
+    }
+    ASSERT_EQ(expected, dispatch_tests::required_features()); // First call: selection
+    ASSERT_EQ(expected, dispatch_tests::required_features()); // Subsequent calls: bound variant
+    ASSERT_TRUE(rmgr::fib::cpu_supports(dispatch_tests::required_features()));
+}
+
+
+TEST(dispatch, arguments)
+{
+    ASSERT_EQ(INT64_MIN, dispatch_tests::max_epu64(uint64_t(INT64_MIN), uint64_t(INT64_MAX)));
+    ASSERT_EQ(-1,        dispatch_tests::max_epu64(UINT64_MAX, 0));
+    ASSERT_EQ(42,        dispatch_tests::max_epu64(42, 41));
+}
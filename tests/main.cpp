@@ -1,8 +1,39 @@
+#include <rmgr/fib/dispatch.h>
 #include <gtest/gtest.h>
+#include <string>
+
+
+/// Excludes the tests of the instruction sets the CPU lacks, they would die of an illegal instruction
+static void skip_unsupported_instruction_sets()
+{
+    static const struct { uint32_t features; const char* suite; } instructionSets[] =
+    {
+        { rmgr::fib::CPU_SSE3,  "SSE3"  },
+        { rmgr::fib::CPU_SSSE3, "SSSE3" },
+        { rmgr::fib::CPU_SSE41, "SSE41" },
+        { rmgr::fib::CPU_SSE42, "SSE42" },
+        { rmgr::fib::CPU_AVX,   "AVX"   },
+        { rmgr::fib::CPU_AVX2,  "AVX2"  },
+    };
+
+    std::string filter = ::testing::GTEST_FLAG(filter);
+    bool negative = (filter.find('-') != std::string::npos);
+    for (size_t i=0; i<sizeof(instructionSets)/sizeof(instructionSets[0]); ++i)
+    {
+        if (rmgr::fib::cpu_supports(instructionSets[i].features))
+            continue;
+        filter += negative ? ":" : "-";
+        filter += instructionSets[i].suite;
+        filter += ".*";
+        negative = true;
+    }
+    ::testing::GTEST_FLAG(filter) = filter;
+}
 
 
 extern "C" int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
+    skip_unsupported_instruction_sets();
     return RUN_ALL_TESTS();
 }
@@ -1,5 +1,9 @@
 #include <rmgr/fib/sse.h>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 
 
 TEST(IS, epi8_extract)
@@ -72,6 +76,61 @@ static RMGR_NOINLINE bool compare(T a, T b, Comparison comp)
 }
 
 
+namespace {
+
+/**
+ * Calls Check::run<imm>() with the given arguments for each imm from N down to 0
+ *
+ * Intrinsics taking an immediate can't be called from a regular loop, hence this compile-time one.
+ * Like the checks, it lives in an unnamed namespace: each instruction set compiles its own.
+ */
+template<int N>
+struct ForEachImmediate
+{
+    template<typename Check, typename A>
+    static void run(const A& a)
+    {
+        Check::template run<N>(a);
+        ForEachImmediate<N-1>::template run<Check>(a);
+    }
+
+    template<typename Check, typename A, typename B>
+    static void run(const A& a, const B& b)
+    {
+        Check::template run<N>(a, b);
+        ForEachImmediate<N-1>::template run<Check>(a, b);
+    }
+
+    template<typename Check, typename A, typename B, typename C>
+    static void run(const A& a, const B& b, const C& c)
+    {
+        Check::template run<N>(a, b, c);
+        ForEachImmediate<N-1>::template run<Check>(a, b, c);
+    }
+};
+
+template<>
+struct ForEachImmediate<-1>
+{
+    template<typename Check, typename A>
+    static void run(const A&)
+    {
+    }
+
+    template<typename Check, typename A, typename B>
+    static void run(const A&, const B&)
+    {
+    }
+
+    template<typename Check, typename A, typename B, typename C>
+    static void run(const A&, const B&, const C&)
+    {
+    }
+};
+
+} // namespace
+
+
 template<typename Scalar>
 static void store(Scalar buffer[], const __m128i& v)
 {
@@ -90,6 +149,93 @@ static void store(double buffer[], const __m128d& v)
     _mm_storeu_pd(buffer, v);
 }
 
+#if INTERNAL_RMGR_FIB_USE_AVX
+template<typename Scalar>
+static void store(Scalar buffer[], const __m256i& v)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer), v);
+}
+
+
+static void store(float buffer[], const __m256& v)
+{
+    _mm256_storeu_ps(buffer, v);
+}
+
+
+static void store(double buffer[], const __m256d& v)
+{
+    _mm256_storeu_pd(buffer, v);
+}
+#endif
+
+
+/// Checks that r is a with the lane at index replaced by i, all lanes being Scalar
+template<typename Scalar>
+static RMGR_NOINLINE void assert_insert(const __m128i& a, Scalar i, int index, const __m128i& r)
+{
+    const size_t length = sizeof(__m128i) / sizeof(Scalar);
+    Scalar bufA[length], bufR[length];
+    store(bufA, a);
+    store(bufR, r);
+    for (size_t j=0; j<length; ++j)
+    {
+        ASSERT_EQ(int(j) == index ? i : bufA[j], bufR[j]) << index << ' ' << j;
+    }
+}
+
+namespace {
+
+/// Checks the lane insertions and extractions for a given immediate
+struct ImmediateInserts
+{
+    template<int N>
+    static void run(const __m128i& a, const __m128& b)
+    {
+        assert_insert<int8_t>(a, int8_t(-N), N, _mm_insert_epi8(a, -N, N));
+        if (N < 4)
+        {
+            const int n = N & 3; // Keeps the immediates in range when N >= 4, for which this is dead code
+            assert_insert<int32_t>(a, INT32_MIN + n, n, _mm_insert_epi32(a, INT32_MIN + n, n));
+            ASSERT_EQ(_mm_extract_epi32(_mm_castps_si128(b), n), _mm_extract_ps(b, n));
+        }
+        if (N < 2)
+        {
+            const int n = N & 1;
+            assert_insert<int64_t>(a, INT64_MIN + n, n, _mm_insert_epi64(a, INT64_MIN + n, n));
+        }
+    }
+};
+
+/// Checks _mm_insert_ps() against a scalar reference
+struct InsertPs
+{
+    template<int imm>
+    static RMGR_NOINLINE void run(const __m128& a, const __m128& b)
+    {
+        float bufA[4], bufB[4], bufR[4];
+        store(bufA, a);
+        store(bufB, b);
+        store(bufR, _mm_insert_ps(a, b, imm));
+        for (int j=0; j<4; ++j)
+        {
+            const float expected = (imm & (1 << j)) ? 0.0f : (j == ((imm >> 4) & 3)) ? bufB[(imm >> 6) & 3] : bufA[j];
+            ASSERT_EQ(expected, bufR[j]) << imm << ' ' << j;
+        }
+    }
+};
+
+} // namespace
+
+
+TEST(IS, insert)
+{
+    const __m128i a = _mm_set_epi8(-128,-127,-65,-64,-63,-2,-1,0,1,2,3,63,64,65,126,127);
+    const __m128  b = _mm_setr_ps(1.5f, -2.5f, 3.5f, -4.5f);
+    ForEachImmediate<15>::run<ImmediateInserts>(a, b);
+    ForEachImmediate<255>::run<InsertPs>(_mm_setr_ps(10.0f, 20.0f, 30.0f, 40.0f), b);
+}
+
 
 template<typename Scalar, typename Vector>
 static RMGR_NOINLINE void assert_comparison(const Vector& a, const Vector& b, const Vector& res, Comparison comp)
@@ -448,6 +594,147 @@ TEST(IS, epi64_right_shift)
 }
 
 
+template<typename Scalar, typename UScalar, typename Vector>
+static RMGR_NOINLINE void assert_variable_shifts(const Vector& a, const Vector& count, const Vector& sll, const Vector& srl, const Vector& sra)
+{
+    const size_t   length = sizeof(Vector) / sizeof(Scalar);
+    const unsigned bits   = sizeof(Scalar) * 8;
+    Scalar  bufA[length], bufSra[length];
+    UScalar bufC[length], bufSll[length], bufSrl[length];
+    store(bufA,   a);
+    store(bufC,   count);
+    store(bufSll, sll);
+    store(bufSrl, srl);
+    store(bufSra, sra);
+    for (size_t i=0; i<length; ++i)
+    {
+        const UScalar u = UScalar(bufA[i]);
+        const UScalar c = bufC[i];
+        ASSERT_EQ(c < bits ? UScalar(u << c) : UScalar(0),                   bufSll[i]);
+        ASSERT_EQ(c < bits ? UScalar(u >> c) : UScalar(0),                   bufSrl[i]);
+        ASSERT_EQ(c < bits ? Scalar(bufA[i] >> c) : Scalar(bufA[i] < 0 ? -1 : 0), bufSra[i]);
+    }
+}
+
+TEST(IS, epi8_variable_shifts)
+{
+    const __m128i v       = _mm_setr_epi8(-128,-127,-3,-2,-1,0,1,2,3,64,126,127,0x55,-0x56,0x0F,-0x10);
+    const __m128i offsets = _mm_setr_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+    for (unsigned i=0; i<256u; ++i)
+    {
+        // Every lane sees every count
+        const __m128i c = _mm_add_epi8(_mm_set1_epi8(int8_t(i)), offsets);
+        assert_variable_shifts<int8_t, uint8_t>(v, c, _mm_sllv_epi8(v,c), _mm_srlv_epi8(v,c), _mm_srav_epi8(v,c));
+    }
+}
+
+TEST(IS, epi16_variable_shifts)
+{
+    const __m128i v       = _mm_setr_epi16(-32768,-32767,-2,-1,0,1,0x1234,32767);
+    const __m128i offsets = _mm_setr_epi16(0,1,2,3,4,5,6,7);
+    for (unsigned i=0; i<65536u; ++i)
+    {
+        // Every lane sees every count
+        const __m128i c = _mm_add_epi16(_mm_set1_epi16(int16_t(i)), offsets);
+        assert_variable_shifts<int16_t, uint16_t>(v, c, _mm_sllv_epi16(v,c), _mm_srlv_epi16(v,c), _mm_srav_epi16(v,c));
+    }
+}
+
+TEST(IS, epi32_variable_shifts)
+{
+    const __m128i  v        = _mm_setr_epi32(INT32_MIN, -0x12345678, 0x12345678, INT32_MAX);
+    const __m128i  offsets  = _mm_setr_epi32(0,1,2,3);
+    const uint32_t counts[] = {0x100, 0x11F, 0x7FFFFFFFu, 0x80000000u, 0xFFFFFFFCu};
+    for (unsigned i=0; i<40u; ++i)
+    {
+        const __m128i c = _mm_add_epi32(_mm_set1_epi32(int32_t(i)), offsets);
+        assert_variable_shifts<int32_t, uint32_t>(v, c, _mm_sllv_epi32(v,c), _mm_srlv_epi32(v,c), _mm_srav_epi32(v,c));
+    }
+    for (size_t i=0; i<sizeof(counts)/sizeof(counts[0]); ++i)
+    {
+        const __m128i c = _mm_add_epi32(_mm_set1_epi32(int32_t(counts[i])), offsets);
+        assert_variable_shifts<int32_t, uint32_t>(v, c, _mm_sllv_epi32(v,c), _mm_srlv_epi32(v,c), _mm_srav_epi32(v,c));
+    }
+}
+
+TEST(IS, epi64_variable_shifts)
+{
+    const __m128i  v        = _mm_set_epi64x(0xFEDCBA9876543210ll, 0x0123456789ABCDEFll);
+    const __m128i  w        = _mm_set_epi64x(0x0123456789ABCDEFll, 0xFEDCBA9876543210ll);
+    const uint64_t counts[] = {0x100, 0x13F, 0x100000000ull, 0x10000003Full, 0x8000000000000000ull, 0xFFFFFFFFFFFFFFFEull};
+    for (unsigned i=0; i<70u; ++i)
+    {
+        const __m128i c = _mm_set_epi64x(int64_t(i+1), int64_t(i));
+        assert_variable_shifts<int64_t, uint64_t>(v, c, _mm_sllv_epi64(v,c), _mm_srlv_epi64(v,c), _mm_srav_epi64(v,c));
+        assert_variable_shifts<int64_t, uint64_t>(w, c, _mm_sllv_epi64(w,c), _mm_srlv_epi64(w,c), _mm_srav_epi64(w,c));
+    }
+    for (size_t i=0; i<sizeof(counts)/sizeof(counts[0]); ++i)
+    {
+        const __m128i c = _mm_set_epi64x(int64_t(counts[i]+1), int64_t(counts[i]));
+        assert_variable_shifts<int64_t, uint64_t>(v, c, _mm_sllv_epi64(v,c), _mm_srlv_epi64(v,c), _mm_srav_epi64(v,c));
+        assert_variable_shifts<int64_t, uint64_t>(w, c, _mm_sllv_epi64(w,c), _mm_srlv_epi64(w,c), _mm_srav_epi64(w,c));
+    }
+}
+
+
+/// Checks the left and right rotates of a by count, taken modulo the lane width, against scalar references
+template<typename Scalar, typename Vector>
+static RMGR_NOINLINE void assert_rotates(const Vector& a, const Vector& count, const Vector& rol, const Vector& ror)
+{
+    const size_t   length = sizeof(Vector) / sizeof(Scalar);
+    const unsigned bits   = 8 * sizeof(Scalar);
+    Scalar bufA[length], bufC[length], bufL[length], bufR[length];
+    store(bufA, a);
+    store(bufC, count);
+    store(bufL, rol);
+    store(bufR, ror);
+    for (size_t i=0; i<length; ++i)
+    {
+        const unsigned n = unsigned(bufC[i]) & (bits - 1);
+        ASSERT_EQ(n ? Scalar((bufA[i] << n) | (bufA[i] >> (bits - n))) : bufA[i], bufL[i]) << n;
+        ASSERT_EQ(n ? Scalar((bufA[i] >> n) | (bufA[i] << (bits - n))) : bufA[i], bufR[i]) << n;
+    }
+}
+
+namespace {
+
+/// Checks the rotates by a given immediate
+struct ImmediateRotates
+{
+    template<int N>
+    static void run(const __m128i& a)
+    {
+        assert_rotates<uint8_t>( a, _mm_set1_epi8(char(N)), _mm_rol_epi8(a, N),  _mm_ror_epi8(a, N));
+        assert_rotates<uint16_t>(a, _mm_set1_epi16(N),      _mm_rol_epi16(a, N), _mm_ror_epi16(a, N));
+        assert_rotates<uint32_t>(a, _mm_set1_epi32(N),      _mm_rol_epi32(a, N), _mm_ror_epi32(a, N));
+        assert_rotates<uint64_t>(a, _mm_set1_epi64x(N),     _mm_rol_epi64(a, N), _mm_ror_epi64(a, N));
+    }
+};
+
+} // namespace
+
+
+TEST(IS, rotates)
+{
+    const __m128i a = _mm_set_epi64x(0xFEDCBA9876543210ll, 0x0123456789ABCDEFll);
+    ForEachImmediate<63>::run<ImmediateRotates>(a);
+
+    uint64_t seed = 0x1F2E3D4C5B6A7988ull;
+    for (unsigned i=0; i<1000; ++i)
+    {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const uint64_t lo = seed;
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const __m128i c = _mm_set_epi64x(int64_t(seed), int64_t(lo));
+        const __m128i v = _mm_shuffle_epi32(c, _MM_SHUFFLE(0,3,2,1));
+        assert_rotates<uint8_t>( v, c, _mm_rolv_epi8(v, c),  _mm_rorv_epi8(v, c));
+        assert_rotates<uint16_t>(v, c, _mm_rolv_epi16(v, c), _mm_rorv_epi16(v, c));
+        assert_rotates<uint32_t>(v, c, _mm_rolv_epi32(v, c), _mm_rorv_epi32(v, c));
+        assert_rotates<uint64_t>(v, c, _mm_rolv_epi64(v, c), _mm_rorv_epi64(v, c));
+    }
+}
+
+
 template<typename Scalar, typename Vector>
 static void assert_min_max(const Vector& a, const Vector& b, const Vector& res, const Scalar& (*fct)(const Scalar&, const Scalar&))
 {
@@ -487,6 +774,17 @@ TEST(IS, epu16_min_max)
 }
 
 
+TEST(IS, epi32_min_max)
+{
+    const __m128i a = _mm_set_epi32(INT32_MIN,INT32_MIN,0,INT32_MAX);
+    const __m128i b = _mm_set_epi32(INT32_MIN,-1,      -1,INT32_MIN);
+    assert_min_max<int32_t>(a, b, _mm_min_epi32(a,b), std::min);
+    assert_min_max<int32_t>(b, a, _mm_min_epi32(b,a), std::min);
+    assert_min_max<int32_t>(a, b, _mm_max_epi32(a,b), std::max);
+    assert_min_max<int32_t>(b, a, _mm_max_epi32(b,a), std::max);
+}
+
+
 TEST(IS, epu32_min_max)
 {
     const __m128i a = _mm_set_epi32(INT32_MIN,INT32_MIN,0,INT32_MAX);
@@ -597,3 +895,1574 @@ TEST(IS, pd_abs)
     assert_abs<double, double>(a, _mm_abs_pd(a));
     assert_abs<double, double>(b, _mm_abs_pd(b));
 }
+
+
+/// Checks that res holds |a - b| as unsigned lanes
+template<typename Scalar, typename UScalar, typename Vector>
+static RMGR_NOINLINE void assert_absdiff(const Vector& a, const Vector& b, const Vector& res)
+{
+    const size_t length = sizeof(Vector) / sizeof(Scalar);
+    Scalar  bufA[length], bufB[length];
+    UScalar bufR[length];
+    store(bufA, a);
+    store(bufB, b);
+    store(bufR, res);
+    for (size_t i=0; i<length; ++i)
+    {
+        const UScalar expected = (bufA[i] > bufB[i]) ? UScalar(UScalar(bufA[i]) - UScalar(bufB[i])) : UScalar(UScalar(bufB[i]) - UScalar(bufA[i]));
+        ASSERT_EQ(expected, bufR[i]) << i;
+    }
+}
+
+/// Checks that each 64-bit lane of res is the sum of |a - b| over the matching lanes of a and b
+template<typename UScalar, typename Vector>
+static RMGR_NOINLINE void assert_sad(const Vector& a, const Vector& b, const Vector& res)
+{
+    const size_t length = sizeof(Vector) / sizeof(UScalar);
+    const size_t perSum = sizeof(uint64_t) / sizeof(UScalar);
+    UScalar  bufA[length], bufB[length];
+    uint64_t bufR[length / perSum];
+    store(bufA, a);
+    store(bufB, b);
+    store(bufR, res);
+    for (size_t i=0; i<length/perSum; ++i)
+    {
+        uint64_t expected = 0;
+        for (size_t j=i*perSum; j<(i+1)*perSum; ++j)
+            expected += (bufA[j] > bufB[j]) ? bufA[j] - bufB[j] : bufB[j] - bufA[j];
+        ASSERT_EQ(expected, bufR[i]) << i;
+    }
+}
+
+template<typename Vector>
+static void assert_absdiffs(const Vector& a, const Vector& b);
+
+template<>
+void assert_absdiffs(const __m128i& a, const __m128i& b)
+{
+    assert_absdiff<int8_t,   uint8_t >(a, b, _mm_absdiff_epi8(a, b));
+    assert_absdiff<uint8_t,  uint8_t >(a, b, _mm_absdiff_epu8(a, b));
+    assert_absdiff<int16_t,  uint16_t>(a, b, _mm_absdiff_epi16(a, b));
+    assert_absdiff<uint16_t, uint16_t>(a, b, _mm_absdiff_epu16(a, b));
+    assert_absdiff<int32_t,  uint32_t>(a, b, _mm_absdiff_epi32(a, b));
+    assert_absdiff<uint32_t, uint32_t>(a, b, _mm_absdiff_epu32(a, b));
+    assert_absdiff<int64_t,  uint64_t>(a, b, _mm_absdiff_epi64(a, b));
+    assert_absdiff<uint64_t, uint64_t>(a, b, _mm_absdiff_epu64(a, b));
+    assert_sad<uint16_t>(a, b, _mm_sad_epu16(a, b));
+    assert_sad<uint32_t>(a, b, _mm_sad_epu32(a, b));
+}
+
+/// Calls check() on pairs of extreme values, then of random ones
+template<typename Vector>
+static void test_pairs(void (*check)(const Vector&, const Vector&))
+{
+    const size_t length = sizeof(Vector) / sizeof(uint64_t);
+    const uint64_t extremes[] = {0, 1, 0x7FFFFFFFFFFFFFFFull, 0x8000000000000000ull, 0xFFFFFFFFFFFFFFFFull, 0x807F80017FFF8000ull};
+    const size_t count = sizeof(extremes) / sizeof(extremes[0]);
+    uint64_t bufA[length], bufB[length];
+    for (size_t i=0; i<count*count; ++i)
+    {
+        for (size_t j=0; j<length; ++j)
+        {
+            bufA[j] = extremes[(i + j) % count];
+            bufB[j] = extremes[(i / count + j) % count];
+        }
+        Vector a, b;
+        memcpy(&a, bufA, sizeof(a));
+        memcpy(&b, bufB, sizeof(b));
+        check(a, b);
+    }
+
+    uint64_t seed = 0x5A6B7C8D9EAFB0C1ull;
+    for (unsigned i=0; i<1000; ++i)
+    {
+        for (size_t j=0; j<length; ++j)
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            bufA[j] = seed;
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            bufB[j] = seed;
+        }
+        Vector a, b;
+        memcpy(&a, bufA, sizeof(a));
+        memcpy(&b, bufB, sizeof(b));
+        check(a, b);
+    }
+}
+
+
+TEST(IS, absdiff)
+{
+    test_pairs<__m128i>(assert_absdiffs<__m128i>);
+}
+
+
+/// Checks that res holds the average of a and b, rounded up if round is true, down otherwise
+template<typename Scalar, typename Vector>
+static RMGR_NOINLINE void assert_avg(const Vector& a, const Vector& b, const Vector& res, bool round)
+{
+    const size_t length = sizeof(Vector) / sizeof(Scalar);
+    Scalar bufA[length], bufB[length], bufR[length];
+    store(bufA, a);
+    store(bufB, b);
+    store(bufR, res);
+    for (size_t i=0; i<length; ++i)
+    {
+        const Scalar lsb      = Scalar((round ? (bufA[i] | bufB[i]) : (bufA[i] & bufB[i])) & 1);
+        const Scalar expected = Scalar((bufA[i] >> 1) + (bufB[i] >> 1) + lsb);
+        ASSERT_EQ(expected, bufR[i]) << i;
+    }
+}
+
+template<typename Vector>
+static void assert_averages(const Vector& a, const Vector& b);
+
+template<>
+void assert_averages(const __m128i& a, const __m128i& b)
+{
+    assert_avg<uint8_t >(a, b, _mm_avg_epu8(a, b),        true);
+    assert_avg<int8_t  >(a, b, _mm_avg_epi8(a, b),        true);
+    assert_avg<uint8_t >(a, b, _mm_avg_floor_epu8(a, b),  false);
+    assert_avg<int8_t  >(a, b, _mm_avg_floor_epi8(a, b),  false);
+    assert_avg<uint16_t>(a, b, _mm_avg_epu16(a, b),       true);
+    assert_avg<int16_t >(a, b, _mm_avg_epi16(a, b),       true);
+    assert_avg<uint16_t>(a, b, _mm_avg_floor_epu16(a, b), false);
+    assert_avg<int16_t >(a, b, _mm_avg_floor_epi16(a, b), false);
+    assert_avg<uint32_t>(a, b, _mm_avg_epu32(a, b),       true);
+    assert_avg<int32_t >(a, b, _mm_avg_epi32(a, b),       true);
+    assert_avg<uint32_t>(a, b, _mm_avg_floor_epu32(a, b), false);
+    assert_avg<int32_t >(a, b, _mm_avg_floor_epi32(a, b), false);
+    assert_avg<uint64_t>(a, b, _mm_avg_epu64(a, b),       true);
+    assert_avg<int64_t >(a, b, _mm_avg_epi64(a, b),       true);
+    assert_avg<uint64_t>(a, b, _mm_avg_floor_epu64(a, b), false);
+    assert_avg<int64_t >(a, b, _mm_avg_floor_epi64(a, b), false);
+}
+
+
+TEST(IS, avg)
+{
+    test_pairs<__m128i>(assert_averages<__m128i>);
+}
+
+
+/// Checks r against the bitwise function of a, b and c whose truth table is imm
+template<typename Vector>
+static RMGR_NOINLINE void assert_ternarylogic(const Vector& a, const Vector& b, const Vector& c, const Vector& r, int imm)
+{
+    const size_t length = sizeof(Vector) / sizeof(uint64_t);
+    uint64_t bufA[length], bufB[length], bufC[length], bufR[length];
+    store(bufA, a);
+    store(bufB, b);
+    store(bufC, c);
+    store(bufR, r);
+    for (size_t i=0; i<length; ++i)
+    {
+        uint64_t expected = 0;
+        for (int j=0; j<8; ++j)
+        {
+            if (imm & (1 << j))
+                expected |= ((j & 4) ? bufA[i] : ~bufA[i]) & ((j & 2) ? bufB[i] : ~bufB[i]) & ((j & 1) ? bufC[i] : ~bufC[i]);
+        }
+        ASSERT_EQ(expected, bufR[i]) << imm << ' ' << i;
+    }
+}
+
+namespace {
+
+/// Checks the ternary logic for a given immediate
+struct TernaryLogicImmediates
+{
+    template<int N>
+    static void run(const __m128i& a, const __m128i& b, const __m128i& c)
+    {
+        assert_ternarylogic(a, b, c, _mm_ternarylogic_epi32(a, b, c, N), N);
+        assert_ternarylogic(a, b, c, _mm_ternarylogic_epi64(a, b, c, N), N);
+    }
+};
+
+} // namespace
+
+
+TEST(IS, ternarylogic)
+{
+    // With these inputs, each byte of the result is the truth table itself
+    const __m128i a = _mm_set1_epi8(char(0xF0));
+    const __m128i b = _mm_set1_epi8(char(0xCC));
+    const __m128i c = _mm_set1_epi8(char(0xAA));
+    ForEachImmediate<255>::run<TernaryLogicImmediates>(a, b, c);
+    ForEachImmediate<255>::run<TernaryLogicImmediates>(_mm_setr_epi32(0, -1, 0x01234567, int(0x89ABCDEF)), _mm_setr_epi32(-1, 0x76543210, 0, int(0xFEDCBA98)), _mm_setr_epi32(0x55555555, 0, -1, 0x0F0F0F0F));
+    ASSERT_EQ(0xE8, _mm_extract_epi8(_mm_ternarylogic_epi32(a, b, c, 0xE8), 5));
+}
+
+
+static int evaluationCount;
+
+static RMGR_NOINLINE __m128i counted(const __m128i& a)
+{
+    ++evaluationCount;
+    return a;
+}
+
+
+TEST(IS, single_evaluation)
+{
+    const __m128i a = _mm_set_epi32(-2,-1,1,2);
+    evaluationCount = 0;
+    _mm_not_si128(counted(a));
+    _mm_neg_epi8(counted(a));
+    _mm_cmpneq_epi16(counted(a), counted(a));
+    _mm_cmpge_epi32(counted(a), counted(a));
+    _mm_cmpgt_epu64(counted(a), counted(a));
+    _mm_slli_epi8(counted(a), 3);
+    _mm_srai_epi8(counted(a), 3);
+    _mm_extract_epi64(counted(a), 1);
+    _mm_cmplt_epu8_mask(counted(a), counted(a));
+    _mm_ternarylogic_epi32(counted(a), counted(a), counted(a), 0xE8);
+    ASSERT_EQ(16, evaluationCount);
+}
+
+
+template<typename Vector>
+static RMGR_NOINLINE void assert_mul_epi32(const Vector& a, const Vector& b, const Vector& lo, const Vector& hiU, const Vector& hiS)
+{
+    const size_t length = sizeof(Vector) / sizeof(int32_t);
+    int32_t bufA[length], bufB[length], bufLo[length], bufHiU[length], bufHiS[length];
+    store(bufA,   a);
+    store(bufB,   b);
+    store(bufLo,  lo);
+    store(bufHiU, hiU);
+    store(bufHiS, hiS);
+    for (size_t i=0; i<length; ++i)
+    {
+        ASSERT_EQ(int32_t(uint32_t(bufA[i]) * uint32_t(bufB[i])), bufLo[i]);
+        ASSERT_EQ(uint32_t((uint64_t(uint32_t(bufA[i])) * uint32_t(bufB[i])) >> 32), uint32_t(bufHiU[i]));
+        ASSERT_EQ(int32_t((int64_t(bufA[i]) * bufB[i]) >> 32), bufHiS[i]);
+    }
+}
+
+
+TEST(IS, epi32_mul)
+{
+    const int32_t values[] = {INT32_MIN, INT32_MIN+1, -0x10001, -0x10000, -0xFFFF, -2, -1, 0, 1, 2,
+                              0xFFFF, 0x10000, 0x10001, 0x01234567, INT32_MAX-1, INT32_MAX};
+    const size_t count = sizeof(values) / sizeof(values[0]);
+    for (size_t i=0; i<count; ++i)
+    {
+        for (size_t j=0; j<count; ++j)
+        {
+            const __m128i a = _mm_set_epi32(values[i], values[j], values[count-1-i], values[j]);
+            const __m128i b = _mm_set_epi32(values[j], values[i], values[j], values[count-1-i]);
+            assert_mul_epi32(a, b, _mm_mullo_epi32(a,b), _mm_mulhi_epu32(a,b), _mm_mulhi_epi32(a,b));
+        }
+    }
+}
+
+
+// The references don't use 32x32->64 partial products like the emulation does, so that they can't
+// share its mistakes: they rely on 128-bit integers when available, shift-and-add otherwise
+static uint64_t mulhi_u64(uint64_t a, uint64_t b)
+{
+#ifdef __SIZEOF_INT128__
+    return uint64_t((unsigned __int128)(a) * b >> 64);
+#else
+    uint64_t hi = 0, lo = 0;
+    for (int i=63; i>=0; --i)
+    {
+        // (hi:lo) = 2 * (hi:lo) + bit i of b * a
+        hi = (hi << 1) | (lo >> 63);
+        lo <<= 1;
+        if ((b >> i) & 1)
+        {
+            lo += a;
+            hi += (lo < a) ? 1 : 0;
+        }
+    }
+    return hi;
+#endif
+}
+
+
+static int64_t mulhi_i64(int64_t a, int64_t b)
+{
+#ifdef __SIZEOF_INT128__
+    return int64_t((__int128)(a) * b >> 64);
+#else
+    const uint64_t hi = mulhi_u64(uint64_t(a), uint64_t(b));
+    return int64_t(hi - (a < 0 ? uint64_t(b) : 0) - (b < 0 ? uint64_t(a) : 0));
+#endif
+}
+
+
+template<typename Vector>
+static RMGR_NOINLINE void assert_mul_epi64(const Vector& a, const Vector& b, const Vector& lo, const Vector& hiU, const Vector& hiS)
+{
+    const size_t length = sizeof(Vector) / sizeof(int64_t);
+    int64_t bufA[length], bufB[length], bufLo[length], bufHiU[length], bufHiS[length];
+    store(bufA,   a);
+    store(bufB,   b);
+    store(bufLo,  lo);
+    store(bufHiU, hiU);
+    store(bufHiS, hiS);
+    for (size_t i=0; i<length; ++i)
+    {
+        ASSERT_EQ(int64_t(uint64_t(bufA[i]) * uint64_t(bufB[i])), bufLo[i]);
+        ASSERT_EQ(mulhi_u64(uint64_t(bufA[i]), uint64_t(bufB[i])), uint64_t(bufHiU[i]));
+        ASSERT_EQ(mulhi_i64(bufA[i], bufB[i]), bufHiS[i]);
+    }
+}
+
+
+TEST(IS, epi64_mul)
+{
+    const int64_t values[] = {INT64_MIN, INT64_MIN+1, -0x100000001ll, -0x100000000ll, -0xFFFFFFFFll, -2, -1, 0, 1, 2,
+                              0xFFFFFFFFll, 0x100000000ll, 0x100000001ll, 0x0123456789ABCDEFll, INT64_MAX-1, INT64_MAX};
+    const size_t count = sizeof(values) / sizeof(values[0]);
+    for (size_t i=0; i<count; ++i)
+    {
+        for (size_t j=0; j<count; ++j)
+        {
+            const __m128i a = _mm_set_epi64x(values[i], values[j]);
+            const __m128i b = _mm_set_epi64x(values[j], values[i]);
+            assert_mul_epi64(a, b, _mm_mullo_epi64(a,b), _mm_mulhi_epu64(a,b), _mm_mulhi_epi64(a,b));
+        }
+    }
+
+    // Cross-check the scalar reference
+    ASSERT_EQ(UINT64_C(0xFFFFFFFFFFFFFFFE), mulhi_u64(UINT64_MAX, UINT64_MAX));
+    ASSERT_EQ(INT64_C(0x4000000000000000),  mulhi_i64(INT64_MIN, INT64_MIN));
+    ASSERT_EQ(-1,                           mulhi_i64(-1, 1));
+}
+
+
+template<typename Scalar>
+static RMGR_NOINLINE void assert_saturated(const __m128i& a, const __m128i& b, const __m128i& adds, const __m128i& subs)
+{
+    typedef std::numeric_limits<Scalar> limits;
+    const size_t length = sizeof(__m128i) / sizeof(Scalar);
+    Scalar bufA[length], bufB[length], bufAdds[length], bufSubs[length];
+    store(bufA,    a);
+    store(bufB,    b);
+    store(bufAdds, adds);
+    store(bufSubs, subs);
+    for (size_t i=0; i<length; ++i)
+    {
+        const Scalar x = bufA[i], y = bufB[i];
+        const Scalar sum  = (y > 0) ? (x > Scalar(limits::max() - y) ? limits::max() : Scalar(x + y))
+                                    : (x < Scalar(limits::min() - y) ? limits::min() : Scalar(x + y));
+        const Scalar diff = (y > 0) ? (x < Scalar(limits::min() + y) ? limits::min() : Scalar(x - y))
+                                    : (x > Scalar(limits::max() + y) ? limits::max() : Scalar(x - y));
+        ASSERT_EQ(sum,  bufAdds[i]);
+        ASSERT_EQ(diff, bufSubs[i]);
+    }
+}
+
+
+TEST(IS, epi32_saturated)
+{
+    const int32_t values[] = {INT32_MIN, INT32_MIN+1, -0x40000000, -2, -1, 0, 1, 2, 0x40000000, INT32_MAX-1, INT32_MAX};
+    const size_t count = sizeof(values) / sizeof(values[0]);
+    for (size_t i=0; i<count; ++i)
+    {
+        for (size_t j=0; j<count; ++j)
+        {
+            const __m128i a = _mm_set_epi32(values[i], values[j], values[i], values[count-1-j]);
+            const __m128i b = _mm_set_epi32(values[j], values[i], values[count-1-j], values[i]);
+            assert_saturated<int32_t> (a, b, _mm_adds_epi32(a,b), _mm_subs_epi32(a,b));
+            assert_saturated<uint32_t>(a, b, _mm_adds_epu32(a,b), _mm_subs_epu32(a,b));
+        }
+    }
+}
+
+
+TEST(IS, epi64_saturated)
+{
+    const int64_t values[] = {INT64_MIN, INT64_MIN+1, -0x100000000ll, -0xFFFFFFFFll, -2, -1, 0, 1, 2,
+                              0xFFFFFFFFll, 0x100000000ll, INT64_MAX-1, INT64_MAX};
+    const size_t count = sizeof(values) / sizeof(values[0]);
+    for (size_t i=0; i<count; ++i)
+    {
+        for (size_t j=0; j<count; ++j)
+        {
+            const __m128i a = _mm_set_epi64x(values[i], values[j]);
+            const __m128i b = _mm_set_epi64x(values[j], values[i]);
+            assert_saturated<int64_t> (a, b, _mm_adds_epi64(a,b), _mm_subs_epi64(a,b));
+            assert_saturated<uint64_t>(a, b, _mm_adds_epu64(a,b), _mm_subs_epu64(a,b));
+        }
+    }
+}
+
+
+/// Checks the reductions of a vector of signed lanes and of the same vector seen as unsigned
+template<typename Scalar, typename UScalar>
+static RMGR_NOINLINE void assert_reductions(const __m128i& a, Scalar add, Scalar band, Scalar bor, Scalar min, Scalar max, UScalar umin, UScalar umax)
+{
+    const size_t length = sizeof(__m128i) / sizeof(Scalar);
+    Scalar buf[length];
+    store(buf, a);
+    UScalar expAdd = 0, expAnd = UScalar(~UScalar(0)), expOr = 0;
+    Scalar  expMin = buf[0], expMax = buf[0];
+    UScalar expUMin = UScalar(buf[0]), expUMax = UScalar(buf[0]);
+    for (size_t i=0; i<length; ++i)
+    {
+        const UScalar u = UScalar(buf[i]);
+        expAdd  = UScalar(expAdd + u);
+        expAnd &= u;
+        expOr  |= u;
+        expMin  = (buf[i] < expMin) ? buf[i] : expMin;
+        expMax  = (buf[i] > expMax) ? buf[i] : expMax;
+        expUMin = (u < expUMin) ? u : expUMin;
+        expUMax = (u > expUMax) ? u : expUMax;
+    }
+    ASSERT_EQ(Scalar(expAdd), add);
+    ASSERT_EQ(Scalar(expAnd), band);
+    ASSERT_EQ(Scalar(expOr),  bor);
+    ASSERT_EQ(expMin,  min);
+    ASSERT_EQ(expMax,  max);
+    ASSERT_EQ(expUMin, umin);
+    ASSERT_EQ(expUMax, umax);
+}
+
+
+TEST(IS, reductions)
+{
+    // Each extreme value is moved across all lanes of each width in turn, amid pseudo-random bytes
+    const int64_t extremes[] = {INT64_MIN, INT64_MIN+1, -1, 0, 1, INT64_MAX-1, INT64_MAX,
+                                INT32_MIN, INT32_MAX, UINT32_MAX, INT16_MIN, INT16_MAX, UINT16_MAX, INT8_MIN, INT8_MAX, UINT8_MAX};
+    uint64_t seed = 0x0123456789ABCDEFull;
+    for (size_t e=0; e<sizeof(extremes)/sizeof(extremes[0]); ++e)
+    {
+        for (unsigned width=1; width<=8; width*=2)
+        {
+            for (unsigned lane=0; lane<16; lane+=width)
+            {
+                uint8_t bytes[16];
+                for (unsigned i=0; i<16; ++i)
+                {
+                    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+                    bytes[i] = uint8_t(seed >> 56);
+                }
+                memcpy(bytes + lane, &extremes[e], width); // Little endian: the low bytes come first
+                __m128i a;
+                memcpy(&a, bytes, sizeof(a));
+                assert_reductions<int8_t, uint8_t>(a, _mm_reduce_add_epi8(a), _mm_reduce_and_epi8(a), _mm_reduce_or_epi8(a),
+                                                   _mm_reduce_min_epi8(a), _mm_reduce_max_epi8(a), _mm_reduce_min_epu8(a), _mm_reduce_max_epu8(a));
+                assert_reductions<int16_t, uint16_t>(a, _mm_reduce_add_epi16(a), _mm_reduce_and_epi16(a), _mm_reduce_or_epi16(a),
+                                                     _mm_reduce_min_epi16(a), _mm_reduce_max_epi16(a), _mm_reduce_min_epu16(a), _mm_reduce_max_epu16(a));
+                assert_reductions<int32_t, uint32_t>(a, _mm_reduce_add_epi32(a), _mm_reduce_and_epi32(a), _mm_reduce_or_epi32(a),
+                                                     _mm_reduce_min_epi32(a), _mm_reduce_max_epi32(a), _mm_reduce_min_epu32(a), _mm_reduce_max_epu32(a));
+                assert_reductions<int64_t, uint64_t>(a, _mm_reduce_add_epi64(a), _mm_reduce_and_epi64(a), _mm_reduce_or_epi64(a),
+                                                     _mm_reduce_min_epi64(a), _mm_reduce_max_epi64(a), _mm_reduce_min_epu64(a), _mm_reduce_max_epu64(a));
+            }
+        }
+    }
+
+    // A few hand-checked values, in case the reference above is wrong
+    const __m128i ones = _mm_set1_epi32(-1);
+    ASSERT_EQ(-1,  _mm_reduce_and_epi8(ones));
+    ASSERT_EQ(-16, _mm_reduce_add_epi8(ones));
+    ASSERT_EQ(-8,  _mm_reduce_add_epi16(ones));
+    ASSERT_EQ(0,   _mm_reduce_or_epi64(_mm_setzero_si128()));
+}
+
+
+/// Checks a per-lane population count against a bit-by-bit count
+template<typename Scalar>
+static RMGR_NOINLINE void assert_popcnt(const __m128i& a, const __m128i& r)
+{
+    const size_t length = sizeof(__m128i) / sizeof(Scalar);
+    Scalar bufA[length], bufR[length];
+    store(bufA, a);
+    store(bufR, r);
+    for (size_t i=0; i<length; ++i)
+    {
+        Scalar expected = 0;
+        for (unsigned bit=0; bit<sizeof(Scalar)*8; ++bit)
+            expected = Scalar(expected + ((bufA[i] >> bit) & 1));
+        ASSERT_EQ(expected, bufR[i]);
+    }
+}
+
+
+TEST(IS, popcnt)
+{
+    // Exhaustive for 8 and 16-bit lanes
+    for (unsigned i=0; i<0x10000; i+=8)
+    {
+        const __m128i a = _mm_add_epi16(_mm_set1_epi16(int16_t(i)), _mm_setr_epi16(0,1,2,3,4,5,6,7));
+        assert_popcnt<uint8_t>(a, _mm_popcnt_epi8(a));
+        assert_popcnt<uint16_t>(a, _mm_popcnt_epi16(a));
+    }
+
+    // Pseudo-random for 32 and 64-bit lanes, plus a few extremes
+    uint64_t seed = 0x0123456789ABCDEFull;
+    for (unsigned i=0; i<10000; ++i)
+    {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const uint64_t lo = seed;
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const __m128i a = _mm_set_epi64x(int64_t(seed), int64_t(lo & (lo >> (i % 64)))); // Sparser bits in the low lane
+        assert_popcnt<uint32_t>(a, _mm_popcnt_epi32(a));
+        assert_popcnt<uint64_t>(a, _mm_popcnt_epi64(a));
+    }
+    const __m128i ones = _mm_set1_epi32(-1);
+    assert_popcnt<uint32_t>(ones, _mm_popcnt_epi32(ones));
+    assert_popcnt<uint64_t>(ones, _mm_popcnt_epi64(ones));
+    ASSERT_EQ(64, _mm_cvtsi128_si64(_mm_popcnt_epi64(ones)));
+}
+
+
+/// Checks per-lane leading and trailing zero counts against bit-by-bit counts
+template<typename Scalar>
+static RMGR_NOINLINE void assert_zero_counts(const __m128i& a, const __m128i& lz, const __m128i& tz)
+{
+    const size_t   length = sizeof(__m128i) / sizeof(Scalar);
+    const unsigned bits   = sizeof(Scalar) * 8;
+    Scalar bufA[length], bufLz[length], bufTz[length];
+    store(bufA,  a);
+    store(bufLz, lz);
+    store(bufTz, tz);
+    for (size_t i=0; i<length; ++i)
+    {
+        Scalar expectedLz = 0, expectedTz = 0;
+        while (expectedLz < bits && !((bufA[i] >> (bits - 1 - expectedLz)) & 1))
+            ++expectedLz;
+        while (expectedTz < bits && !((bufA[i] >> expectedTz) & 1))
+            ++expectedTz;
+        ASSERT_EQ(expectedLz, bufLz[i]) << std::hex << uint64_t(bufA[i]);
+        ASSERT_EQ(expectedTz, bufTz[i]) << std::hex << uint64_t(bufA[i]);
+    }
+}
+
+
+TEST(IS, zero_counts)
+{
+    // Exhaustive for 8 and 16-bit lanes
+    for (unsigned i=0; i<0x10000; i+=8)
+    {
+        const __m128i a = _mm_add_epi16(_mm_set1_epi16(int16_t(i)), _mm_setr_epi16(0,1,2,3,4,5,6,7));
+        assert_zero_counts<uint8_t>(a, _mm_lzcnt_epi8(a), _mm_tzcnt_epi8(a));
+        assert_zero_counts<uint16_t>(a, _mm_lzcnt_epi16(a), _mm_tzcnt_epi16(a));
+    }
+
+    // Every pair of leading and trailing one positions, with either pseudo-random bits or all ones in
+    // between (the ones right below the leading one are what could make a float conversion round up)
+    uint64_t seed = 0x0123456789ABCDEFull;
+    for (unsigned hi=0; hi<=64; ++hi)
+    {
+        for (unsigned lo=0; lo<hi || lo==0; ++lo)
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            const uint64_t top    = (hi != 0) ? uint64_t(1) << (hi - 1) : 0;
+            const uint64_t bottom = (hi != 0) ? uint64_t(1) << lo : 0;
+            const uint64_t range  = (top - 1) & (~uint64_t(0) << lo) & ~top; // Bits strictly between lo and hi-1
+            const __m128i  a      = _mm_set_epi64x(int64_t(top | range | bottom), int64_t(top | (seed & range) | bottom));
+            assert_zero_counts<uint32_t>(a, _mm_lzcnt_epi32(a), _mm_tzcnt_epi32(a));
+            assert_zero_counts<uint64_t>(a, _mm_lzcnt_epi64(a), _mm_tzcnt_epi64(a));
+        }
+    }
+    const __m128i zero = _mm_setzero_si128();
+    assert_zero_counts<uint32_t>(zero, _mm_lzcnt_epi32(zero), _mm_tzcnt_epi32(zero));
+    assert_zero_counts<uint64_t>(zero, _mm_lzcnt_epi64(zero), _mm_tzcnt_epi64(zero));
+}
+
+
+/// Rounds the lanes of x like _mm_round_ps() with an explicit rounding mode, but through conversions
+/// to 32-bit integers, so it doesn't depend on the MXCSR rounding mode either
+static __m128 round_ps_through_epi32(const __m128& x, int mode)
+{
+    const __m128 sign  = _mm_and_ps(x, _mm_set1_ps(-0.0f));
+    const __m128 abs   = _mm_xor_ps(x, sign);
+    const __m128 one   = _mm_set1_ps(1.0f);
+    const __m128 trunc = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+    const __m128 floor = _mm_sub_ps(trunc, _mm_and_ps(_mm_cmpgt_ps(trunc, x), one));
+    __m128 r = trunc;
+    if (mode == _MM_FROUND_TO_NEG_INF)
+        r = floor;
+    else if (mode == _MM_FROUND_TO_POS_INF)
+        r = _mm_add_ps(trunc, _mm_and_ps(_mm_cmplt_ps(trunc, x), one));
+    else if (mode == _MM_FROUND_TO_NEAREST_INT)
+    {
+        // Ties go to the even neighbour
+        const __m128 d    = _mm_sub_ps(x, floor);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 odd  = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_cvttps_epi32(floor), _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+        const __m128 up   = _mm_or_ps(_mm_cmpgt_ps(d, half), _mm_and_ps(_mm_cmpeq_ps(d, half), odd));
+        r = _mm_add_ps(floor, _mm_and_ps(up, one));
+    }
+    r = _mm_or_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), r), sign); // Rounding keeps the sign, even for zeroes
+    const __m128 small = _mm_cmplt_ps(abs, _mm_set1_ps(8388608.0f));
+    const __m128 nan   = _mm_cmpunord_ps(x, x);
+    const __m128 quiet = _mm_or_ps(x, _mm_castsi128_ps(_mm_set1_epi32(0x00400000))); // Like roundps does with signaling NaNs
+    return _mm_or_ps(_mm_or_ps(_mm_and_ps(small, r), _mm_andnot_ps(_mm_or_ps(small, nan), x)), _mm_and_ps(nan, quiet));
+}
+
+
+/// Checks that r and expected have the same bits, lane by lane
+static RMGR_NOINLINE void assert_rounded(const __m128& x, const __m128& r, const __m128& expected, const char* rounding)
+{
+    uint32_t bufX[4], bufR[4], bufE[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(bufX), _mm_castps_si128(x));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(bufR), _mm_castps_si128(r));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(bufE), _mm_castps_si128(expected));
+    for (size_t i=0; i<4; ++i)
+    {
+        ASSERT_EQ(bufE[i], bufR[i]) << rounding << std::hex << " 0x" << bufX[i];
+    }
+}
+
+
+/// Checks _mm_round_ps() and friends on one float out of step/4, under all MXCSR rounding modes: the
+/// explicit modes must not depend on it, _MM_FROUND_CUR_DIRECTION must follow it
+static void assert_round_ps(uint32_t step)
+{
+    const unsigned csr         = _mm_getcsr();
+    const unsigned csrModes[4] = {_MM_ROUND_NEAREST, _MM_ROUND_DOWN, _MM_ROUND_UP, _MM_ROUND_TOWARD_ZERO};
+    const int      modes[4]    = {_MM_FROUND_TO_NEAREST_INT, _MM_FROUND_TO_NEG_INF, _MM_FROUND_TO_POS_INF, _MM_FROUND_TO_ZERO};
+    for (unsigned m=0; m<4; ++m)
+    {
+        __m128i bits = _mm_setr_epi32(0, 1, 2, 3);
+        _mm_setcsr((csr & ~_MM_ROUND_MASK) | csrModes[m]);
+        for (uint64_t i=0; i<(uint64_t(1)<<32); i+=step)
+        {
+            const __m128 x       = _mm_castsi128_ps(bits);
+            const __m128 nearest = round_ps_through_epi32(x, _MM_FROUND_TO_NEAREST_INT);
+            const __m128 floor   = round_ps_through_epi32(x, _MM_FROUND_TO_NEG_INF);
+            const __m128 ceil    = round_ps_through_epi32(x, _MM_FROUND_TO_POS_INF);
+            const __m128 trunc   = round_ps_through_epi32(x, _MM_FROUND_TO_ZERO);
+            const __m128 current = round_ps_through_epi32(x, modes[m]);
+            const __m128 r0      = _mm_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            const __m128 r1      = _mm_floor_ps(x);
+            const __m128 r2      = _mm_ceil_ps(x);
+            const __m128 r3      = _mm_round_ps(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            const __m128 r4      = _mm_round_ps(x, _MM_FROUND_CUR_DIRECTION);
+            __m128i ok = _mm_cmpeq_epi32(_mm_castps_si128(r0), _mm_castps_si128(nearest));
+            ok = _mm_and_si128(ok, _mm_cmpeq_epi32(_mm_castps_si128(r1), _mm_castps_si128(floor)));
+            ok = _mm_and_si128(ok, _mm_cmpeq_epi32(_mm_castps_si128(r2), _mm_castps_si128(ceil)));
+            ok = _mm_and_si128(ok, _mm_cmpeq_epi32(_mm_castps_si128(r3), _mm_castps_si128(trunc)));
+            ok = _mm_and_si128(ok, _mm_cmpeq_epi32(_mm_castps_si128(r4), _mm_castps_si128(current)));
+            if (_mm_movemask_epi8(ok) != 0xFFFF)
+            {
+                _mm_setcsr(csr);
+                assert_rounded(x, r0, nearest, "nearest");
+                assert_rounded(x, r1, floor,   "floor");
+                assert_rounded(x, r2, ceil,    "ceil");
+                assert_rounded(x, r3, trunc,   "trunc");
+                assert_rounded(x, r4, current, "current");
+                return;
+            }
+            bits = _mm_add_epi32(bits, _mm_set1_epi32(int32_t(step)));
+        }
+    }
+    _mm_setcsr(csr);
+}
+
+
+// Takes minutes, enabled by the RMGR_FIB_EXHAUSTIVE_TESTS CMake option
+#if RMGR_FIB_EXHAUSTIVE_TESTS
+TEST(IS, round_ps_exhaustive)
+{
+    assert_round_ps(4);
+}
+#endif
+
+
+TEST(IS, round_ps)
+{
+    // A prime step goes through all exponents with varied mantissas
+    ASSERT_NO_FATAL_FAILURE(assert_round_ps(4 * 4099));
+
+    // The scalar versions only round the low lane of b
+    const __m128 a = _mm_setr_ps(1.5f, 2.5f, 3.5f, 4.5f);
+    const __m128 b = _mm_setr_ps(-2.5f, 5.5f, 6.5f, 7.5f);
+    float r[4];
+    _mm_storeu_ps(r, _mm_round_ss(a, b, _MM_FROUND_TO_NEAREST_INT));
+    ASSERT_EQ(-2.0f, r[0]);
+    ASSERT_EQ(2.5f,  r[1]);
+    _mm_storeu_ps(r, _mm_floor_ss(a, b));
+    ASSERT_EQ(-3.0f, r[0]);
+    ASSERT_EQ(4.5f,  r[3]);
+    _mm_storeu_ps(r, _mm_ceil_ss(a, b));
+    ASSERT_EQ(-2.0f, r[0]);
+    ASSERT_EQ(3.5f,  r[2]);
+}
+
+
+/// Checks the roundings of two doubles against the standard library
+static RMGR_NOINLINE void assert_round_pd(const __m128d& x)
+{
+    double bufX[2], bufN[2], bufF[2], bufC[2], bufT[2], bufS[2];
+    _mm_storeu_pd(bufX, x);
+    _mm_storeu_pd(bufN, _mm_round_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    _mm_storeu_pd(bufF, _mm_floor_pd(x));
+    _mm_storeu_pd(bufC, _mm_ceil_pd(x));
+    _mm_storeu_pd(bufT, _mm_round_pd(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+    _mm_storeu_pd(bufS, _mm_floor_sd(_mm_set1_pd(42.0), x));
+    for (size_t i=0; i<2; ++i)
+    {
+        const double expected[4] = {std::nearbyint(bufX[i]), std::floor(bufX[i]), std::ceil(bufX[i]), std::trunc(bufX[i])};
+        const double actual[4]   = {bufN[i], bufF[i], bufC[i], bufT[i]};
+        for (size_t j=0; j<4; ++j)
+        {
+            if (std::isnan(bufX[i]))
+            {
+                ASSERT_TRUE(std::isnan(actual[j])) << j;
+            }
+            else
+            {
+                ASSERT_EQ(expected[j], actual[j]) << j << ' ' << bufX[i];
+                ASSERT_EQ(std::signbit(expected[j]), std::signbit(actual[j])) << j << ' ' << bufX[i];
+            }
+        }
+    }
+    if (std::isnan(bufX[0]))
+    {
+        ASSERT_TRUE(std::isnan(bufS[0]));
+    }
+    else
+    {
+        ASSERT_EQ(std::floor(bufX[0]), bufS[0]);
+    }
+    ASSERT_EQ(42.0, bufS[1]);
+}
+
+
+TEST(IS, round_pd)
+{
+    // Values around the integers and the halves, at all magnitudes, then pseudo-random bits
+    const double specials[] = {0.0, -0.0, 0.5, -0.5, 1.5, -1.5, 2.5, -2.5, 0.49999999999999994, 4503599627370495.5,
+                               -4503599627370495.5, 4503599627370496.0, 9007199254740991.0, 1e300, -1e300, 5e-324,
+                               -5e-324, std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+                               std::numeric_limits<double>::quiet_NaN()};
+    for (size_t i=0; i<sizeof(specials)/sizeof(specials[0]); ++i)
+    {
+        assert_round_pd(_mm_set_pd(-specials[i], specials[i]));
+    }
+    for (int e=-4; e<60; ++e)
+    {
+        for (int k=-8; k<=8; ++k)
+        {
+            const double v = std::ldexp(1.0, e) + k * 0.25;
+            assert_round_pd(_mm_set_pd(-v, v));
+        }
+    }
+    uint64_t seed = 0x7766554433221100ull;
+    for (unsigned i=0; i<100000; ++i)
+    {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const uint64_t lo = seed;
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        // Biases the exponents towards the range where there is something to round
+        const uint64_t hi = (seed & 0x800FFFFFFFFFFFFFull) | (uint64_t(1023 - 8 + (seed >> 52) % 70) << 52);
+        assert_round_pd(_mm_castsi128_pd(_mm_set_epi64x(int64_t(hi), int64_t(lo))));
+    }
+}
+
+
+/// Checks the conversions of 32-bit unsigned lanes to float against the compiler's
+static RMGR_NOINLINE void assert_cvtepu32(const __m128i& a)
+{
+    uint32_t bufA[4];
+    float    bufR[4];
+    store(bufA, a);
+    _mm_storeu_ps(bufR, _mm_cvtepu32_ps(a));
+    for (size_t i=0; i<4; ++i)
+    {
+        ASSERT_EQ(float(bufA[i]), bufR[i]) << bufA[i];
+    }
+}
+
+
+/// Checks the conversions of 64-bit lanes to floating point against the compiler's
+static RMGR_NOINLINE void assert_cvtepi64(const __m128i& a)
+{
+    int64_t bufA[2];
+    double  bufI[2], bufU[2], bufIF[2], bufUF[2];
+    float   bufF[4], bufFF[4];
+    store(bufA,  a);
+    store(bufI,  _mm_cvtepi64_pd(a));
+    store(bufU,  _mm_cvtepu64_pd(a));
+    store(bufIF, _mm_cvtepi64_pd_fast(a));
+    store(bufUF, _mm_cvtepu64_pd_fast(a));
+    _mm_storeu_ps(bufF,  _mm_cvtepi64_ps(a));
+    _mm_storeu_ps(bufFF, _mm_cvtepi64_ps_fast(a));
+    for (size_t i=0; i<2; ++i)
+    {
+        const int64_t  s = bufA[i];
+        const uint64_t u = uint64_t(s);
+        ASSERT_EQ(double(s), bufI[i]) << s;
+        ASSERT_EQ(double(u), bufU[i]) << u;
+        ASSERT_EQ(float(s),  bufF[i]) << s;
+        if (s > -(INT64_C(1) << 51) && s < (INT64_C(1) << 51))
+        {
+            ASSERT_EQ(double(s), bufIF[i]) << s;
+            ASSERT_EQ(float(s),  bufFF[i]) << s;
+        }
+        if (u < (UINT64_C(1) << 52))
+        {
+            ASSERT_EQ(double(u), bufUF[i]) << u;
+        }
+    }
+    ASSERT_EQ(0.0f, bufF[2]);
+    ASSERT_EQ(0.0f, bufF[3]);
+}
+
+
+/// Checks the truncating conversions of doubles to 64-bit lanes, out of range values giving the
+/// integer indefinite value
+static RMGR_NOINLINE void assert_cvttpd(const __m128d& a)
+{
+    double   bufA[2];
+    int64_t  bufI[2], bufIF[2];
+    uint64_t bufU[2], bufUF[2];
+    store(bufA,  a);
+    store(bufI,  _mm_cvttpd_epi64(a));
+    store(bufU,  _mm_cvttpd_epu64(a));
+    store(bufIF, _mm_cvttpd_epi64_fast(a));
+    store(bufUF, _mm_cvttpd_epu64_fast(a));
+    for (size_t i=0; i<2; ++i)
+    {
+        const double   d = bufA[i];
+        const int64_t  s = (d >= -9223372036854775808.0 && d < 9223372036854775808.0) ? int64_t(d)  : INT64_MIN;  // False for NaNs
+        const uint64_t u = (d > -1.0 && d < 18446744073709551616.0)                    ? uint64_t(d) : UINT64_MAX;
+        ASSERT_EQ(s, bufI[i]) << d;
+        ASSERT_EQ(u, bufU[i]) << d;
+        if (d > -2251799813685248.0 && d < 2251799813685248.0) // 2^51
+        {
+            ASSERT_EQ(s, bufIF[i]) << d;
+        }
+        if (d >= 0.0 && d < 4503599627370496.0) // 2^52
+        {
+            ASSERT_EQ(u, bufUF[i]) << d;
+        }
+    }
+}
+
+
+static double double_from_bits(uint64_t bits)
+{
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+
+TEST(IS, conversions)
+{
+    // Integers of every magnitude, some of them with all ones below the leading one
+    uint64_t seed = 0x0123456789ABCDEFull;
+    for (unsigned i=0; i<100000; ++i)
+    {
+        uint64_t r[2];
+        for (unsigned j=0; j<2; ++j)
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            const uint64_t x = seed >> (seed & 63);
+            r[j] = (j == 0) ? x : ((seed >> 6) & 1) ? ~x : (x | (x >> 1) | (x >> 2) | (x >> 3));
+        }
+        const __m128i a = _mm_set_epi64x(int64_t(r[1]), int64_t(r[0]));
+        assert_cvtepu32(a);
+        assert_cvtepi64(a);
+    }
+
+    // Values rounding to even or right above a tie, which would be rounded twice through double
+    const int64_t edges[] = {0, 1, -1, INT64_MIN, INT64_MAX, 0xFFFFFFFFll, 0x80000000ll, 0xFFFFFF80ll, 0xFFFFFF7Fll, 0x1000001ll,
+                             (INT64_C(1) << 53) + 1, (INT64_C(1) << 51) - 1, -(INT64_C(1) << 51) + 1, (INT64_C(1) << 47), -(INT64_C(1) << 47) - 1,
+                             (INT64_C(1) << 60) + (INT64_C(1) << 36) + 1, (INT64_C(1) << 60) + (INT64_C(1) << 36),
+                             -(INT64_C(1) << 60) - (INT64_C(1) << 36) - 1, (INT64_C(1) << 50) + (INT64_C(1) << 26) + 1};
+    const size_t edgeCount = sizeof(edges) / sizeof(edges[0]);
+    for (size_t i=0; i<edgeCount; ++i)
+    {
+        const __m128i a = _mm_set_epi64x(edges[i], edges[(i + 1) % edgeCount]);
+        assert_cvtepu32(a);
+        assert_cvtepi64(a);
+    }
+
+    // Doubles of every sign and magnitude from 1/8 to 2^66, with pseudo-random mantissas
+    for (unsigned i=0; i<100000; ++i)
+    {
+        double d[2];
+        for (unsigned j=0; j<2; ++j)
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            const uint64_t exponent = 1023 - 3 + (seed >> 57) % 70;
+            d[j] = double_from_bits((seed & 0x800FFFFFFFFFFFFFull) | (exponent << 52));
+        }
+        assert_cvttpd(_mm_set_pd(d[1], d[0]));
+    }
+
+    const double inf = std::numeric_limits<double>::infinity();
+    const double specials[] = {0.0, -0.0, 0.5, -0.5, 0.9999999999999999, -0.9999999999999999, 1.0, -1.0, 1.5, -2.5,
+                               inf, -inf, std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::denorm_min(),
+                               2251799813685247.5, -2251799813685247.5, 4503599627370495.5, 4503599627370496.0,
+                               9223372036854774784.0, 9223372036854775808.0, -9223372036854775808.0, -9223372036854777856.0,
+                               18446744073709549568.0, 18446744073709551616.0};
+    const size_t specialCount = sizeof(specials) / sizeof(specials[0]);
+    for (size_t i=0; i<specialCount; ++i)
+    {
+        assert_cvttpd(_mm_set_pd(specials[i], specials[(i + 1) % specialCount]));
+    }
+}
+
+
+/// Checks that the lanes of r are the low lanes of a, widened
+template<typename From, typename To>
+static RMGR_NOINLINE void assert_widening(const __m128i& a, const __m128i& r)
+{
+    From bufA[sizeof(__m128i) / sizeof(From)];
+    To   bufR[sizeof(__m128i) / sizeof(To)];
+    store(bufA, a);
+    store(bufR, r);
+    for (size_t i=0; i<sizeof(__m128i)/sizeof(To); ++i)
+    {
+        ASSERT_EQ(To(bufA[i]), bufR[i]) << i;
+    }
+}
+
+
+/// Checks the narrowings of the lanes of a into the low lanes of r, the upper ones being zero
+template<typename From, typename To>
+static RMGR_NOINLINE void assert_narrowing(const __m128i& a, const __m128i& r, bool saturate)
+{
+    const size_t length = sizeof(__m128i) / sizeof(From);
+    From bufA[length];
+    To   bufR[sizeof(__m128i) / sizeof(To)];
+    store(bufA, a);
+    store(bufR, r);
+    for (size_t i=0; i<length; ++i)
+    {
+        To expected = To(bufA[i]);
+        if (saturate && bufA[i] < From(std::numeric_limits<To>::min()))
+            expected = std::numeric_limits<To>::min();
+        if (saturate && bufA[i] > From(std::numeric_limits<To>::max()))
+            expected = std::numeric_limits<To>::max();
+        ASSERT_EQ(expected, bufR[i]) << i;
+    }
+    for (size_t i=length; i<sizeof(__m128i)/sizeof(To); ++i)
+    {
+        ASSERT_EQ(To(0), bufR[i]) << i;
+    }
+}
+
+
+TEST(IS, widening_narrowing)
+{
+    // Every lane width gets values around its extremes, amid pseudo-random bytes
+    const int64_t extremes[] = {INT64_MIN, INT64_MIN+1, -1, 0, 1, INT64_MAX, INT32_MIN, INT32_MIN-1ll, INT32_MAX, INT32_MAX+1ll,
+                                UINT32_MAX, UINT32_MAX+1ll, INT16_MIN, INT16_MAX, UINT16_MAX, UINT16_MAX+1ll, INT8_MIN, INT8_MAX, UINT8_MAX};
+    uint64_t seed = 0x0123456789ABCDEFull;
+    for (unsigned i=0; i<10000; ++i)
+    {
+        int64_t lanes[2];
+        for (unsigned j=0; j<2; ++j)
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            const int64_t e = extremes[(seed >> 40) % (sizeof(extremes) / sizeof(extremes[0]))];
+            lanes[j] = (seed & 1) ? int64_t(seed) : e;
+        }
+        const __m128i a = _mm_set_epi64x(lanes[1], lanes[0]);
+        const __m128i b = _mm_shuffle_epi32(a, _MM_SHUFFLE(0,1,2,3));
+        const __m128i c = _mm_unpacklo_epi16(a, b); // Mixes 16 and 32-bit extremes up
+
+        for (int k=0; k<3; ++k)
+        {
+            const __m128i& v = (k == 0) ? a : (k == 1) ? b : c;
+            assert_widening<uint8_t,  uint16_t>(v, _mm_cvtepu8_epi16(v));
+            assert_widening<uint8_t,  uint32_t>(v, _mm_cvtepu8_epi32(v));
+            assert_widening<uint8_t,  uint64_t>(v, _mm_cvtepu8_epi64(v));
+            assert_widening<uint16_t, uint32_t>(v, _mm_cvtepu16_epi32(v));
+            assert_widening<uint16_t, uint64_t>(v, _mm_cvtepu16_epi64(v));
+            assert_widening<uint32_t, uint64_t>(v, _mm_cvtepu32_epi64(v));
+            assert_widening<int8_t,   int16_t>( v, _mm_cvtepi8_epi16(v));
+            assert_widening<int8_t,   int32_t>( v, _mm_cvtepi8_epi32(v));
+            assert_widening<int8_t,   int64_t>( v, _mm_cvtepi8_epi64(v));
+            assert_widening<int16_t,  int32_t>( v, _mm_cvtepi16_epi32(v));
+            assert_widening<int16_t,  int64_t>( v, _mm_cvtepi16_epi64(v));
+            assert_widening<int32_t,  int64_t>( v, _mm_cvtepi32_epi64(v));
+
+            assert_narrowing<int32_t,  uint8_t>( v, _mm_cvtepi32_epi8(v),    false);
+            assert_narrowing<int64_t,  int32_t>( v, _mm_cvtsepi64_epi32(v),  true);
+            assert_narrowing<uint64_t, uint32_t>(v, _mm_cvtusepi64_epi32(v), true);
+
+            // _mm_packus_epi32() fills the low half from a and the high one from b
+            int32_t  bufV[4];
+            uint16_t bufR[8];
+            store(bufV, v);
+            store(bufR, _mm_packus_epi32(v, a));
+            for (size_t l=0; l<4; ++l)
+            {
+                ASSERT_EQ(uint16_t(bufV[l] < 0 ? 0 : bufV[l] > 65535 ? 65535 : bufV[l]), bufR[l]) << bufV[l];
+            }
+            store(bufV, a);
+            for (size_t l=0; l<4; ++l)
+            {
+                ASSERT_EQ(uint16_t(bufV[l] < 0 ? 0 : bufV[l] > 65535 ? 65535 : bufV[l]), bufR[4+l]) << bufV[l];
+            }
+        }
+    }
+}
+
+
+/// Checks that the lanes of r come from b where bit i of mask is set, from a otherwise
+template<typename Scalar>
+static RMGR_NOINLINE void assert_blend(const __m128i& a, const __m128i& b, const __m128i& r, unsigned mask)
+{
+    const size_t length = sizeof(__m128i) / sizeof(Scalar);
+    Scalar bufA[length];
+    Scalar bufB[length];
+    Scalar bufR[length];
+    store(bufA, a);
+    store(bufB, b);
+    store(bufR, r);
+    for (size_t i=0; i<length; ++i)
+    {
+        ASSERT_EQ(((mask >> i) & 1) ? bufB[i] : bufA[i], bufR[i]) << mask << ' ' << i;
+    }
+}
+
+
+namespace {
+
+/// Checks the immediate blends for a given immediate
+struct ImmediateBlends
+{
+    template<int N>
+    static void run(const __m128i& a, const __m128i& b)
+    {
+        assert_blend<int16_t>(a, b, _mm_blend_epi16(a, b, N), N);
+        if (N < 16)
+        {
+            const int n = N & 15; // Keeps the immediates in range when N >= 16, for which this is dead code
+            assert_blend<int32_t>(a, b, _mm_blend_epi32(a, b, n), n);
+            assert_blend<int32_t>(a, b, _mm_castps_si128(_mm_blend_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), n)), n);
+        }
+        if (N < 4)
+        {
+            const int n = N & 3;
+            assert_blend<int64_t>(a, b, _mm_castpd_si128(_mm_blend_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b), n)), n);
+        }
+    }
+};
+
+} // namespace
+
+
+TEST(IS, blends)
+{
+    const __m128i a = _mm_setr_epi16(0x0100, 0x0302, 0x0504, 0x0706, 0x0908, 0x0B0A, 0x0D0C, 0x0F0E);
+    const __m128i b = _mm_setr_epi16(-0x0100, -0x0302, -0x0504, -0x0706, -0x0908, -0x0B0A, -0x0D0C, -0x0F0E);
+    ForEachImmediate<255>::run<ImmediateBlends>(a, b);
+
+    // Variable blends only look at the MSB of each lane of the mask
+    uint64_t seed = 0x0F1E2D3C4B5A6978ull;
+    for (unsigned i=0; i<1000; ++i)
+    {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const uint64_t lo = seed;
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const __m128i mask = _mm_set_epi64x(int64_t(seed), int64_t(lo));
+
+        const unsigned msb8  = unsigned(_mm_movemask_epi8(mask));
+        const unsigned msb32 = unsigned(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+        const unsigned msb64 = unsigned(_mm_movemask_pd(_mm_castsi128_pd(mask)));
+        assert_blend<int8_t>( a, b, _mm_blendv_epi8(a, b, mask), msb8);
+        assert_blend<int32_t>(a, b, _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _mm_castsi128_ps(mask))), msb32);
+        assert_blend<int64_t>(a, b, _mm_castpd_si128(_mm_blendv_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b), _mm_castsi128_pd(mask))), msb64);
+    }
+}
+
+
+/// Checks _mm_alignr_epi8() against a byte by byte concatenation
+template<int N>
+static RMGR_NOINLINE void assert_alignr(const __m128i& a, const __m128i& b, const __m128i& r)
+{
+    uint8_t concat[48] = {}; // b, then a, then zeroes
+    uint8_t bufR[16];
+    store(concat,      b);
+    store(concat + 16, a);
+    store(bufR,        r);
+    for (int i=0; i<16; ++i)
+    {
+        ASSERT_EQ((N + i < 48) ? concat[N + i] : 0, bufR[i]) << N << ' ' << i;
+    }
+}
+
+
+/// Checks the SSSE3 instructions on a and b against scalar references
+static RMGR_NOINLINE void assert_ssse3(const __m128i& a, const __m128i& b)
+{
+    int8_t   a8[16], b8[16], r8[16];
+    uint8_t  ua8[16];
+    int16_t  a16[8], b16[8], r16[8];
+    int32_t  a32[4], b32[4], r32[4];
+    store(a8, a);  store(b8, b);  store(ua8, a);
+    store(a16, a); store(b16, b);
+    store(a32, a); store(b32, b);
+
+    store(r8, _mm_shuffle_epi8(a, b));
+    for (int i=0; i<16; ++i)
+    {
+        ASSERT_EQ((b8[i] < 0) ? 0 : a8[b8[i] & 15], r8[i]) << i;
+    }
+
+    store(r8, _mm_sign_epi8(a, b));
+    for (int i=0; i<16; ++i)
+    {
+        ASSERT_EQ(int8_t((b8[i] < 0) ? -a8[i] : (b8[i] == 0) ? 0 : a8[i]), r8[i]) << i;
+    }
+    store(r16, _mm_sign_epi16(a, b));
+    for (int i=0; i<8; ++i)
+    {
+        ASSERT_EQ(int16_t((b16[i] < 0) ? -a16[i] : (b16[i] == 0) ? 0 : a16[i]), r16[i]) << i;
+    }
+    store(r32, _mm_sign_epi32(a, b));
+    for (int i=0; i<4; ++i)
+    {
+        ASSERT_EQ(int32_t((b32[i] < 0) ? 0u-uint32_t(a32[i]) : (b32[i] == 0) ? 0u : uint32_t(a32[i])), r32[i]) << i;
+    }
+
+    // Horizontal operations take their pairs from a for the low half and from b for the high one
+    int16_t hadd16[8], hadds16[8], hsub16[8], hsubs16[8];
+    store(hadd16,  _mm_hadd_epi16(a, b));
+    store(hadds16, _mm_hadds_epi16(a, b));
+    store(hsub16,  _mm_hsub_epi16(a, b));
+    store(hsubs16, _mm_hsubs_epi16(a, b));
+    for (int i=0; i<8; ++i)
+    {
+        const int16_t* src = (i < 4) ? a16 : b16;
+        const int      x   = src[2 * (i % 4)];
+        const int      y   = src[2 * (i % 4) + 1];
+        ASSERT_EQ(int16_t(x + y), hadd16[i]) << i;
+        ASSERT_EQ(int16_t(x - y), hsub16[i]) << i;
+        ASSERT_EQ(int16_t(std::min(std::max(x + y, -32768), 32767)), hadds16[i]) << i;
+        ASSERT_EQ(int16_t(std::min(std::max(x - y, -32768), 32767)), hsubs16[i]) << i;
+    }
+    int32_t hadd32[4], hsub32[4];
+    store(hadd32, _mm_hadd_epi32(a, b));
+    store(hsub32, _mm_hsub_epi32(a, b));
+    for (int i=0; i<4; ++i)
+    {
+        const int32_t* src = (i < 2) ? a32 : b32;
+        ASSERT_EQ(int32_t(uint32_t(src[2 * (i % 2)]) + uint32_t(src[2 * (i % 2) + 1])), hadd32[i]) << i;
+        ASSERT_EQ(int32_t(uint32_t(src[2 * (i % 2)]) - uint32_t(src[2 * (i % 2) + 1])), hsub32[i]) << i;
+    }
+
+    store(r16, _mm_mulhrs_epi16(a, b));
+    for (int i=0; i<8; ++i)
+    {
+        ASSERT_EQ(int16_t(((int32_t(a16[i]) * b16[i] >> 14) + 1) >> 1), r16[i]) << i;
+    }
+
+    store(r16, _mm_maddubs_epi16(a, b));
+    for (int i=0; i<8; ++i)
+    {
+        const int sum = ua8[2*i] * b8[2*i] + ua8[2*i+1] * b8[2*i+1];
+        ASSERT_EQ(int16_t(std::min(std::max(sum, -32768), 32767)), r16[i]) << i;
+    }
+
+    assert_alignr<0>( a, b, _mm_alignr_epi8(a, b, 0));
+    assert_alignr<1>( a, b, _mm_alignr_epi8(a, b, 1));
+    assert_alignr<5>( a, b, _mm_alignr_epi8(a, b, 5));
+    assert_alignr<15>(a, b, _mm_alignr_epi8(a, b, 15));
+    assert_alignr<16>(a, b, _mm_alignr_epi8(a, b, 16));
+    assert_alignr<17>(a, b, _mm_alignr_epi8(a, b, 17));
+    assert_alignr<31>(a, b, _mm_alignr_epi8(a, b, 31));
+    assert_alignr<32>(a, b, _mm_alignr_epi8(a, b, 32));
+}
+
+
+/// Checks a constant byte shuffle against the runtime one
+#define ASSERT_SHUFFLE_EPI8_CONST(a, i0, i1, i2, i3, i4, i5, i6, i7, i8, i9, i10, i11, i12, i13, i14, i15)                                \
+    do                                                                                                                             \
+    {                                                                                                                              \
+        uint8_t expected[16], actual[16];                                                                                          \
+        store(expected, _mm_shuffle_epi8(a, _mm_setr_epi8(i0, i1, i2, i3, i4, i5, i6, i7, i8, i9, i10, i11, i12, i13, i14, i15))); \
+        store(actual,   _mm_shuffle_epi8_const(a, i0, i1, i2, i3, i4, i5, i6, i7, i8, i9, i10, i11, i12, i13, i14, i15));          \
+        for (int n=0; n<16; ++n)                                                                                                   \
+        {                                                                                                                          \
+            ASSERT_EQ(expected[n], actual[n]) << n;                                                                                \
+        }                                                                                                                          \
+    } while (0)
+
+
+TEST(IS, ssse3)
+{
+    // Pseudo-random vectors, with the control of the second one sometimes restricted to valid indices
+    const int16_t extremes[] = {INT16_MIN, INT16_MIN+1, -1, 0, 1, INT16_MAX, INT8_MIN, INT8_MAX, UINT8_MAX, 0x4000, -0x4000};
+    uint64_t seed = 0xFEDCBA9876543210ull;
+    for (unsigned i=0; i<10000; ++i)
+    {
+        int16_t lanes[16];
+        for (unsigned j=0; j<16; ++j)
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            lanes[j] = (seed & 1) ? int16_t(seed >> 32) : extremes[(seed >> 40) % (sizeof(extremes) / sizeof(extremes[0]))];
+        }
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + 8));
+        assert_ssse3(a, b);
+        assert_ssse3(a, _mm_and_si128(b, _mm_set1_epi8(0x0F)));
+
+        ASSERT_SHUFFLE_EPI8_CONST(a, 15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0); // Byte reversal
+        ASSERT_SHUFFLE_EPI8_CONST(a,  4,  5,  6,  7,  0,  1,  2,  3, 12, 13, 14, 15,  8,  9, 10, 11); // Dword permutation
+        ASSERT_SHUFFLE_EPI8_CONST(a,  0,  1,  2,  3,  0,  1,  2,  3,  0,  1,  2,  3,  0,  1,  2,  3); // Dword broadcast
+        ASSERT_SHUFFLE_EPI8_CONST(a,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3); // Byte broadcast
+        ASSERT_SHUFFLE_EPI8_CONST(a, -1,  0, -1,  1, -1,  2, -1,  3, -1,  4, -1,  5, -1,  6, -1,  7); // Interleave with zeroes
+        ASSERT_SHUFFLE_EPI8_CONST(a,  1,  0,  3,  2, 21, 20,  7,  6,  9,  8, 11, 10, -128, 12, 15, 14); // Extra index bits
+    }
+}
+
+#undef ASSERT_SHUFFLE_EPI8_CONST
+
+
+template<typename Scalar>
+static RMGR_NOINLINE void assert_mask_comparison(const __m128i& a, const __m128i& b, unsigned mask, Comparison comp)
+{
+    const size_t length = sizeof(__m128i) / sizeof(Scalar);
+    Scalar bufA[length];
+    Scalar bufB[length];
+    store(bufA, a);
+    store(bufB, b);
+    for (size_t i=0; i<length; ++i)
+    {
+        ASSERT_EQ(((mask >> i) & 1) != 0, compare(bufA[i], bufB[i], comp));
+    }
+    ASSERT_EQ(0u, mask >> length);
+}
+
+
+TEST(IS, epi8_mask_comparisons)
+{
+    const __m128i v[2] = {_mm_set_epi8(-128,-128,-127,-127,-1,-1,0,0,1,1,2,2,126,126,127,127),
+                          _mm_set_epi8(-128,-127,-128,-127,-2,-1,1,0,2,1,1,2,127,126,126,127)};
+    for (int i=0; i<2; ++i)
+    {
+        const __m128i& a = v[i];
+        const __m128i& b = v[1-i];
+        assert_mask_comparison<int8_t>( a, b, _mm_cmpeq_epi8_mask(a,b),  COMP_EQ);
+        assert_mask_comparison<int8_t>( a, b, _mm_cmpneq_epi8_mask(a,b), COMP_NE);
+        assert_mask_comparison<int8_t>( a, b, _mm_cmplt_epi8_mask(a,b),  COMP_LT);
+        assert_mask_comparison<int8_t>( a, b, _mm_cmple_epi8_mask(a,b),  COMP_LE);
+        assert_mask_comparison<int8_t>( a, b, _mm_cmpgt_epi8_mask(a,b),  COMP_GT);
+        assert_mask_comparison<int8_t>( a, b, _mm_cmpge_epi8_mask(a,b),  COMP_GE);
+        assert_mask_comparison<uint8_t>(a, b, _mm_cmpeq_epu8_mask(a,b),  COMP_EQ);
+        assert_mask_comparison<uint8_t>(a, b, _mm_cmpneq_epu8_mask(a,b), COMP_NE);
+        assert_mask_comparison<uint8_t>(a, b, _mm_cmplt_epu8_mask(a,b),  COMP_LT);
+        assert_mask_comparison<uint8_t>(a, b, _mm_cmple_epu8_mask(a,b),  COMP_LE);
+        assert_mask_comparison<uint8_t>(a, b, _mm_cmpgt_epu8_mask(a,b),  COMP_GT);
+        assert_mask_comparison<uint8_t>(a, b, _mm_cmpge_epu8_mask(a,b),  COMP_GE);
+    }
+}
+
+
+TEST(IS, epi16_mask_comparisons)
+{
+    const __m128i v[2] = {_mm_set_epi16(-32768,-32768,-32767,-1,0, 1,32767,32767),
+                          _mm_set_epi16(-32768,-32767,-1,     1,0,-1,    0,32767)};
+    for (int i=0; i<2; ++i)
+    {
+        const __m128i& a = v[i];
+        const __m128i& b = v[1-i];
+        assert_mask_comparison<int16_t>( a, b, _mm_cmpeq_epi16_mask(a,b),  COMP_EQ);
+        assert_mask_comparison<int16_t>( a, b, _mm_cmpneq_epi16_mask(a,b), COMP_NE);
+        assert_mask_comparison<int16_t>( a, b, _mm_cmplt_epi16_mask(a,b),  COMP_LT);
+        assert_mask_comparison<int16_t>( a, b, _mm_cmple_epi16_mask(a,b),  COMP_LE);
+        assert_mask_comparison<int16_t>( a, b, _mm_cmpgt_epi16_mask(a,b),  COMP_GT);
+        assert_mask_comparison<int16_t>( a, b, _mm_cmpge_epi16_mask(a,b),  COMP_GE);
+        assert_mask_comparison<uint16_t>(a, b, _mm_cmpeq_epu16_mask(a,b),  COMP_EQ);
+        assert_mask_comparison<uint16_t>(a, b, _mm_cmpneq_epu16_mask(a,b), COMP_NE);
+        assert_mask_comparison<uint16_t>(a, b, _mm_cmplt_epu16_mask(a,b),  COMP_LT);
+        assert_mask_comparison<uint16_t>(a, b, _mm_cmple_epu16_mask(a,b),  COMP_LE);
+        assert_mask_comparison<uint16_t>(a, b, _mm_cmpgt_epu16_mask(a,b),  COMP_GT);
+        assert_mask_comparison<uint16_t>(a, b, _mm_cmpge_epu16_mask(a,b),  COMP_GE);
+    }
+}
+
+
+TEST(IS, epi32_mask_comparisons)
+{
+    const __m128i v[2] = {_mm_set_epi32(INT32_MIN,INT32_MIN,0,INT32_MAX),
+                          _mm_set_epi32(INT32_MIN,-1,      -1,INT32_MIN)};
+    for (int i=0; i<2; ++i)
+    {
+        const __m128i& a = v[i];
+        const __m128i& b = v[1-i];
+        assert_mask_comparison<int32_t>( a, b, _mm_cmpeq_epi32_mask(a,b),  COMP_EQ);
+        assert_mask_comparison<int32_t>( a, b, _mm_cmpneq_epi32_mask(a,b), COMP_NE);
+        assert_mask_comparison<int32_t>( a, b, _mm_cmplt_epi32_mask(a,b),  COMP_LT);
+        assert_mask_comparison<int32_t>( a, b, _mm_cmple_epi32_mask(a,b),  COMP_LE);
+        assert_mask_comparison<int32_t>( a, b, _mm_cmpgt_epi32_mask(a,b),  COMP_GT);
+        assert_mask_comparison<int32_t>( a, b, _mm_cmpge_epi32_mask(a,b),  COMP_GE);
+        assert_mask_comparison<uint32_t>(a, b, _mm_cmpeq_epu32_mask(a,b),  COMP_EQ);
+        assert_mask_comparison<uint32_t>(a, b, _mm_cmpneq_epu32_mask(a,b), COMP_NE);
+        assert_mask_comparison<uint32_t>(a, b, _mm_cmplt_epu32_mask(a,b),  COMP_LT);
+        assert_mask_comparison<uint32_t>(a, b, _mm_cmple_epu32_mask(a,b),  COMP_LE);
+        assert_mask_comparison<uint32_t>(a, b, _mm_cmpgt_epu32_mask(a,b),  COMP_GT);
+        assert_mask_comparison<uint32_t>(a, b, _mm_cmpge_epu32_mask(a,b),  COMP_GE);
+    }
+}
+
+
+TEST(IS, epi64_mask_comparisons)
+{
+    const __m128i v[3] = {_mm_set_epi64x(INT64_MIN,INT64_MIN), _mm_set_epi64x(INT64_MIN,-1), _mm_set_epi64x(0,INT64_MAX)};
+    for (int i=0; i<3; ++i)
+    {
+        for (int j=0; j<3; ++j)
+        {
+            const __m128i& a = v[i];
+            const __m128i& b = v[j];
+            assert_mask_comparison<int64_t>( a, b, _mm_cmpeq_epi64_mask(a,b),  COMP_EQ);
+            assert_mask_comparison<int64_t>( a, b, _mm_cmpneq_epi64_mask(a,b), COMP_NE);
+            assert_mask_comparison<int64_t>( a, b, _mm_cmplt_epi64_mask(a,b),  COMP_LT);
+            assert_mask_comparison<int64_t>( a, b, _mm_cmple_epi64_mask(a,b),  COMP_LE);
+            assert_mask_comparison<int64_t>( a, b, _mm_cmpgt_epi64_mask(a,b),  COMP_GT);
+            assert_mask_comparison<int64_t>( a, b, _mm_cmpge_epi64_mask(a,b),  COMP_GE);
+            assert_mask_comparison<uint64_t>(a, b, _mm_cmpeq_epu64_mask(a,b),  COMP_EQ);
+            assert_mask_comparison<uint64_t>(a, b, _mm_cmpneq_epu64_mask(a,b), COMP_NE);
+            assert_mask_comparison<uint64_t>(a, b, _mm_cmplt_epu64_mask(a,b),  COMP_LT);
+            assert_mask_comparison<uint64_t>(a, b, _mm_cmple_epu64_mask(a,b),  COMP_LE);
+            assert_mask_comparison<uint64_t>(a, b, _mm_cmpgt_epu64_mask(a,b),  COMP_GT);
+            assert_mask_comparison<uint64_t>(a, b, _mm_cmpge_epu64_mask(a,b),  COMP_GE);
+        }
+    }
+}
+
+
+TEST(IS, cmp_mask_predicates)
+{
+    const __m128i a = _mm_set_epi64x(INT64_MIN, 1);
+    const __m128i b = _mm_set_epi64x(-1,        1);
+    ASSERT_EQ(_mm_cmpeq_epi8_mask(a,b),   _mm_cmp_epi8_mask(a,b,0));
+    ASSERT_EQ(_mm_cmplt_epi8_mask(a,b),   _mm_cmp_epi8_mask(a,b,1));
+    ASSERT_EQ(_mm_cmple_epi8_mask(a,b),   _mm_cmp_epi8_mask(a,b,2));
+    ASSERT_EQ(0,                          _mm_cmp_epi8_mask(a,b,3));
+    ASSERT_EQ(_mm_cmpneq_epi8_mask(a,b),  _mm_cmp_epi8_mask(a,b,4));
+    ASSERT_EQ(_mm_cmpge_epi8_mask(a,b),   _mm_cmp_epi8_mask(a,b,5));
+    ASSERT_EQ(_mm_cmpgt_epi8_mask(a,b),   _mm_cmp_epi8_mask(a,b,6));
+    ASSERT_EQ(0xFFFF,                     _mm_cmp_epi8_mask(a,b,7));
+    ASSERT_EQ(_mm_cmplt_epu8_mask(a,b),   _mm_cmp_epu8_mask(a,b,1));
+    ASSERT_EQ(_mm_cmplt_epi16_mask(a,b),  _mm_cmp_epi16_mask(a,b,1));
+    ASSERT_EQ(_mm_cmpge_epu16_mask(a,b),  _mm_cmp_epu16_mask(a,b,5));
+    ASSERT_EQ(0xFF,                       _mm_cmp_epu16_mask(a,b,7));
+    ASSERT_EQ(_mm_cmple_epi32_mask(a,b),  _mm_cmp_epi32_mask(a,b,2));
+    ASSERT_EQ(_mm_cmpgt_epu32_mask(a,b),  _mm_cmp_epu32_mask(a,b,6));
+    ASSERT_EQ(0x0F,                       _mm_cmp_epu32_mask(a,b,7));
+    ASSERT_EQ(_mm_cmpneq_epi64_mask(a,b), _mm_cmp_epi64_mask(a,b,4));
+    ASSERT_EQ(_mm_cmplt_epu64_mask(a,b),  _mm_cmp_epu64_mask(a,b,1));
+    ASSERT_EQ(0,                          _mm_cmp_epu64_mask(a,b,3));
+    ASSERT_EQ(0x03,                       _mm_cmp_epu64_mask(a,b,7));
+}
+
+
+/// Checks that bit i of mask is the MSB of lane i, and that no bit is set past the last lane
+template<typename Scalar>
+static RMGR_NOINLINE void assert_movemask(const __m128i& a, unsigned mask)
+{
+    const size_t length = sizeof(__m128i) / sizeof(Scalar);
+    Scalar bufA[length];
+    store(bufA, a);
+    for (size_t i=0; i<length; ++i)
+        ASSERT_EQ(bufA[i] < 0, ((mask >> i) & 1) != 0) << i;
+    ASSERT_EQ(0u, mask >> length);
+}
+
+
+/// Checks that the lanes of v are all ones where their bit of k is set, zero otherwise
+template<typename Scalar>
+static RMGR_NOINLINE void assert_movm(unsigned k, const __m128i& v)
+{
+    const size_t length = sizeof(__m128i) / sizeof(Scalar);
+    Scalar bufV[length];
+    store(bufV, v);
+    for (size_t i=0; i<length; ++i)
+        ASSERT_EQ(((k >> i) & 1) ? Scalar(-1) : Scalar(0), bufV[i]) << k << ' ' << i;
+}
+
+
+TEST(IS, movemask)
+{
+    uint64_t seed = 0x0123456789ABCDEFull;
+    for (int i=0; i<1000; ++i)
+    {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const uint64_t lo = seed;
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const __m128i a = _mm_set_epi64x(int64_t(seed), int64_t(lo));
+        assert_movemask<int16_t>(a, unsigned(_mm_movemask_epi16(a)));
+        assert_movemask<int32_t>(a, unsigned(_mm_movemask_epi32(a)));
+        assert_movemask<int64_t>(a, unsigned(_mm_movemask_epi64(a)));
+        assert_movemask<int8_t>( a, _mm_movepi8_mask(a));
+        assert_movemask<int16_t>(a, _mm_movepi16_mask(a));
+        assert_movemask<int32_t>(a, _mm_movepi32_mask(a));
+        assert_movemask<int64_t>(a, _mm_movepi64_mask(a));
+    }
+
+    // The bits past the last lane are ignored, and every mask survives a round trip
+    for (unsigned k=0; k<0x10000; ++k)
+    {
+        assert_movm<int8_t>(k, _mm_movm_epi8(__mmask16(k)));
+        ASSERT_EQ(int(k), _mm_movemask_epi8(_mm_movm_epi8(__mmask16(k))));
+        if (k >= 0x100)
+            continue;
+        assert_movm<int16_t>(k,        _mm_movm_epi16(__mmask8(k)));
+        assert_movm<int32_t>(k & 0x0F, _mm_movm_epi32(__mmask8(k)));
+        assert_movm<int64_t>(k & 0x03, _mm_movm_epi64(__mmask8(k)));
+        ASSERT_EQ(int(k),        _mm_movemask_epi16(_mm_movm_epi16(__mmask8(k))));
+        ASSERT_EQ(int(k & 0x0F), _mm_movemask_epi32(_mm_movm_epi32(__mmask8(k))));
+        ASSERT_EQ(int(k & 0x03), _mm_movemask_epi64(_mm_movm_epi64(__mmask8(k))));
+    }
+}
+
+
+/// Checks the result of a masked operation against that of the unmasked one
+template<typename Scalar>
+static RMGR_NOINLINE void assert_masked(const __m128i& src, unsigned k, const __m128i& full, const __m128i& masked, bool zeroing)
+{
+    const size_t length = sizeof(__m128i) / sizeof(Scalar);
+    Scalar bufSrc[length];
+    Scalar bufFull[length];
+    Scalar bufMasked[length];
+    store(bufSrc,    src);
+    store(bufFull,   full);
+    store(bufMasked, masked);
+    for (size_t i=0; i<length; ++i)
+    {
+        const Scalar expected = ((k >> i) & 1) ? bufFull[i] : (zeroing ? Scalar(0) : bufSrc[i]);
+        ASSERT_EQ(expected, bufMasked[i]);
+    }
+}
+
+
+TEST(IS, mask_operations)
+{
+    const __m128i a   = _mm_set_epi8(-128,-127,-65,-64,-63,-2,-1,0,1,2,3,63,64,65,126,127);
+    const __m128i b   = _mm_set_epi8(1,-1,127,-128,5,-6,7,-8,9,-10,11,-12,13,-14,15,-16);
+    const __m128i src = _mm_set1_epi8(0x5A);
+    const unsigned masks[] = {0x0000, 0xFFFF, 0xA5C3, 0x1234, 0x8001};
+    for (size_t m=0; m<sizeof(masks)/sizeof(masks[0]); ++m)
+    {
+        const __mmask16 k16 = __mmask16(masks[m]);
+        const __mmask8  k8  = __mmask8(masks[m]);
+        const __mmask8  k4  = __mmask8(masks[m] & 0x0F);
+        const __mmask8  k2  = __mmask8(masks[m] & 0x03);
+
+        assert_masked<int8_t>(  a,   k16, b,                   _mm_mask_blend_epi8(k16,a,b),     false);
+        assert_masked<int8_t>(  src, k16, _mm_add_epi8(a,b),   _mm_mask_add_epi8(src,k16,a,b),   false);
+        assert_masked<int8_t>(  src, k16, _mm_add_epi8(a,b),   _mm_maskz_add_epi8(k16,a,b),      true);
+        assert_masked<int8_t>(  src, k16, _mm_sub_epi8(a,b),   _mm_mask_sub_epi8(src,k16,a,b),   false);
+        assert_masked<int8_t>(  src, k16, _mm_sub_epi8(a,b),   _mm_maskz_sub_epi8(k16,a,b),      true);
+        assert_masked<int8_t>(  src, k16, _mm_min_epi8(a,b),   _mm_mask_min_epi8(src,k16,a,b),   false);
+        assert_masked<int8_t>(  src, k16, _mm_max_epi8(a,b),   _mm_maskz_max_epi8(k16,a,b),      true);
+        assert_masked<uint8_t>( src, k16, _mm_min_epu8(a,b),   _mm_maskz_min_epu8(k16,a,b),      true);
+        assert_masked<uint8_t>( src, k16, _mm_max_epu8(a,b),   _mm_mask_max_epu8(src,k16,a,b),   false);
+
+        assert_masked<int16_t>( a,   k8,  b,                   _mm_mask_blend_epi16(k8,a,b),     false);
+        assert_masked<int16_t>( src, k8,  _mm_add_epi16(a,b),  _mm_mask_add_epi16(src,k8,a,b),   false);
+        assert_masked<int16_t>( src, k8,  _mm_sub_epi16(a,b),  _mm_maskz_sub_epi16(k8,a,b),      true);
+        assert_masked<int16_t>( src, k8,  _mm_min_epi16(a,b),  _mm_maskz_min_epi16(k8,a,b),      true);
+        assert_masked<int16_t>( src, k8,  _mm_max_epi16(a,b),  _mm_mask_max_epi16(src,k8,a,b),   false);
+        assert_masked<uint16_t>(src, k8,  _mm_min_epu16(a,b),  _mm_mask_min_epu16(src,k8,a,b),   false);
+        assert_masked<uint16_t>(src, k8,  _mm_max_epu16(a,b),  _mm_maskz_max_epu16(k8,a,b),      true);
+
+        assert_masked<int32_t>( a,   k4,  b,                   _mm_mask_blend_epi32(k4,a,b),     false);
+        assert_masked<int32_t>( src, k4,  _mm_add_epi32(a,b),  _mm_maskz_add_epi32(k4,a,b),      true);
+        assert_masked<int32_t>( src, k4,  _mm_sub_epi32(a,b),  _mm_mask_sub_epi32(src,k4,a,b),   false);
+        assert_masked<int32_t>( src, k4,  _mm_min_epi32(a,b),  _mm_mask_min_epi32(src,k4,a,b),   false);
+        assert_masked<int32_t>( src, k4,  _mm_max_epi32(a,b),  _mm_maskz_max_epi32(k4,a,b),      true);
+        assert_masked<uint32_t>(src, k4,  _mm_min_epu32(a,b),  _mm_maskz_min_epu32(k4,a,b),      true);
+        assert_masked<uint32_t>(src, k4,  _mm_max_epu32(a,b),  _mm_mask_max_epu32(src,k4,a,b),   false);
+        assert_masked<int32_t>( a,   k4,  b,                   _mm_castps_si128(_mm_mask_blend_ps(k4,_mm_castsi128_ps(a),_mm_castsi128_ps(b))), false);
+
+        assert_masked<int64_t>( a,   k2,  b,                   _mm_mask_blend_epi64(k2,a,b),     false);
+        assert_masked<int64_t>( src, k2,  _mm_add_epi64(a,b),  _mm_mask_add_epi64(src,k2,a,b),   false);
+        assert_masked<int64_t>( src, k2,  _mm_sub_epi64(a,b),  _mm_maskz_sub_epi64(k2,a,b),      true);
+        assert_masked<int64_t>( src, k2,  _mm_min_epi64(a,b),  _mm_maskz_min_epi64(k2,a,b),      true);
+        assert_masked<int64_t>( src, k2,  _mm_max_epi64(a,b),  _mm_mask_max_epi64(src,k2,a,b),   false);
+        assert_masked<uint64_t>(src, k2,  _mm_min_epu64(a,b),  _mm_mask_min_epu64(src,k2,a,b),   false);
+        assert_masked<uint64_t>(src, k2,  _mm_max_epu64(a,b),  _mm_maskz_max_epu64(k2,a,b),      true);
+        assert_masked<int64_t>( a,   k2,  b,                   _mm_castpd_si128(_mm_mask_blend_pd(k2,_mm_castsi128_pd(a),_mm_castsi128_pd(b))), false);
+    }
+}
+
+
+/// Checks all the forms of compress & expand for mask k, stored being filled with 0x77 before compressstoreu()
+template<typename Scalar>
+static RMGR_NOINLINE void assert_compress_expand(const __m128i& src, unsigned k, const __m128i& a,
+                                                 const __m128i& maskzCompress, const __m128i& maskCompress, const uint8_t* stored,
+                                                 const __m128i& maskzExpand,   const __m128i& maskExpand)
+{
+    const size_t length = sizeof(__m128i) / sizeof(Scalar);
+    Scalar bufSrc[length];
+    Scalar bufA[length];
+    Scalar bufMaskzCompress[length];
+    Scalar bufMaskCompress[length];
+    Scalar bufMaskzExpand[length];
+    Scalar bufMaskExpand[length];
+    store(bufSrc,           src);
+    store(bufA,             a);
+    store(bufMaskzCompress, maskzCompress);
+    store(bufMaskCompress,  maskCompress);
+    store(bufMaskzExpand,   maskzExpand);
+    store(bufMaskExpand,    maskExpand);
+
+    size_t n = 0;
+    for (size_t i=0; i<length; ++i)
+    {
+        if ((k >> i) & 1)
+        {
+            ASSERT_EQ(bufA[i], bufMaskzCompress[n]) << k << ' ' << i;
+            ASSERT_EQ(bufA[i], bufMaskCompress[n])  << k << ' ' << i;
+            ASSERT_EQ(0, memcmp(&bufA[i], stored + n * sizeof(Scalar), sizeof(Scalar))) << k << ' ' << i;
+            ASSERT_EQ(bufA[n], bufMaskzExpand[i]) << k << ' ' << i;
+            ASSERT_EQ(bufA[n], bufMaskExpand[i])  << k << ' ' << i;
+            ++n;
+        }
+        else
+        {
+            ASSERT_EQ(Scalar(0), bufMaskzExpand[i]) << k << ' ' << i;
+            ASSERT_EQ(bufSrc[i], bufMaskExpand[i])  << k << ' ' << i;
+        }
+    }
+    for (size_t i=n; i<length; ++i)
+    {
+        ASSERT_EQ(Scalar(0), bufMaskzCompress[i]) << k << ' ' << i;
+        ASSERT_EQ(bufSrc[i], bufMaskCompress[i])  << k << ' ' << i;
+    }
+    for (size_t i=n*sizeof(Scalar); i<sizeof(__m128i); ++i)
+        ASSERT_EQ(0x77, stored[i]) << k << ' ' << i;
+}
+
+
+TEST(IS, compress_expand)
+{
+    // Distinct non-zero bytes, hence distinct non-zero lanes of every width
+    const __m128i a   = _mm_setr_epi8(1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16);
+    const __m128i src = _mm_set1_epi8(0x5A);
+    uint8_t stored[sizeof(__m128i)];
+    for (unsigned k=0; k<0x10000; ++k)
+    {
+        const __mmask16 k16 = __mmask16(k);
+        memset(stored, 0x77, sizeof(stored));
+        _mm_mask_compressstoreu_epi8(stored, k16, a);
+        assert_compress_expand<int8_t>(src, k, a, _mm_maskz_compress_epi8(k16,a), _mm_mask_compress_epi8(src,k16,a), stored,
+                                                  _mm_maskz_expand_epi8(k16,a),   _mm_mask_expand_epi8(src,k16,a));
+        if (k >= 0x100)
+            continue;
+
+        const __mmask8 k8 = __mmask8(k);
+        memset(stored, 0x77, sizeof(stored));
+        _mm_mask_compressstoreu_epi16(stored, k8, a);
+        assert_compress_expand<int16_t>(src, k, a, _mm_maskz_compress_epi16(k8,a), _mm_mask_compress_epi16(src,k8,a), stored,
+                                                   _mm_maskz_expand_epi16(k8,a),   _mm_mask_expand_epi16(src,k8,a));
+
+        // The bits above the number of lanes are ignored
+        memset(stored, 0x77, sizeof(stored));
+        _mm_mask_compressstoreu_epi32(stored, k8, a);
+        assert_compress_expand<int32_t>(src, k & 0x0F, a, _mm_maskz_compress_epi32(k8,a), _mm_mask_compress_epi32(src,k8,a), stored,
+                                                          _mm_maskz_expand_epi32(k8,a),   _mm_mask_expand_epi32(src,k8,a));
+        memset(stored, 0x77, sizeof(stored));
+        _mm_mask_compressstoreu_epi64(stored, k8, a);
+        assert_compress_expand<int64_t>(src, k & 0x03, a, _mm_maskz_compress_epi64(k8,a), _mm_mask_compress_epi64(src,k8,a), stored,
+                                                          _mm_maskz_expand_epi64(k8,a),   _mm_mask_expand_epi64(src,k8,a));
+    }
+}
@@ -0,0 +1,374 @@
+#include <rmgr/fib/vec.h>
+#include <gtest/gtest.h>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+
+template<typename T>
+struct VecTestValues
+{
+    static const size_t COUNT = 10;
+
+    static T get(size_t i)
+    {
+        typedef std::numeric_limits<T> limits;
+        const T values[COUNT] = {limits::min(), T(limits::min()+1), T(-1), 0, 1, 2, T(0x55), T(limits::max()/3), T(limits::max()-1), limits::max()};
+        return values[i % COUNT];
+    }
+};
+
+template<>
+struct VecTestValues<float>
+{
+    static const size_t COUNT = 10;
+
+    static float get(size_t i)
+    {
+        const float values[COUNT] = {-FLT_MAX, -1.5f, -0.0f, 0.0f, FLT_MIN, 1.0f, 2.5f, 3.0f, 1e10f, FLT_MAX};
+        return values[i % COUNT];
+    }
+};
+
+template<>
+struct VecTestValues<double>
+{
+    static const size_t COUNT = 10;
+
+    static double get(size_t i)
+    {
+        const double values[COUNT] = {-DBL_MAX, -1.5, -0.0, 0.0, DBL_MIN, 1.0, 2.5, 3.0, 1e300, DBL_MAX};
+        return values[i % COUNT];
+    }
+};
+
+
+/// Whether the lanes of a mask are all set where `expected` is true and all clear elsewhere
+template<typename T, unsigned N>
+static RMGR_NOINLINE void assert_vec_mask(const rmgr::fib::vec_mask<T, N>& mask, const bool (&expected)[N])
+{
+    uint8_t bytes[sizeof(T) * N];
+    memcpy(bytes, &mask.native(), sizeof(bytes));
+    bool any = false, all = true;
+    for (unsigned i=0; i<N; ++i)
+    {
+        for (size_t j=0; j<sizeof(T); ++j)
+            ASSERT_EQ(expected[i] ? 0xFF : 0x00, bytes[i*sizeof(T) + j]);
+        any |= expected[i];
+        all &= expected[i];
+    }
+    ASSERT_EQ(any,  mask.any());
+    ASSERT_EQ(all,  mask.all());
+    ASSERT_EQ(!any, mask.none());
+}
+
+
+/// Compares lanes bitwise, so that -0.0 and 0.0 are told apart
+template<typename T>
+static bool same_bits(T a, T b)
+{
+    return memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+
+template<typename T, unsigned N>
+static RMGR_NOINLINE void assert_vec_common(const rmgr::fib::vec<T, N>& a, const rmgr::fib::vec<T, N>& b)
+{
+    T bufA[N], bufB[N], bufMin[N], bufMax[N], bufSel[N];
+    a.storeu(bufA);
+    b.storeu(bufB);
+    min(a, b).storeu(bufMin);
+    max(a, b).storeu(bufMax);
+    select(a < b, a, b).storeu(bufSel);
+    bool eq[N], ne[N], lt[N], le[N], gt[N], ge[N];
+    for (unsigned i=0; i<N; ++i)
+    {
+        eq[i] = compare(bufA[i], bufB[i], COMP_EQ);
+        ne[i] = compare(bufA[i], bufB[i], COMP_NE);
+        lt[i] = compare(bufA[i], bufB[i], COMP_LT);
+        le[i] = compare(bufA[i], bufB[i], COMP_LE);
+        gt[i] = compare(bufA[i], bufB[i], COMP_GT);
+        ge[i] = compare(bufA[i], bufB[i], COMP_GE);
+        ASSERT_TRUE(same_bits<T>((bufA[i] < bufB[i]) ? bufA[i] : bufB[i], bufMin[i]));
+        ASSERT_TRUE(same_bits<T>((bufA[i] > bufB[i]) ? bufA[i] : bufB[i], bufMax[i]));
+        ASSERT_TRUE(same_bits<T>(lt[i] ? bufA[i] : bufB[i], bufSel[i]));
+    }
+    assert_vec_mask(a == b, eq);
+    assert_vec_mask(a != b, ne);
+    assert_vec_mask(a <  b, lt);
+    assert_vec_mask(a <= b, le);
+    assert_vec_mask(a >  b, gt);
+    assert_vec_mask(a >= b, ge);
+    assert_vec_mask((a < b) | (a == b), le);
+    assert_vec_mask((a <= b) & (a >= b), eq);
+    assert_vec_mask((a <= b) ^ (a >= b), ne);
+    assert_vec_mask(~(a < b), ge);
+}
+
+
+template<typename T, unsigned N>
+static RMGR_NOINLINE void assert_vec_int(const rmgr::fib::vec<T, N>& a, const rmgr::fib::vec<T, N>& b)
+{
+    typedef typename std::make_unsigned<T>::type U;
+    const unsigned bits = 8 * sizeof(T);
+    T counts[N];
+    for (unsigned i=0; i<N; ++i)
+        counts[i] = T(i % bits);
+    const rmgr::fib::vec<T, N> c = rmgr::fib::vec<T, N>::loadu(counts);
+
+    T bufA[N], bufB[N], bufAdd[N], bufSub[N], bufNeg[N], bufAnd[N], bufOr[N], bufXor[N], bufNot[N], bufAbs[N];
+    T bufShl[N], bufShr[N], bufShlv[N], bufShrv[N];
+    a.storeu(bufA);
+    b.storeu(bufB);
+    (a + b).storeu(bufAdd);
+    (a - b).storeu(bufSub);
+    (-a).storeu(bufNeg);
+    (a & b).storeu(bufAnd);
+    (a | b).storeu(bufOr);
+    (a ^ b).storeu(bufXor);
+    (~a).storeu(bufNot);
+    abs(a).storeu(bufAbs);
+    (a << 3).storeu(bufShl);
+    (a >> 3).storeu(bufShr);
+    (a << c).storeu(bufShlv);
+    (a >> c).storeu(bufShrv);
+    for (unsigned i=0; i<N; ++i)
+    {
+        const T x = bufA[i], y = bufB[i];
+        ASSERT_EQ(T(U(x) + U(y)),  bufAdd[i]);
+        ASSERT_EQ(T(U(x) - U(y)),  bufSub[i]);
+        ASSERT_EQ(T(U(0) - U(x)),  bufNeg[i]);
+        ASSERT_EQ(T(x & y),        bufAnd[i]);
+        ASSERT_EQ(T(x | y),        bufOr[i]);
+        ASSERT_EQ(T(x ^ y),        bufXor[i]);
+        ASSERT_EQ(T(~x),           bufNot[i]);
+        ASSERT_EQ(T(x < 0 ? U(0) - U(x) : U(x)), bufAbs[i]);
+        ASSERT_EQ(T(U(x) << 3),    bufShl[i]);
+        ASSERT_EQ(T(x >> 3),       bufShr[i]);
+        ASSERT_EQ(T(U(x) << counts[i]), bufShlv[i]);
+        ASSERT_EQ(T(x >> counts[i]),    bufShrv[i]);
+    }
+    assert_vec_common(a, b);
+}
+
+
+template<typename T, unsigned N>
+static RMGR_NOINLINE void assert_vec_fp(const rmgr::fib::vec<T, N>& a, const rmgr::fib::vec<T, N>& b)
+{
+    T bufA[N], bufB[N], bufAdd[N], bufSub[N], bufMul[N], bufDiv[N], bufNeg[N], bufAbs[N], bufAndNot[N];
+    a.storeu(bufA);
+    b.storeu(bufB);
+    (a + b).storeu(bufAdd);
+    (a - b).storeu(bufSub);
+    (a * b).storeu(bufMul);
+    (a / b).storeu(bufDiv);
+    (-a).storeu(bufNeg);
+    abs(a).storeu(bufAbs);
+    (a & ~rmgr::fib::vec<T, N>(T(-0.0))).storeu(bufAndNot); // Clears the sign bit
+    for (unsigned i=0; i<N; ++i)
+    {
+        const T x = bufA[i], y = bufB[i];
+        ASSERT_TRUE(same_bits<T>(x + y,         bufAdd[i]));
+        ASSERT_TRUE(same_bits<T>(x - y,         bufSub[i]));
+        ASSERT_TRUE(same_bits<T>(x * y,         bufMul[i]));
+        ASSERT_TRUE(same_bits<T>(x / y,         bufDiv[i]));
+        ASSERT_EQ(-x, bufNeg[i]); // 0 - x, like the intrinsic, so the sign of zero is not flipped
+        ASSERT_TRUE(same_bits<T>(std::fabs(x),  bufAbs[i]));
+        ASSERT_TRUE(same_bits<T>(std::fabs(x),  bufAndNot[i]));
+    }
+    assert_vec_common(a, b);
+}
+
+
+/// Runs a check on every pair of test values
+template<typename T, unsigned N>
+static void check_vec(void (*check)(const rmgr::fib::vec<T, N>&, const rmgr::fib::vec<T, N>&))
+{
+    typedef VecTestValues<T> Values;
+    for (size_t offset=0; offset<Values::COUNT; ++offset)
+    {
+        for (size_t shift=0; shift<Values::COUNT; ++shift)
+        {
+            T bufA[N], bufB[N];
+            for (unsigned i=0; i<N; ++i)
+            {
+                bufA[i] = Values::get(offset + i);
+                bufB[i] = Values::get(offset + i + shift);
+            }
+            check(rmgr::fib::vec<T, N>::loadu(bufA), rmgr::fib::vec<T, N>::loadu(bufB));
+            if (::testing::Test::HasFatalFailure())
+                return;
+        }
+    }
+}
+
+
+TEST(IS, vec_integers)
+{
+    check_vec<int8_t,   16>(assert_vec_int<int8_t,   16>);
+    check_vec<uint8_t,  16>(assert_vec_int<uint8_t,  16>);
+    check_vec<int16_t,   8>(assert_vec_int<int16_t,   8>);
+    check_vec<uint16_t,  8>(assert_vec_int<uint16_t,  8>);
+    check_vec<int32_t,   4>(assert_vec_int<int32_t,   4>);
+    check_vec<uint32_t,  4>(assert_vec_int<uint32_t,  4>);
+    check_vec<int64_t,   2>(assert_vec_int<int64_t,   2>);
+    check_vec<uint64_t,  2>(assert_vec_int<uint64_t,  2>);
+}
+
+
+TEST(IS, vec_floating_point)
+{
+    check_vec<float,  4>(assert_vec_fp<float,  4>);
+    check_vec<double, 2>(assert_vec_fp<double, 2>);
+}
+
+
+TEST(IS, vec_raw_interop)
+{
+    // Conversions both ways, so that raw intrinsics can be mixed in
+    typedef rmgr::fib::vec<uint32_t, 4> u32x4;
+    const u32x4   a(7);
+    const __m128i b = a + u32x4(_mm_set1_epi32(-1));
+    ASSERT_EQ(6, _mm_cvtsi128_si32(b));
+    ASSERT_TRUE((u32x4(b) > u32x4::zero()).all());
+    ASSERT_TRUE((u32x4(_mm_set1_epi32(-1)) > a).all()); // Unsigned comparison
+}
+
+
+/// Checks the division of each lane of `n` by `d` against the scalar one
+template<typename T>
+static RMGR_NOINLINE void assert_divisor(const rmgr::fib::divisor<T>& d, const typename rmgr::fib::divisor<T>::vec_type& n)
+{
+    typedef typename std::make_unsigned<T>::type U;
+    const unsigned N = 16 / sizeof(T);
+    T bufN[N], bufQ[N], bufR[N];
+    n.storeu(bufN);
+    (n / d).storeu(bufQ);
+    (n % d).storeu(bufR);
+    for (unsigned i=0; i<N; ++i)
+    {
+        // The minimum divided by -1 overflows, and wraps around
+        const bool wraps = std::is_signed<T>::value && d.value() == T(-1);
+        ASSERT_EQ(wraps ? T(U(0) - U(bufN[i])) : T(bufN[i] / d.value()), bufQ[i]);
+        ASSERT_EQ(wraps ? T(0)           : T(bufN[i] % d.value()), bufR[i]);
+    }
+}
+
+
+/// Divisors worth checking: small ones, powers of 2 and their neighbours, extremes
+template<typename T>
+static std::vector<T> test_divisors()
+{
+    typedef std::numeric_limits<T> limits;
+    typedef typename std::make_unsigned<T>::type U;
+    std::vector<T> divisors;
+    for (int d=1; d<=40; ++d)
+        divisors.push_back(T(d));
+    for (unsigned s=6; s<8*sizeof(T); ++s)
+    {
+        const U p = U(U(1) << s);
+        divisors.push_back(T(p - 1));
+        divisors.push_back(T(p));
+        divisors.push_back(T(p + 1));
+    }
+    divisors.push_back(T(limits::max() - 1));
+    divisors.push_back(limits::max());
+    divisors.push_back(T(limits::max() / 3));
+    divisors.push_back(T(0x2F1D));
+    if (std::is_signed<T>::value)
+    {
+        const size_t count = divisors.size();
+        for (size_t i=0; i<count; ++i)
+            divisors.push_back(T(U(0) - U(divisors[i])));
+        divisors.push_back(limits::min());
+    }
+    return divisors;
+}
+
+
+/// All the 16-bit dividends
+template<typename T>
+static void check_divisor_16(T d)
+{
+    const rmgr::fib::divisor<T> divisor(d);
+    for (int n=0; n<0x10000; n+=8)
+    {
+        assert_divisor(divisor, typename rmgr::fib::divisor<T>::vec_type(_mm_add_epi16(_mm_set1_epi16(int16_t(n)), _mm_set_epi16(7,6,5,4,3,2,1,0))));
+        if (::testing::Test::HasFatalFailure())
+            return;
+    }
+}
+
+
+/// The extremes, small dividends and pseudo-random ones
+template<typename T>
+static void check_divisor_wide(T d)
+{
+    typedef std::numeric_limits<T> limits;
+    typedef typename std::make_unsigned<T>::type U;
+    const unsigned N = 16 / sizeof(T);
+    const rmgr::fib::divisor<T> divisor(d);
+    const T extremes[] = {limits::min(), T(limits::min()+1), T(-2), T(-1), 0, 1, 2, T(limits::max()-1), limits::max(),
+                          d, T(U(d) - 1), T(U(d) + 1), T(U(0) - U(d))};
+    uint64_t seed = uint64_t(d);
+    T buf[N];
+    for (size_t i=0; i<sizeof(extremes)/sizeof(extremes[0]) + 64*N; ++i)
+    {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        buf[i % N] = (i < sizeof(extremes)/sizeof(extremes[0])) ? extremes[i] : T(seed >> (i % 40)); // Varying magnitudes
+        if (i % N == N-1)
+        {
+            assert_divisor(divisor, rmgr::fib::divisor<T>::vec_type::loadu(buf));
+            if (::testing::Test::HasFatalFailure())
+                return;
+        }
+    }
+}
+
+
+TEST(IS, vec_divisor)
+{
+    const std::vector<int16_t>  i16 = test_divisors<int16_t>();
+    const std::vector<uint16_t> u16 = test_divisors<uint16_t>();
+    const std::vector<int32_t>  i32 = test_divisors<int32_t>();
+    const std::vector<uint32_t> u32 = test_divisors<uint32_t>();
+    const std::vector<int64_t>  i64 = test_divisors<int64_t>();
+    const std::vector<uint64_t> u64 = test_divisors<uint64_t>();
+    for (size_t i=0; i<i16.size(); ++i) { check_divisor_16(i16[i]);   ASSERT_FALSE(HasFatalFailure()) << i16[i]; }
+    for (size_t i=0; i<u16.size(); ++i) { check_divisor_16(u16[i]);   ASSERT_FALSE(HasFatalFailure()) << u16[i]; }
+    for (size_t i=0; i<i32.size(); ++i) { check_divisor_wide(i32[i]); ASSERT_FALSE(HasFatalFailure()) << i32[i]; }
+    for (size_t i=0; i<u32.size(); ++i) { check_divisor_wide(u32[i]); ASSERT_FALSE(HasFatalFailure()) << u32[i]; }
+    for (size_t i=0; i<i64.size(); ++i) { check_divisor_wide(i64[i]); ASSERT_FALSE(HasFatalFailure()) << i64[i]; }
+    for (size_t i=0; i<u64.size(); ++i) { check_divisor_wide(u64[i]); ASSERT_FALSE(HasFatalFailure()) << u64[i]; }
+}
+
+
+#if INTERNAL_RMGR_FIB_USE_AVX
+
+TEST(IS, vec256_floating_point)
+{
+    check_vec<float,  8>(assert_vec_fp<float,  8>);
+    check_vec<double, 4>(assert_vec_fp<double, 4>);
+}
+
+#endif // INTERNAL_RMGR_FIB_USE_AVX
+
+
+#if INTERNAL_RMGR_FIB_USE_AVX2
+
+TEST(IS, vec256_integers)
+{
+    check_vec<int8_t,   32>(assert_vec_int<int8_t,   32>);
+    check_vec<uint8_t,  32>(assert_vec_int<uint8_t,  32>);
+    check_vec<int16_t,  16>(assert_vec_int<int16_t,  16>);
+    check_vec<uint16_t, 16>(assert_vec_int<uint16_t, 16>);
+    check_vec<int32_t,   8>(assert_vec_int<int32_t,   8>);
+    check_vec<uint32_t,  8>(assert_vec_int<uint32_t,  8>);
+    check_vec<int64_t,   4>(assert_vec_int<int64_t,   4>);
+    check_vec<uint64_t,  4>(assert_vec_int<uint64_t,  4>);
+}
+
+#endif // INTERNAL_RMGR_FIB_USE_AVX2